@@ -137,6 +137,9 @@ FakeAlignmentSource::FakeAlignmentSource(const edm::ParameterSet& iConfig)
     this->setWhatProduced(this, &FakeAlignmentSource::produceTrackerSurfaceDeformation);
   }
 
+  // The data is made from the configuration only, it does not need other EventSetup data:
+  this->mayUseOwnMutex();
+
   // Tell framework to provide IOV for the above data:
   if (produceTracker_) {
     this->findingRecord<TrackerAlignmentRcd>();
@@ -8,7 +8,10 @@ namespace reco {
 
 class ExpressionEvaluator {
 public:
-  ExpressionEvaluator(const char * pkg,  const char * iname, const std::string & iexpr);
+  // if cacheDir is not empty, the compiled library is stored there, keyed by
+  // package, base class and expression, and reused instead of compiling again
+  ExpressionEvaluator(const char * pkg,  const char * iname, const std::string & iexpr,
+                      const std::string & cacheDir = std::string());
   ~ExpressionEvaluator();
   
   template<typename EXPR, typename... CArgs>
@@ -20,6 +23,7 @@ public:
 private:
 
   std::string m_name;
+  std::string m_tmpName;
   void * m_expr;
 };
 
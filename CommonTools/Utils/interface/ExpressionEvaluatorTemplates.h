@@ -7,6 +7,9 @@
 #include<memory>
 #include<tuple>
 
+// used by the code generated from string cuts and expressions
+#include "CommonTools/Utils/interface/cppExpressionSupport.h"
+
 namespace reco {
 
   template<typename Ret, typename... Args>
@@ -10,6 +10,7 @@
 #include "CommonTools/Utils/src/SelectorPtr.h"
 #include "CommonTools/Utils/src/SelectorBase.h"
 #include "CommonTools/Utils/interface/cutParser.h"
+#include "CommonTools/Utils/interface/cppExpression.h"
 #include "FWCore/Utilities/interface/ObjectWithDict.h"
 
 template<typename T, bool DefaultLazyness=false>
@@ -21,11 +22,19 @@ struct StringCutObjectSelector {
 			   "failed to parse \"" + cut + "\"");
     }
   }
+  // also compile the cut to native code, using the precompiled header of
+  // package pkg (see cppExpression.h); the reflection-based selector is
+  // kept for lazy parsing and for cuts that cannot be compiled
+  StringCutObjectSelector(const std::string & cut, bool lazy, const char * pkg) :
+    StringCutObjectSelector(cut, lazy) {
+    if(! lazy) compiled_ = reco::parser::compiledCut<T>(cut, pkg);
+  }
   StringCutObjectSelector(const reco::parser::SelectorPtr & select) : 
     select_(select),
     type_(typeid(T)) {
   }
   bool operator()(const T & t) const {
+    if(compiled_) return compiled_->eval(t);
     edm::ObjectWithDict o(type_, const_cast<T *>(& t));
     return (*select_)(o);  
   }
@@ -33,6 +42,7 @@ struct StringCutObjectSelector {
 private:
   reco::parser::SelectorPtr select_;
   edm::TypeWithDict type_;
+  std::shared_ptr<reco::CutOnObject<T> const> compiled_;
 };
 
 #endif
@@ -10,6 +10,7 @@
 #include "CommonTools/Utils/src/ExpressionPtr.h"
 #include "CommonTools/Utils/src/ExpressionBase.h"
 #include "CommonTools/Utils/interface/expressionParser.h"
+#include "CommonTools/Utils/interface/cppExpression.h"
 #include "FWCore/Utilities/interface/ObjectWithDict.h"
 
 template<typename T, bool DefaultLazyness=false>
@@ -21,11 +22,19 @@ struct StringObjectFunction {
 			   "failed to parse \"" + expr + "\"");
     }
   }
+  // also compile the expression to native code, using the precompiled header
+  // of package pkg (see cppExpression.h); the reflection-based expression is
+  // kept for lazy parsing and for expressions that cannot be compiled
+  StringObjectFunction(const std::string & expr, bool lazy, const char * pkg) :
+    StringObjectFunction(expr, lazy) {
+    if(! lazy) compiled_ = reco::parser::compiledExpression<T>(expr, pkg);
+  }
   StringObjectFunction(const reco::parser::ExpressionPtr & expr) : 
     expr_(expr),
     type_(typeid(T)) {
   }
   double operator()(const T & t) const {
+    if(compiled_) return compiled_->eval(t);
     edm::ObjectWithDict o(type_, const_cast<T *>(& t));
     return expr_->value(o);  
   }
@@ -33,6 +42,7 @@ struct StringObjectFunction {
 private:
   reco::parser::ExpressionPtr expr_;
   edm::TypeWithDict type_;
+  std::shared_ptr<reco::ValueOnObject<T> const> compiled_;
 };
 
 template <typename Object> class sortByStringFunction  {
@@ -0,0 +1,68 @@
+#ifndef CommonTools_Utils_cppExpression_h
+#define CommonTools_Utils_cppExpression_h
+/* Compilation of the cut and expression strings of StringCutObjectSelector
+ * and StringObjectFunction to native code.
+ *
+ * The string is translated into a C++ expression on an object "obj" of type
+ * T, which is compiled by the ExpressionEvaluator against the precompiled
+ * header of the given package (which must declare T). If the environment
+ * variable CMSSW_EXPRESSION_CACHE points to a directory, the compiled
+ * libraries are kept there, keyed by expression and type, and reused by
+ * later jobs.
+ *
+ * The compiled object is a static of the library, which stays loaded until
+ * the end of the job; the returned shared_ptr therefore never deletes it.
+ * A null pointer is returned when the string cannot be translated or the
+ * generated code does not compile (e.g. the expression uses data members,
+ * edm::Ref dereferencing or enum arguments, which only the reflection-based
+ * parser resolves); callers then keep using the reflection-based evaluation.
+ */
+#include "CommonTools/Utils/interface/ExpressionEvaluator.h"
+#include "CommonTools/Utils/interface/ExpressionEvaluatorTemplates.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/GetEnvironmentVariable.h"
+#include "FWCore/Utilities/interface/TypeWithDict.h"
+#include <memory>
+#include <string>
+
+namespace reco {
+  namespace parser {
+    // translate a cut (cut = true) or an expression string into C++;
+    // returns false if the string is not supported
+    bool cppExpression(const std::string & text, bool cut, std::string & code);
+
+    // reports that text could not be compiled
+    void compilationFailed(const std::string & text, cms::Exception const & e);
+
+    template<typename Base>
+    std::shared_ptr<Base const> compileCppExpression(const char * pkg, const std::string & base, const std::string & body, const std::string & text) {
+      try {
+        ExpressionEvaluator eval(pkg, base.c_str(), body, edm::getEnvironmentVariable("CMSSW_EXPRESSION_CACHE"));
+        return std::shared_ptr<Base const>(eval.expr<Base>(), [](Base const *) {});
+      } catch(cms::Exception const & e) {
+        compilationFailed(text, e);
+        return std::shared_ptr<Base const>();
+      }
+    }
+
+    template<typename T>
+    std::shared_ptr<CutOnObject<T> const> compiledCut(const std::string & cut, const char * pkg) {
+      std::string code;
+      if(! cppExpression(cut, true, code)) return std::shared_ptr<CutOnObject<T> const>();
+      std::string type = edm::TypeWithDict(typeid(T)).cppName();
+      std::string body = "bool eval(" + type + " const& obj) const override { return " + code + "; }";
+      return compileCppExpression<CutOnObject<T>>(pkg, "reco::CutOnObject<" + type + ">", body, cut);
+    }
+
+    template<typename T>
+    std::shared_ptr<ValueOnObject<T> const> compiledExpression(const std::string & expr, const char * pkg) {
+      std::string code;
+      if(! cppExpression(expr, false, code)) return std::shared_ptr<ValueOnObject<T> const>();
+      std::string type = edm::TypeWithDict(typeid(T)).cppName();
+      std::string body = "double eval(" + type + " const& obj) const override { return " + code + "; }";
+      return compileCppExpression<ValueOnObject<T>>(pkg, "reco::ValueOnObject<" + type + ">", body, expr);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef CommonTools_Utils_cppExpressionSupport_h
+#define CommonTools_Utils_cppExpressionSupport_h
+/* Helpers used by the C++ code that reco::parser::cppExpression generates
+ * from cut and expression strings. Each of them reproduces the behaviour of
+ * the corresponding node of the reflection-based parser, so that a compiled
+ * selector returns the same result as the interpreted one.
+ */
+#include "FWCore/Utilities/interface/EDMException.h"
+#include "DataFormats/Math/interface/deltaPhi.h"
+#include "DataFormats/Math/interface/deltaR.h"
+#include "Math/ProbFuncMathCore.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace reco {
+  namespace parser {
+    namespace cpp {
+
+      // method calls go through objects, references and pointers alike,
+      // as in MethodInvoker::invoke
+      template<typename T>
+      inline T const& deref(T const& t) { return t; }
+
+      template<typename T>
+      inline T const& deref(T const* t) {
+        if (t == nullptr) {
+          throw edm::Exception(edm::errors::InvalidReference)
+              << "method called in a compiled expression returned a null pointer ";
+        }
+        return *t;
+      }
+
+      template<typename T>
+      inline T const& deref(T* t) { return deref(const_cast<T const*>(t)); }
+
+      // see ExpressionFunctionSetter.cc
+      inline double abs(double x) { return std::fabs(x); }
+      inline double acos(double x) { return std::acos(x); }
+      inline double asin(double x) { return std::asin(x); }
+      inline double atan(double x) { return std::atan(x); }
+      inline double atan2(double x, double y) { return std::atan2(x, y); }
+      inline double chi2prob(double x, double y) { return ROOT::Math::chisquared_cdf_c(x, y); }
+      inline double cos(double x) { return std::cos(x); }
+      inline double cosh(double x) { return std::cosh(x); }
+      inline double deltaR(double e1, double p1, double e2, double p2) { return reco::deltaR(e1, p1, e2, p2); }
+      inline double deltaPhi(double p1, double p2) { return reco::deltaPhi(p1, p2); }
+      inline double exp(double x) { return std::exp(x); }
+      inline double hypot(double x, double y) { return std::hypot(x, y); }
+      inline double log(double x) { return std::log(x); }
+      inline double max(double x, double y) { return std::max(x, y); }
+      inline double min(double x, double y) { return std::min(x, y); }
+      inline double pow(double x, double y) { return std::pow(x, y); }
+      inline double sin(double x) { return std::sin(x); }
+      inline double sinh(double x) { return std::sinh(x); }
+      inline double sqrt(double x) { return std::sqrt(x); }
+      inline double tan(double x) { return std::tan(x); }
+      inline double tanh(double x) { return std::tanh(x); }
+      inline double test_bit(double mask, double iBit) { return (int(mask) >> int(iBit)) & 1; }
+
+    }
+  }
+}
+
+#endif
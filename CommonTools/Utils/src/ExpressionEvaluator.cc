@@ -2,10 +2,12 @@
 #include "FWCore/Version/interface/GetReleaseVersion.h"
 #include "FWCore/Utilities/interface/GetEnvironmentVariable.h"
 #include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/Digest.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include "popenCPP.h"
 
+#include <cstdio>
 #include <fstream>
 #include <regex>
 #include <dlfcn.h>
@@ -29,6 +31,16 @@ namespace {
     return n1;
   }
 
+  // stable name for the cached library of a given expression
+  std::string cacheKey(const char * pkg, const char * iname, std::string const & iexpr) {
+    cms::Digest digest(edm::getReleaseVersion());
+    digest.append(edm::getEnvironmentVariable("SCRAM_ARCH"));
+    digest.append(pkg);
+    digest.append(iname);
+    digest.append(iexpr);
+    return digest.digest().toString();
+  }
+
  void remove(std::string const & name) {
   std::string sfile = "/tmp/"+name+".cc";
   std::string ofile = "/tmp/"+name+".so";
@@ -51,17 +63,31 @@ namespace {
 
 namespace reco{
 
-ExpressionEvaluator::ExpressionEvaluator(const char * pkg, const char * iname, std::string const & iexpr) :
-  m_name("VI_"+generateName())
+ExpressionEvaluator::ExpressionEvaluator(const char * pkg, const char * iname, std::string const & iexpr, std::string const & cacheDir) :
+  m_tmpName("VI_"+generateName())
 {
-
+  m_name = cacheDir.empty() ? m_tmpName : "VI_"+cacheKey(pkg, iname, iexpr);
 
   std::string pch = pkg; pch += "/src/precompile.h";
   std::string quote("\"");
 
   
-  std::string sfile = "/tmp/"+m_name+".cc";
-  std::string ofile = "/tmp/"+m_name+".so";
+  std::string sfile = "/tmp/"+m_tmpName+".cc";
+  std::string ofile = cacheDir.empty() ? "/tmp/"+m_tmpName+".so" : cacheDir+'/'+m_name+".so";
+  // when caching, compile under a unique name and move the library in place
+  // once complete, so that concurrent jobs never load a partial file
+  std::string cfile = cacheDir.empty() ? ofile : cacheDir+'/'+m_tmpName+".so";
+
+  if (!cacheDir.empty()) {
+    void * dl = dlopen(ofile.c_str(),RTLD_LAZY);
+    if (dl) {
+      m_expr = dlsym(dl,("factory"+m_name).c_str());
+      if (m_expr) {
+        COUT << "using cached " << ofile << std::endl;
+        return;
+      }
+    }
+  }
 
   auto arch = edm::getEnvironmentVariable("SCRAM_ARCH");
   auto baseDir = edm::getEnvironmentVariable("CMSSW_BASE");
@@ -108,7 +134,7 @@ ExpressionEvaluator::ExpressionEvaluator(const char * pkg, const char * iname, s
 
   std::string cpp = "c++ -H -Wall -shared -Winvalid-pch "; cpp+=cxxf;
   cpp += " -I" + incDir; 
-  cpp += " -o " + ofile + ' ' + sfile+" 2>&1\n";
+  cpp += " -o " + cfile + ' ' + sfile+" 2>&1\n";
 
   COUT << cpp << std::endl;
 
@@ -140,20 +166,24 @@ ExpressionEvaluator::ExpressionEvaluator(const char * pkg, const char * iname, s
   auto ss = execSysCommand(cpp);
   COUT << ss << std::endl;
 
+  if (cfile != ofile && std::rename(cfile.c_str(), ofile.c_str()) != 0) {
+    std::remove(cfile.c_str());
+  }
+
   void * dl = dlopen(ofile.c_str(),RTLD_LAZY);
   if (!dl) {
-     remove(m_name);
+     remove(m_tmpName);
      throw  cms::Exception("ExpressionEvaluator", std::string("compilation/linking failed\n") +  cpp + ss + "dlerror " + dlerror());
     return;
   }
 
   m_expr = dlsym(dl,factory.c_str());
-  remove(m_name);
+  remove(m_tmpName);
 }
 
 
 ExpressionEvaluator::~ExpressionEvaluator(){
-  remove(m_name);
+  remove(m_tmpName);
 }
 
 
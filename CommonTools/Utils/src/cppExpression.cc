@@ -0,0 +1,417 @@
+#include "CommonTools/Utils/interface/cppExpression.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <cctype>
+#include <set>
+
+/* Recursive-descent translation of the cut/expression grammar of Grammar.h
+ * into C++. The rules, their order and the backtracking follow the Spirit
+ * grammar one by one, so that every string accepted by cutParser or
+ * expressionParser is given the same structure here. Methods are emitted as
+ * calls on the object "obj", going through reco::parser::cpp::deref; whether
+ * they actually exist is left to the compiler.
+ */
+
+namespace {
+
+  class Translator {
+  public:
+    explicit Translator(std::string const& text) : text_(text), pos_(0) { }
+
+    bool cut(std::string& code) {
+      return logicalExpression(code) and atEnd();
+    }
+
+    bool expression(std::string& code) {
+      return expr(code) and atEnd();
+    }
+
+  private:
+    // whitespace is skipped between tokens, as with space_p
+    void skip() {
+      while (pos_ < text_.size() and std::isspace(static_cast<unsigned char>(text_[pos_])))
+        ++pos_;
+    }
+
+    bool atEnd() {
+      skip();
+      return pos_ == text_.size();
+    }
+
+    char peek() {
+      skip();
+      return pos_ < text_.size() ? text_[pos_] : '\0';
+    }
+
+    bool accept(char c) {
+      if (peek() != c)
+        return false;
+      ++pos_;
+      return true;
+    }
+
+    // lexeme_d[alpha_p >> *chset<>("a-zA-Z0-9_")]
+    bool identifier(std::string& name) {
+      skip();
+      if (pos_ >= text_.size() or not std::isalpha(static_cast<unsigned char>(text_[pos_])))
+        return false;
+      size_t begin = pos_;
+      while (pos_ < text_.size() and (std::isalnum(static_cast<unsigned char>(text_[pos_])) or text_[pos_] == '_'))
+        ++pos_;
+      name = text_.substr(begin, pos_ - begin);
+      return true;
+    }
+
+    // real_p (strict = false) and strict_real_p (strict = true)
+    bool real(std::string& code, bool strict) {
+      skip();
+      size_t p = pos_;
+      if (p < text_.size() and (text_[p] == '+' or text_[p] == '-'))
+        ++p;
+      size_t digits = 0;
+      while (p < text_.size() and std::isdigit(static_cast<unsigned char>(text_[p]))) { ++p; ++digits; }
+      bool isReal = false;
+      if (p < text_.size() and text_[p] == '.') {
+        ++p;
+        isReal = true;
+        while (p < text_.size() and std::isdigit(static_cast<unsigned char>(text_[p]))) { ++p; ++digits; }
+      }
+      if (digits == 0)
+        return false;
+      if (p < text_.size() and (text_[p] == 'e' or text_[p] == 'E')) {
+        size_t q = p + 1;
+        if (q < text_.size() and (text_[q] == '+' or text_[q] == '-'))
+          ++q;
+        if (q < text_.size() and std::isdigit(static_cast<unsigned char>(text_[q]))) {
+          while (q < text_.size() and std::isdigit(static_cast<unsigned char>(text_[q])))
+            ++q;
+          p = q;
+          isReal = true;
+        }
+      }
+      if (strict and not isReal)
+        return false;
+      code = text_.substr(pos_, p - pos_);
+      pos_ = p;
+      return true;
+    }
+
+    // int_p
+    bool integer(std::string& code) {
+      skip();
+      size_t p = pos_;
+      if (p < text_.size() and (text_[p] == '+' or text_[p] == '-'))
+        ++p;
+      size_t begin = p;
+      while (p < text_.size() and std::isdigit(static_cast<unsigned char>(text_[p])))
+        ++p;
+      if (p == begin)
+        return false;
+      code = text_.substr(pos_, p - pos_);
+      pos_ = p;
+      return true;
+    }
+
+    // metharg: strict real, integer, or a string in single or double quotes
+    bool methodArgument(std::string& code) {
+      if (real(code, true) or integer(code))
+        return true;
+      char quote = peek();
+      if (quote != '"' and quote != '\'')
+        return false;
+      size_t end = text_.find(quote, pos_ + 1);
+      if (end == std::string::npos)
+        return false;
+      code = "\"";
+      for (size_t i = pos_ + 1; i < end; ++i) {
+        if (text_[i] == '"' or text_[i] == '\\')
+          code += '\\';
+        code += text_[i];
+      }
+      code += '"';
+      pos_ = end + 1;
+      return true;
+    }
+
+    bool methodArguments(std::string& code, char close) {
+      std::string arg;
+      if (not methodArgument(arg))
+        return false;
+      code = arg;
+      while (accept(',')) {
+        if (not methodArgument(arg))
+          return false;
+        code += ", " + arg;
+      }
+      return accept(close);
+    }
+
+    // var: name(args) | name | name()
+    bool var(std::string const& object, std::string& code) {
+      std::string name;
+      if (not identifier(name))
+        return false;
+      size_t afterName = pos_;
+      std::string args;
+      if (accept('(') and methodArguments(args, ')')) {
+        code = "reco::parser::cpp::deref(" + object + ")." + name + "(" + args + ")";
+        return true;
+      }
+      pos_ = afterName;
+      if (not (accept('(') and accept(')')))
+        pos_ = afterName;
+      code = "reco::parser::cpp::deref(" + object + ")." + name + "()";
+      return true;
+    }
+
+    // method: var >> *(arrayAccess | '.' var)
+    bool method(std::string& code) {
+      std::string current;
+      if (not var("obj", current))
+        return false;
+      for (;;) {
+        size_t save = pos_;
+        std::string args;
+        if (accept('[')) {
+          if (methodArguments(args, ']') and args.find(',') == std::string::npos) {
+            current = "reco::parser::cpp::deref(" + current + ")[" + args + "]";
+            continue;
+          }
+          pos_ = save;
+          return false;
+        }
+        if (accept('.')) {
+          std::string next;
+          if (not var(current, next))
+            return false;
+          current = next;
+          continue;
+        }
+        break;
+      }
+      code = "double(reco::parser::cpp::deref(" + current + "))";
+      return true;
+    }
+
+    bool function(std::string& code) {
+      // log10 is listed after log in Grammar.h, so it can never match as a function
+      static const std::set<std::string> functions1 = {
+        "abs", "acos", "asin", "atan", "cosh", "cos", "exp", "log", "sinh", "sin", "sqrt", "tanh", "tan" };
+      static const std::set<std::string> functions2 = {
+        "atan2", "chi2prob", "pow", "min", "max", "deltaPhi", "hypot", "test_bit" };
+      static const std::set<std::string> functions4 = { "deltaR" };
+
+      size_t save = pos_;
+      std::string name;
+      if (not identifier(name))
+        return false;
+      unsigned int nargs = functions1.count(name) ? 1 : functions2.count(name) ? 2 : functions4.count(name) ? 4 : 0;
+      if (nargs == 0 or not accept('(')) {
+        pos_ = save;
+        return false;
+      }
+      code = "reco::parser::cpp::" + name + "(";
+      for (unsigned int i = 0; i < nargs; ++i) {
+        std::string arg;
+        if ((i > 0 and not accept(',')) or not expr(arg))
+          return false;
+        code += (i > 0 ? ", " : "") + arg;
+      }
+      code += ")";
+      return accept(')');
+    }
+
+    // factor: number | function | method | '(' expression ')' | '-' factor | '+' factor
+    bool factor(std::string& code) {
+      size_t save = pos_;
+      std::string sub;
+      if (real(sub, false)) {
+        code = "double(" + sub + ")";
+        return true;
+      }
+      if (function(sub)) {
+        code = sub;
+        return true;
+      }
+      pos_ = save;
+      if (method(sub)) {
+        code = sub;
+        return true;
+      }
+      pos_ = save;
+      if (accept('(')) {
+        if (expr(sub) and accept(')')) {
+          code = "(" + sub + ")";
+          return true;
+        }
+      }
+      pos_ = save;
+      if (accept('-') and factor(sub)) {
+        code = "(-" + sub + ")";
+        return true;
+      }
+      pos_ = save;
+      if (accept('+') and factor(sub)) {
+        code = sub;
+        return true;
+      }
+      pos_ = save;
+      return false;
+    }
+
+    // power: factor >> *('^' >> factor), left associative
+    bool power(std::string& code) {
+      if (not factor(code))
+        return false;
+      while (accept('^')) {
+        std::string rhs;
+        if (not factor(rhs))
+          return false;
+        code = "reco::parser::cpp::pow(" + code + ", " + rhs + ")";
+      }
+      return true;
+    }
+
+    // term: power >> *(('*' | '/') >> power)
+    bool term(std::string& code) {
+      if (not power(code))
+        return false;
+      for (;;) {
+        char op = peek();
+        if (op != '*' and op != '/')
+          return true;
+        ++pos_;
+        std::string rhs;
+        if (not power(rhs))
+          return false;
+        code = "(" + code + " " + op + " " + rhs + ")";
+      }
+    }
+
+    // expression: cond_expression | nocond_expression
+    bool expr(std::string& code) {
+      size_t save = pos_;
+      if (accept('?')) {
+        std::string cond, lhs, rhs;
+        if (logicalExpression(cond) and accept('?') and expr(lhs) and accept(':') and expr(rhs)) {
+          code = "((" + cond + ") ? " + lhs + " : " + rhs + ")";
+          return true;
+        }
+        pos_ = save;
+        return false;
+      }
+      if (not term(code))
+        return false;
+      for (;;) {
+        char op = peek();
+        if (op != '+' and op != '-')
+          return true;
+        ++pos_;
+        std::string rhs;
+        if (not term(rhs))
+          return false;
+        code = "(" + code + " " + op + " " + rhs + ")";
+      }
+    }
+
+    bool comparison(std::string& op) {
+      size_t save = pos_;
+      char c = peek();
+      ++pos_;
+      switch (c) {
+      case '<': op = (pos_ < text_.size() and text_[pos_] == '=') ? (++pos_, "<=") : "<"; return true;
+      case '>': op = (pos_ < text_.size() and text_[pos_] == '=') ? (++pos_, ">=") : ">"; return true;
+      case '=': if (pos_ < text_.size() and text_[pos_] == '=') ++pos_; op = "=="; return true;
+      case '!': if (pos_ < text_.size() and text_[pos_] == '=') { ++pos_; op = "!="; return true; } break;
+      default: break;
+      }
+      pos_ = save;
+      return false;
+    }
+
+    // logical_factor: trinary_comp | binary_comp | '(' logical ')' | '!' logical_factor | expression
+    bool logicalFactor(std::string& code) {
+      size_t save = pos_;
+      std::string lhs, op1, mid, op2, rhs;
+      if (expr(lhs) and comparison(op1) and expr(mid)) {
+        size_t afterBinary = pos_;
+        if (comparison(op2) and expr(rhs)) {
+          // the middle term is evaluated twice, as in TrinarySelector
+          code = "(" + lhs + " " + op1 + " " + mid + " && " + mid + " " + op2 + " " + rhs + ")";
+          return true;
+        }
+        pos_ = afterBinary;
+        code = "(" + lhs + " " + op1 + " " + mid + ")";
+        return true;
+      }
+      pos_ = save;
+      std::string sub;
+      if (accept('(')) {
+        if (logicalExpression(sub) and accept(')')) {
+          code = "(" + sub + ")";
+          return true;
+        }
+      }
+      pos_ = save;
+      if (accept('!') and logicalFactor(sub)) {
+        code = "(!" + sub + ")";
+        return true;
+      }
+      pos_ = save;
+      if (expr(sub)) {
+        code = "(" + sub + " != 0)";
+        return true;
+      }
+      pos_ = save;
+      return false;
+    }
+
+    // logical_term: logical_factor >> *(('&&' | '&') >> logical_factor)
+    bool logicalTerm(std::string& code) {
+      if (not logicalFactor(code))
+        return false;
+      while (accept('&')) {
+        if (pos_ < text_.size() and text_[pos_] == '&')
+          ++pos_;
+        std::string rhs;
+        if (not logicalFactor(rhs))
+          return false;
+        code = "(" + code + " && " + rhs + ")";
+      }
+      return true;
+    }
+
+    // logical_expression: logical_term >> *(('||' | '|') >> logical_term)
+    bool logicalExpression(std::string& code) {
+      if (not logicalTerm(code))
+        return false;
+      while (accept('|')) {
+        if (pos_ < text_.size() and text_[pos_] == '|')
+          ++pos_;
+        std::string rhs;
+        if (not logicalTerm(rhs))
+          return false;
+        code = "(" + code + " || " + rhs + ")";
+      }
+      return true;
+    }
+
+    std::string const& text_;
+    size_t pos_;
+  };
+
+}
+
+bool reco::parser::cppExpression(std::string const& text, bool cut, std::string& code) {
+  if (cut and text.find_first_not_of(' ') == std::string::npos) {
+    // see cutParser: a blank cut selects everything
+    code = "true";
+    return true;
+  }
+  Translator translator(text);
+  return cut ? translator.cut(code) : translator.expression(code);
+}
+
+void reco::parser::compilationFailed(std::string const& text, cms::Exception const& e) {
+  edm::LogInfo("ExpressionCompilation") << "could not compile \"" << text << "\", using the interpreted version:\n" << e.what();
+}
@@ -2,6 +2,8 @@
 
 #include "CommonTools/Utils/interface/ExpressionEvaluator.h"
 #include "CommonTools/Utils/interface/ExpressionEvaluatorTemplates.h"
+#include "CommonTools/Utils/interface/StringCutObjectSelector.h"
+#include "CommonTools/Utils/interface/StringObjectFunction.h"
 
 #include "DataFormats/TrackReco/interface/Track.h"
 #include "DataFormats/TrackReco/interface/TrackExtra.h"
@@ -62,6 +64,31 @@ namespace {
    }
 
 
+  // the compiled selector must agree with the interpreted one on every candidate;
+  // returns how many candidates pass
+  int checkCompiledCut(std::vector<reco::LeafCandidate> const & cands, const std::string & cut) {
+    std::cerr << "testing compiled cut " << cut << std::endl;
+    CPPUNIT_ASSERT(reco::parser::compiledCut<reco::LeafCandidate>(cut, "CommonTools/CandUtils"));
+    StringCutObjectSelector<reco::LeafCandidate> interpreted(cut);
+    StringCutObjectSelector<reco::LeafCandidate> compiled(cut, false, "CommonTools/CandUtils");
+    int passed = 0;
+    for (auto const & cand : cands) {
+      CPPUNIT_ASSERT(interpreted(cand) == compiled(cand));
+      if (compiled(cand)) ++passed;
+    }
+    return passed;
+  }
+
+  void checkCompiledFunction(std::vector<reco::LeafCandidate> const & cands, const std::string & expr) {
+    std::cerr << "testing compiled expression " << expr << std::endl;
+    CPPUNIT_ASSERT(reco::parser::compiledExpression<reco::LeafCandidate>(expr, "CommonTools/CandUtils"));
+    StringObjectFunction<reco::LeafCandidate> interpreted(expr);
+    StringObjectFunction<reco::LeafCandidate> compiled(expr, false, "CommonTools/CandUtils");
+    for (auto const & cand : cands) {
+      CPPUNIT_ASSERT(std::abs(interpreted(cand) - compiled(cand)) < 1.e-9);
+    }
+  }
+
   struct MyAnalyzer {
     using Selector = reco::MaskCollection<reco::LeafCandidate>;
     explicit MyAnalyzer(std::string const & cut) {
@@ -157,6 +184,25 @@ void testExpressionEvaluator::checkAll() {
 
   }
 
+  {
+    auto compiledCands = generate();
+    compiledCands.push_back(c1);
+    compiledCands.push_back(c2);
+    int const all = compiledCands.size();
+    // the same selection as MyAnalyzer below
+    CPPUNIT_ASSERT(2 == checkCompiledCut(compiledCands, "pt > 15 & abs(eta) < 2"));
+    int passed = checkCompiledCut(compiledCands, "pt > 12 & abs(eta) < 2.4 | charge = -1");
+    CPPUNIT_ASSERT(passed > 0 && passed < all);
+    passed = checkCompiledCut(compiledCands, "1 < pt < 20 && !(charge > 0)");
+    CPPUNIT_ASSERT(passed > 0 && passed < all);
+    CPPUNIT_ASSERT(all == checkCompiledCut(compiledCands, ""));
+    checkCompiledFunction(compiledCands, "-2^2 + pt / 3 * charge");
+    checkCompiledFunction(compiledCands, "? charge < 0 ? px : py");
+    checkCompiledFunction(compiledCands, "deltaPhi(phi, 1.5) + test_bit(5, 2) + min(pz, energy())");
+  }
+  // methods the type does not have make the compilation fail, and the caller falls back
+  CPPUNIT_ASSERT(reco::parser::compiledCut<reco::LeafCandidate>("pdgIdNotThere", "CommonTools/CandUtils") == nullptr);
+
   MyAnalyzer analyzer("cand.pt()>15 & std::abs(cand.eta())<2");
   analyzer.analyze();
 
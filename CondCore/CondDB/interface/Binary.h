@@ -18,6 +18,10 @@ namespace cond {
 
     Binary( const void* data, size_t size  );
 
+    // refers to the data owned by the given pointer (e.g. a read-only file
+    // mapping) without copying it; get() and the non-const data() make a copy first
+    Binary( std::shared_ptr<const void> data, size_t size );
+
     explicit Binary( const coral::Blob& data );
 
     Binary( const Binary& rhs );
@@ -35,7 +39,12 @@ namespace cond {
     size_t size() const;
 
   private:
-    std::shared_ptr<coral::Blob> m_data;
+    // copy the referenced data, if any, into m_data
+    void detach() const;
+
+    mutable std::shared_ptr<coral::Blob> m_data;
+    mutable std::shared_ptr<const void> m_view;
+    size_t m_viewSize = 0;
   };
 
 }
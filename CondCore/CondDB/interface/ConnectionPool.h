@@ -19,6 +19,9 @@ namespace coral {
 
 namespace cond {
   class CoralServiceManager;
+  namespace persistency {
+    class PayloadCache;
+  }
 }
 
 namespace cond {
@@ -27,6 +30,9 @@ namespace cond {
     // 
     enum DbAuthenticationSystem { UndefinedAuthentication=0,CondDbKey, CoralXMLFile };
 
+    // environment variable giving the payload cache directory, if not set in the configuration
+    static constexpr const char* const PAYLOAD_CACHE_PATH_ENV = "CMSSW_CONDDB_PAYLOAD_CACHE";
+
     // a wrapper for the coral connection service.  
     class ConnectionPool {
     public:
@@ -38,6 +44,10 @@ namespace cond {
       void setAuthenticationSystem( int authSysCode );
       void setFrontierSecurity( const std::string& signature );
       void setLogging( bool flag );   
+      // directory of the node-local payload cache (see PayloadCache); empty: no cache
+      void setPayloadCachePath( const std::string& p );
+      // maximum size of the payload cache in MB, 0 for no limit
+      void setPayloadCacheSize( unsigned int megabytes );
       bool isLoggingEnabled() const;
       void setParameters( const edm::ParameterSet& connectionPset );
       void configure();
@@ -53,6 +63,7 @@ namespace cond {
                              const std::string& transactionId, 
                              bool writeCapable = false );
       void configure( coral::IConnectionServiceConfiguration& coralConfig );
+      std::shared_ptr<PayloadCache> payloadCache();
     private:
       std::string m_authPath = std::string( "" );
       int m_authSys = 0;
@@ -61,6 +72,9 @@ namespace cond {
       //The frontier security option is turned on for all sessions
       //usig this wrapper of the CORAL connection setup for configuring the server access
       std::string m_frontierSecurity = std::string( "" );
+      std::string m_payloadCachePath = std::string( "" );
+      unsigned int m_payloadCacheSize = 4096;
+      std::shared_ptr<PayloadCache> m_payloadCache;
       // this one has to be moved!
       cond::CoralServiceManager* m_pluginManager = nullptr; 
       std::map<std::string,int> m_dbTypes;
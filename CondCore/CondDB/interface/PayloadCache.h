@@ -0,0 +1,80 @@
+#ifndef CondCore_CondDB_PayloadCache_h
+#define CondCore_CondDB_PayloadCache_h
+//
+// Package:     CondDB
+//
+/**PayloadCache.h CondCore/CondDB/interface/PayloadCache.h
+   Description: node-local cache of the payload data fetched from the database.
+
+   Each payload is kept in one file, named after its hash, with the payload
+   type, the serialized payload and the streamer info. The first process
+   which needs a payload fetches it from the database and stores it; the
+   other processes running on the node map the file read-only instead of
+   querying the database (or Frontier) again. The serialized payload is
+   deserialized straight from the mapping, so its pages are shared through
+   the page cache by all the processes reading it; each process still builds
+   its own deserialized object, which holds heap pointers and cannot be
+   shared.
+   Since the hash identifies the content of the payload, an entry never
+   becomes stale; it is checked against the hash when read, and ignored if
+   it does not match. Files are written under a unique temporary name and
+   renamed, and never modified afterwards, so that a reader sees either a
+   complete entry or none, and a mapping stays valid even if the entry is
+   replaced or removed. The directory must belong to the user running the
+   job.
+   When the entries exceed the maximum size, the least recently used ones
+   (by modification time, which is updated on each read) are removed after
+   storing a new one.
+*/
+//
+
+#include "CondCore/CondDB/interface/Types.h"
+//
+#include <atomic>
+#include <string>
+
+namespace cond {
+
+  class Binary;
+
+  namespace persistency {
+
+    class PayloadCache {
+    public:
+      // maxSize in bytes, 0 for no limit
+      explicit PayloadCache( const std::string& directory, size_t maxSize = 0 );
+
+      // returns false if the payload is not in the cache; on success the
+      // data refer to the mapped entry
+      bool fetch( const Hash& payloadHash,
+		  std::string& payloadType,
+		  Binary& payloadData,
+		  Binary& streamerInfoData ) const;
+
+      // failures to store are reported, but not fatal: the payload is simply not cached
+      void store( const Hash& payloadHash,
+		  const std::string& payloadType,
+		  const Binary& payloadData,
+		  const Binary& streamerInfoData ) const;
+
+      const std::string& directory() const { return m_directory; }
+      size_t maxSize() const { return m_maxSize; }
+
+      // number of calls to fetch which found the payload, or did not
+      unsigned int hits() const { return m_hits; }
+      unsigned int misses() const { return m_misses; }
+
+    private:
+      std::string fileName( const Hash& payloadHash ) const;
+      // remove the least recently used entries beyond m_maxSize, except keep
+      void evict( const std::string& keep ) const;
+
+      std::string m_directory;
+      size_t m_maxSize;
+      mutable std::atomic<unsigned int> m_hits{0};
+      mutable std::atomic<unsigned int> m_misses{0};
+    };
+
+  }
+}
+#endif // CondCore_CondDB_PayloadCache_h
@@ -6,6 +6,10 @@ CondDB = cms.PSet(
         authenticationSystem = cms.untracked.int32(0),
         security = cms.untracked.string(''),
         messageLevel = cms.untracked.int32(0),
+        # node-local cache of the payloads fetched from the database, shared by the jobs on the node ('': disabled)
+        payloadCachePath = cms.untracked.string(''),
+        # maximum size of the payload cache in MB, beyond which the least recently used payloads are removed (0: no limit)
+        payloadCacheSize = cms.untracked.uint32(4096),
     ),
     connect = cms.string(''), 
 )
@@ -17,41 +17,63 @@ cond::Binary::Binary( const void* data, size_t size  ):
   ::memcpy( m_data->startingAddress(), data, size );
 }
 
+cond::Binary::Binary( std::shared_ptr<const void> data, size_t size ):
+  m_data( new coral::Blob(0) ),
+  m_view( std::move( data ) ),
+  m_viewSize( size ){
+}
+
 cond::Binary::Binary( const coral::Blob& data ):
   m_data( new coral::Blob(data.size()) ){
   ::memcpy( m_data->startingAddress(), data.startingAddress(), data.size() );
 }
 
 cond::Binary::Binary( const Binary& rhs ):
-  m_data( rhs.m_data ){
+  m_data( rhs.m_data ),
+  m_view( rhs.m_view ),
+  m_viewSize( rhs.m_viewSize ){
 }
 
 cond::Binary& cond::Binary::operator=( const Binary& rhs ){
   if( this != &rhs ) {
     m_data = rhs.m_data;
+    m_view = rhs.m_view;
+    m_viewSize = rhs.m_viewSize;
   }
   return *this;
 }
 
+void cond::Binary::detach() const {
+  if( !m_view ) return;
+  m_data.reset( new coral::Blob( m_viewSize ) );
+  ::memcpy( m_data->startingAddress(), m_view.get(), m_viewSize );
+  m_view.reset();
+}
+
 const coral::Blob& cond::Binary::get() const {
+  detach();
   return *m_data;
 }
 
 void cond::Binary::copy( const std::string& source ){
+  m_view.reset();
   m_data.reset( new coral::Blob( source.size() ) );
   ::memcpy( m_data->startingAddress(), source.c_str(), source.size() );
 }
 
 const void* cond::Binary::data() const {
+  if( m_view ) return m_view.get();
   if(!m_data.get()) throwException( "Binary data can't be accessed.","Binary::data");
   return m_data->startingAddress();
 }
 void* cond::Binary::data(){
+  detach();
   if(!m_data.get()) throwException( "Binary data can't be accessed.","Binary::data");
   return m_data->startingAddress();
 }
 
 size_t cond::Binary::size() const {
+  if( m_view ) return m_viewSize;
   if(!m_data.get()) throwException( "Binary data can't be accessed.","Binary::size");
   return m_data->size();
 }
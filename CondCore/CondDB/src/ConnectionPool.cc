@@ -4,6 +4,7 @@
 #include "IOVSchema.h"
 //
 #include "CondCore/CondDB/interface/CoralServiceManager.h"
+#include "CondCore/CondDB/interface/PayloadCache.h"
 #include "CondCore/CondDB/interface/Auth.h"
 // CMSSW includes
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
@@ -46,6 +47,16 @@ namespace cond {
     void ConnectionPool::setLogging( bool flag ){
       m_loggingEnabled = flag;
     }
+
+    void ConnectionPool::setPayloadCachePath( const std::string& p ){
+      m_payloadCachePath = p;
+      m_payloadCache.reset();
+    }
+
+    void ConnectionPool::setPayloadCacheSize( unsigned int megabytes ){
+      m_payloadCacheSize = megabytes;
+      m_payloadCache.reset();
+    }
     
     void ConnectionPool::setParameters( const edm::ParameterSet& connectionPset ){
       //set the connection parameters from a ParameterSet
@@ -74,6 +85,8 @@ namespace cond {
       }
       setMessageVerbosity( level );
       setLogging( connectionPset.getUntrackedParameter<bool>( "logging", m_loggingEnabled ) );
+      setPayloadCachePath( connectionPset.getUntrackedParameter<std::string>( "payloadCachePath", m_payloadCachePath ) );
+      setPayloadCacheSize( connectionPset.getUntrackedParameter<unsigned int>( "payloadCacheSize", m_payloadCacheSize ) );
     }
 
     bool ConnectionPool::isLoggingEnabled() const {
@@ -156,7 +169,22 @@ namespace cond {
                                            const std::string& transactionId, 
                                            bool writeCapable ){
       std::shared_ptr<coral::ISessionProxy> coralSession = createCoralSession( connectionString, transactionId, writeCapable );
-      return Session( std::make_shared<SessionImpl>( coralSession, connectionString ));
+      auto session = std::make_shared<SessionImpl>( coralSession, connectionString );
+      session->payloadCache = payloadCache();
+      return Session( session );
+    }
+
+    std::shared_ptr<PayloadCache> ConnectionPool::payloadCache(){
+      if( !m_payloadCache ){
+        std::string cachePath = m_payloadCachePath;
+        if( cachePath.empty() ){
+          // the cache can also be enabled for all the jobs of a node from the environment
+          const char* cacheEnv = ::getenv( PAYLOAD_CACHE_PATH_ENV );
+          if( cacheEnv ) cachePath = cacheEnv;
+        }
+        if( !cachePath.empty() ) m_payloadCache = std::make_shared<PayloadCache>( cachePath, size_t( m_payloadCacheSize ) << 20 );
+      }
+      return m_payloadCache;
     }
 
     Session ConnectionPool::createSession( const std::string& connectionString, bool writeCapable ){
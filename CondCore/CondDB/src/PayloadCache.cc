@@ -0,0 +1,202 @@
+#include "CondCore/CondDB/interface/PayloadCache.h"
+#include "CondCore/CondDB/interface/Binary.h"
+#include "CondCore/CondDB/interface/Exception.h"
+#include "IOVSchema.h"
+//
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+//
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+//
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  constexpr char cacheMagic[8] = { 'C', 'O', 'N', 'D', 'P', 'L', 'C', '1' };
+
+  struct EntryHeader {
+    char magic[8];
+    uint64_t typeSize;
+    uint64_t dataSize;
+    uint64_t streamerInfoSize;
+  };
+
+  bool writeAll( int fd, const void* data, size_t size ){
+    const char* p = static_cast<const char*>( data );
+    while( size > 0 ){
+      ssize_t n = ::write( fd, p, size );
+      if( n < 0 ){
+	if( errno == EINTR ) continue;
+	return false;
+      }
+      p += n;
+      size -= n;
+    }
+    return true;
+  }
+
+}
+
+namespace cond {
+
+  namespace persistency {
+
+    PayloadCache::PayloadCache( const std::string& directory, size_t maxSize ):
+      m_directory( directory ),
+      m_maxSize( maxSize ){
+      if( ::mkdir( m_directory.c_str(), 0755 ) != 0 && errno != EEXIST ){
+	throwException( "Cannot create the payload cache directory \""+m_directory+"\": "+std::strerror( errno ),
+			"PayloadCache::PayloadCache" );
+      }
+      // the entries are trusted only if nobody else can replace them
+      struct stat st;
+      if( ::stat( m_directory.c_str(), &st ) != 0 || !S_ISDIR( st.st_mode ) ){
+	throwException( "The payload cache path \""+m_directory+"\" is not a directory",
+			"PayloadCache::PayloadCache" );
+      }
+      if( st.st_uid != ::geteuid() || ( st.st_mode & ( S_IWGRP | S_IWOTH ) ) ){
+	throwException( "The payload cache directory \""+m_directory+"\" must belong to the user running the job and must not be writable by others",
+			"PayloadCache::PayloadCache" );
+      }
+    }
+
+    std::string PayloadCache::fileName( const Hash& payloadHash ) const {
+      return m_directory+"/"+payloadHash+".payload";
+    }
+
+    bool PayloadCache::fetch( const Hash& payloadHash,
+			      std::string& payloadType,
+			      Binary& payloadData,
+			      Binary& streamerInfoData ) const {
+      int fd = ::open( fileName( payloadHash ).c_str(), O_RDONLY );
+      if( fd < 0 ){
+	++m_misses;
+	return false;
+      }
+      struct stat st;
+      void* map = MAP_FAILED;
+      size_t size = 0;
+      if( ::fstat( fd, &st ) == 0 && size_t( st.st_size ) >= sizeof( EntryHeader ) ){
+	size = st.st_size;
+	map = ::mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+	// the entry has been used: it is the last to be evicted
+	::futimens( fd, nullptr );
+      }
+      ::close( fd );
+
+      bool ok = map != MAP_FAILED;
+      if( ok ){
+	// unmapped when the last Binary referring to the entry goes away
+	std::shared_ptr<const void> entry( map, [size]( const void* p ){ ::munmap( const_cast<void*>( p ), size ); } );
+	const char* p = static_cast<const char*>( map );
+	EntryHeader header;
+	::memcpy( &header, p, sizeof( header ) );
+	ok = ::memcmp( header.magic, cacheMagic, sizeof( cacheMagic ) ) == 0 &&
+	  sizeof( header ) + header.typeSize + header.dataSize + header.streamerInfoSize == size;
+	if( ok ){
+	  p += sizeof( header );
+	  std::string type( p, header.typeSize );
+	  p += header.typeSize;
+	  Binary data( std::shared_ptr<const void>( entry, p ), header.dataSize );
+	  p += header.dataSize;
+	  Binary streamerInfo( std::shared_ptr<const void>( entry, p ), header.streamerInfoSize );
+	  // the entry must hold the payload it is named after
+	  ok = makeHash( type, data ) == payloadHash;
+	  if( ok ){
+	    payloadType = type;
+	    payloadData = data;
+	    streamerInfoData = streamerInfo;
+	  }
+	}
+      }
+      if( ok ){
+	++m_hits;
+      } else {
+	++m_misses;
+	edm::LogWarning( "PayloadCache" ) << "Ignoring the invalid cache entry "<<fileName( payloadHash );
+      }
+      return ok;
+    }
+
+    void PayloadCache::store( const Hash& payloadHash,
+			      const std::string& payloadType,
+			      const Binary& payloadData,
+			      const Binary& streamerInfoData ) const {
+      std::string target = fileName( payloadHash );
+      // unique for each writer, be it another thread or another process
+      std::vector<char> tmpName( target.begin(), target.end() );
+      const std::string suffix( ".tmp.XXXXXX" );
+      tmpName.insert( tmpName.end(), suffix.begin(), suffix.end() );
+      tmpName.push_back( 0 );
+      int fd = ::mkstemp( tmpName.data() );
+      if( fd < 0 ){
+	edm::LogWarning( "PayloadCache" ) << "Cannot create "<<tmpName.data()<<": "<<std::strerror( errno );
+	return;
+      }
+      EntryHeader header;
+      ::memcpy( header.magic, cacheMagic, sizeof( cacheMagic ) );
+      header.typeSize = payloadType.size();
+      header.dataSize = payloadData.size();
+      header.streamerInfoSize = streamerInfoData.size();
+      // mkstemp makes the file readable only by its owner
+      bool ok = ::fchmod( fd, 0644 ) == 0 &&
+	writeAll( fd, &header, sizeof( header ) ) &&
+	writeAll( fd, payloadType.data(), payloadType.size() ) &&
+	writeAll( fd, payloadData.data(), payloadData.size() ) &&
+	writeAll( fd, streamerInfoData.data(), streamerInfoData.size() );
+      ok = ( ::close( fd ) == 0 ) && ok;
+      // several processes may store the same payload at the same time: the entries are identical
+      if( !ok || ::rename( tmpName.data(), target.c_str() ) != 0 ){
+	edm::LogWarning( "PayloadCache" ) << "Cannot store the payload "<<payloadHash<<" in "<<m_directory<<": "<<std::strerror( errno );
+	::unlink( tmpName.data() );
+	return;
+      }
+      if( m_maxSize ) evict( target );
+    }
+
+    void PayloadCache::evict( const std::string& keep ) const {
+      struct Entry {
+	std::string name;
+	size_t size;
+	struct timespec used;
+      };
+      std::vector<Entry> entries;
+      size_t total = 0;
+      DIR* dir = ::opendir( m_directory.c_str() );
+      if( !dir ) return;
+      const std::string extension( ".payload" );
+      while( struct dirent* d = ::readdir( dir ) ){
+	std::string name = m_directory+"/"+d->d_name;
+	struct stat st;
+	if( name.size() <= extension.size() || name.compare( name.size()-extension.size(), extension.size(), extension ) != 0 ||
+	    ::stat( name.c_str(), &st ) != 0 ) continue;
+	entries.push_back( { name, size_t( st.st_size ), st.st_mtim } );
+	total += st.st_size;
+      }
+      ::closedir( dir );
+      if( total <= m_maxSize ) return;
+
+      std::sort( entries.begin(), entries.end(), []( const Entry& a, const Entry& b ){
+	  return a.used.tv_sec != b.used.tv_sec ? a.used.tv_sec < b.used.tv_sec : a.used.tv_nsec < b.used.tv_nsec;
+	} );
+      // the processes which have mapped an entry keep it until they unmap it;
+      // another process may have removed it already
+      for( const auto& entry : entries ){
+	if( total <= m_maxSize ) break;
+	if( entry.name == keep ) continue;
+	::unlink( entry.name.c_str() );
+	total -= entry.size;
+      }
+    }
+
+  }
+}
@@ -2,6 +2,7 @@
 #define CondCore_CondDB_SessionImpl_h
 
 #include "CondCore/CondDB/interface/Types.h"
+#include "CondCore/CondDB/interface/PayloadCache.h"
 #include "IOVSchema.h"
 #include "GTSchema.h"
 #include "RunInfoSchema.h"
@@ -70,6 +71,8 @@ namespace cond {
       std::unique_ptr<IIOVSchema> iovSchemaHandle; 
       std::unique_ptr<IGTSchema> gtSchemaHandle; 
       std::unique_ptr<IRunInfoSchema> runInfoSchemaHandle; 
+      // node-local cache of the fetched payloads, shared by the sessions of a ConnectionPool (if enabled)
+      std::shared_ptr<PayloadCache> payloadCache;
     };
 
   }
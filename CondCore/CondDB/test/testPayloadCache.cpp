@@ -0,0 +1,131 @@
+#include "FWCore/PluginManager/interface/PluginManager.h"
+#include "FWCore/PluginManager/interface/standard.h"
+//
+#include "CondCore/CondDB/interface/ConnectionPool.h"
+#include "CondCore/CondDB/interface/PayloadCache.h"
+//
+#include "MyTestData.h"
+//
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace cond::persistency;
+
+int main (int argc, char** argv)
+{
+  edmplugin::PluginManager::Config config;
+  edmplugin::PluginManager::configure(edmplugin::standard::config());
+
+  std::string connectionString("sqlite_file:cms_conditions_cache.db");
+  std::string cacheDir("payloadCache");
+  std::cout <<"# Connecting with db in "<<connectionString<<", payload cache in "<<cacheDir<<std::endl;
+  int ret = 0;
+  try{
+
+    ConnectionPool connPool;
+    connPool.setPayloadCachePath( cacheDir );
+    Session session = connPool.createSession( connectionString, true );
+    session.transaction().start( false );
+    MyTestData d0( 17 );
+    cond::Hash p0 = session.storePayload( d0, boost::posix_time::microsec_clock::universal_time() );
+    session.transaction().commit();
+    std::string entry = cacheDir+"/"+p0+".payload";
+    ::remove( entry.c_str() );
+
+    // the first fetch goes to the database and fills the cache
+    session.transaction().start( true );
+    std::shared_ptr<MyTestData> r0 = session.fetchPayload<MyTestData>( p0 );
+    session.transaction().commit();
+    if( *r0 != d0 ){
+      std::cout <<"ERROR: MyTestData object read from the database different from source."<<std::endl;
+      ret = 1;
+    }
+    if( !std::ifstream( entry ) ){
+      std::cout <<"ERROR: the payload has not been stored in the cache."<<std::endl;
+      ret = 1;
+    }
+
+    // the cache entry alone gives back the payload
+    PayloadCache cache( cacheDir );
+    std::string payloadType;
+    cond::Binary payloadData, streamerInfoData;
+    if( !cache.fetch( p0, payloadType, payloadData, streamerInfoData ) || cache.hits() != 1 ){
+      std::cout <<"ERROR: the payload has not been found in the cache."<<std::endl;
+      ret = 1;
+    } else {
+      // the data refer to the mapped entry, which stays valid once the file is removed
+      ::remove( entry.c_str() );
+      if( *cond::deserialize<MyTestData>( payloadType, payloadData, streamerInfoData ) != d0 ){
+	std::cout <<"ERROR: MyTestData object read from the cache different from source."<<std::endl;
+	ret = 1;
+      }
+      cache.store( p0, payloadType, payloadData, streamerInfoData );
+    }
+
+    // a second session of the pool reads it from the cache
+    Session session2 = connPool.createSession( connectionString );
+    session2.transaction().start( true );
+    std::shared_ptr<MyTestData> r1 = session2.fetchPayload<MyTestData>( p0 );
+    session2.transaction().commit();
+    if( *r1 != d0 ){
+      std::cout <<"ERROR: MyTestData object read through the cache different from source."<<std::endl;
+      ret = 1;
+    }
+
+    // and so does a session on a database without the payload
+    std::string emptyDb( "cms_conditions_cache_empty.db" );
+    ::remove( emptyDb.c_str() );
+    Session session3 = connPool.createSession( "sqlite_file:"+emptyDb, true );
+    session3.transaction().start( true );
+    std::shared_ptr<MyTestData> r3 = session3.fetchPayload<MyTestData>( p0 );
+    session3.transaction().commit();
+    if( *r3 != d0 ){
+      std::cout <<"ERROR: MyTestData object read from the cache only different from source."<<std::endl;
+      ret = 1;
+    }
+
+    // a complete entry not holding the payload it is named after is ignored
+    const char other[] = "not the payload";
+    cache.store( p0, payloadType, cond::Binary( other, sizeof( other ) ), streamerInfoData );
+    if( cache.fetch( p0, payloadType, payloadData, streamerInfoData ) ){
+      std::cout <<"ERROR: a cache entry with a wrong payload hash has been accepted."<<std::endl;
+      ret = 1;
+    }
+
+    // a truncated entry is ignored, and the payload is read from the database again
+    std::ofstream( entry, std::ios::trunc ) << "CONDPLC1";
+    if( cache.fetch( p0, payloadType, payloadData, streamerInfoData ) ){
+      std::cout <<"ERROR: a truncated cache entry has been accepted."<<std::endl;
+      ret = 1;
+    }
+    session2.transaction().start( true );
+    std::shared_ptr<MyTestData> r2 = session2.fetchPayload<MyTestData>( p0 );
+    session2.transaction().commit();
+    if( *r2 != d0 ){
+      std::cout <<"ERROR: MyTestData object read after a truncated cache entry different from source."<<std::endl;
+      ret = 1;
+    }
+
+    // beyond the maximum size, the least recently used entries are removed
+    std::string smallDir( "payloadCacheSmall" );
+    PayloadCache small( smallDir, 1500 );
+    const std::string blob( 1000, 'x' );
+    small.store( "first", "blob", cond::Binary( blob.data(), blob.size() ), cond::Binary() );
+    small.store( "second", "blob", cond::Binary( blob.data(), blob.size() ), cond::Binary() );
+    if( std::ifstream( smallDir+"/first.payload" ) || !std::ifstream( smallDir+"/second.payload" ) ){
+      std::cout <<"ERROR: the oldest entry has not been evicted from the full cache."<<std::endl;
+      ret = 1;
+    }
+    ::remove( ( smallDir+"/second.payload" ).c_str() );
+  } catch (const std::exception& e){
+    std::cout << "ERROR: " << e.what() << std::endl;
+    return -1;
+  } catch (...){
+    std::cout << "UNEXPECTED FAILURE." << std::endl;
+    return -1;
+  }
+  std::cout <<"## Run "<<( ret == 0 ? "successfully completed." : "FAILED." )<<std::endl;
+  return ret;
+}
@@ -118,6 +118,10 @@ CondDBESSource::CondDBESSource( const edm::ParameterSet& iConfig ) :
     m_policy = RECONNECT_EACH_RUN;
   }
 
+  // the payloads are read from the database without using other EventSetup data, so
+  // when EventSetup data is prefetched they need not wait for other modules' data
+  mayUseOwnMutex();
+
   Stats s = {0,0,0,0,0,0,0,0};
   m_stats = s;	
 
@@ -37,12 +37,17 @@
        
        double GetResponse(const float* vector) const;
        double GetGradBoostClassifier(const float* vector) const;
+       
+       //responses to nvectors input vectors, stored stride floats apart, identical to
+       //calling GetResponse for each of them
+       void GetResponses(const float* vectors, unsigned int nvectors, unsigned int stride, double* responses) const;
        double GetAdaBoostClassifier(const float* vector) const { return GetResponse(vector); }
        
        //for backwards-compatibility
        double GetClassifier(const float* vector) const { return GetGradBoostClassifier(vector); }
        
        void SetInitialResponse(double response) { fInitialResponse = response; }
+       double InitialResponse() const { return fInitialResponse; }
        
        std::vector<GBRTree> &Trees() { return fTrees; }
        const std::vector<GBRTree> &Trees() const { return fTrees; }
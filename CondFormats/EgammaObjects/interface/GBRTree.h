@@ -43,6 +43,8 @@
        
        double GetResponse(const float* vector) const;
        int TerminalIndex(const float *vector) const;
+       //terminal indices of nvectors input vectors, stored stride floats apart
+       void TerminalIndices(const float *vectors, unsigned int nvectors, unsigned int stride, int *indices) const;
        
        std::vector<float> &Responses() { return fResponses; }       
        const std::vector<float> &Responses() const { return fResponses; }
@@ -3,6 +3,14 @@
 #include "TMVA/DecisionTree.h"
 #include "TMVA/MethodBDT.h"
 
+#include <algorithm>
+
+namespace {
+  //number of input vectors which go through the trees together: their inputs
+  //and terminal indices should stay in the L1 cache
+  constexpr unsigned int kBatchSize = 64;
+}
+
 
 
 //_______________________________________________________________________
@@ -53,6 +61,22 @@ GBRForest::GBRForest(const TMVA::MethodBDT *bdt)
   
 }
 
-
-
-
+//_______________________________________________________________________
+void GBRForest::GetResponses(const float* vectors, unsigned int nvectors, unsigned int stride, double* responses) const {
+  
+  //the responses of the trees are added in the same order as in GetResponse,
+  //so that the results are bit-identical
+  std::fill(responses, responses+nvectors, fInitialResponse);
+  
+  int indices[kBatchSize];
+  for (unsigned int first=0; first<nvectors; first+=kBatchSize) {
+    unsigned int n = std::min(kBatchSize, nvectors-first);
+    for (std::vector<GBRTree>::const_iterator it=fTrees.begin(); it!=fTrees.end(); ++it) {
+      it->TerminalIndices(vectors + first*stride, n, stride, indices);
+      const std::vector<float> &treeResponses = it->Responses();
+      for (unsigned int i=0; i<n; ++i) {
+        responses[first+i] += treeResponses[indices[i]];
+      }
+    }
+  }
+}
@@ -137,3 +137,37 @@ void GBRTree::AddNode(const TMVA::DecisionTreeNode *node, double scale, bool isr
   }
   
 }
+
+//_______________________________________________________________________
+void GBRTree::TerminalIndices(const float *vectors, unsigned int nvectors, unsigned int stride, int *indices) const {
+  
+  //all the vectors go down the tree together, one level at a time, and the ones
+  //which already reached a terminal node keep their index: the inner loop has no
+  //data-dependent branch, and can be vectorized by the compiler
+  const unsigned char *cutIndices = fCutIndices.data();
+  const float *cutVals = fCutVals.data();
+  const int *leftIndices = fLeftIndices.data();
+  const int *rightIndices = fRightIndices.data();
+  
+  //the root node is always an intermediate node
+  for (unsigned int i=0; i<nvectors; ++i) {
+    indices[i] = vectors[i*stride + cutIndices[0]] > cutVals[0] ? rightIndices[0] : leftIndices[0];
+  }
+  
+  bool active = true;
+  while (active) {
+    active = false;
+    for (unsigned int i=0; i<nvectors; ++i) {
+      int index = indices[i];
+      int node = index>0 ? index : 0;
+      int next = vectors[i*stride + cutIndices[node]] > cutVals[node] ? rightIndices[node] : leftIndices[node];
+      index = index>0 ? next : index;
+      indices[i] = index;
+      active |= index>0;
+    }
+  }
+  
+  for (unsigned int i=0; i<nvectors; ++i) {
+    indices[i] = -indices[i];
+  }
+}
@@ -0,0 +1,35 @@
+#ifndef CondFormats_EgammaObjects_test_RandomGBRTree_h
+#define CondFormats_EgammaObjects_test_RandomGBRTree_h
+
+#include "CondFormats/EgammaObjects/interface/GBRTree.h"
+
+#include <random>
+
+// Random trees for the tests of GBRForest and of the code generated from it.
+
+namespace gbrtest {
+
+  // adds a random tree of the given depth, with nodes stored as by GBRTree
+  inline void addNode(GBRTree &tree, int depth, unsigned int nvars, std::mt19937 &rng) {
+    std::uniform_real_distribution<float> value(-1.f, 1.f);
+    int node = tree.CutIndices().size();
+    tree.CutIndices().push_back(rng() % nvars);
+    tree.CutVals().push_back(value(rng));
+    tree.LeftIndices().push_back(0);
+    tree.RightIndices().push_back(0);
+    for (int side = 0; side < 2; ++side) {
+      int child;
+      if (depth > 1 && rng() % 4 != 0) {
+        child = tree.CutIndices().size();
+        addNode(tree, depth - 1, nvars, rng);
+      } else {
+        child = -int(tree.Responses().size());
+        tree.Responses().push_back(value(rng));
+      }
+      (side == 0 ? tree.LeftIndices() : tree.RightIndices())[node] = child;
+    }
+  }
+
+}
+
+#endif
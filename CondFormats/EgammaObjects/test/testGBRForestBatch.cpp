@@ -0,0 +1,50 @@
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CondFormats/EgammaObjects/test/RandomGBRTree.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Checks that GBRForest::GetResponses gives bit-identical results to
+// GetResponse, on random forests and inputs.
+
+int main()
+{
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<float> input(-1.2f, 1.2f);
+  const unsigned int nvars = 7;
+  const unsigned int stride = 9;
+
+  for (unsigned int ntrees : {1u, 3u, 200u}) {
+    GBRForest forest;
+    forest.SetInitialResponse(0.3);
+    for (unsigned int itree = 0; itree < ntrees; ++itree) {
+      GBRTree tree;
+      gbrtest::addNode(tree, 1 + itree % 6, nvars, rng);
+      forest.Trees().push_back(tree);
+    }
+
+    for (unsigned int nvectors : {0u, 1u, 63u, 64u, 65u, 1000u}) {
+      std::vector<float> vectors(nvectors * stride);
+      for (auto &v : vectors) v = input(rng);
+      // values on the cuts, to check the boundaries
+      for (unsigned int i = 0; i < nvectors; i += 5)
+        vectors[i * stride] = forest.Trees()[0].CutVals()[0];
+
+      std::vector<double> responses(nvectors);
+      forest.GetResponses(vectors.data(), nvectors, stride, responses.data());
+      for (unsigned int i = 0; i < nvectors; ++i) {
+        double expected = forest.GetResponse(vectors.data() + i * stride);
+        if (std::memcmp(&expected, &responses[i], sizeof(double)) != 0) {
+          std::cerr << "GetResponses differs from GetResponse for " << ntrees << " trees, vector " << i << " of "
+                    << nvectors << ": " << responses[i] << " instead of " << expected << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+#ifndef DQMServices_Core_ConcurrentFillBuffer_h
+#define DQMServices_Core_ConcurrentFillBuffer_h
+
+/* Per-thread copies of the histogram of a ConcurrentMonitorElement.
+ *
+ * Each thread that fills the MonitorElement fills a private copy of its
+ * histogram, without taking any lock: the only lock is taken the first time
+ * a thread fills the MonitorElement, to make its copy.  The memory used is
+ * therefore one copy of the histogram per filling thread.
+ *
+ * The copies are added to the MonitorElement by merge(), which the DQMStore
+ * calls at the end of each luminosity block and of the run, and before the
+ * MonitorElements are saved or published.  merge() may run while other
+ * threads keep filling: each thread marks when it is filling its copy, and
+ * merge() swaps the copy for an empty one and waits for the fill in progress,
+ * if any, before adding it.  Since the copies are summed with TH1::Add, the
+ * bin contents, the number of entries and the statistics are the same as
+ * when filling the histogram directly, up to the order of the floating point
+ * additions.
+ *
+ * Only 1D and 2D histograms (TH1F/S/D, TH2F/S/D) whose axes cannot be
+ * extended are supported; for all other kinds supports() returns false and
+ * the ConcurrentMonitorElement keeps filling under its spin lock.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/spin_mutex.h>
+
+class MonitorElement;
+class TH1;
+
+class ConcurrentFillBuffer
+{
+public:
+  // true for the argument types that the buffer can accumulate
+  template <typename... Args>
+  struct accepts : std::false_type { };
+
+  template <typename X>
+  struct accepts<X> : std::is_arithmetic<X> { };
+
+  template <typename X, typename Y>
+  struct accepts<X, Y> :
+    std::integral_constant<bool, std::is_arithmetic<X>::value and std::is_arithmetic<Y>::value> { };
+
+  template <typename X, typename Y, typename Z>
+  struct accepts<X, Y, Z> :
+    std::integral_constant<bool, std::is_arithmetic<X>::value and std::is_arithmetic<Y>::value and std::is_arithmetic<Z>::value> { };
+
+  // whether the MonitorElement can be filled through a ConcurrentFillBuffer
+  static bool supports(MonitorElement const* me);
+
+  ConcurrentFillBuffer(MonitorElement* me, uint32_t run);
+  ~ConcurrentFillBuffer();
+
+  ConcurrentFillBuffer(ConcurrentFillBuffer const&) = delete;
+  ConcurrentFillBuffer& operator=(ConcurrentFillBuffer const&) = delete;
+
+  // fill the copy of the calling thread;
+  // return false if the signature does not match the kind of histogram,
+  // in which case the caller should fall back to MonitorElement::Fill
+  bool fill(double x) const;
+  bool fill(double x, double yw) const;
+  bool fill(double x, double y, double zw) const;
+
+  // add the copies of all threads to the MonitorElement, and empty them
+  void merge();
+
+  // lock to be held by anybody else modifying the MonitorElement
+  tbb::spin_mutex& histogramMutex() const { return histogramMutex_; }
+
+  uint32_t run() const { return run_; }
+
+private:
+  struct Copy {
+    std::atomic<TH1*> histogram{nullptr};  // filled by the owning thread
+    std::atomic<bool> filling{false};      // set while the owning thread fills histogram
+    std::unique_ptr<TH1> spare;            // only used by merge()
+  };
+
+  Copy& local() const;
+  // to be called with histogramMutex_ held
+  TH1* emptyCopy() const;
+
+  MonitorElement* me_;
+  uint32_t run_;
+  bool is2D_;
+  mutable tbb::spin_mutex histogramMutex_;   // guards me_ and copies_
+  mutable std::vector<std::unique_ptr<Copy>> copies_;
+  mutable tbb::enumerable_thread_specific<Copy*> localCopy_;
+};
+
+#endif // DQMServices_Core_ConcurrentFillBuffer_h
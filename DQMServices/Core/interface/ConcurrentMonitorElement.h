@@ -6,9 +6,12 @@
  * ...
  */
 
+#include <memory>
 #include <mutex>
+#include <type_traits>
 #include <tbb/spin_mutex.h>
 
+#include "DQMServices/Core/interface/ConcurrentFillBuffer.h"
 #include "DQMServices/Core/interface/MonitorElement.h"
 
 class ConcurrentMonitorElement
@@ -16,6 +19,30 @@ class ConcurrentMonitorElement
 private:
   mutable MonitorElement* me_;
   mutable tbb::spin_mutex lock_;
+  // if set, each thread fills its own copy of the histogram without taking
+  // lock_, and the histogram is modified only under the lock of the buffer
+  std::shared_ptr<ConcurrentFillBuffer> buffer_;
+
+  // lock guarding the contents of the histogram
+  tbb::spin_mutex& histogramLock() const
+  {
+    return buffer_ ? buffer_->histogramMutex() : lock_;
+  }
+
+  template <typename... Args>
+  void doFill(std::true_type, Args && ... args) const
+  {
+    if (buffer_ and buffer_->fill(static_cast<double>(args)...))
+      return;
+    doFill(std::false_type(), std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  void doFill(std::false_type, Args && ... args) const
+  {
+    std::lock_guard<tbb::spin_mutex> guard(histogramLock());
+    me_->Fill(std::forward<Args>(args)...);
+  }
 
 public:
   ConcurrentMonitorElement(void) :
@@ -26,6 +53,11 @@ public:
     me_(me)
   { }
 
+  ConcurrentMonitorElement(MonitorElement* me, std::shared_ptr<ConcurrentFillBuffer> buffer) :
+    me_(me),
+    buffer_(std::move(buffer))
+  { }
+
   // non-copiable
   ConcurrentMonitorElement(ConcurrentMonitorElement const&) = delete;
 
@@ -35,6 +67,7 @@ public:
     std::lock_guard<tbb::spin_mutex> guard(other.lock_);
     me_ = other.me_;
     other.me_ = nullptr;
+    buffer_ = std::move(other.buffer_);
   }
 
   // not copy-assignable
@@ -49,6 +82,7 @@ public:
     std::lock_guard<tbb::spin_mutex> others(other.lock_, std::adopt_lock);
     me_ = other.me_;
     other.me_ = nullptr;
+    buffer_ = std::move(other.buffer_);
     return *this;
   }
 
@@ -59,14 +93,16 @@ public:
   template <typename... Args>
   void fill(Args && ... args) const
   {
-    std::lock_guard<tbb::spin_mutex> guard(lock_);
-    me_->Fill(std::forward<Args>(args)...);
+    doFill(ConcurrentFillBuffer::accepts<typename std::decay<Args>::type...>(), std::forward<Args>(args)...);
   }
 
   // expose as a const method to mean that it is concurrent-safe
   void shiftFillLast(double y, double ye = 0., int32_t xscale = 1) const
   {
-    std::lock_guard<tbb::spin_mutex> guard(lock_);
+    // the last bin is found from the contents, so the copies are added first
+    if (buffer_)
+      buffer_->merge();
+    std::lock_guard<tbb::spin_mutex> guard(histogramLock());
     me_->ShiftFillLast(y, ye, xscale);
   }
 
@@ -75,6 +111,7 @@ public:
   {
     std::lock_guard<tbb::spin_mutex> guard(lock_);
     me_ = nullptr;
+    buffer_.reset();
   }
 
   operator bool() const
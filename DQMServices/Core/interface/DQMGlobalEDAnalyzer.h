@@ -42,14 +42,16 @@ DQMGlobalEDAnalyzer<H>::globalBeginRun(edm::Run const& run, edm::EventSetup cons
       b.cd();
       bookHistograms(b, run, setup, *h);
     },
-    run.run() );
+    run.run(), true );
   return h;
 }
 
 template <typename H>
 void
-DQMGlobalEDAnalyzer<H>::globalEndRun(edm::Run const&, edm::EventSetup const&) const
+DQMGlobalEDAnalyzer<H>::globalEndRun(edm::Run const& run, edm::EventSetup const&) const
 {
+  // fold the per-thread fills of this run's ConcurrentMonitorElements into the histograms
+  edm::Service<DQMStore>()->mergeConcurrentFills(run.run());
 }
 
 template <typename H>
@@ -132,6 +132,7 @@ public:
       assert(store);
     }
 
+  protected:
     // Embedded classes do not natively own a pointer to the embedding
     // class. We therefore need to store a pointer to the main
     // DQMStore instance (owner_).
@@ -147,7 +148,9 @@ public:
     ConcurrentMonitorElement book##suffix(Args&&... args)               \
     {                                                                   \
       MonitorElement* me = IBooker::book##suffix(std::forward<Args>(args)...); \
-      return ConcurrentMonitorElement(me);                              \
+      if (not bufferFills_)                                             \
+        return ConcurrentMonitorElement(me);                            \
+      return ConcurrentMonitorElement(me, owner_->makeConcurrentFillBuffer(me, run_)); \
     }
 
     // For the supported interface, see the DQMStore function that
@@ -176,11 +179,18 @@ public:
     ConcurrentBooker& operator=(ConcurrentBooker &&) = delete;
 
   private:
-    explicit ConcurrentBooker(DQMStore* store) noexcept :
-      IBooker{store}
+    ConcurrentBooker(DQMStore* store, uint32_t run, bool bufferFills) noexcept :
+      IBooker{store},
+      run_{run},
+      bufferFills_{bufferFills}
     {}
 
     ~ConcurrentBooker() = default;
+
+    // run the booked MonitorElements belong to, used to merge their fill buffers
+    uint32_t run_;
+    // whether the caller will merge the fill buffers via mergeConcurrentFills
+    bool bufferFills_;
   };
 
   class IGetter {
@@ -259,16 +269,19 @@ public:
   }
 
   // Similar function used to book "global" histograms via the
-  // ConcurrentMonitorElement interface.
+  // ConcurrentMonitorElement interface. If bufferFills is set, and
+  // lock-free filling is enabled, the histograms are filled through
+  // per-thread copies, and the caller must call mergeConcurrentFills
+  // at the end of the run.
   template <typename iFunc>
-  void bookConcurrentTransaction(iFunc f, uint32_t run)
+  void bookConcurrentTransaction(iFunc f, uint32_t run, bool bufferFills = false)
   {
     std::lock_guard<std::mutex> guard(book_mutex_);
     /* Set the run_ member only if enableMultiThread is enabled */
     if (enableMultiThread_) {
       run_ = run;
     }
-    ConcurrentBooker booker(this);
+    ConcurrentBooker booker(this, run, bufferFills);
     f(booker);
 
     /* Reset the run_ member only if enableMultiThread is enabled */
@@ -474,6 +487,13 @@ public:
             bool fileMustExist = true);
   bool mtEnabled() { return enableMultiThread_; };
 
+  // Merge the per-thread fill buffers of the ConcurrentMonitorElements
+  // booked for the given run into their MonitorElements; if release is
+  // set, the buffers are dropped and no more fills are expected.
+  void mergeConcurrentFills(uint32_t run, bool release = true);
+  // Merge the per-thread fill buffers of all runs, keeping them.
+  void mergeConcurrentFills();
+
 
 public:
   // -------------------------------------------------------------------------
@@ -497,6 +517,12 @@ private:
   // ---------------- Navigation -----------------------
   bool cdInto(std::string const& path) const;
 
+  // ------------------- Concurrent fills ------------------------------
+  // called by the ConcurrentBooker while holding book_mutex_
+  std::shared_ptr<ConcurrentFillBuffer> makeConcurrentFillBuffer(MonitorElement* me, uint32_t run);
+  // to be called with book_mutex_ held
+  void mergeAllConcurrentFills();
+
   // ------------------- Reference ME -------------------------------
   bool isCollateME(MonitorElement* me) const;
 
@@ -553,6 +579,7 @@ private:
   void reset();
   void forceReset();
   void postGlobalBeginLumi(const edm::GlobalContext&);
+  void preGlobalEndLumi(const edm::GlobalContext&);
 
   bool extract(TObject* obj, std::string const& dir, bool overwrite, bool collateHistograms);
   TObject* extractNextObject(TBufferFile&) const;
@@ -635,6 +662,7 @@ private:
   bool enableMultiThread_{false};
   bool LSbasedMode_;
   bool forceResetOnBeginLumi_{false};
+  bool lockFreeConcurrentFill_{false};
   std::string readSelectedDirectory_{};
   uint32_t run_{};
   uint32_t moduleId_{};
@@ -648,6 +676,8 @@ private:
   QAMap qalgos_;
   QTestSpecs qtestspecs_;
 
+  std::vector<std::shared_ptr<ConcurrentFillBuffer>> concurrentFillBuffers_;
+
   std::mutex book_mutex_;
 
   friend class edm::DQMHttpSource;
@@ -10,5 +10,9 @@ DQMStore = cms.Service("DQMStore",
     #MEs are flagged to be LS based.
     LSbasedMode = cms.untracked.bool(False),
     #this is bound to the enableMultiThread flag.
-    forceResetOnBeginLumi = cms.untracked.bool(False)
+    forceResetOnBeginLumi = cms.untracked.bool(False),
+    #fill per-thread copies of the 1D and 2D ConcurrentMonitorElements without
+    #locking, and add them to the histograms at the end of each lumi and of
+    #the run, and before saving; uses one copy of each histogram per thread
+    lockFreeConcurrentFill = cms.untracked.bool(False)
 )
@@ -0,0 +1,128 @@
+#include "DQMServices/Core/interface/ConcurrentFillBuffer.h"
+#include "DQMServices/Core/interface/MonitorElement.h"
+
+#include <mutex>
+#include <thread>
+
+#include "TH1.h"
+#include "TH2.h"
+
+bool
+ConcurrentFillBuffer::supports(MonitorElement const* me)
+{
+  if (me == nullptr)
+    return false;
+
+  switch (me->kind()) {
+  case MonitorElement::DQM_KIND_TH1F:
+  case MonitorElement::DQM_KIND_TH1S:
+  case MonitorElement::DQM_KIND_TH1D:
+  case MonitorElement::DQM_KIND_TH2F:
+  case MonitorElement::DQM_KIND_TH2S:
+  case MonitorElement::DQM_KIND_TH2D:
+    // copies extended differently could not be added together
+    return not (me->getTH1()->GetXaxis()->CanExtend() or me->getTH1()->GetYaxis()->CanExtend());
+  default:
+    return false;
+  }
+}
+
+ConcurrentFillBuffer::ConcurrentFillBuffer(MonitorElement* me, uint32_t run) :
+  me_(me),
+  run_(run),
+  is2D_(me->kind() == MonitorElement::DQM_KIND_TH2F
+        or me->kind() == MonitorElement::DQM_KIND_TH2S
+        or me->kind() == MonitorElement::DQM_KIND_TH2D),
+  localCopy_(nullptr)
+{ }
+
+ConcurrentFillBuffer::~ConcurrentFillBuffer()
+{
+  for (auto& copy : copies_)
+    delete copy->histogram.load();
+}
+
+TH1*
+ConcurrentFillBuffer::emptyCopy() const
+{
+  TH1* histogram = static_cast<TH1*>(me_->getTH1()->Clone());
+  histogram->SetDirectory(nullptr);
+  histogram->Reset();
+  return histogram;
+}
+
+ConcurrentFillBuffer::Copy&
+ConcurrentFillBuffer::local() const
+{
+  Copy*& copy = localCopy_.local();
+  if (copy == nullptr) {
+    // the copies are owned by the buffer, so that merge() can reach them
+    std::lock_guard<tbb::spin_mutex> guard(histogramMutex_);
+    copies_.push_back(std::make_unique<Copy>());
+    copies_.back()->histogram = emptyCopy();
+    copy = copies_.back().get();
+  }
+  return *copy;
+}
+
+bool
+ConcurrentFillBuffer::fill(double x) const
+{
+  if (is2D_)
+    return false;
+  Copy& copy = local();
+  // both operations are sequentially consistent, see merge()
+  copy.filling.store(true);
+  copy.histogram.load()->Fill(x);
+  copy.filling.store(false, std::memory_order_release);
+  return true;
+}
+
+/// (x, w) for 1D and (x, y) for 2D histograms, as in MonitorElement::Fill
+bool
+ConcurrentFillBuffer::fill(double x, double yw) const
+{
+  Copy& copy = local();
+  copy.filling.store(true);
+  TH1* histogram = copy.histogram.load();
+  if (is2D_)
+    static_cast<TH2*>(histogram)->Fill(x, yw, 1.);
+  else
+    histogram->Fill(x, yw);
+  copy.filling.store(false, std::memory_order_release);
+  return true;
+}
+
+bool
+ConcurrentFillBuffer::fill(double x, double y, double zw) const
+{
+  if (not is2D_)
+    return false;
+  Copy& copy = local();
+  copy.filling.store(true);
+  static_cast<TH2*>(copy.histogram.load())->Fill(x, y, zw);
+  copy.filling.store(false, std::memory_order_release);
+  return true;
+}
+
+void
+ConcurrentFillBuffer::merge()
+{
+  std::lock_guard<tbb::spin_mutex> guard(histogramMutex_);
+  for (auto& copy : copies_) {
+    if (not copy->spare)
+      copy->spare.reset(emptyCopy());
+    // The owning thread sets 'filling' before reading 'histogram', and here
+    // 'histogram' is swapped before reading 'filling': either the thread sees
+    // the empty copy, or the fill in progress on the full one is waited for.
+    std::unique_ptr<TH1> full(copy->histogram.exchange(copy->spare.release()));
+    while (copy->filling.load())
+      std::this_thread::yield();
+    if (full->GetEntries() != 0.) {
+      me_->getTH1()->Add(full.get());
+      me_->update();
+      full->Reset();
+    }
+    copy->spare = std::move(full);
+  }
+}
@@ -90,6 +90,9 @@ void DQMService::flushStandalone()
   // OK, send an update.
   if (net_)
   {
+    // Add the fills done through per-thread copies.
+    store_->mergeConcurrentFills();
+
     DQMNet::Object o;
     std::set<std::string> seen;
     std::string fullpath;
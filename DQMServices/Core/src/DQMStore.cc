@@ -19,6 +19,7 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/range/iterator_range_core.hpp>
 
+#include <algorithm>
 #include <iterator>
 #include <cerrno>
 #include <exception>
@@ -380,6 +381,8 @@ DQMStore::DQMStore(edm::ParameterSet const& pset, edm::ActivityRegistry& ar)
     ar.watchPostSourceLumi([this](edm::LuminosityBlockIndex){ forceReset(); });
   }
   ar.watchPostGlobalBeginLumi(this, &DQMStore::postGlobalBeginLumi);
+  if (lockFreeConcurrentFill_)
+    ar.watchPreGlobalEndLumi(this, &DQMStore::preGlobalEndLumi);
 }
 
 DQMStore::DQMStore(edm::ParameterSet const& pset)
@@ -423,6 +426,10 @@ DQMStore::initializeFrom(edm::ParameterSet const& pset)
   if (LSbasedMode_)
     std::cout << "DQMStore: LSbasedMode option is enabled\n";
 
+  lockFreeConcurrentFill_ = pset.getUntrackedParameter<bool>("lockFreeConcurrentFill", false);
+  if (lockFreeConcurrentFill_)
+    std::cout << "DQMStore: lock-free filling of concurrent MonitorElements is enabled\n";
+
   std::string ref = pset.getUntrackedParameter<std::string>("referenceFileName", "");
   if (! ref.empty()) {
     std::cout << "DQMStore: using reference file '" << ref << "'\n";
@@ -2016,6 +2023,69 @@ DQMStore::deleteUnusedLumiHistograms(uint32_t const run, uint32_t const lumi)
   }
 }
 
+/** Create the per-thread fill buffer for a MonitorElement booked through
+ * the ConcurrentBooker, if lock-free filling is enabled and supported for
+ * its kind; otherwise return a null pointer, and the ConcurrentMonitorElement
+ * will fill the MonitorElement under its own lock.
+ */
+std::shared_ptr<ConcurrentFillBuffer>
+DQMStore::makeConcurrentFillBuffer(MonitorElement* me, uint32_t const run)
+{
+  if (not lockFreeConcurrentFill_ or not ConcurrentFillBuffer::supports(me))
+    return nullptr;
+
+  auto buffer = std::make_shared<ConcurrentFillBuffer>(me, run);
+  concurrentFillBuffers_.push_back(buffer);
+  return buffer;
+}
+
+/** Merge the fills still pending in the buffers of the ConcurrentMonitorElements
+ * of the given run into the underlying MonitorElements. Other threads may keep
+ * filling meanwhile. With release set, which must be done only once no more
+ * events of that run are being processed (e.g. at globalEndRun), the buffers
+ * are also dropped.
+ */
+void
+DQMStore::mergeConcurrentFills(uint32_t const run, bool const release)
+{
+  std::lock_guard<std::mutex> guard(book_mutex_);
+
+  auto merged = std::remove_if(concurrentFillBuffers_.begin(), concurrentFillBuffers_.end(),
+                               [run, release](std::shared_ptr<ConcurrentFillBuffer> const& buffer) {
+                                 if (buffer->run() != run)
+                                   return false;
+                                 buffer->merge();
+                                 return release;
+                               });
+  concurrentFillBuffers_.erase(merged, concurrentFillBuffers_.end());
+}
+
+/** Merge the fills still pending in the buffers of all the ConcurrentMonitorElements,
+ * e.g. before their MonitorElements are published. The buffers are kept.
+ */
+void
+DQMStore::mergeConcurrentFills()
+{
+  std::lock_guard<std::mutex> guard(book_mutex_);
+  mergeAllConcurrentFills();
+}
+
+void
+DQMStore::mergeAllConcurrentFills()
+{
+  for (auto const& buffer : concurrentFillBuffers_)
+    buffer->merge();
+}
+
+/** Called before all globalEndLuminosityBlock, so that the MonitorElements
+ * are up to date for whatever reads or saves them at the end of the lumi.
+ */
+void
+DQMStore::preGlobalEndLumi(edm::GlobalContext const& gc)
+{
+  mergeConcurrentFills(gc.luminosityBlockID().run(), false);
+}
+
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
@@ -2462,6 +2532,7 @@ DQMStore::save(std::string const& filename,
   };
 
   std::lock_guard<std::mutex> guard(book_mutex_);
+  mergeAllConcurrentFills();
 
   unsigned int nme = 0;
 
@@ -2635,6 +2706,7 @@ DQMStore::savePB(std::string const& filename,
   using google::protobuf::io::StringOutputStream;
 
   std::lock_guard<std::mutex> guard(book_mutex_);
+  mergeAllConcurrentFills();
 
   unsigned int nme = 0;
 
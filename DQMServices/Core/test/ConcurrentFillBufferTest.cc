@@ -0,0 +1,122 @@
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TH1D.h"
+#include "TH2F.h"
+#include "TROOT.h"
+
+#include "DQMServices/Core/interface/ConcurrentFillBuffer.h"
+#include "DQMServices/Core/interface/MonitorElement.h"
+
+/*
+ * Test case for the per-thread copies of ConcurrentFillBuffer: the same fills
+ * are done from several threads through the buffer, merging while the threads
+ * fill, and directly into a reference histogram; the integer weights make the
+ * sums exact, so the entries, the sums of weights and the bin contents must be
+ * identical.
+ */
+
+namespace {
+  struct Fill {
+    double x;
+    double y;
+    double w;
+  };
+
+  std::vector<Fill> makeFills(unsigned int n, unsigned int seed)
+  {
+    std::mt19937 rng(seed);
+    // including values out of the axis range, for the under- and overflows
+    std::uniform_real_distribution<double> value(-1.2, 1.2);
+    std::uniform_int_distribution<int> weight(1, 4);
+    std::vector<Fill> fills(n);
+    for (auto& fill : fills)
+      fill = {value(rng), value(rng), double(weight(rng))};
+    return fills;
+  }
+
+  // one fill, of the buffer or of the reference histogram
+  struct Fill1D {
+    void operator()(ConcurrentFillBuffer const& buffer, Fill const& f) const { buffer.fill(f.x, f.w); }
+    void operator()(TH1& histogram, Fill const& f) const { histogram.Fill(f.x, f.w); }
+  };
+
+  struct Fill2D {
+    void operator()(ConcurrentFillBuffer const& buffer, Fill const& f) const { buffer.fill(f.x, f.y, f.w); }
+    void operator()(TH2& histogram, Fill const& f) const { histogram.Fill(f.x, f.y, f.w); }
+  };
+
+  bool compare(char const* what, TH1 const& filled, TH1 const& reference)
+  {
+    bool same = filled.GetEntries() == reference.GetEntries()
+      and filled.GetSumOfWeights() == reference.GetSumOfWeights();
+    for (int bin = 0; bin < reference.GetNcells(); ++bin)
+      same = same and filled.GetBinContent(bin) == reference.GetBinContent(bin);
+    if (not same)
+      std::cout << "Error: " << what << " filled concurrently has " << filled.GetEntries()
+                << " entries and a sum of weights of " << filled.GetSumOfWeights()
+                << " instead of " << reference.GetEntries() << " and " << reference.GetSumOfWeights()
+                << ", or different bin contents" << std::endl;
+    return same;
+  }
+
+  // fill 'me' from 'nthreads' threads through a ConcurrentFillBuffer, and
+  // 'reference' from this thread, with 'fill' doing one fill of either
+  template <typename H, typename F>
+  bool check(char const* what, MonitorElement& me, H& reference, F fill)
+  {
+    unsigned int const nthreads = 4;
+    unsigned int const nfills = 100000;
+
+    if (not ConcurrentFillBuffer::supports(&me)) {
+      std::cout << "Error: " << what << " is not supported" << std::endl;
+      return false;
+    }
+    ConcurrentFillBuffer buffer(&me, 1);
+    std::atomic<unsigned int> running{nthreads};
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < nthreads; ++i) {
+      threads.emplace_back([&buffer, &running, &fill, i]() {
+        for (auto const& f : makeFills(nfills, i))
+          fill(buffer, f);
+        --running;
+      });
+    }
+    // merge while the threads fill, as at the end of a lumi
+    while (running != 0) {
+      buffer.merge();
+      std::this_thread::yield();
+    }
+    for (auto& thread : threads)
+      thread.join();
+    buffer.merge();
+
+    for (unsigned int i = 0; i < nthreads; ++i)
+      for (auto const& f : makeFills(nfills, i))
+        fill(reference, f);
+    return compare(what, *me.getTH1(), reference);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  ROOT::EnableThreadSafety();
+  TH1::AddDirectory(false);
+  std::string const dir("test");
+
+  MonitorElement me1D(&dir, "h1");
+  me1D.initialise(MonitorElement::DQM_KIND_TH1D, new TH1D("h1", "h1", 50, -1., 1.));
+  TH1D reference1D("r1", "r1", 50, -1., 1.);
+  bool ok = check("TH1D", me1D, reference1D, Fill1D());
+
+  MonitorElement me2D(&dir, "h2");
+  me2D.initialise(MonitorElement::DQM_KIND_TH2F, new TH2F("h2", "h2", 20, -1., 1., 20, -1., 1.));
+  TH2F reference2D("r2", "r2", 20, -1., 1., 20, -1., 1.);
+  ok = check("TH2F", me2D, reference2D, Fill2D()) and ok;
+
+  return ok ? 0 : 1;
+}
@@ -72,7 +72,7 @@ class DQMStreamerOutputRepackerTest : public edm::StreamerOutputModuleBase {
 
 DQMStreamerOutputRepackerTest::DQMStreamerOutputRepackerTest(
     edm::ParameterSet const& ps)
-    : edm::one::OutputModuleBase::OutputModuleBase(ps),
+    : edm::global::OutputModuleBase::OutputModuleBase(ps),
       edm::StreamerOutputModuleBase(ps) {
   outputPath_ = ps.getUntrackedParameter<std::string>("outputPath");
   streamLabel_ = ps.getUntrackedParameter<std::string>("streamLabel");
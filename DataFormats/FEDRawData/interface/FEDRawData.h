@@ -8,6 +8,12 @@
  *  lenght of the data is a multiple of the S-Link64 word lenght (8 byte).
  *  The FED data should include the standard FED header and trailer.
  *
+ *  The data can also be a read-only view of a buffer owned by somebody
+ *  else (e.g. the input source), kept alive by a shared owner as long as
+ *  the FEDRawData or any of its copies exists. The view is transient: a
+ *  FEDRawData is always written out with its data (see FEDRawDataStreamer),
+ *  and the non-const access makes a private copy of the data first.
+ *
  *  \author G. Bruno - CERN, EP Division
  *  \author S. Argiro - CERN and INFN - 
  *                      Refactoring and Modifications to fit into CMSSW
@@ -16,6 +22,7 @@
 
 #include <vector>
 #include <cstddef>
+#include <memory>
 
 class FEDRawData {
 
@@ -31,6 +38,12 @@ class FEDRawData {
   /// word (8 bytes)
   FEDRawData(size_t newsize);
 
+  /// Ctor referring to the size bytes at data, without copying them.
+  /// owner keeps the data alive until this FEDRawData and all its copies
+  /// are deleted. It is required that the size is a multiple of the size of
+  /// a FED word (8 bytes)
+  FEDRawData(const unsigned char *data, size_t size, std::shared_ptr<const void> owner);
+
   /// Copy constructor
   FEDRawData(const FEDRawData &);
 
@@ -40,21 +53,32 @@ class FEDRawData {
   /// Return a const pointer to the beginning of the data buffer
   const unsigned char * data() const;
 
-  /// Return a pointer to the beginning of the data buffer
+  /// Return a pointer to the beginning of the data buffer; a view
+  /// is replaced by a copy of its data first
   unsigned char * data();
 
   /// Lenght of the data buffer in bytes
-  size_t size() const {return data_.size();}
+  size_t size() const {return view_ ? viewSize_ : data_.size();}
     
   /// Resize to the specified size in bytes. It is required that 
   /// the size is a multiple of the size of a FED word (8 bytes)
   void resize(size_t newsize);
 
+  /// True if the data are not owned by this FEDRawData
+  bool isView() const {return view_ != nullptr;}
+
  private:
 
+  /// Copy the data of a view into data_
+  void copyView();
 
   Data data_;
 
+  // transient view of data owned by owner_
+  const unsigned char * view_ = nullptr;
+  size_t viewSize_ = 0;
+  std::shared_ptr<const void> owner_;
+
 };
 
 #endif
@@ -0,0 +1,33 @@
+#ifndef FEDRawData_FEDRawDataStreamer_h
+#define FEDRawData_FEDRawDataStreamer_h
+
+/** \class FEDRawDataStreamer
+ *
+ *  ROOT streamer for FEDRawData: a FEDRawData which is a view of data
+ *  owned by somebody else is written as if it owned a copy of the data,
+ *  so that the persistent format does not depend on how it was filled.
+ *  Reading is unchanged.
+ *  The streamer is installed by setFEDRawDataStreamerInTClass(), which
+ *  the FEDRawData constructor making a view calls the first time.
+ */
+
+#include "TClassStreamer.h"
+#include "TClassRef.h"
+
+class TBuffer;
+
+class FEDRawDataStreamer : public TClassStreamer {
+ public:
+  explicit FEDRawDataStreamer() : cl_("FEDRawData") {}
+
+  void operator() (TBuffer &R__b, void *objp) override;
+
+  TClassStreamer* Generate() const override;
+
+ private:
+  TClassRef cl_;
+};
+
+void setFEDRawDataStreamerInTClass();
+
+#endif
@@ -6,6 +6,7 @@
 */
 
 #include <DataFormats/FEDRawData/interface/FEDRawData.h>
+#include <DataFormats/FEDRawData/interface/FEDRawDataStreamer.h>
 #include <FWCore/Utilities/interface/Exception.h>
 #include <iostream>
 
@@ -19,17 +20,37 @@ FEDRawData::FEDRawData(size_t newsize):data_(newsize){
   if (newsize%8!=0) throw cms::Exception("DataCorrupt") << "FEDRawData::resize: " << newsize << " is not a multiple of 8 bytes." << endl;
 }
 
-FEDRawData::FEDRawData(const FEDRawData &in) : data_(in.data_)
+FEDRawData::FEDRawData(const unsigned char *data, size_t size, std::shared_ptr<const void> owner):
+  view_(data),viewSize_(size),owner_(std::move(owner)){
+  if (size%8!=0) throw cms::Exception("DataCorrupt") << "FEDRawData::FEDRawData: " << size << " is not a multiple of 8 bytes." << endl;
+  // views can be written only through FEDRawDataStreamer, installed with the first one
+  static const bool streamerSet = (setFEDRawDataStreamerInTClass(), true);
+  (void)streamerSet;
+}
+
+FEDRawData::FEDRawData(const FEDRawData &in) : data_(in.data_),
+  view_(in.view_),viewSize_(in.viewSize_),owner_(in.owner_)
 {
 }
 FEDRawData::~FEDRawData()
 {
 }
-const unsigned char * FEDRawData::data()const {return &data_[0];}
+const unsigned char * FEDRawData::data()const {return view_ ? view_ : &data_[0];}
 
-unsigned char * FEDRawData::data() {return &data_[0];}
+unsigned char * FEDRawData::data() {
+  if (view_) copyView();
+  return &data_[0];
+}
+
+void FEDRawData::copyView() {
+  data_.assign(view_, view_ + viewSize_);
+  view_ = nullptr;
+  viewSize_ = 0;
+  owner_.reset();
+}
 
 void FEDRawData::resize(size_t newsize) {
+  if (view_) copyView();
   if (size()==newsize) return;
 
   data_.resize(newsize);
@@ -0,0 +1,34 @@
+#include <DataFormats/FEDRawData/interface/FEDRawDataStreamer.h>
+#include <DataFormats/FEDRawData/interface/FEDRawData.h>
+
+#include <cstring>
+
+#include "TBuffer.h"
+#include "TClass.h"
+
+void FEDRawDataStreamer::operator()(TBuffer &R__b, void *objp) {
+  if (R__b.IsReading()) {
+    cl_->ReadBuffer(R__b, objp);
+  } else {
+    const FEDRawData* obj = static_cast<const FEDRawData*>(objp);
+    if (obj->isView()) {
+      // write a copy owning the data, with the same persistent layout
+      FEDRawData copy(obj->size());
+      if (obj->size() > 0) memcpy(copy.data(), obj->data(), obj->size());
+      cl_->WriteBuffer(R__b, &copy);
+    } else {
+      cl_->WriteBuffer(R__b, objp);
+    }
+  }
+}
+
+TClassStreamer* FEDRawDataStreamer::Generate() const {
+  return new FEDRawDataStreamer(*this);
+}
+
+void setFEDRawDataStreamerInTClass() {
+  TClass *cl = TClass::GetClass("FEDRawData");
+  if (cl != nullptr && cl->GetStreamer() == nullptr) {
+    cl->AdoptStreamer(new FEDRawDataStreamer());
+  }
+}
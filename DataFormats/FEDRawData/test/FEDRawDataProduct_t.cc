@@ -10,11 +10,19 @@
 #include <DataFormats/FEDRawData/interface/FEDRawData.h>
 #include <DataFormats/FEDRawData/interface/FEDRawDataCollection.h>
 
+#include "TBufferFile.h"
+#include "TClass.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
 class testFEDRawDataProduct: public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(testFEDRawDataProduct);
 
   CPPUNIT_TEST(testInsertAndReadBack);
+  CPPUNIT_TEST(testStreamView);
  
   CPPUNIT_TEST_SUITE_END();
 
@@ -24,6 +32,7 @@ public:
   void setUp(){}
   void tearDown(){}  
   void testInsertAndReadBack();
+  void testStreamView();
 }; 
 
 ///registration of the test so that the runner can find it
@@ -54,4 +63,36 @@ void testFEDRawDataProduct::testInsertAndReadBack(){
 
 }
 
+void testFEDRawDataProduct::testStreamView(){
+
+  auto buffer = std::make_shared<std::vector<unsigned char> >(64);
+  for (size_t i = 0; i < buffer->size(); ++i) (*buffer)[i] = i;
+
+  FEDRawData f2(16);
+  f2.data()[0] = 'd';
 
+  FEDRawDataCollection fp;
+  fp.FEDData(12) = FEDRawData(buffer->data() + 8, 24, buffer);
+  fp.FEDData(121) = f2;
+  CPPUNIT_ASSERT(fp.FEDData(12).isView());
+
+  // a view is written with its data, and read back as an ordinary FEDRawData
+  TClass* cl = TClass::GetClass(typeid(FEDRawDataCollection));
+  CPPUNIT_ASSERT(cl != nullptr);
+  TBufferFile wbuffer(TBufferFile::kWrite);
+  wbuffer.InitMap();
+  wbuffer.StreamObject(&fp, cl);
+
+  TBufferFile rbuffer(TBufferFile::kRead, wbuffer.Length(), wbuffer.Buffer(), kFALSE);
+  rbuffer.InitMap();
+  FEDRawDataCollection read;
+  rbuffer.StreamObject(&read, cl);
+
+  const FEDRawDataCollection& cread = read;
+  CPPUNIT_ASSERT(!cread.FEDData(12).isView());
+  CPPUNIT_ASSERT(cread.FEDData(12).size() == 24);
+  CPPUNIT_ASSERT(memcmp(cread.FEDData(12).data(), buffer->data() + 8, 24) == 0);
+  CPPUNIT_ASSERT(cread.FEDData(121).size() == 16);
+  CPPUNIT_ASSERT(cread.FEDData(121).data()[0] == 'd');
+  CPPUNIT_ASSERT(cread.FEDData(13).size() == 0);
+}
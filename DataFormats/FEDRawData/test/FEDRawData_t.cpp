@@ -10,6 +10,8 @@
 #include <DataFormats/FEDRawData/interface/FEDRawData.h>
 
 #include <iostream>
+#include <memory>
+#include <vector>
 
 class testFEDRawData: public CppUnit::TestFixture {
 
@@ -17,6 +19,7 @@ class testFEDRawData: public CppUnit::TestFixture {
 
   CPPUNIT_TEST(testCtor);
   CPPUNIT_TEST(testdata);
+  CPPUNIT_TEST(testView);
  
   CPPUNIT_TEST_SUITE_END();
 
@@ -27,6 +30,7 @@ public:
   void tearDown(){}  
   void testCtor();
   void testdata(); 
+  void testView();
  
 }; 
 
@@ -56,5 +60,34 @@ void testFEDRawData::testdata(){
   CPPUNIT_ASSERT(buf[47] == 'c');
 }
 
+void testFEDRawData::testView(){
+  auto buffer = std::make_shared<std::vector<unsigned char> >(64, 'x');
+  std::weak_ptr<std::vector<unsigned char> > alive(buffer);
+  {
+    FEDRawData f(buffer->data() + 8, 48, buffer);
+    buffer.reset();
+    CPPUNIT_ASSERT(f.isView());
+    CPPUNIT_ASSERT(f.size() == size_t(48));
+    CPPUNIT_ASSERT(!alive.expired());
+
+    const FEDRawData & cf = f;
+    CPPUNIT_ASSERT(cf.data() == alive.lock()->data() + 8);
+
+    // copies share the data
+    FEDRawData f2(f);
+    CPPUNIT_ASSERT(f2.isView());
+    CPPUNIT_ASSERT(static_cast<const FEDRawData &>(f2).data() == cf.data());
+
+    // non-const access makes a private copy
+    f2.data()[0] = 'a';
+    CPPUNIT_ASSERT(!f2.isView());
+    CPPUNIT_ASSERT(f2.size() == size_t(48));
+    CPPUNIT_ASSERT(f2.data()[0] == 'a');
+    CPPUNIT_ASSERT(cf.data()[0] == 'x');
+  }
+  // the owner is released with the last view
+  CPPUNIT_ASSERT(alive.expired());
+}
+
 
 #include <Utilities/Testing/interface/CppUnit_testdriver.icpp>
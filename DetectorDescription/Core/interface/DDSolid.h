@@ -607,6 +607,11 @@ struct DDSolidFactory
 
   static DDSolid shapeless( const DDName & name );
 
+  //! Creates a non-boolean solid of the given \a shape from its parameters (as given by DDSolid::parameters())
+  static DDSolid solid( const DDName & name,
+			DDSolidShape shape,
+			const std::vector<double> & pars );
+
   static DDSolid reflection( const DDName & name,
 			     const DDSolid & s );
 };		     		     				    		     		    
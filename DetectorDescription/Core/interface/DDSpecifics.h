@@ -69,6 +69,14 @@ public:
               const std::vector<std::string> & partSelections,
 	      const DDsvalues_type & svalues,
 	      bool doRegex=true);
+
+  /** Same as above, but with part selections which are already resolved into
+      logical parts (e.g. taken from selection() of another DDSpecifics);
+      no selection strings are parsed and no regular expressions are matched.
+  */
+  DDSpecifics(const DDName & name,
+              const std::vector<DDPartSelection> & partSelections,
+	      const DDsvalues_type & svalues);
   
   //! Gives a reference to the collection of part-selections
   const std::vector<DDPartSelection> & selection() const;
@@ -78,6 +86,10 @@ public:
   
   //! Calculates the geometrical history of a fully specified PartSelector
   std::pair<bool,DDExpandedView> node() const;
+
+private:
+  //! registers the specifics with the logical parts at the end of each part selection
+  void attachToLogicalParts();
 };
 
 #endif
@@ -910,3 +910,11 @@ DDSolidFactory::shapeless( const DDName & name )
 {
   return DDSolid( name, std::make_unique< DDI::Shapeless >());
 }
+
+DDSolid
+DDSolidFactory::solid( const DDName & name,
+		       DDSolidShape shape,
+		       const std::vector<double> & pars )
+{
+  return DDSolid( name, shape, pars );
+}
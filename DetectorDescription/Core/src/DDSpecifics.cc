@@ -27,6 +27,21 @@ DDSpecifics::DDSpecifics(const DDName & name,
   : DDBase< DDName, std::unique_ptr<Specific> >()
 {
   create( name, std::make_unique<Specific>( partSelections, svalues, doRegex ));   
+  attachToLogicalParts();
+} 
+
+DDSpecifics::DDSpecifics(const DDName & name,
+                         const std::vector<DDPartSelection> & partSelections,
+	      		 const DDsvalues_type & svalues)
+  : DDBase< DDName, std::unique_ptr<Specific> >()
+{
+  create( name, std::make_unique<Specific>( partSelections, svalues ));
+  attachToLogicalParts();
+}
+
+void
+DDSpecifics::attachToLogicalParts()
+{
   std::vector<std::pair<DDLogicalPart,std::pair<const DDPartSelection*, const DDsvalues_type*> > > v;
   rep().updateLogicalPart(v);
   for( auto& it : v ) {
@@ -38,7 +53,7 @@ DDSpecifics::DDSpecifics(const DDName & name,
 					  << it.first.ddname().fullname();
     }
   }
-} 
+}
 
 const std::vector<DDPartSelection> &
 DDSpecifics::selection() const
@@ -0,0 +1,62 @@
+#ifndef GUARD_DDCompactViewSnapshot_H
+#define GUARD_DDCompactViewSnapshot_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class DDCompactView;
+
+/** @class DDCompactViewSnapshot DDCompactViewSnapshot.h
+ *
+ *  Description:
+ *       Binary snapshot of a fully built DDCompactView, i.e. after the XML
+ *     has been parsed and all DDAlgorithms have run: the materials, solids
+ *     (with their parameters), rotation matrices, logical parts and
+ *     positionings reachable from the graph, and the SpecPars attached to the
+ *     logical parts with their part selections already resolved into logical
+ *     parts. Reading it back rebuilds the same DDCompactView without the XML
+ *     parsing, the expression evaluation, the algorithms and the regular
+ *     expression matching of the SpecPar selections.
+ *
+ *       The file is a fixed Header followed by the payload. The payload is
+ *     read in place from a read-only memory mapping of the file; numbers are
+ *     stored in the byte order of the machine which wrote the snapshot (a
+ *     foreign byte order shows up as a version mismatch). The names of the
+ *     SpecPars are not kept (as in DDCoreToDDXMLOutput, they are renamed
+ *     SpecParN).
+ *
+ *       The header keeps a digest of the XML files the geometry was built
+ *     from, so that a snapshot can be checked against its source.
+ */
+
+class DDCompactViewSnapshot {
+
+public:
+
+  static constexpr uint32_t version = 1;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t sourceDigest;
+    uint64_t payloadSize;
+    uint64_t payloadChecksum;
+  };
+
+  //! writes the snapshot of \a cpv to \a fileName
+  static void write( const DDCompactView& cpv, const std::string& fileName, uint64_t sourceDigest );
+
+  //! reads and checks the header of the snapshot in \a fileName
+  static Header header( const std::string& fileName );
+
+  //! rebuilds the DDCompactView (locked down) from the snapshot in \a fileName
+  static std::unique_ptr<DDCompactView> read( const std::string& fileName );
+
+  //! digest (64-bit FNV-1a) of the contents of the given files, in this order
+  static uint64_t digest( const std::vector<std::string>& fileNames );
+};
+
+#endif
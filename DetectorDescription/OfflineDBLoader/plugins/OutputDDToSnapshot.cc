@@ -0,0 +1,58 @@
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESTransientHandle.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "DetectorDescription/OfflineDBLoader/interface/DDCompactViewSnapshot.h"
+#include "DetectorDescription/Core/interface/DDCompactView.h"
+#include "Geometry/Records/interface/IdealGeometryRecord.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+/** Writes the DDCompactView of the job (normally built from the XML by
+    XMLIdealGeometryESSource) into a binary snapshot, to be read back by
+    DDSnapshotGeometryESSource. geomXMLFiles are the files the geometry is
+    built from; their digest is kept in the snapshot.
+*/
+class OutputDDToSnapshot : public edm::one::EDAnalyzer<edm::one::WatchRuns>
+{
+public:
+  explicit OutputDDToSnapshot( const edm::ParameterSet& iConfig );
+  ~OutputDDToSnapshot() override {}
+
+  void beginJob() override {}
+  void beginRun( edm::Run const& iEvent, edm::EventSetup const& ) override;
+  void analyze( edm::Event const& iEvent, edm::EventSetup const& ) override {}
+  void endRun( edm::Run const& iEvent, edm::EventSetup const& ) override {}
+  void endJob() override {}
+
+private:
+  std::string m_fname;
+  std::string m_label;
+  std::vector<std::string> m_xmlFiles;
+};
+
+OutputDDToSnapshot::OutputDDToSnapshot( const edm::ParameterSet& iConfig )
+  : m_fname( iConfig.getUntrackedParameter<std::string>( "fileName" )),
+    m_label( iConfig.getUntrackedParameter<std::string>( "label", "" ))
+{
+  for( const auto& f : iConfig.getParameter<std::vector<std::string> >( "geomXMLFiles" )) {
+    m_xmlFiles.emplace_back( edm::FileInPath( f ).fullPath());
+  }
+}
+
+void
+OutputDDToSnapshot::beginRun( const edm::Run&, edm::EventSetup const& es )
+{
+  edm::ESTransientHandle<DDCompactView> pDD;
+  es.get<IdealGeometryRecord>().get( m_label, pDD );
+
+  DDCompactViewSnapshot::write( *pDD, m_fname, DDCompactViewSnapshot::digest( m_xmlFiles ));
+  std::cout << "OutputDDToSnapshot: wrote " << pDD->graph().size() << " logical parts to " << m_fname << std::endl;
+}
+
+DEFINE_FWK_MODULE( OutputDDToSnapshot );
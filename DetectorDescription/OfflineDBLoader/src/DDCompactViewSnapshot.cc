@@ -0,0 +1,564 @@
+#include "DetectorDescription/OfflineDBLoader/interface/DDCompactViewSnapshot.h"
+#include "DetectorDescription/Core/interface/DDCompactView.h"
+#include "DetectorDescription/Core/interface/DDLogicalPart.h"
+#include "DetectorDescription/Core/interface/DDMaterial.h"
+#include "DetectorDescription/Core/interface/DDName.h"
+#include "DetectorDescription/Core/interface/DDPartSelection.h"
+#include "DetectorDescription/Core/interface/DDPosData.h"
+#include "DetectorDescription/Core/interface/DDRotationMatrix.h"
+#include "DetectorDescription/Core/interface/DDSolid.h"
+#include "DetectorDescription/Core/interface/DDSolidShapes.h"
+#include "DetectorDescription/Core/interface/DDSpecifics.h"
+#include "DetectorDescription/Core/interface/DDTransform.h"
+#include "DetectorDescription/Core/interface/DDTranslation.h"
+#include "DetectorDescription/Core/interface/DDValue.h"
+#include "DetectorDescription/Core/interface/DDValuePair.h"
+#include "DetectorDescription/Core/interface/DDsvalues.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  constexpr char magicWord[8] = { 'D', 'D', 'S', 'N', 'A', 'P', 'S', 'H' };
+
+  constexpr uint64_t fnvOffset = 14695981039346656037ULL;
+  constexpr uint64_t fnvPrime = 1099511628211ULL;
+
+  uint64_t fnv1a( const char* data, size_t size, uint64_t hash = fnvOffset )
+  {
+    for( size_t i = 0; i < size; ++i ) {
+      hash ^= static_cast<unsigned char>( data[i] );
+      hash *= fnvPrime;
+    }
+    return hash;
+  }
+
+  bool isBoolean( DDSolidShape shape )
+  {
+    return ( shape == DDSolidShape::ddunion ||
+	     shape == DDSolidShape::ddsubtraction ||
+	     shape == DDSolidShape::ddintersection );
+  }
+
+  void checkHeader( const DDCompactViewSnapshot::Header& header, const std::string& fileName )
+  {
+    if( std::memcmp( header.magic, magicWord, sizeof( magicWord )) != 0 ) {
+      throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: " << fileName << " is not a geometry snapshot.";
+    }
+    if( header.version != DDCompactViewSnapshot::version || header.headerSize != sizeof( DDCompactViewSnapshot::Header )) {
+      throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: " << fileName << " has format version " << header.version
+					    << " (header size " << header.headerSize << "), expected version "
+					    << DDCompactViewSnapshot::version << " (header size " << sizeof( DDCompactViewSnapshot::Header )
+					    << "); the snapshot has to be regenerated, or was written on a machine with a different byte order.";
+    }
+  }
+
+  // the payload, as it is built up by the writer
+  class Buffer {
+  public:
+    template<typename T> void put( T value ) {
+      const char* p = reinterpret_cast<const char*>( &value );
+      data_.insert( data_.end(), p, p + sizeof( T ));
+    }
+    void putString( const std::string& s ) {
+      put<uint32_t>( s.size());
+      data_.insert( data_.end(), s.begin(), s.end());
+    }
+    void putDoubles( const std::vector<double>& v ) {
+      put<uint32_t>( v.size());
+      for( double d : v ) put<double>( d );
+    }
+    const std::vector<char>& data() const { return data_; }
+  private:
+    std::vector<char> data_;
+  };
+
+  // bounds-checked sequential access to the mapped payload
+  class Cursor {
+  public:
+    Cursor( const char* begin, const char* end, const std::string& fileName )
+      : p_( begin ), end_( end ), fileName_( fileName ) { }
+    template<typename T> T get() {
+      need( sizeof( T ));
+      T value;
+      std::memcpy( &value, p_, sizeof( T ));
+      p_ += sizeof( T );
+      return value;
+    }
+    std::string getString() {
+      uint32_t n = get<uint32_t>();
+      need( n );
+      std::string s( p_, n );
+      p_ += n;
+      return s;
+    }
+    std::vector<double> getDoubles() {
+      uint32_t n = get<uint32_t>();
+      need( size_t( n ) * sizeof( double ));
+      std::vector<double> v( n );
+      std::memcpy( v.data(), p_, n * sizeof( double ));
+      p_ += n * sizeof( double );
+      return v;
+    }
+    bool atEnd() const { return p_ == end_; }
+  private:
+    void need( size_t n ) const {
+      if( size_t( end_ - p_ ) < n ) {
+	throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: " << fileName_ << " is truncated.";
+      }
+    }
+    const char* p_;
+    const char* end_;
+    const std::string& fileName_;
+  };
+
+  // read-only mapping of a whole file
+  class MappedFile {
+  public:
+    explicit MappedFile( const std::string& fileName ) : data_( nullptr ), size_( 0 ) {
+      int fd = ::open( fileName.c_str(), O_RDONLY );
+      if( fd < 0 ) {
+	throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: cannot open " << fileName << ": " << std::strerror( errno );
+      }
+      struct stat st;
+      if( ::fstat( fd, &st ) != 0 ) {
+	::close( fd );
+	throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: cannot stat " << fileName << ": " << std::strerror( errno );
+      }
+      size_ = st.st_size;
+      if( size_ > 0 ) {
+	void* p = ::mmap( nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0 );
+	if( p == MAP_FAILED ) {
+	  ::close( fd );
+	  throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: cannot map " << fileName << ": " << std::strerror( errno );
+	}
+	data_ = static_cast<const char*>( p );
+	::madvise( p, size_, MADV_SEQUENTIAL );
+      }
+      ::close( fd );
+    }
+    ~MappedFile() {
+      if( data_ ) ::munmap( const_cast<char*>( data_ ), size_ );
+    }
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+  private:
+    const char* data_;
+    size_t size_;
+  };
+
+  // collects everything reachable from the graph, each object after the
+  // ones it refers to
+  class Collector {
+  public:
+    uint32_t name( const DDName& n ) {
+      auto it = nameIndex_.emplace( n, names_.size());
+      if( it.second ) names_.emplace_back( n );
+      return it.first->second;
+    }
+
+    void addMaterial( const DDMaterial& mat ) {
+      if( !matSeen_.insert( mat ).second || !mat.isDefined().second ) return;
+      for( int i = 0; i < mat.noOfConstituents(); ++i ) {
+	addMaterial( mat.constituent( i ).first );
+      }
+      materials_.emplace_back( mat );
+    }
+
+    void addRotation( const DDRotation& rot ) {
+      if( !rotSeen_.insert( rot ).second || !rot.isDefined().second ) return;
+      rotations_.emplace_back( rot );
+    }
+
+    void addSolid( const DDSolid& sol ) {
+      if( !solSeen_.insert( sol ).second || !sol.isDefined().second ) return;
+      if( isBoolean( sol.shape())) {
+	const DDBooleanSolid bs( sol );
+	addSolid( bs.solidA());
+	addSolid( bs.solidB());
+	addRotation( bs.rotation());
+      }
+      solids_.emplace_back( sol );
+    }
+
+    void addLogicalPart( const DDLogicalPart& lp ) {
+      if( !lpSeen_.insert( lp ).second || !lp.isDefined().second ) return;
+      addMaterial( lp.material());
+      addSolid( lp.solid());
+      logicalParts_.emplace_back( lp );
+    }
+
+    void addSpecifics( const DDLogicalPart& lp ) {
+      for( const auto& it : lp.attachedSpecifics()) {
+	auto sp = specIndex_.emplace( it.second, specifics_.size());
+	if( sp.second ) specifics_.emplace_back( it.second, std::vector<const DDPartSelection*>());
+	specifics_[sp.first->second].second.emplace_back( it.first );
+      }
+    }
+
+    std::vector<DDName> names_;
+    std::vector<DDMaterial> materials_;
+    std::vector<DDRotation> rotations_;
+    std::vector<DDSolid> solids_;
+    std::vector<DDLogicalPart> logicalParts_;
+    std::vector<std::pair<const DDsvalues_type*, std::vector<const DDPartSelection*> > > specifics_;
+
+  private:
+    std::map<DDName, uint32_t> nameIndex_;
+    std::set<DDMaterial> matSeen_;
+    std::set<DDRotation> rotSeen_;
+    std::set<DDSolid> solSeen_;
+    std::set<DDLogicalPart> lpSeen_;
+    std::map<const DDsvalues_type*, size_t> specIndex_;
+  };
+
+  void putTranslation( Buffer& buf, const DDTranslation& t )
+  {
+    buf.put<double>( t.x());
+    buf.put<double>( t.y());
+    buf.put<double>( t.z());
+  }
+
+  DDTranslation getTranslation( Cursor& cur )
+  {
+    double x = cur.get<double>();
+    double y = cur.get<double>();
+    double z = cur.get<double>();
+    return DDTranslation( x, y, z );
+  }
+}
+
+void
+DDCompactViewSnapshot::write( const DDCompactView& cpv, const std::string& fileName, uint64_t sourceDigest )
+{
+  using Graph = DDCompactView::Graph;
+  const Graph& gra = cpv.graph();
+
+  Collector col;
+  col.addLogicalPart( cpv.root());
+  for( auto git = gra.begin(); git != gra.end(); ++git ) {
+    col.addLogicalPart( gra.nodeData( git ));
+    for( const auto& cit : *git ) {
+      col.addLogicalPart( gra.nodeData( cit.first ));
+      col.addRotation( gra.edgeData( cit.second )->ddrot());
+    }
+  }
+  // the SpecPars are found through the logical parts they are attached to;
+  // the logical parts of the intermediate selection levels must exist as well
+  size_t nlp = col.logicalParts_.size();
+  for( size_t i = 0; i < nlp; ++i ) {
+    col.addSpecifics( col.logicalParts_[i] );
+  }
+  for( auto& sp : col.specifics_ ) {
+    // the selections of one SpecPar are stored in one vector: keep their order
+    std::sort( sp.second.begin(), sp.second.end());
+    for( const DDPartSelection* ps : sp.second ) {
+      for( const DDPartSelectionLevel& level : *ps ) {
+	col.addLogicalPart( level.lp_ );
+      }
+    }
+  }
+
+  // the objects refer to each other by name; the table of names is written first
+  Buffer body;
+  body.put<uint32_t>( col.name( cpv.root().ddname()));
+
+  body.put<uint32_t>( col.materials_.size());
+  for( const auto& mat : col.materials_ ) {
+    body.put<uint32_t>( col.name( mat.ddname()));
+    body.put<double>( mat.z());
+    body.put<double>( mat.a());
+    body.put<double>( mat.density());
+    body.put<uint32_t>( mat.noOfConstituents());
+    for( int i = 0; i < mat.noOfConstituents(); ++i ) {
+      body.put<uint32_t>( col.name( mat.constituent( i ).first.ddname()));
+      body.put<double>( mat.constituent( i ).second );
+    }
+  }
+
+  body.put<uint32_t>( col.rotations_.size());
+  for( const auto& rot : col.rotations_ ) {
+    body.put<uint32_t>( col.name( rot.ddname()));
+    double c[9];
+    rot.rotation().GetComponents( c, c + 9 );
+    for( double x : c ) body.put<double>( x );
+  }
+
+  body.put<uint32_t>( col.solids_.size());
+  for( const auto& sol : col.solids_ ) {
+    body.put<uint32_t>( col.name( sol.ddname()));
+    body.put<uint32_t>( static_cast<uint32_t>( sol.shape()));
+    if( isBoolean( sol.shape())) {
+      const DDBooleanSolid bs( sol );
+      body.put<uint32_t>( col.name( bs.solidA().ddname()));
+      body.put<uint32_t>( col.name( bs.solidB().ddname()));
+      putTranslation( body, bs.translation());
+      body.put<uint32_t>( col.name( bs.rotation().ddname()));
+    } else {
+      body.putDoubles( sol.parameters());
+    }
+  }
+
+  body.put<uint32_t>( col.logicalParts_.size());
+  for( const auto& lp : col.logicalParts_ ) {
+    body.put<uint32_t>( col.name( lp.ddname()));
+    body.put<uint32_t>( col.name( lp.material().ddname()));
+    body.put<uint32_t>( col.name( lp.solid().ddname()));
+    body.put<uint32_t>( static_cast<uint32_t>( lp.category()));
+  }
+
+  uint32_t npos = 0;
+  for( auto git = gra.begin(); git != gra.end(); ++git ) npos += git->size();
+  body.put<uint32_t>( npos );
+  for( auto git = gra.begin(); git != gra.end(); ++git ) {
+    uint32_t parent = col.name( gra.nodeData( git ).ddname());
+    for( const auto& cit : *git ) {
+      const DDPosData* pd = gra.edgeData( cit.second );
+      body.put<uint32_t>( parent );
+      body.put<uint32_t>( col.name( gra.nodeData( cit.first ).ddname()));
+      body.put<int32_t>( pd->copyno());
+      putTranslation( body, pd->translation());
+      body.put<uint32_t>( col.name( pd->ddrot().ddname()));
+    }
+  }
+
+  body.put<uint32_t>( col.specifics_.size());
+  for( const auto& sp : col.specifics_ ) {
+    body.put<uint32_t>( sp.second.size());
+    for( const DDPartSelection* ps : sp.second ) {
+      body.put<uint32_t>( ps->size());
+      for( const DDPartSelectionLevel& level : *ps ) {
+	body.put<uint32_t>( col.name( level.lp_.ddname()));
+	body.put<int32_t>( level.copyno_ );
+	body.put<uint32_t>( static_cast<uint32_t>( level.selectionType_ ));
+      }
+    }
+    body.put<uint32_t>( sp.first->size());
+    for( const auto& it : *sp.first ) {
+      const DDValue& v = it.second;
+      body.putString( v.name());
+      body.put<uint8_t>( v.isEvaluated());
+      body.put<uint32_t>( v.size());
+      if( v.size() == 0 ) continue;
+      for( const auto& s : v.strings()) body.putString( s );
+      if( v.isEvaluated()) {
+	for( double d : v.doubles()) body.put<double>( d );
+      }
+    }
+  }
+
+  Buffer names;
+  names.put<uint32_t>( col.names_.size());
+  for( const auto& n : col.names_ ) {
+    names.putString( n.name());
+    names.putString( n.ns());
+  }
+
+  Header header;
+  std::memcpy( header.magic, magicWord, sizeof( magicWord ));
+  header.version = version;
+  header.headerSize = sizeof( Header );
+  header.sourceDigest = sourceDigest;
+  header.payloadSize = names.data().size() + body.data().size();
+  header.payloadChecksum = fnv1a( body.data().data(), body.data().size(),
+				  fnv1a( names.data().data(), names.data().size()));
+
+  std::ofstream out( fileName, std::ios::binary | std::ios::trunc );
+  out.write( reinterpret_cast<const char*>( &header ), sizeof( header ));
+  out.write( names.data().data(), names.data().size());
+  out.write( body.data().data(), body.data().size());
+  out.close();
+  if( !out ) {
+    throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: cannot write " << fileName;
+  }
+}
+
+DDCompactViewSnapshot::Header
+DDCompactViewSnapshot::header( const std::string& fileName )
+{
+  Header header;
+  std::ifstream in( fileName, std::ios::binary );
+  if( !in.read( reinterpret_cast<char*>( &header ), sizeof( header ))) {
+    throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: cannot read the header of " << fileName;
+  }
+  checkHeader( header, fileName );
+  return header;
+}
+
+std::unique_ptr<DDCompactView>
+DDCompactViewSnapshot::read( const std::string& fileName )
+{
+  MappedFile file( fileName );
+  Header header;
+  if( file.size() < sizeof( header )) {
+    throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: " << fileName << " is truncated.";
+  }
+  std::memcpy( &header, file.data(), sizeof( header ));
+  checkHeader( header, fileName );
+  const char* payload = file.data() + sizeof( header );
+  if( file.size() - sizeof( header ) != header.payloadSize ) {
+    throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: " << fileName << " has " << file.size() - sizeof( header )
+					  << " bytes of payload, expected " << header.payloadSize;
+  }
+  if( fnv1a( payload, header.payloadSize ) != header.payloadChecksum ) {
+    throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: " << fileName << " is corrupted (checksum mismatch).";
+  }
+  Cursor cur( payload, payload + header.payloadSize, fileName );
+
+  std::vector<DDName> names;
+  uint32_t nnames = cur.get<uint32_t>();
+  names.reserve( nnames );
+  for( uint32_t i = 0; i < nnames; ++i ) {
+    std::string name = cur.getString();
+    std::string ns = cur.getString();
+    names.emplace_back( name, ns );
+  }
+  auto name = [&]() -> const DDName& {
+    uint32_t i = cur.get<uint32_t>();
+    if( i >= names.size()) {
+      throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: " << fileName << " refers to name " << i
+					    << " out of " << names.size();
+    }
+    return names[i];
+  };
+
+  DDLogicalPart root( name());
+  auto cpv = std::make_unique<DDCompactView>( root );
+
+  for( uint32_t i = 0, n = cur.get<uint32_t>(); i < n; ++i ) {
+    const DDName& matName = name();
+    double z = cur.get<double>();
+    double a = cur.get<double>();
+    double density = cur.get<double>();
+    uint32_t nconst = cur.get<uint32_t>();
+    if( nconst == 0 ) {
+      DDMaterial( matName, z, a, density );
+    } else {
+      DDMaterial mat( matName, density );
+      for( uint32_t j = 0; j < nconst; ++j ) {
+	const DDName& constName = name();
+	mat.addMaterial( DDMaterial( constName ), cur.get<double>());
+      }
+    }
+  }
+
+  for( uint32_t i = 0, n = cur.get<uint32_t>(); i < n; ++i ) {
+    const DDName& rotName = name();
+    double c[9];
+    for( double& x : c ) x = cur.get<double>();
+    DDrot( rotName, std::make_unique<DDRotationMatrix>( c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8] ));
+  }
+
+  for( uint32_t i = 0, n = cur.get<uint32_t>(); i < n; ++i ) {
+    const DDName& solName = name();
+    auto shape = static_cast<DDSolidShape>( cur.get<uint32_t>());
+    if( isBoolean( shape )) {
+      DDSolid a( name());
+      DDSolid b( name());
+      DDTranslation t = getTranslation( cur );
+      DDRotation r( name());
+      if( shape == DDSolidShape::ddunion ) {
+	DDSolidFactory::unionSolid( solName, a, b, t, r );
+      } else if( shape == DDSolidShape::ddsubtraction ) {
+	DDSolidFactory::subtraction( solName, a, b, t, r );
+      } else {
+	DDSolidFactory::intersection( solName, a, b, t, r );
+      }
+    } else {
+      DDSolidFactory::solid( solName, shape, cur.getDoubles());
+    }
+  }
+
+  for( uint32_t i = 0, n = cur.get<uint32_t>(); i < n; ++i ) {
+    const DDName& lpName = name();
+    DDMaterial mat( name());
+    DDSolid sol( name());
+    auto category = static_cast<DDEnums::Category>( cur.get<uint32_t>());
+    DDLogicalPart( lpName, mat, sol, category );
+  }
+
+  for( uint32_t i = 0, n = cur.get<uint32_t>(); i < n; ++i ) {
+    DDLogicalPart parent( name());
+    DDLogicalPart child( name());
+    int copyno = cur.get<int32_t>();
+    DDTranslation t = getTranslation( cur );
+    DDRotation r( name());
+    cpv->position( child, parent, copyno, t, r );
+  }
+
+  const std::string& specNs = root.ddname().ns();
+  for( uint32_t i = 0, n = cur.get<uint32_t>(); i < n; ++i ) {
+    std::vector<DDPartSelection> selections( cur.get<uint32_t>());
+    for( auto& ps : selections ) {
+      uint32_t nlevels = cur.get<uint32_t>();
+      ps.reserve( nlevels );
+      for( uint32_t j = 0; j < nlevels; ++j ) {
+	DDLogicalPart lp( name());
+	int copyno = cur.get<int32_t>();
+	auto type = static_cast<ddselection_type>( cur.get<uint32_t>());
+	ps.emplace_back( DDPartSelectionLevel( lp, copyno, type ));
+      }
+    }
+    DDsvalues_type svt;
+    uint32_t nvalues = cur.get<uint32_t>();
+    svt.reserve( nvalues );
+    for( uint32_t j = 0; j < nvalues; ++j ) {
+      std::string valName = cur.getString();
+      bool isEvaluated = cur.get<uint8_t>();
+      std::vector<DDValuePair> vvp( cur.get<uint32_t>());
+      for( auto& vp : vvp ) vp.first = cur.getString();
+      if( isEvaluated ) {
+	for( auto& vp : vvp ) vp.second = cur.get<double>();
+      }
+      DDValue val( valName, vvp );
+      val.setEvalState( isEvaluated );
+      svt.emplace_back( DDsvalues_Content_type( val, val ));
+    }
+    // the ids of the values depend on the order in which their names were registered
+    std::sort( svt.begin(), svt.end());
+    DDSpecifics( DDName( "SpecPar" + std::to_string( i ), specNs ), selections, svt );
+  }
+
+  if( !cur.atEnd()) {
+    throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: unexpected data at the end of " << fileName;
+  }
+
+  cpv->lockdown();
+  return cpv;
+}
+
+uint64_t
+DDCompactViewSnapshot::digest( const std::vector<std::string>& fileNames )
+{
+  uint64_t hash = fnvOffset;
+  std::vector<char> buffer( 1 << 16 );
+  for( const auto& fileName : fileNames ) {
+    std::ifstream in( fileName, std::ios::binary );
+    if( !in ) {
+      throw cms::Exception( "DDException" ) << "DDCompactViewSnapshot: cannot open " << fileName;
+    }
+    uint64_t size = 0;
+    while( in.read( buffer.data(), buffer.size()) || in.gcount() > 0 ) {
+      hash = fnv1a( buffer.data(), in.gcount(), hash );
+      size += in.gcount();
+    }
+    // separates the files, so that moving bytes from one file to the next changes the digest
+    hash = fnv1a( reinterpret_cast<const char*>( &size ), sizeof( size ), hash );
+  }
+  return hash;
+}
@@ -0,0 +1,17 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("GeometrySnapshotWriter")
+process.load("Geometry.CMSCommonData.cmsIdealGeometryXML_cfi")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(1)
+    )
+
+process.source = cms.Source("EmptySource")
+
+process.SnapshotWriter = cms.EDAnalyzer("OutputDDToSnapshot",
+                                        fileName = cms.untracked.string('cmsIdealGeometry.ddsnap'),
+                                        geomXMLFiles = process.XMLIdealGeometryESSource.geomXMLFiles
+                                        )
+
+process.p1 = cms.Path(process.SnapshotWriter)
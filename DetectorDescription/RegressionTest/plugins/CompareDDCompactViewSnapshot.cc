@@ -0,0 +1,128 @@
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESTransientHandle.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "DetectorDescription/Core/interface/DDCompactView.h"
+#include "DetectorDescription/Core/interface/DDLogicalPart.h"
+#include "DetectorDescription/Core/interface/DDPartSelection.h"
+#include "DetectorDescription/Core/interface/DDsvalues.h"
+#include "DetectorDescription/OfflineDBLoader/interface/DDCompactViewSnapshot.h"
+#include "DetectorDescription/RegressionTest/interface/DDCompareTools.h"
+#include "Geometry/Records/interface/IdealGeometryRecord.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/** Checks that a snapshot written by OutputDDToSnapshot still matches its
+    source: the digest of geomXMLFiles must be the one kept in the snapshot,
+    and the DDCompactView read from the snapshot must be the same as the one
+    of the job (built from geomXMLFiles by XMLIdealGeometryESSource), in
+    graph, positions, rotations, solids and materials (DDCompareCPV) and in
+    the SpecPars attached to each logical part. Any difference is an error.
+*/
+class CompareDDCompactViewSnapshot : public edm::one::EDAnalyzer<edm::one::WatchRuns>
+{
+public:
+  explicit CompareDDCompactViewSnapshot( const edm::ParameterSet& );
+  ~CompareDDCompactViewSnapshot() override {}
+
+  void beginJob() override {}
+  void beginRun( edm::Run const& , edm::EventSetup const& ) override;
+  void analyze( edm::Event const& , edm::EventSetup const& ) override {}
+  void endRun( edm::Run const& , edm::EventSetup const& ) override {}
+  void endJob() override {}
+
+private:
+  using SpecParMap = std::map<std::string, std::vector<std::string> >;
+  static SpecParMap specPars( const DDCompactView& cpv );
+
+  std::string m_fname;
+  std::string m_label;
+  std::vector<std::string> m_xmlFiles;
+};
+
+CompareDDCompactViewSnapshot::CompareDDCompactViewSnapshot( const edm::ParameterSet& iConfig )
+  : m_fname( iConfig.getUntrackedParameter<std::string>( "snapshotFile" )),
+    m_label( iConfig.getUntrackedParameter<std::string>( "label", "" ))
+{
+  for( const auto& f : iConfig.getParameter<std::vector<std::string> >( "geomXMLFiles" )) {
+    m_xmlFiles.emplace_back( edm::FileInPath( f ).fullPath());
+  }
+}
+
+CompareDDCompactViewSnapshot::SpecParMap
+CompareDDCompactViewSnapshot::specPars( const DDCompactView& cpv )
+{
+  SpecParMap result;
+  const auto& gra = cpv.graph();
+  for( auto git = gra.begin(); git != gra.end(); ++git ) {
+    const DDLogicalPart& lp = gra.nodeData( git );
+    auto it = result.emplace( lp.ddname().fullname(), std::vector<std::string>());
+    if( !it.second ) continue;
+    for( const auto& spec : lp.attachedSpecifics()) {
+      std::ostringstream os;
+      os << std::setprecision( 17 ) << *spec.first << " : " << *spec.second;
+      it.first->second.emplace_back( os.str());
+    }
+    std::sort( it.first->second.begin(), it.first->second.end());
+  }
+  return result;
+}
+
+void
+CompareDDCompactViewSnapshot::beginRun( const edm::Run&, edm::EventSetup const& es )
+{
+  edm::ESTransientHandle<DDCompactView> pDD;
+  es.get<IdealGeometryRecord>().get( m_label, pDD );
+
+  bool ok = true;
+  DDCompactViewSnapshot::Header header = DDCompactViewSnapshot::header( m_fname );
+  if( header.sourceDigest != DDCompactViewSnapshot::digest( m_xmlFiles )) {
+    std::cout << "The snapshot was NOT made from the given XML files" << std::endl;
+    ok = false;
+  }
+
+  std::unique_ptr<DDCompactView> snapshot = DDCompactViewSnapshot::read( m_fname );
+
+  DDCompOptions ddco;
+  ddco.compRotName_ = true;
+  DDCompareCPV ddccpv( ddco );
+  if( ddccpv( *pDD, *snapshot )) {
+    std::cout << "DDCompactView graphs match" << std::endl;
+  } else {
+    std::cout << "DDCompactView graphs do NOT match" << std::endl;
+    ok = false;
+  }
+
+  SpecParMap xmlSpecs = specPars( *pDD );
+  SpecParMap snapshotSpecs = specPars( *snapshot );
+  unsigned int nbad = 0;
+  for( const auto& it : xmlSpecs ) {
+    auto sit = snapshotSpecs.find( it.first );
+    if( sit == snapshotSpecs.end() || sit->second != it.second ) {
+      if( nbad++ < 10 ) std::cout << "SpecPars of " << it.first << " do NOT match" << std::endl;
+    }
+  }
+  if( nbad == 0 && xmlSpecs.size() == snapshotSpecs.size()) {
+    std::cout << "SpecPars match" << std::endl;
+  } else {
+    std::cout << "SpecPars of " << nbad << " logical parts do NOT match" << std::endl;
+    ok = false;
+  }
+
+  if( !ok ) {
+    throw cms::Exception( "DDException" ) << "The geometry snapshot " << m_fname << " does not match its source.";
+  }
+}
+
+DEFINE_FWK_MODULE( CompareDDCompactViewSnapshot );
@@ -0,0 +1,22 @@
+#!/bin/bash
+
+pushd ${LOCAL_TMP_DIR}
+
+status=0
+
+echo "writeGeometrySnapshot_cfg.py"
+cmsRun ${LOCAL_TEST_DIR}/../../OfflineDBLoader/test/writeGeometrySnapshot_cfg.py
+if [ $? -ne 0 ]
+then
+  status=1
+else
+  echo "testCompareDDCompactViewSnapshot_cfg.py"
+  cmsRun ${LOCAL_TEST_DIR}/testCompareDDCompactViewSnapshot_cfg.py
+  if [ $? -ne 0 ]
+  then
+    status=1
+  fi
+fi
+
+popd
+exit $status
@@ -0,0 +1,22 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("GeometryCompareDDCompactViewSnapshot")
+process.load("Geometry.CMSCommonData.cmsIdealGeometryXML_cfi")
+
+process.source = cms.Source("EmptyIOVSource",
+                            lastValue = cms.uint64(1),
+                            timetype = cms.string('runnumber'),
+                            firstValue = cms.uint64(1),
+                            interval = cms.uint64(1)
+                            )
+
+process.SnapshotCheck = cms.EDAnalyzer("CompareDDCompactViewSnapshot",
+                                       snapshotFile = cms.untracked.string('cmsIdealGeometry.ddsnap'),
+                                       geomXMLFiles = process.XMLIdealGeometryESSource.geomXMLFiles
+                                       )
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(1)
+    )
+
+process.p1 = cms.Path(process.SnapshotCheck)
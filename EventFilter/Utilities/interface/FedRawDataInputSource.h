@@ -59,6 +59,7 @@ private:
 
   void readSupervisor();
   void readWorker(unsigned int tid);
+  void releaseChunk(InputChunk *chunk);
   void threadError();
   bool exceptionState() {return setExceptionState_;}
 
@@ -91,6 +92,7 @@ private:
   const bool verifyAdler32_;
   const bool verifyChecksum_;
   const bool useL1EventID_;
+  const bool zeroCopyFEDRawData_;
   std::vector<std::string> fileNames_;
   bool useFileBroker_;
   //std::vector<std::string> fileNamesSorted_;
@@ -130,6 +132,12 @@ private:
   InputFile *currentFile_ = nullptr;
   bool chunkIsFree_=false;
 
+  //chunk holding the current event, if FEDRawData can refer to it
+  InputChunk *eventChunk_ = nullptr;
+  //events crossing chunk boundaries are assembled here with zero-copy FEDRawData,
+  //as the chunks may still be referred to by other events
+  std::vector<unsigned char> eventBuffer_;
+
   bool startedSupervisorThread_ = false;
   std::unique_ptr<std::thread> readSupervisorThread_;
   std::vector<std::thread*> workerThreads_;
@@ -183,6 +191,8 @@ struct InputChunk {
   unsigned int offset_;
   unsigned int fileIndex_;
   std::atomic<bool> readComplete_;
+  //the source and each event referring to the chunk data (see releaseChunk)
+  std::atomic<unsigned int> users_;
 
   InputChunk(unsigned int index, uint32_t size): size_(size),index_(index) {
     buf_ = new unsigned char[size_];
@@ -193,6 +203,7 @@ struct InputChunk {
     usedSize_=toRead;
     fileIndex_=fileIndex;
     readComplete_=false;
+    users_=1;
   }
 
   ~InputChunk() {delete[] buf_;}
@@ -236,8 +247,8 @@ struct InputFile {
     //some atomics to make sure everything is cache synchronized for the main thread
     return chunks_[chunkid]!=nullptr && chunks_[chunkid]->readComplete_;
   }
-  bool advance(unsigned char* & dataPosition, const size_t size);
-  void moveToPreviousChunk(const size_t size, const size_t offset);
+  bool advance(unsigned char* & dataPosition, const size_t size, unsigned char* buffer = nullptr);
+  void moveToPreviousChunk(const size_t size, const size_t offset, unsigned char* buffer = nullptr);
   void rewindChunk(const size_t size);
 };
 
@@ -74,7 +74,7 @@ namespace evf {
 
   template<typename Consumer>
   RecoEventOutputModuleForFU<Consumer>::RecoEventOutputModuleForFU(edm::ParameterSet const& ps) :
-    edm::one::OutputModuleBase::OutputModuleBase(ps),
+    edm::global::OutputModuleBase::OutputModuleBase(ps),
     edm::StreamerOutputModuleBase(ps),
     c_(new Consumer(ps)),
     streamLabel_(ps.getParameter<std::string>("@module_label")),
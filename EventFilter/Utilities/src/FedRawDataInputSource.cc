@@ -64,6 +64,7 @@ FedRawDataInputSource::FedRawDataInputSource(edm::ParameterSet const& pset,
   verifyAdler32_(pset.getUntrackedParameter<bool> ("verifyAdler32", true)),
   verifyChecksum_(pset.getUntrackedParameter<bool> ("verifyChecksum", true)),
   useL1EventID_(pset.getUntrackedParameter<bool> ("useL1EventID", false)),
+  zeroCopyFEDRawData_(pset.getUntrackedParameter<bool> ("zeroCopyFEDRawData", false)),
   fileNames_(pset.getUntrackedParameter<std::vector<std::string>> ("fileNames",std::vector<std::string>())),
   fileListMode_(pset.getUntrackedParameter<bool> ("fileListMode", false)),
   fileListLoopMode_(pset.getUntrackedParameter<bool> ("fileListLoopMode", false)),
@@ -113,6 +114,13 @@ FedRawDataInputSource::FedRawDataInputSource(edm::ParameterSet const& pset,
   singleBufferMode_ = !(numBuffers_>1);
   readingFilesCount_=0;
 
+  if (zeroCopyFEDRawData_) {
+    if (singleBufferMode_)
+      edm::LogWarning("FedRawDataInputSource") << "zeroCopyFEDRawData requires numBuffers > 1, FED data will be copied";
+    else
+      eventBuffer_.resize(eventChunkSize_);
+  }
+
   if (!crc32c_hw_test())
     edm::LogError("FedRawDataInputSource::FedRawDataInputSource") << "Intel crc32c checksum computation unavailable";
 
@@ -214,6 +222,7 @@ void FedRawDataInputSource::fillDescriptions(edm::ConfigurationDescriptions& des
   desc.addUntracked<bool> ("verifyAdler32", true)->setComment("Verify event Adler32 checksum with FRDv3 or v4");
   desc.addUntracked<bool> ("verifyChecksum", true)->setComment("Verify event CRC-32C checksum of FRDv5 or higher");
   desc.addUntracked<bool> ("useL1EventID", false)->setComment("Use L1 event ID from FED header if true or from TCDS FED if false");
+  desc.addUntracked<bool> ("zeroCopyFEDRawData", false)->setComment("FEDRawData refer to the input buffers instead of copying the FED data (requires numBuffers > 1); a buffer is reused only after all the events using it are done");
   desc.addUntracked<bool> ("fileListMode", false)->setComment("Use fileNames parameter to directly specify raw files to open");
   desc.addUntracked<std::vector<std::string>> ("fileNames", std::vector<std::string>())->setComment("file list used when fileListMode is enabled");
   desc.setAllowAnything();
@@ -422,7 +431,7 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
   if (currentFile_->bufferPosition_==currentFile_->fileSize_) {
     readingFilesCount_--;
     //release last chunk (it is never released elsewhere)
-    freeChunks_.push(currentFile_->chunks_[currentFile_->currentChunk_]);
+    releaseChunk(currentFile_->chunks_[currentFile_->currentChunk_]);
     if (currentFile_->nEvents_>=0 && currentFile_->nEvents_!=int(currentFile_->nProcessed_))
     {
       throw cms::Exception("FedRawDataInputSource::getNextEvent")
@@ -517,6 +526,8 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
     currentFile_->bufferPosition_ += event_->size();
     currentFile_->chunkPosition_ += event_->size();
     //last chunk is released when this function is invoked next time
+    //the chunk is read again for the next events: FED data are always copied
+    eventChunk_ = nullptr;
 
   }
   //multibuffer mode:
@@ -534,8 +545,12 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
     chunkIsFree_ = false;
     unsigned char *dataPosition;
 
+    //with zero-copy FEDRawData, other events may still refer to the chunks,
+    //so events crossing chunk boundaries are not moved within the chunks
+    unsigned char *assemblyBuffer = zeroCopyFEDRawData_ ? eventBuffer_.data() : nullptr;
+
     //read header, copy it to a single chunk if necessary
-    bool chunkEnd = currentFile_->advance(dataPosition,FRDHeaderVersionSize[detectedFRDversion_]);
+    bool chunkEnd = currentFile_->advance(dataPosition,FRDHeaderVersionSize[detectedFRDversion_],assemblyBuffer);
 
     event_.reset( new FRDEventMsgView(dataPosition) );
     if (event_->size()>eventChunkSize_) {
@@ -555,7 +570,7 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
 
     if (chunkEnd) {
       //header was at the chunk boundary, we will have to move payload as well
-      currentFile_->moveToPreviousChunk(msgSize,FRDHeaderVersionSize[detectedFRDversion_]);
+      currentFile_->moveToPreviousChunk(msgSize,FRDHeaderVersionSize[detectedFRDversion_],assemblyBuffer);
       chunkIsFree_ = true;
     }
     else {
@@ -564,7 +579,7 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
 	//rewind to header start position
 	currentFile_->rewindChunk(FRDHeaderVersionSize[detectedFRDversion_]);
 	//copy event to a chunk start and move pointers
-	chunkEnd = currentFile_->advance(dataPosition,FRDHeaderVersionSize[detectedFRDversion_]+msgSize);
+	chunkEnd = currentFile_->advance(dataPosition,FRDHeaderVersionSize[detectedFRDversion_]+msgSize,assemblyBuffer);
 	assert(chunkEnd);
 	chunkIsFree_=true;
 	//header is moved
@@ -577,6 +592,8 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
 	chunkIsFree_=false;
       }
     }
+    //events which were moved or assembled are copied
+    eventChunk_ = (zeroCopyFEDRawData_ && !chunkIsFree_) ? currentFile_->chunks_[currentFile_->currentChunk_] : nullptr;
   }//end multibuffer mode
   if (fms_) fms_->setInState(evf::FastMonitoringThread::inChecksumEvent);
 
@@ -713,7 +730,7 @@ void FedRawDataInputSource::read(edm::EventPrincipal& eventPrincipal)
     }
 
   }
-  if (chunkIsFree_) freeChunks_.push(currentFile_->chunks_[currentFile_->currentChunk_-1]);
+  if (chunkIsFree_) releaseChunk(currentFile_->chunks_[currentFile_->currentChunk_-1]);
   chunkIsFree_=false;
   if (fms_) fms_->setInState(evf::FastMonitoringThread::inNoRequest);
   return;
@@ -730,6 +747,14 @@ edm::Timestamp FedRawDataInputSource::fillFEDRawDataCollection(FEDRawDataCollect
 
   uint32_t eventSize = event_->eventSize();
   unsigned char* event = (unsigned char*)event_->payload();
+
+  //all the FEDRawData of the event share one reference to the chunk
+  std::shared_ptr<const void> chunkOwner;
+  if (eventChunk_) {
+    eventChunk_->users_++;
+    chunkOwner = std::shared_ptr<const void>(eventChunk_, [this](InputChunk* chunk){ releaseChunk(chunk); });
+  }
+
   GTPEventID_=0;
   tcds_pointer_ = nullptr;
   while (eventSize > 0) {
@@ -765,8 +790,13 @@ edm::Timestamp FedRawDataInputSource::fillFEDRawDataCollection(FEDRawDataCollect
       }
     }
     FEDRawData& fedData = rawData.FEDData(fedId);
-    fedData.resize(fedSize);
-    memcpy(fedData.data(), event + eventSize, fedSize);
+    if (chunkOwner) {
+      fedData = FEDRawData(event + eventSize, fedSize, chunkOwner);
+    }
+    else {
+      fedData.resize(fedSize);
+      memcpy(fedData.data(), event + eventSize, fedSize);
+    }
   }
   assert(eventSize == 0);
 
@@ -776,6 +806,14 @@ edm::Timestamp FedRawDataInputSource::fillFEDRawDataCollection(FEDRawDataCollect
 void FedRawDataInputSource::rewind_()
 {}
 
+void FedRawDataInputSource::releaseChunk(InputChunk *chunk)
+{
+  //the last user of the chunk (the source or the last event referring to it)
+  //gives it back to the reader threads
+  if (--chunk->users_ == 0)
+    freeChunks_.push(chunk);
+}
+
 
 void FedRawDataInputSource::readSupervisor()
 {
@@ -1218,7 +1256,7 @@ void FedRawDataInputSource::threadError()
 }
 
 
-inline bool InputFile::advance(unsigned char* & dataPosition, const size_t size)
+inline bool InputFile::advance(unsigned char* & dataPosition, const size_t size, unsigned char* buffer)
 {
   //wait for chunk
   while (!waitForChunk(currentChunk_)) {
@@ -1236,11 +1274,19 @@ inline bool InputFile::advance(unsigned char* & dataPosition, const size_t size)
       usleep(100000);
       if (parent_->exceptionState()) parent_->threadError();
     }
-    //copy everything to beginning of the first chunk
-    dataPosition-=chunkPosition_;
-    assert(dataPosition==chunks_[currentChunk_]->buf_);
-    memmove(chunks_[currentChunk_]->buf_, chunks_[currentChunk_]->buf_+chunkPosition_, currentLeft);
-    memcpy(chunks_[currentChunk_]->buf_ + currentLeft, chunks_[currentChunk_+1]->buf_, size - currentLeft);
+    if (buffer) {
+      //copy everything to the buffer, leaving the chunk untouched
+      memcpy(buffer, dataPosition, currentLeft);
+      memcpy(buffer + currentLeft, chunks_[currentChunk_+1]->buf_, size - currentLeft);
+      dataPosition = buffer;
+    }
+    else {
+      //copy everything to beginning of the first chunk
+      dataPosition-=chunkPosition_;
+      assert(dataPosition==chunks_[currentChunk_]->buf_);
+      memmove(chunks_[currentChunk_]->buf_, chunks_[currentChunk_]->buf_+chunkPosition_, currentLeft);
+      memcpy(chunks_[currentChunk_]->buf_ + currentLeft, chunks_[currentChunk_+1]->buf_, size - currentLeft);
+    }
     //set pointers at the end of the old data position
     bufferPosition_+=size;
     chunkPosition_=size-currentLeft;
@@ -1254,12 +1300,14 @@ inline bool InputFile::advance(unsigned char* & dataPosition, const size_t size)
   }
 }
 
-inline void InputFile::moveToPreviousChunk(const size_t size, const size_t offset)
+inline void InputFile::moveToPreviousChunk(const size_t size, const size_t offset, unsigned char* buffer)
 {
   //this will fail in case of events that are too large
   assert(size < chunks_[currentChunk_]->size_ - chunkPosition_);
   assert(size - offset < chunks_[currentChunk_]->size_);
-  memcpy(chunks_[currentChunk_-1]->buf_+offset,chunks_[currentChunk_]->buf_+chunkPosition_,size);
+  //the header is already at the beginning of the buffer or of the previous chunk
+  unsigned char* destination = buffer ? buffer : chunks_[currentChunk_-1]->buf_;
+  memcpy(destination+offset,chunks_[currentChunk_]->buf_+chunkPosition_,size);
   chunkPosition_+=size;
   bufferPosition_+=size;
 }
@@ -0,0 +1,21 @@
+#!/bin/bash
+
+function die { echo Failure $1: status $2 ; exit $2 ; }
+
+pushd ${LOCAL_TMP_DIR}
+
+rm -rf ramdisk data
+mkdir -p ramdisk data
+
+# about 100 kB per event and 20 events per file: the events cross the
+# boundaries of the 1 MB chunks of the reader
+echo "startBU.py"
+cmsRun ${LOCAL_TEST_DIR}/startBU.py runNumber=100 buBaseDir=ramdisk maxEvents=200 fedMeanSize=128 || die "cmsRun startBU.py" $?
+
+rawFiles=`ls ramdisk/run000100/*.raw | sed 's/^/file:/' | tr '\n' ',' | sed 's/,$//'`
+[ -n "${rawFiles}" ] || die "no raw file written by startBU.py" 1
+
+echo "testZeroCopyFEDRawData_cfg.py"
+cmsRun ${LOCAL_TEST_DIR}/testZeroCopyFEDRawData_cfg.py runNumber=100 buBaseDir=ramdisk fuBaseDir=data inputFiles=${rawFiles} || die "cmsRun testZeroCopyFEDRawData_cfg.py" $?
+
+popd
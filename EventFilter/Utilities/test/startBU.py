@@ -21,13 +21,19 @@ options.register ('buBaseDir',
                   VarParsing.VarParsing.varType.string,          # string, int, or float
                   "BU base directory")
 
+options.register ('fedMeanSize',
+                  1024, # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Mean size of the fake FED data")
+
 options.parseArguments()
 
 cmsswbase = os.path.expandvars("$CMSSW_BASE/")
 
 process = cms.Process("FAKEBU")
 process.maxEvents = cms.untracked.PSet(
-    input = cms.untracked.int32(-1)
+    input = cms.untracked.int32(options.maxEvents)
 )
 
 process.options = cms.untracked.PSet(
@@ -74,7 +80,7 @@ process.a = cms.EDAnalyzer("ExceptionGenerator",
     defaultQualifier = cms.untracked.int32(0))
 
 process.s = cms.EDProducer("DaqFakeReader",
-                           meanSize = cms.untracked.uint32(1024),
+                           meanSize = cms.untracked.uint32(options.fedMeanSize),
                            width = cms.untracked.uint32(512),
                            injectErrPpm = cms.untracked.uint32(0)
                            )
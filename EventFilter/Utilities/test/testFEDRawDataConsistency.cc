@@ -0,0 +1,52 @@
+/** \file
+ *
+ *  Checks that the header and trailer of each FED of the event are consistent
+ *  with its position and size, e.g. to detect FEDRawData referring to input
+ *  buffers which have been reused.
+ */
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+#include "DataFormats/FEDRawData/interface/FEDHeader.h"
+#include "DataFormats/FEDRawData/interface/FEDTrailer.h"
+#include "DataFormats/FEDRawData/interface/FEDNumbering.h"
+
+
+namespace test{
+
+  class FEDRawDataConsistencyCheck: public edm::global::EDAnalyzer<> {
+    private:
+    edm::EDGetTokenT<FEDRawDataCollection> m_fedRawDataCollectionToken;
+    public:
+    FEDRawDataConsistencyCheck(const edm::ParameterSet& pset):
+      m_fedRawDataCollectionToken( consumes<FEDRawDataCollection>( pset.getUntrackedParameter<edm::InputTag>( "inputTag", edm::InputTag( "source" ) ) ) ) {
+    }
+
+    void analyze(edm::StreamID, const edm::Event & e, const edm::EventSetup& c) const override {
+      edm::Handle<FEDRawDataCollection> rawdata;
+      e.getByToken(m_fedRawDataCollectionToken,rawdata);
+      unsigned int nFEDs = 0;
+      for (int fedId = 0; fedId <= FEDNumbering::lastFEDId(); ++fedId) {
+        const FEDRawData& data = rawdata->FEDData(fedId);
+        size_t size = data.size();
+        if (size == 0) continue;
+        ++nFEDs;
+        FEDHeader header(data.data());
+        FEDTrailer trailer(data.data() + size - FEDTrailer::length);
+        if (size < FEDHeader::length + FEDTrailer::length || !header.check() || !trailer.check()
+            || header.sourceID() != fedId || trailer.fragmentLength() * 8 != size) {
+          throw cms::Exception("FEDRawDataConsistencyCheck") << "Event " << e.id() << ": the " << size
+                                                             << " bytes of FED " << fedId << " are not consistent";
+        }
+      }
+      if (nFEDs == 0)
+        throw cms::Exception("FEDRawDataConsistencyCheck") << "Event " << e.id() << " has no FED data";
+    }
+  };
+DEFINE_FWK_MODULE(FEDRawDataConsistencyCheck);
+}
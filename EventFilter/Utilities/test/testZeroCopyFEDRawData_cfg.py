@@ -0,0 +1,78 @@
+from __future__ import print_function
+import FWCore.ParameterSet.Config as cms
+import FWCore.ParameterSet.VarParsing as VarParsing
+import os
+
+# Reads the raw files given as inputFiles (e.g. written by startBU.py) with
+# zero-copy FEDRawData, with chunks small enough for events to cross their
+# boundaries, and checks the FED data of each event
+
+options = VarParsing.VarParsing ('analysis')
+
+options.register ('runNumber',
+                  100, # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Run Number")
+
+options.register ('buBaseDir',
+                  'ramdisk', # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.string,          # string, int, or float
+                  "BU base directory")
+
+options.register ('fuBaseDir',
+                  'data', # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.string,          # string, int, or float
+                  "FU base directory")
+
+options.register ('numThreads',
+                  4, # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Number of CMSSW threads")
+
+options.parseArguments()
+
+process = cms.Process("TESTFU")
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.numThreads),
+    numberOfStreams = cms.untracked.uint32(options.numThreads),
+)
+
+process.EvFDaqDirector = cms.Service("EvFDaqDirector",
+    runNumber = cms.untracked.uint32(options.runNumber),
+    baseDir = cms.untracked.string(options.fuBaseDir),
+    buBaseDir = cms.untracked.string(options.buBaseDir),
+    directorIsBu = cms.untracked.bool(False),
+    testModeNoBuilderUnit = cms.untracked.bool(False))
+
+try:
+  os.makedirs(options.fuBaseDir+"/run"+str(options.runNumber).zfill(6))
+except Exception as ex:
+  print(str(ex))
+  pass
+
+process.source = cms.Source("FedRawDataInputSource",
+    runNumber = cms.untracked.uint32(options.runNumber),
+    getLSFromFilename = cms.untracked.bool(True),
+    testModeNoBuilderUnit = cms.untracked.bool(False),
+    verifyAdler32 = cms.untracked.bool(True),
+    verifyChecksum = cms.untracked.bool(True),
+    useL1EventID = cms.untracked.bool(True),
+    eventChunkSize = cms.untracked.uint32(1),
+    eventChunkBlock = cms.untracked.uint32(1),
+    numBuffers = cms.untracked.uint32(3),
+    zeroCopyFEDRawData = cms.untracked.bool(True),
+    fileListMode = cms.untracked.bool(True),
+    fileNames = cms.untracked.vstring(options.inputFiles)
+    )
+
+process.check = cms.EDAnalyzer("FEDRawDataConsistencyCheck")
+
+process.p = cms.Path(process.check)
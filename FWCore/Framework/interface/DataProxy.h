@@ -21,13 +21,16 @@
 
 // system include files
 #include <atomic>
+#include <mutex>
 
 // user include files
+#include "FWCore/Concurrency/interface/WaitingTaskList.h"
 #include "FWCore/Utilities/interface/thread_safety_macros.h"
 
 // forward declarations
 namespace edm {
    class ActivityRegistry;
+   class WaitingTask;
 
    namespace eventsetup {
       struct ComponentDescription;
@@ -46,6 +49,18 @@ namespace edm {
          void doGet(EventSetupRecordImpl const& iRecord, DataKey const& iKey, bool iTransiently, ActivityRegistry*) const;
          void const* get(EventSetupRecordImpl const&, DataKey const& iKey, bool iTransiently, ActivityRegistry*) const;
 
+         /**Starts making the data in a separate task if it is not already cached. iTask is
+          notified once the data is available (or its production failed, in which case the
+          exception is passed along) and that task has finished; it is not used at all if the
+          data is already cached. A get() done before the task starts makes the data itself.
+          The data is requested transiently, i.e. it is only kept for the rest of the IOV if
+          some later get() asks for it non-transiently.
+          */
+         void prefetchAsync(WaitingTask* iTask, EventSetupRecordImpl const&, DataKey const& iKey, ActivityRegistry*) const;
+
+         ///true if the data was requested non-transiently before the last call to invalidate()
+         bool requestedInPreviousInterval() const { return requestedInPreviousInterval_.load(std::memory_order_acquire); }
+
          ///returns the description of the DataProxyProvider which owns this Proxy
          ComponentDescription const* providerDescription() const {
             return description_;
@@ -53,16 +68,31 @@ namespace edm {
          // ---------- static member functions --------------------
 
          // ---------- member functions ---------------------------
-         void invalidate() {
-            clearCacheIsValid();
-            invalidateCache();
-         }
+         void invalidate();
 
          void resetIfTransient();
 
          void setProviderDescription(ComponentDescription const* iDesc) {
             description_ = iDesc;
          }
+
+         /**Sets the mutex held while the data is made, instead of the mutex shared by all
+          proxies. Only done by DataProxyProvider::keyedProxies for providers which
+          call mayUseOwnMutex(), when EventSetup data is prefetched.
+          */
+         void setMutex(std::recursive_mutex* iMutex) {
+            mutex_ = iMutex;
+         }
+
+         ///clears the flag returned by requestedInPreviousInterval(), returning its old value
+         bool takeRequestedInPreviousInterval() const {
+            return requestedInPreviousInterval_.exchange(false);
+         }
+
+         ///sets the flag returned by requestedInPreviousInterval(), so the data is prefetched as if it had been requested
+         void requestPrefetching() const {
+            requestedInPreviousInterval_.store(true, std::memory_order_release);
+         }
       protected:
          /**This is the function which does the real work of getting the data if it is not
           already cached.  The returning 'void const*' must point to an instance of the class
@@ -90,11 +120,24 @@ namespace edm {
 
          DataProxy const& operator=(DataProxy const&) = delete; // stop default
 
+         ///calls getImpl while holding the mutex, unless the cache is already valid
+         void makeData(EventSetupRecordImpl const&, DataKey const& iKey, ActivityRegistry*) const;
+         ///makes the data if prefetchAsync was called and nothing has started making it yet, returns true if it did
+         bool runPrefetch(EventSetupRecordImpl const&, DataKey const& iKey, ActivityRegistry*) const;
+         ///waits, without holding any mutex, for the prefetching which another thread is running
+         void waitForPrefetch() const;
+
+         enum PrefetchState { kNotRequested, kRequested, kRunning, kDone };
+
          // ---------- member data --------------------------------
-         CMS_THREAD_SAFE mutable void const* cache_; //protected by a global mutex
+         CMS_THREAD_SAFE mutable void const* cache_; //protected by mutex_
          mutable std::atomic<bool> cacheIsValid_;
          mutable std::atomic<bool> nonTransientAccessRequested_;
+         mutable std::atomic<bool> requestedInPreviousInterval_;
          ComponentDescription const* description_;
+         std::recursive_mutex* mutex_;
+         mutable WaitingTaskList waitingTasks_;
+         mutable std::atomic<PrefetchState> prefetchState_;
       };
    }
 }
@@ -21,6 +21,7 @@
 // system include files
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -82,6 +83,12 @@ class DataProxyProvider
       void resetProxies(const EventSetupRecordKey& iRecordType);
       void resetProxiesIfTransient(const EventSetupRecordKey& iRecordType);
 
+      /**This method is only to be called by the framework, before the proxies are
+        registered, and only if EventSetup data is prefetched. It gives the proxies of a
+        provider which called mayUseOwnMutex() a mutex of their own.
+      **/
+      void enableOwnMutex();
+
    protected:
       template< class T>
       void usingRecord() {
@@ -90,6 +97,15 @@ class DataProxyProvider
       
       void usingRecordWithKey(const EventSetupRecordKey&);
 
+      /**Call from the constructor if none of the data made by this provider depends on
+       other EventSetup data. If the framework prefetches EventSetup data, its proxies are
+       then serialized by a mutex belonging to this provider instead of the one shared by
+       all providers, so they can be made at the same time as the data of other providers.
+       Requesting data of another provider while making data of this one then throws an
+       exception.
+       */
+      void mayUseOwnMutex();
+
       void invalidateProxies(const EventSetupRecordKey& iRecordKey) ;
 
       virtual void registerProxies(const EventSetupRecordKey& iRecordKey ,
@@ -107,6 +123,8 @@ class DataProxyProvider
       RecordProxies recordProxies_;
       ComponentDescription description_;
       std::string appendToDataLabel_;
+      bool mayUseOwnMutex_;
+      std::unique_ptr<std::recursive_mutex> ownMutex_;
 };
 
 template<class ProxyT>
@@ -40,6 +40,7 @@
 namespace edm {
    class ActivityRegistry;
    class ESInputTag;
+   class WaitingTask;
    
    namespace eventsetup {
       class EventSetupProvider;
@@ -145,6 +146,8 @@ namespace edm {
       void add(const eventsetup::EventSetupRecordImpl& iRecord);
       
       void clear();
+
+      void prefetchPreviouslyRequestedAsync(WaitingTask* iTask) const;
       
     private:
       EventSetup(ActivityRegistry*);
@@ -72,6 +72,17 @@ class EventSetupProvider {
 
       EventSetup const& eventSetup() const {return eventSetup_;}
 
+      /**Starts making, in separate tasks, the data of the records valid for the last
+       call to eventSetupForInstance which was requested during their previous interval of
+       validity and has not been made yet. iTask is notified once all of it has been made.
+       */
+      void prefetchPreviouslyRequestedAsync(WaitingTask* iTask) const {
+         eventSetup_.prefetchPreviouslyRequestedAsync(iTask);
+      }
+
+      ///makes the given data of the records valid for the last call to eventSetupForInstance be prefetched as if it had been requested
+      void requestPrefetching(std::map<EventSetupRecordKey, std::vector<DataKey> > const& iToPrefetch) const;
+
       //called by specializations of EventSetupRecordProviders
       void addRecordToEventSetup(EventSetupRecordImpl& iRecord);
 
@@ -79,6 +90,9 @@ class EventSetupProvider {
       void replaceExisting(std::shared_ptr<DataProxyProvider>);
       void add(std::shared_ptr<EventSetupRecordIntervalFinder>);
 
+      ///gives their own mutex to the DataProxyProviders which allow it, must be called before finishConfiguration
+      void enableOwnMutexes();
+
       void finishConfiguration();
 
       ///Used when we need to force a Record to reset all its proxies
@@ -74,6 +74,7 @@ namespace edm {
    class ESHandleExceptionFactory;
    class ESInputTag;
    class EventSetup;
+   class WaitingTask;
 
    namespace eventsetup {
       struct ComponentDescription;
@@ -123,6 +124,12 @@ namespace edm {
 
          ///clears the oToFill vector and then fills it with the keys for all registered data keys
          void fillRegisteredDataKeys(std::vector<DataKey>& oToFill) const;
+
+         /**Starts making, each in its own task, the data which was requested non-transiently
+          during the previous interval of validity and is not yet available. iTask is notified
+          once all of it has been made.
+          */
+         void prefetchPreviouslyRequestedAsync(WaitingTask* iTask) const;
          // ---------- static member functions --------------------
 
          // ---------- member functions ---------------------------
@@ -245,6 +245,7 @@ namespace edm {
       virtual void openFile(FileBlock const&) {}
       virtual bool isFileOpen() const { return true; }
       
+      virtual void preallocStreams(unsigned int){}
       virtual void doBeginRun_(RunForOutput const&){}
       virtual void doEndRun_(RunForOutput const& ){}
       virtual void doBeginLuminosityBlock_(LuminosityBlockForOutput const&){}
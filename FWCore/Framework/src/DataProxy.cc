@@ -11,14 +11,21 @@
 //
 
 // system include files
+#include <exception>
 #include <mutex>
+#include "tbb/task.h"
 
 // user include files
 #include "FWCore/Framework/interface/DataProxy.h"
 #include "FWCore/Framework/interface/ComponentDescription.h"
 #include "FWCore/Framework/interface/MakeDataException.h"
 #include "FWCore/Framework/interface/EventSetupRecord.h"
+#include "FWCore/Concurrency/interface/FunctorTask.h"
+#include "FWCore/Concurrency/interface/WaitingTask.h"
+#include "FWCore/Concurrency/interface/WaitingTaskHolder.h"
 #include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 //
 // constants, enums and typedefs
@@ -26,6 +33,13 @@
 namespace edm {
    namespace eventsetup {
      static std::recursive_mutex s_esGlobalMutex;
+     //The mutex of the provider whose data this thread is presently making, if that
+     // provider does not use s_esGlobalMutex. Such providers may not make data of
+     // other providers, since taking a second mutex could deadlock.
+     static thread_local std::recursive_mutex const* s_ownMutexHeld = nullptr;
+     //The number of proxies whose data this thread is presently making, i.e. whether it
+     // holds any of the EventSetup mutexes.
+     static thread_local unsigned int s_makingData = 0;
 //
 // static data member definitions
 //
@@ -43,7 +57,10 @@ DataProxy::DataProxy() :
    cache_(nullptr),
    cacheIsValid_(false),
    nonTransientAccessRequested_(false),
-   description_(dummyDescription())
+   requestedInPreviousInterval_(false),
+   description_(dummyDescription()),
+   mutex_(&s_esGlobalMutex),
+   prefetchState_(kNotRequested)
 {
 }
 
@@ -75,11 +92,22 @@ void DataProxy::clearCacheIsValid() {
    cacheIsValid_.store(false, std::memory_order_release);
    nonTransientAccessRequested_.store(false, std::memory_order_release);
    cache_ = nullptr;
+   //the framework only resets proxies once all prefetching has finished
+   prefetchState_.store(kNotRequested, std::memory_order_release);
+   waitingTasks_.reset();
 }
-      
+
+void
+DataProxy::invalidate() {
+   requestedInPreviousInterval_.store(nonTransientAccessRequested_.load(std::memory_order_acquire), std::memory_order_release);
+   clearCacheIsValid();
+   invalidateCache();
+}
+
 void 
 DataProxy::resetIfTransient() {
    if (!nonTransientAccessRequested_.load(std::memory_order_acquire)) {
+      requestedInPreviousInterval_.store(false, std::memory_order_release);
       clearCacheIsValid();
       invalidateTransientCache();
    }
@@ -129,18 +157,95 @@ namespace  {
       bool calledPostLock_;
       ActivityRegistry* activityRegistry_;
    };
+
+   class MakingDataSentry {
+   public:
+      MakingDataSentry(std::recursive_mutex const* iMutex, std::recursive_mutex const* iGlobalMutex) :
+         previous_(s_ownMutexHeld) {
+         if (iMutex != iGlobalMutex) {
+            s_ownMutexHeld = iMutex;
+         }
+         ++s_makingData;
+      }
+      ~MakingDataSentry() {
+         --s_makingData;
+         s_ownMutexHeld = previous_;
+      }
+   private:
+      std::recursive_mutex const* previous_;
+   };
+}
+
+void
+DataProxy::makeData(const EventSetupRecordImpl& iRecord, const DataKey& iKey, ActivityRegistry* activityRegistry) const
+{
+   if(nullptr != s_ownMutexHeld && s_ownMutexHeld != mutex_) {
+      throw cms::Exception("EventSetupDataDependency")
+         << "While making EventSetup data, a module which declared that it does not depend on other\n"
+         << "EventSetup data requested data of type '" << iKey.type().name() << "' with label '" << iKey.name().value()
+         << "'\nfrom record '" << iRecord.key().name() << "', which is made by module '"
+         << providerDescription()->type_ << "' with label '" << providerDescription()->label_ << "'.";
+   }
+   ESSignalSentry signalSentry(iRecord, iKey, providerDescription(), activityRegistry);
+   std::lock_guard<std::recursive_mutex> guard(*mutex_);
+   signalSentry.sendPostLockSignal();
+   if(!cacheIsValid()) {
+      MakingDataSentry makingDataSentry(mutex_, &s_esGlobalMutex);
+      cache_ = const_cast<DataProxy*>(this)->getImpl(iRecord, iKey);
+      cacheIsValid_.store(true,std::memory_order_release);
+   }
+}
+
+bool
+DataProxy::runPrefetch(const EventSetupRecordImpl& iRecord, const DataKey& iKey, ActivityRegistry* activityRegistry) const
+{
+   //Whoever changes the state first, the prefetching task or a module asking for the data,
+   // makes the data and notifies the waiting tasks.
+   PrefetchState expected = kRequested;
+   if(!prefetchState_.compare_exchange_strong(expected, kRunning)) {
+      return false;
+   }
+   std::exception_ptr exceptPtr;
+   try {
+      makeData(iRecord, iKey, activityRegistry);
+   } catch(...) {
+      exceptPtr = std::current_exception();
+   }
+   prefetchState_.store(kDone, std::memory_order_release);
+   waitingTasks_.doneWaiting(exceptPtr);
+   return true;
+}
+
+void
+DataProxy::waitForPrefetch() const
+{
+   auto waitTask = make_empty_waiting_task();
+   waitTask->increment_ref_count();
+   waitingTasks_.add(waitTask.get());
+   //A failed prefetch is not rethrown here: the cache is still invalid, so the
+   // data is made again by the caller and the exception gets the usual context.
+   //The wait is not isolated: the data is being made by another thread, and this
+   // thread may meanwhile run other tasks, including the ones that thread spawns.
+   waitTask->wait_for_all();
 }
 
 const void* 
 DataProxy::get(const EventSetupRecordImpl& iRecord, const DataKey& iKey, bool iTransiently, ActivityRegistry* activityRegistry) const
 {
    if(!cacheIsValid()) {
-      ESSignalSentry signalSentry(iRecord, iKey, providerDescription(), activityRegistry);
-      std::lock_guard<std::recursive_mutex> guard(s_esGlobalMutex);
-      signalSentry.sendPostLockSignal();
+      //If the prefetching task has not started yet, e.g. because all the threads are busy,
+      // the data is made here and the task does nothing once it runs. If it is running,
+      // wait for it through the task list, instead of queueing on the mutex behind it.
+      // This is not done while this thread makes other EventSetup data, since it then
+      // holds a mutex the prefetching task may need.
+      if(!runPrefetch(iRecord, iKey, activityRegistry) && 0 == s_makingData &&
+         kRunning == prefetchState_.load(std::memory_order_acquire)) {
+         waitForPrefetch();
+      }
+      //Also reached if the prefetching failed: the data is made again, so the exception
+      // is thrown with the usual context.
       if(!cacheIsValid()) {
-         cache_ = const_cast<DataProxy*>(this)->getImpl(iRecord, iKey);
-         cacheIsValid_.store(true,std::memory_order_release);
+         makeData(iRecord, iKey, activityRegistry);
       }
    }
    //We need to set the AccessType for each request so this can't be called in the if block above.
@@ -159,6 +264,29 @@ DataProxy::get(const EventSetupRecordImpl& iRecord, const DataKey& iKey, bool iT
 void DataProxy::doGet(const EventSetupRecordImpl& iRecord, const DataKey& iKey, bool iTransiently, ActivityRegistry* activityRegistry) const {
    get(iRecord, iKey, iTransiently, activityRegistry);
 }
+
+void DataProxy::prefetchAsync(WaitingTask* iTask, EventSetupRecordImpl const& iRecord, DataKey const& iKey, ActivityRegistry* activityRegistry) const {
+   if(cacheIsValid()) {
+      return;
+   }
+   waitingTasks_.add(iTask);
+   PrefetchState expected = kNotRequested;
+   if(prefetchState_.compare_exchange_strong(expected, kRequested)) {
+      //The record and the key are owned by the EventSetupRecordImpl which holds this proxy
+      // and stay valid until the framework resets the proxy. A module may make the data
+      // before this task runs, so the task also holds iTask: the framework then still
+      // waits for it before resetting or deleting the proxy.
+      DataKey const* key = &iKey;
+      ServiceToken token = ServiceRegistry::instance().presentToken();
+      WaitingTaskHolder holder(iTask);
+      tbb::task::spawn(*make_functor_task(tbb::task::allocate_root(),
+                                          [this, &iRecord, key, activityRegistry, token, holder]() mutable {
+         ServiceRegistry::Operate guard(token);
+         runPrefetch(iRecord, *key, activityRegistry);
+         holder.doneWaiting(std::exception_ptr{});
+      }));
+   }
+}
       
       
 //
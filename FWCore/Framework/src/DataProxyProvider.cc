@@ -33,7 +33,7 @@ namespace edm {
 //
 // constructors and destructor
 //
-DataProxyProvider::DataProxyProvider() : recordProxies_(), description_()
+DataProxyProvider::DataProxyProvider() : recordProxies_(), description_(), mayUseOwnMutex_(false)
 {
 }
 
@@ -68,6 +68,20 @@ DataProxyProvider::usingRecordWithKey(const EventSetupRecordKey& iKey)
    //keys_.push_back(iKey);
 }
 
+void
+DataProxyProvider::mayUseOwnMutex()
+{
+   mayUseOwnMutex_ = true;
+}
+
+void
+DataProxyProvider::enableOwnMutex()
+{
+   if(mayUseOwnMutex_ && !ownMutex_) {
+      ownMutex_ = std::make_unique<std::recursive_mutex>();
+   }
+}
+
 void 
 DataProxyProvider::invalidateProxies(const EventSetupRecordKey& iRecordKey) 
 {
@@ -152,6 +166,9 @@ DataProxyProvider::keyedProxies(const EventSetupRecordKey& iRecordKey) const
           itProxy != itProxyEnd;
           ++itProxy) {
         itProxy->second->setProviderDescription(&description());
+        if( ownMutex_ ) {
+          itProxy->second->setMutex(ownMutex_.get());
+        }
         if( mustChangeLabels ) {
           //Using swap is fine since
           // 1) the data structure is not a map and so we have not sorted on the keys
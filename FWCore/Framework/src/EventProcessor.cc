@@ -408,6 +408,7 @@ namespace edm {
       fileModeNoMerge_ = (fileMode == "NOMERGE");
     }
     forceESCacheClearOnNewRun_ = optionsPset.getUntrackedParameter<bool>("forceEventSetupCacheClearOnNewRun");
+    bool prefetchESDataOnNewIOV = optionsPset.getUntrackedParameter<bool>("prefetchEventSetupDataOnNewIOV");
 
     //threading
     unsigned int nThreads = optionsPset.getUntrackedParameter<unsigned int>("numberOfThreads");
@@ -481,7 +482,11 @@ namespace edm {
       nStreams=1;
       nConcurrentLumis=1;
       nConcurrentRuns=1;
+      //loopers reset EventSetup proxies outside of EventSetupsController::eventSetupForInstance
+      prefetchESDataOnNewIOV=false;
     }
+    espController_->setPrefetchOnNewIOV(prefetchESDataOnNewIOV);
+    espController_->setDataToPrefetchOnFirstIOV(optionsPset.getUntrackedParameterSet("eventSetupDataToPrefetchOnFirstIOV"));
 
     preallocations_ = PreallocationConfiguration{nThreads,nStreams,nConcurrentLumis,nConcurrentRuns};
 
@@ -17,6 +17,7 @@
 // user include files
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/Framework/interface/EventSetupRecord.h"
+#include "FWCore/Framework/interface/EventSetupRecordImpl.h"
 #include "FWCore/Framework/interface/EventSetupKnownRecordsSupplier.h"
 
 namespace edm {
@@ -80,6 +81,14 @@ EventSetup::add(const eventsetup::EventSetupRecordImpl& iRecord)
 {
    insert(iRecord.key(), &iRecord);
 }
+
+void
+EventSetup::prefetchPreviouslyRequestedAsync(WaitingTask* iTask) const
+{
+   for(auto const& keyRecord : recordMap_) {
+      keyRecord.second->prefetchPreviouslyRequestedAsync(iTask);
+   }
+}
    
 //
 // const member functions
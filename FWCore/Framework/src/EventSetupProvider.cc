@@ -19,6 +19,8 @@
 // user include files
 #include "FWCore/Framework/interface/EventSetupProvider.h"
 #include "FWCore/Framework/interface/EventSetupRecordProvider.h"
+#include "FWCore/Framework/interface/EventSetupRecordImpl.h"
+#include "FWCore/Framework/interface/DataProxy.h"
 #include "FWCore/Framework/interface/EventSetupRecord.h"
 #include "FWCore/Framework/interface/DataProxyProvider.h"
 #include "FWCore/Framework/interface/EventSetupRecordIntervalFinder.h"
@@ -119,6 +121,32 @@ EventSetupProvider::add(std::shared_ptr<DataProxyProvider> iProvider)
    dataProviders_->push_back(iProvider);
 }
 
+void
+EventSetupProvider::enableOwnMutexes()
+{
+   if(dataProviders_) {
+      for(auto const& dataProxyProvider : *dataProviders_) {
+         dataProxyProvider->enableOwnMutex();
+      }
+   }
+}
+
+void
+EventSetupProvider::requestPrefetching(std::map<EventSetupRecordKey, std::vector<DataKey> > const& iToPrefetch) const
+{
+   for(auto const& recordKeys : iToPrefetch) {
+      EventSetupRecordImpl const* record = eventSetup_.findImpl(recordKeys.first);
+      if(nullptr != record) {
+         for(auto const& dataKey : recordKeys.second) {
+            DataProxy const* proxy = record->find(dataKey);
+            if(nullptr != proxy) {
+               proxy->requestPrefetching();
+            }
+         }
+      }
+   }
+}
+
 void 
 EventSetupProvider::replaceExisting(std::shared_ptr<DataProxyProvider> dataProxyProvider)
 {
@@ -205,6 +205,17 @@ EventSetupRecordImpl::doGet(const DataKey& aKey, bool aGetTransiently) const {
    return nullptr != proxy;
 }
 
+void
+EventSetupRecordImpl::prefetchPreviouslyRequestedAsync(WaitingTask* iTask) const {
+   for(auto const& keyedProxy : proxies_) {
+      DataProxy const* proxy = keyedProxy.second;
+      //the flag is cleared so a failed prefetch is not retried at every transition of the IOV
+      if(!proxy->cacheIsValid() && proxy->takeRequestedInPreviousInterval()) {
+         proxy->prefetchAsync(iTask, *this, keyedProxy.first, eventSetup_->activityRegistry());
+      }
+   }
+}
+
 bool 
 EventSetupRecordImpl::wasGotten(const DataKey& aKey) const {
    const DataProxy* proxy = find(aKey);
@@ -25,7 +25,12 @@
 namespace edm {
   namespace eventsetup {
 
-    EventSetupsController::EventSetupsController() : mustFinishConfiguration_(true) {
+    EventSetupsController::EventSetupsController() : mustFinishConfiguration_(true), prefetchOnNewIOV_(false) {
+    }
+
+    EventSetupsController::~EventSetupsController() {
+      //the prefetching tasks use the proxies owned by the providers
+      waitForPrefetching();
     }
 
     std::shared_ptr<EventSetupProvider>
@@ -48,8 +53,17 @@ namespace edm {
     void
     EventSetupsController::eventSetupForInstance(IOVSyncValue const& syncValue) {
 
+      //proxies may only be reset once nothing is making their data anymore
+      waitForPrefetching();
+
+      bool const firstIOV = mustFinishConfiguration_;
       if (mustFinishConfiguration_) {
-        std::for_each(providers_.begin(), providers_.end(), [](std::shared_ptr<EventSetupProvider> const& esp) {
+        std::for_each(providers_.begin(), providers_.end(), [this](std::shared_ptr<EventSetupProvider> const& esp) {
+          // Without prefetching, data is only made when a module asks for it, so every
+          // proxy may as well share the global mutex.
+          if (prefetchOnNewIOV_) {
+            esp->enableOwnMutexes();
+          }
           esp->finishConfiguration();
         });
         // When the ESSources and ESProducers were constructed a first pass was
@@ -67,15 +81,69 @@ namespace edm {
       std::for_each(providers_.begin(), providers_.end(), [&syncValue](std::shared_ptr<EventSetupProvider> const& esp) {
         esp->eventSetupForInstance(syncValue);
       });
+
+      if (prefetchOnNewIOV_) {
+        // Nothing waits on this task: a module getting data which is being prefetched
+        // waits on the task list of its proxy. The count is kept at one so wait_for_all
+        // returns once all the prefetching tasks have notified it.
+        prefetchTask_ = make_empty_waiting_task();
+        prefetchTask_->increment_ref_count();
+        for (auto const& esp : providers_) {
+          // nothing was requested yet, so the data to prefetch is taken from the configuration
+          if (firstIOV) {
+            esp->requestPrefetching(dataToPrefetchOnFirstIOV_);
+          }
+          esp->prefetchPreviouslyRequestedAsync(prefetchTask_.get());
+        }
+      }
+    }
+
+    void
+    EventSetupsController::setDataToPrefetchOnFirstIOV(ParameterSet const& iPSet) {
+      dataToPrefetchOnFirstIOV_.clear();
+      for (auto const& recordName : iPSet.getParameterNames()) {
+        EventSetupRecordKey recordKey(EventSetupRecordKey::TypeTag::findType(recordName));
+        if (recordKey.type() == EventSetupRecordKey::TypeTag()) {
+          throw Exception(errors::Configuration)
+            << "Unknown record \"" << recordName << "\" in eventSetupDataToPrefetchOnFirstIOV.\n"
+            << "Please check spelling.";
+        }
+        std::vector<DataKey>& dataKeys = dataToPrefetchOnFirstIOV_[recordKey];
+        for (auto const& datum : iPSet.getParameter<std::vector<std::string> >(recordName)) {
+          std::string datumName(datum, 0, datum.find_first_of("/"));
+          std::string labelName;
+          if (datum.size() != datumName.size()) {
+            labelName = std::string(datum, datumName.size() + 1);
+          }
+          TypeTag datumType = TypeTag::findType(datumName);
+          if (datumType == TypeTag()) {
+            throw Exception(errors::Configuration)
+              << "Unknown data type \"" << datumName << "\" for record \"" << recordName
+              << "\" in eventSetupDataToPrefetchOnFirstIOV.\nPlease check spelling.";
+          }
+          dataKeys.emplace_back(datumType, labelName.c_str());
+        }
+      }
     }
 
     void
-    EventSetupsController::forceCacheClear() const {
+    EventSetupsController::forceCacheClear() {
+      waitForPrefetching();
       std::for_each(providers_.begin(), providers_.end(), [](std::shared_ptr<EventSetupProvider> const& esp) {
         esp->forceCacheClear();
       });
     }
 
+    void
+    EventSetupsController::waitForPrefetching() {
+      if (prefetchTask_) {
+        // A failure is not reported here: the proxy stays invalid, so the exception
+        // is thrown again, with the proper context, to the module which needs the data.
+        prefetchTask_->wait_for_all();
+        prefetchTask_ = nullptr;
+      }
+    }
+
     bool
     EventSetupsController::isWithinValidityInterval(IOVSyncValue const& syncValue) const {
       for(auto const& provider: providers_) {
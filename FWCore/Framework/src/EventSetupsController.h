@@ -19,6 +19,9 @@
 //
 
 #include "DataFormats/Provenance/interface/ParameterSetID.h"
+#include "FWCore/Concurrency/interface/WaitingTaskList.h"
+#include "FWCore/Framework/interface/DataKey.h"
+#include "FWCore/Framework/interface/EventSetupRecordKey.h"
 
 #include <map>
 #include <memory>
@@ -74,6 +77,7 @@ namespace edm {
          
       public:
          EventSetupsController();
+         ~EventSetupsController();
 
          std::shared_ptr<EventSetupProvider> makeProvider(ParameterSet&, ActivityRegistry*);
 
@@ -81,7 +85,17 @@ namespace edm {
 
          bool isWithinValidityInterval(IOVSyncValue const& syncValue) const;
         
-         void forceCacheClear() const;
+         void forceCacheClear();
+
+         /**If true, each call to eventSetupForInstance starts making, in the background, the
+          data of the records which changed IOV that was requested in their previous IOV.
+          */
+         void setPrefetchOnNewIOV(bool iPrefetch) { prefetchOnNewIOV_ = iPrefetch; }
+
+         /**Sets the data prefetched at the first call to eventSetupForInstance, when nothing
+          was requested before. iPSet holds, for each record name, a vstring of 'type/label'.
+          */
+         void setDataToPrefetchOnFirstIOV(ParameterSet const& iPSet);
 
          std::shared_ptr<DataProxyProvider> getESProducerAndRegisterProcess(ParameterSet const& pset, unsigned subProcessIndex);
          void putESProducer(ParameterSet const& pset, std::shared_ptr<DataProxyProvider> const& component, unsigned subProcessIndex);
@@ -132,6 +146,9 @@ namespace edm {
          EventSetupsController const& operator=(EventSetupsController const&) = delete; // stop default
 
          void checkESProducerSharing();
+
+         ///waits for the data started by the previous call to eventSetupForInstance
+         void waitForPrefetching();
          
          // ---------- member data --------------------------------
          std::vector<std::shared_ptr<EventSetupProvider> > providers_;
@@ -150,6 +167,9 @@ namespace edm {
          std::multimap<ParameterSetID, ESSourceInfo> essources_;
 
          bool mustFinishConfiguration_;
+         bool prefetchOnNewIOV_;
+         std::map<EventSetupRecordKey, std::vector<DataKey> > dataToPrefetchOnFirstIOV_;
+         std::unique_ptr<EmptyWaitingTask, waitingtask::TaskDestroyer> prefetchTask_;
       };
    }
 }
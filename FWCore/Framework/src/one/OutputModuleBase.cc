@@ -218,6 +218,7 @@ namespace edm {
           seenFirst = true;
         }
       }
+      preallocStreams(nstreams);
     }
 
     void OutputModuleBase::doBeginJob() {
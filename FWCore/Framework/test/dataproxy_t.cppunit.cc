@@ -0,0 +1,191 @@
+/*
+ *  dataproxy_t.cppunit.cc
+ *
+ *  Checks the prefetching of the data of a DataProxy: with a single thread, when
+ *  the prefetching fails and when the IOV changes after a module waited for it.
+ */
+
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "FWCore/Concurrency/interface/WaitingTaskList.h"
+#include "FWCore/Framework/interface/DataKey.h"
+#include "FWCore/Framework/interface/DataProxyTemplate.h"
+#include "FWCore/Framework/interface/EventSetupRecordImpl.h"
+#include "FWCore/Framework/test/DummyData.h"
+#include "FWCore/Framework/test/DummyRecord.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "tbb/task_arena.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace edm::eventsetup;
+using edm::eventsetup::test::DummyData;
+
+namespace {
+  edm::ActivityRegistry activityRegistry;
+
+  // counts the calls to make; make may be told to fail, or to wait until released
+  class CountingProxy : public DataProxyTemplate<DummyRecord, DummyData> {
+  public:
+    CountingProxy() : value_(1), failures_(0), made_(0), started_(false), released_(true) {}
+
+    void setValue(int iValue) { value_ = iValue; }
+    void setFailures(unsigned int iFailures) { failures_ = iFailures; }
+    void block() { released_ = false; }
+    void release() { released_ = true; }
+
+    unsigned int made() const { return made_; }
+    bool started() const { return started_; }
+
+  protected:
+    const DummyData* make(const DummyRecord&, const DataKey&) override {
+      ++made_;
+      started_ = true;
+      while(!released_) {
+        std::this_thread::yield();
+      }
+      if(failures_ > 0) {
+        --failures_;
+        throw cms::Exception("TestFailure") << "making the data failed";
+      }
+      data_ = DummyData(value_);
+      return &data_;
+    }
+    void invalidateCache() override {
+      started_ = false;
+    }
+
+  private:
+    DummyData data_;
+    int value_;
+    unsigned int failures_;
+    std::atomic<unsigned int> made_;
+    std::atomic<bool> started_;
+    std::atomic<bool> released_;
+  };
+
+  DataKey const& dummyKey() {
+    static DataKey const s_key(DataKey::makeTypeTag<DummyData>(), "");
+    return s_key;
+  }
+
+  int getValue(CountingProxy const& iProxy, EventSetupRecordImpl const& iRecord) {
+    return static_cast<DummyData const*>(iProxy.get(iRecord, dummyKey(), false, &activityRegistry))->value_;
+  }
+}
+
+class testDataProxy : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testDataProxy);
+  CPPUNIT_TEST(singleThreadTest);
+  CPPUNIT_TEST(failedPrefetchTest);
+  CPPUNIT_TEST(iovChangeTest);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void singleThreadTest();
+  void failedPrefetchTest();
+  void iovChangeTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testDataProxy);
+
+void testDataProxy::singleThreadTest() {
+  EventSetupRecordImpl record{EventSetupRecordKey::makeKey<DummyRecord>()};
+  CountingProxy proxy;
+
+  tbb::task_arena arena(1);
+  arena.execute([&]() {
+    auto waitTask = edm::make_empty_waiting_task();
+    waitTask->increment_ref_count();
+    proxy.prefetchAsync(waitTask.get(), record, dummyKey(), &activityRegistry);
+    // the prefetching task cannot have started: this thread is the only one, so the
+    // data has to be made here
+    CPPUNIT_ASSERT(getValue(proxy, record) == 1);
+    CPPUNIT_ASSERT(proxy.made() == 1);
+
+    waitTask->wait_for_all();
+    CPPUNIT_ASSERT(nullptr == waitTask->exceptionPtr());
+    CPPUNIT_ASSERT(proxy.made() == 1);
+  });
+}
+
+void testDataProxy::failedPrefetchTest() {
+  EventSetupRecordImpl record{EventSetupRecordKey::makeKey<DummyRecord>()};
+  {
+    CountingProxy proxy;
+    proxy.setFailures(1);
+    auto waitTask = edm::make_empty_waiting_task();
+    waitTask->increment_ref_count();
+    proxy.prefetchAsync(waitTask.get(), record, dummyKey(), &activityRegistry);
+    waitTask->wait_for_all();
+    CPPUNIT_ASSERT(nullptr != waitTask->exceptionPtr());
+    CPPUNIT_ASSERT(!proxy.cacheIsValid());
+
+    // the data is made again for the module asking for it
+    CPPUNIT_ASSERT(getValue(proxy, record) == 1);
+    CPPUNIT_ASSERT(proxy.made() == 2);
+  }
+  {
+    // if it fails again, the module gets the exception
+    CountingProxy proxy;
+    proxy.setFailures(2);
+    auto waitTask = edm::make_empty_waiting_task();
+    waitTask->increment_ref_count();
+    proxy.prefetchAsync(waitTask.get(), record, dummyKey(), &activityRegistry);
+    waitTask->wait_for_all();
+    CPPUNIT_ASSERT_THROW(getValue(proxy, record), cms::Exception);
+    CPPUNIT_ASSERT(proxy.made() == 2);
+  }
+}
+
+void testDataProxy::iovChangeTest() {
+  EventSetupRecordImpl record{EventSetupRecordKey::makeKey<DummyRecord>()};
+  CountingProxy proxy;
+  proxy.block();
+
+  auto waitTask = edm::make_empty_waiting_task();
+  waitTask->increment_ref_count();
+  proxy.prefetchAsync(waitTask.get(), record, dummyKey(), &activityRegistry);
+
+  // a module takes over the prefetching, which then runs until released
+  int firstValue = 0;
+  std::thread module([&]() { firstValue = getValue(proxy, record); });
+  while(!proxy.started()) {
+    std::this_thread::yield();
+  }
+  std::thread releaser([&proxy]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    proxy.release();
+  });
+  // another module waits for it
+  CPPUNIT_ASSERT(getValue(proxy, record) == 1);
+  module.join();
+  releaser.join();
+  CPPUNIT_ASSERT(firstValue == 1);
+  CPPUNIT_ASSERT(proxy.made() == 1);
+
+  // new IOV: as in EventSetupsController, the prefetching is waited for before the
+  // proxy is reset
+  waitTask->wait_for_all();
+  CPPUNIT_ASSERT(nullptr == waitTask->exceptionPtr());
+  proxy.invalidate();
+  proxy.setValue(2);
+  CPPUNIT_ASSERT(!proxy.cacheIsValid());
+  CPPUNIT_ASSERT(proxy.takeRequestedInPreviousInterval());
+
+  auto nextWaitTask = edm::make_empty_waiting_task();
+  nextWaitTask->increment_ref_count();
+  proxy.prefetchAsync(nextWaitTask.get(), record, dummyKey(), &activityRegistry);
+  nextWaitTask->wait_for_all();
+  CPPUNIT_ASSERT(nullptr == nextWaitTask->exceptionPtr());
+  CPPUNIT_ASSERT(proxy.cacheIsValid());
+  CPPUNIT_ASSERT(proxy.made() == 2);
+  CPPUNIT_ASSERT(getValue(proxy, record) == 2);
+}
@@ -25,6 +25,13 @@ void fillOptionsDescription(ParameterSetDescription& description) {
   description.addUntracked<std::string>("fileMode", "FULLMERGE")->
     setComment("Legal values are 'NOMERGE' and 'FULLMERGE'");
   description.addUntracked<bool>("forceEventSetupCacheClearOnNewRun", false);
+  description.addUntracked<bool>("prefetchEventSetupDataOnNewIOV", false)->
+    setComment("Set true to remake, concurrently and as soon as a record changes IOV, the EventSetup data which was requested in its previous IOV");
+  ParameterSetDescription dataToPrefetch;
+  dataToPrefetch.addWildcard<std::vector<std::string>>("*")->
+    setComment("The name of a record, holding the identifiers 'type/label' of its data (the label and '/' may be omitted)");
+  description.addUntracked<ParameterSetDescription>("eventSetupDataToPrefetchOnFirstIOV", dataToPrefetch)->
+    setComment("If prefetchEventSetupDataOnNewIOV is set, the EventSetup data to prefetch at the first IOV, when no data was requested yet");
   description.addUntracked<bool>("throwIfIllegalParameter", true)->
     setComment("Set false to disable exception throws when configuration validation detects illegal parameters");
   description.addUntracked<bool>("printDependencies", false)->
@@ -71,7 +71,9 @@ public:
 
   /** \brief Get a list of all cells within a dR of the given cell
 	  
-      The default implementation makes a loop over all cell geometries.
+      The default implementation looks up the cell positions in an eta-phi
+      grid built at the first query, and only tests the cells of the bins
+      overlapping the cone.
       Cleverer implementations are suggested to use rough conversions between
       eta/phi and ieta/iphi and test on the boundaries.
   */
@@ -127,6 +129,10 @@ protected:
 
 private:
 
+  /// eta-phi grid of the cell positions used by getClosestCell and getCells
+  struct CellIndex ;
+  const CellIndex& cellIndex() const ;
+
   ParMgr*   m_parMgr ;
 
   CaloCellGeometry::CornersMgr* m_cmgr ;
@@ -136,9 +142,11 @@ private:
 #if !defined(__CINT__) && !defined(__MAKECINT__) && !defined(__REFLEX__)
   mutable std::atomic<std::vector<CCGFloat>*>  m_deltaPhi ;
   mutable std::atomic<std::vector<CCGFloat>*>  m_deltaEta ;
+  mutable std::atomic<CellIndex*>  m_cellIndex ;
 #else
   mutable std::vector<CCGFloat>*  m_deltaPhi ;
   mutable std::vector<CCGFloat>*  m_deltaEta ;
+  mutable CellIndex*  m_cellIndex ;
 #endif
 };
 
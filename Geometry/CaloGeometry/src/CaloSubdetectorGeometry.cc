@@ -5,6 +5,8 @@
 #include <Math/EulerAngles.h>
 
 #include <algorithm> 
+#include <cmath>
+#include <numeric>
 
 typedef CaloCellGeometry::Pt3D     Pt3D     ;
 typedef CaloCellGeometry::Pt3DVec  Pt3DVec  ;
@@ -16,9 +18,103 @@ CaloSubdetectorGeometry::CaloSubdetectorGeometry() :
    m_parMgr ( nullptr ) ,
    m_cmgr   ( nullptr ) ,
    m_deltaPhi  (nullptr) ,
-   m_deltaEta  (nullptr)
+   m_deltaEta  (nullptr) ,
+   m_cellIndex (nullptr)
 {}
 
+/* Cell positions sorted by eta-phi bin: the cells of bin b are
+   [binStart[b], binStart[b+1]) in eta, phi and index (position in m_validIds).
+   Cells whose position has no finite eta or phi are left out, as the linear
+   search can never select them either. */
+struct CaloSubdetectorGeometry::CellIndex {
+   // bin edges are widened by this much in the queries, to be safe
+   // against rounding differences with the cell-by-cell comparisons
+   static constexpr double kMargin = 1.e-5 ;
+
+   double etaMin  { 0 } ;
+   double etaStep { 1 } ;
+   double phiStep { 2*M_PI } ;
+   int    nEta    { 1 } ;
+   int    nPhi    { 1 } ;
+   std::vector<uint32_t> binStart ;
+   std::vector<CCGFloat> eta ;
+   std::vector<CCGFloat> phi ;
+   std::vector<uint32_t> index ;
+
+   int etaBin( double e ) const {
+      const double b ( ( e - etaMin )/etaStep ) ;
+      return b < 0 ? 0 : ( b >= nEta ? nEta - 1 : int( b ) ) ;
+   }
+   // not folded into [0,nPhi), so that ranges can cross phi = pi
+   int phiBinUnfolded( double p ) const { return int( std::floor( ( p + M_PI )/phiStep ) ) ; }
+   int phiBin( double p ) const { return std::min( std::max( phiBinUnfolded( p ), 0 ), nPhi - 1 ) ; }
+   int fold( int ip ) const { return ( ( ip % nPhi ) + nPhi ) % nPhi ; }
+   uint32_t bin( int ie, int ip ) const { return ie*nPhi + ip ; }
+};
+
+const CaloSubdetectorGeometry::CellIndex&
+CaloSubdetectorGeometry::cellIndex() const
+{
+   CellIndex* index ( m_cellIndex.load( std::memory_order_acquire ) ) ;
+   if( nullptr != index ) return *index ;
+
+   std::vector<CCGFloat> eta ;
+   std::vector<CCGFloat> phi ;
+   std::vector<uint32_t> ids ;
+   eta.reserve( m_validIds.size() ) ;
+   phi.reserve( m_validIds.size() ) ;
+   ids.reserve( m_validIds.size() ) ;
+   for( uint32_t i ( 0 ); i != m_validIds.size() ; ++i ) {
+      std::shared_ptr<const CaloCellGeometry> cell ( getGeometry( m_validIds[ i ] ) ) ;
+      if( nullptr == cell ) continue ;
+      const GlobalPoint& p ( cell->getPosition() ) ;
+      const CCGFloat eta0 ( p.eta() ) ;
+      const CCGFloat phi0 ( p.phi() ) ;
+      if( !std::isfinite( eta0 ) || !std::isfinite( phi0 ) ) continue ;
+      eta.emplace_back( eta0 ) ;
+      phi.emplace_back( phi0 ) ;
+      ids.emplace_back( i ) ;
+   }
+
+   auto newIndex ( new CellIndex ) ;
+   if( !eta.empty() ) {
+      // square bins with about 4 cells each on average
+      const auto range ( std::minmax_element( eta.begin(), eta.end() ) ) ;
+      const double etaRange ( std::max( double( *range.second - *range.first ), 1.e-3 ) ) ;
+      const double step ( std::sqrt( etaRange*2*M_PI*4/eta.size() ) ) ;
+      newIndex->etaMin  = *range.first ;
+      newIndex->nEta    = std::min( std::max( int( std::ceil( etaRange/step ) ), 1 ), 1000 ) ;
+      newIndex->etaStep = etaRange/newIndex->nEta ;
+      newIndex->nPhi    = std::min( std::max( int( std::ceil( 2*M_PI/step ) ), 1 ), 1000 ) ;
+      newIndex->phiStep = 2*M_PI/newIndex->nPhi ;
+   }
+
+   // counting sort of the cells by bin, keeping the order of m_validIds within a bin
+   const uint32_t nBins ( newIndex->nEta*newIndex->nPhi ) ;
+   std::vector<uint32_t> cellBin ( eta.size() ) ;
+   newIndex->binStart.assign( nBins + 1, 0 ) ;
+   for( uint32_t k ( 0 ); k != eta.size() ; ++k ) {
+      cellBin[ k ] = newIndex->bin( newIndex->etaBin( eta[ k ] ), newIndex->phiBin( phi[ k ] ) ) ;
+      ++newIndex->binStart[ cellBin[ k ] + 1 ] ;
+   }
+   std::partial_sum( newIndex->binStart.begin(), newIndex->binStart.end(), newIndex->binStart.begin() ) ;
+   newIndex->eta.resize( eta.size() ) ;
+   newIndex->phi.resize( eta.size() ) ;
+   newIndex->index.resize( eta.size() ) ;
+   std::vector<uint32_t> fill ( newIndex->binStart.begin(), newIndex->binStart.end() - 1 ) ;
+   for( uint32_t k ( 0 ); k != eta.size() ; ++k ) {
+      const uint32_t pos ( fill[ cellBin[ k ] ]++ ) ;
+      newIndex->eta[ pos ]   = eta[ k ] ;
+      newIndex->phi[ pos ]   = phi[ k ] ;
+      newIndex->index[ pos ] = ids[ k ] ;
+   }
+
+   CellIndex* expect = nullptr;
+   bool exchanged = m_cellIndex.compare_exchange_strong(expect, newIndex, std::memory_order_acq_rel);
+   if (!exchanged) delete newIndex;
+   return *m_cellIndex.load(std::memory_order_acquire) ;
+}
+
 
 CaloSubdetectorGeometry::~CaloSubdetectorGeometry() 
 { 
@@ -26,6 +122,7 @@ CaloSubdetectorGeometry::~CaloSubdetectorGeometry()
    delete m_parMgr ; 
    if (m_deltaPhi) delete m_deltaPhi.load() ;
    if (m_deltaEta) delete m_deltaEta.load() ;
+   if (m_cellIndex) delete m_cellIndex.load() ;
 }
 
 void
@@ -53,6 +150,9 @@ CaloSubdetectorGeometry::present( const DetId& id ) const {
   return std::find(m_validIds.begin(),m_validIds.end(),id)!=m_validIds.end();
 }
 
+// Same result as a loop over all cells in m_validIds order, keeping the
+// first cell with the smallest dR2: the search goes through growing windows
+// of bins around the point, until no cell outside the window can be closer.
 DetId 
 CaloSubdetectorGeometry::getClosestCell( const GlobalPoint& r ) const {
   const CCGFloat eta ( r.eta() ) ;
@@ -60,24 +160,59 @@ CaloSubdetectorGeometry::getClosestCell( const GlobalPoint& r ) const {
   uint32_t index ( ~0 ) ;
   CCGFloat closest ( 1e9 ) ;
 
-  for( uint32_t i ( 0 ); i != m_validIds.size() ; ++i ) {
-    std::shared_ptr<const CaloCellGeometry> cell ( getGeometry( m_validIds[ i ] ) ) ;
-    if( nullptr != cell ) {
-      const GlobalPoint& p ( cell->getPosition() ) ;
-      const CCGFloat eta0 ( p.eta() ) ;
-      const CCGFloat phi0 ( p.phi() ) ;
-      const CCGFloat dR2 ( reco::deltaR2( eta0, phi0, eta, phi ) ) ;
-      if( dR2 < closest ) {
+  const CellIndex& grid ( cellIndex() ) ;
+  if( grid.eta.empty() || !std::isfinite( eta ) || !std::isfinite( phi ) ) return DetId(0) ;
+
+  auto visitBin = [&]( int ie, int ip ) {
+    const uint32_t b ( grid.bin( ie, grid.fold( ip ) ) ) ;
+    for( uint32_t c ( grid.binStart[ b ] ) ; c != grid.binStart[ b + 1 ] ; ++c ) {
+      const CCGFloat dR2 ( reco::deltaR2( grid.eta[ c ], grid.phi[ c ], eta, phi ) ) ;
+      if( dR2 < closest || ( dR2 == closest && grid.index[ c ] < index ) ) {
 	closest = dR2 ;
-	index   = i   ;
+	index   = grid.index[ c ] ;
+      }
+    }
+  } ;
+
+  const int ie0 ( grid.etaBin( eta ) ) ;
+  const int ip0 ( grid.phiBin( phi ) ) ;
+  for( int k ( 0 ) ; ; ++k ) {
+    const int ieMin ( std::max( ie0 - k, 0 ) ) ;
+    const int ieMax ( std::min( ie0 + k, grid.nEta - 1 ) ) ;
+    const bool allPhi ( 2*k + 1 >= grid.nPhi ) ;
+    // only the bins on the border of the window are new; a bin seen twice
+    // once the window wraps around in phi does not change the result
+    for( int ie ( ieMin ) ; ie <= ieMax ; ++ie ) {
+      if( ie == ie0 - k || ie == ie0 + k ) {
+	const int dpMax ( std::min( k, grid.nPhi - 1 - k ) ) ;
+	for( int dp ( -k ) ; dp <= dpMax ; ++dp ) visitBin( ie, ip0 + dp ) ;
+      } else if( 2*k - 1 < grid.nPhi ) {
+	visitBin( ie, ip0 - k ) ;
+	visitBin( ie, ip0 + k ) ;
       }
     }
+
+    // lower bound on the distance of the cells outside the window
+    double outside ( 1e9 ) ;
+    if( ie0 - k > 0 ) outside = std::min( outside, eta - ( grid.etaMin + ( ie0 - k )*grid.etaStep ) ) ;
+    if( ie0 + k < grid.nEta - 1 ) outside = std::min( outside, grid.etaMin + ( ie0 + k + 1 )*grid.etaStep - eta ) ;
+    if( !allPhi ) {
+      const double lowEdge ( ( ip0 - k )*grid.phiStep - M_PI ) ;
+      const double highEdge ( ( ip0 + k + 1 )*grid.phiStep - M_PI ) ;
+      outside = std::min( outside, std::min( phi - lowEdge, highEdge - phi ) ) ;
+    }
+    if( outside >= 1e9 ) break ; // the window covers the whole grid
+    outside -= CellIndex::kMargin ;
+    if( outside > 0 && outside*outside > closest ) break ;
   }
+
   return ( closest > 0.9e9 ||
 	   (uint32_t)(~0) == index       ? DetId(0) :
 	   m_validIds[index] ) ;
 }
 
+// Same selection as a loop over all cells, restricted to the bins that
+// overlap the eta and phi bands of width 2*dR around the point.
 CaloSubdetectorGeometry::DetIdSet 
 CaloSubdetectorGeometry::getCells(const GlobalPoint& r, double dR) const {
    const double dR2 ( dR*dR ) ;
@@ -88,22 +223,36 @@ CaloSubdetectorGeometry::getCells(const GlobalPoint& r, double dR) const {
    
    if( 0.000001 < dR )
    {
-      for( uint32_t i ( 0 ); i != m_validIds.size() ; ++i ) 
+      const CellIndex& grid ( cellIndex() ) ;
+      if( grid.eta.empty() || !std::isfinite( eta ) || !std::isfinite( phi ) ) return dss ;
+
+      const int ieMin ( grid.etaBin( eta - dR - CellIndex::kMargin ) ) ;
+      const int ieMax ( grid.etaBin( eta + dR + CellIndex::kMargin ) ) ;
+      int ipMin ( grid.phiBinUnfolded( phi - dR - CellIndex::kMargin ) ) ;
+      int ipMax ( grid.phiBinUnfolded( phi + dR + CellIndex::kMargin ) ) ;
+      if( ipMax - ipMin + 1 >= grid.nPhi ) {
+	 ipMin = 0 ;
+	 ipMax = grid.nPhi - 1 ;
+      }
+
+      for( int ie ( ieMin ) ; ie <= ieMax ; ++ie ) 
       {
-	 std::shared_ptr<const CaloCellGeometry> cell ( getGeometry( m_validIds[i] ) ) ;
-	 if( nullptr != cell )
+	 for( int ip ( ipMin ) ; ip <= ipMax ; ++ip ) 
 	 {
-	    const GlobalPoint& p ( cell->getPosition() ) ;
-	    const CCGFloat eta0 ( p.eta() ) ;
-	    if( fabs( eta - eta0 ) < dR )
+	    const uint32_t b ( grid.bin( ie, grid.fold( ip ) ) ) ;
+	    for( uint32_t c ( grid.binStart[ b ] ) ; c != grid.binStart[ b + 1 ] ; ++c ) 
 	    {
-	       const CCGFloat phi0 ( p.phi() ) ;
-	       CCGFloat delp ( fabs( phi - phi0 ) ) ;
-	       if( delp > M_PI ) delp = 2*M_PI - delp ;
-	       if( delp < dR )
+	       const CCGFloat eta0 ( grid.eta[ c ] ) ;
+	       if( fabs( eta - eta0 ) < dR )
 	       {
-		  const CCGFloat dist2 ( reco::deltaR2( eta0, phi0, eta, phi ) ) ;
-		  if( dist2 < dR2 ) dss.insert( m_validIds[i] ) ;
+		  const CCGFloat phi0 ( grid.phi[ c ] ) ;
+		  CCGFloat delp ( fabs( phi - phi0 ) ) ;
+		  if( delp > M_PI ) delp = 2*M_PI - delp ;
+		  if( delp < dR )
+		  {
+		     const CCGFloat dist2 ( reco::deltaR2( eta0, phi0, eta, phi ) ) ;
+		     if( dist2 < dR2 ) dss.insert( m_validIds[ grid.index[ c ] ] ) ;
+		  }
 	       }
 	    }
 	 }
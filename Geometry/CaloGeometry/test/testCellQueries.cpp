@@ -0,0 +1,167 @@
+#include "Geometry/CaloGeometry/interface/CaloCellGeometry.h"
+#include "Geometry/CaloGeometry/interface/CaloSubdetectorGeometry.h"
+#include "DataFormats/DetId/interface/DetId.h"
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+#include "DataFormats/Math/interface/deltaR.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Checks the eta-phi grid used by CaloSubdetectorGeometry::getClosestCell
+// and getCells against linear scans of all the cells (the implementation
+// used before the grid), on random points, for a regular and a random cell
+// layout.  Part of the points are outside the eta acceptance of the cells.
+
+typedef CaloCellGeometry::CCGFloat CCGFloat ;
+
+namespace {
+
+  class TestCell : public CaloCellGeometry {
+  public:
+    explicit TestCell( const GlobalPoint& position ) { setRefPoint( position ) ; }
+    void vocalCorners( Pt3DVec& , const CCGFloat* , Pt3D& ) const override {}
+  private:
+    void initCorners( CornersVec& ) override {}
+  };
+
+  class TestGeometry : public CaloSubdetectorGeometry {
+  public:
+    // the cells must be added in increasing DetId order
+    void addCell( const DetId& id, const GlobalPoint& position ) {
+      m_validIds.push_back( id ) ;
+      m_cells.emplace_back( new TestCell( position ) ) ;
+    }
+
+    void newCell( const GlobalPoint& , const GlobalPoint& , const GlobalPoint& ,
+		  const CCGFloat* , const DetId& ) override {}
+
+    std::shared_ptr<const CaloCellGeometry> getGeometry( const DetId& id ) const override {
+      auto pos ( std::lower_bound( m_validIds.begin(), m_validIds.end(), id ) ) ;
+      if( pos == m_validIds.end() || *pos != id ) return nullptr ;
+      return cellGeomPtr( pos - m_validIds.begin() ) ;
+    }
+
+  protected:
+    const CaloCellGeometry* getGeometryRawPtr( uint32_t index ) const override {
+      return index < m_cells.size() ? m_cells[ index ].get() : nullptr ;
+    }
+
+  private:
+    std::vector<std::unique_ptr<TestCell> > m_cells ;
+  };
+
+  GlobalPoint point( double rho, double eta, double phi ) {
+    return GlobalPoint( rho*std::cos( phi ), rho*std::sin( phi ), rho*std::sinh( eta ) ) ;
+  }
+
+  DetId linearClosestCell( const TestGeometry& geometry, const GlobalPoint& r ) {
+    const std::vector<DetId>& ids ( geometry.getValidDetIds() ) ;
+    const CCGFloat eta ( r.eta() ) ;
+    const CCGFloat phi ( r.phi() ) ;
+    uint32_t index ( ~0 ) ;
+    CCGFloat closest ( 1e9 ) ;
+    for( uint32_t i ( 0 ) ; i != ids.size() ; ++i ) {
+      const GlobalPoint& p ( geometry.getGeometry( ids[ i ] )->getPosition() ) ;
+      const CCGFloat dR2 ( reco::deltaR2( CCGFloat( p.eta() ), CCGFloat( p.phi() ), eta, phi ) ) ;
+      if( dR2 < closest ) {
+	closest = dR2 ;
+	index   = i ;
+      }
+    }
+    return ( closest > 0.9e9 || (uint32_t)(~0) == index ? DetId(0) : ids[ index ] ) ;
+  }
+
+  CaloSubdetectorGeometry::DetIdSet linearCells( const TestGeometry& geometry, const GlobalPoint& r, double dR ) {
+    const std::vector<DetId>& ids ( geometry.getValidDetIds() ) ;
+    const double dR2 ( dR*dR ) ;
+    const double eta ( r.eta() ) ;
+    const double phi ( r.phi() ) ;
+    CaloSubdetectorGeometry::DetIdSet dss ;
+    for( uint32_t i ( 0 ) ; i != ids.size() ; ++i ) {
+      const GlobalPoint& p ( geometry.getGeometry( ids[ i ] )->getPosition() ) ;
+      const CCGFloat eta0 ( p.eta() ) ;
+      if( fabs( eta - eta0 ) < dR ) {
+	const CCGFloat phi0 ( p.phi() ) ;
+	CCGFloat delp ( fabs( phi - phi0 ) ) ;
+	if( delp > M_PI ) delp = 2*M_PI - delp ;
+	if( delp < dR ) {
+	  const CCGFloat dist2 ( reco::deltaR2( eta0, phi0, eta, phi ) ) ;
+	  if( dist2 < dR2 ) dss.insert( ids[ i ] ) ;
+	}
+      }
+    }
+    return dss ;
+  }
+
+  // compares the two implementations on random points with |eta| < etaMax,
+  // returns the number of differences
+  unsigned int compare( const char* name, const TestGeometry& geometry, double etaMax, std::mt19937& rng ) {
+    std::uniform_real_distribution<double> etaDist( -etaMax, etaMax ) ;
+    std::uniform_real_distribution<double> phiDist( -M_PI, M_PI ) ;
+    std::uniform_real_distribution<double> dRDist( 0., 0.5 ) ;
+    unsigned int differences ( 0 ) ;
+    for( unsigned int k ( 0 ) ; k != 2000 ; ++k ) {
+      // a few points exactly at phi = pi, where the grid wraps around
+      const GlobalPoint r ( point( 150., etaDist( rng ), k % 50 == 0 ? M_PI : phiDist( rng ) ) ) ;
+      const DetId closest ( geometry.getClosestCell( r ) ) ;
+      const DetId expected ( linearClosestCell( geometry, r ) ) ;
+      if( closest != expected ) {
+	std::cout << name << ": getClosestCell" << r << " gives " << closest.rawId()
+		  << " instead of " << expected.rawId() << std::endl ;
+	++differences ;
+      }
+      const double dR ( dRDist( rng ) ) ;
+      if( geometry.getCells( r, dR ) != linearCells( geometry, r, dR ) ) {
+	std::cout << name << ": getCells" << r << " with dR = " << dR
+		  << " differs from the linear scan" << std::endl ;
+	++differences ;
+      }
+    }
+    return differences ;
+  }
+}
+
+int main()
+{
+  std::mt19937 rng( 1234 ) ;
+  unsigned int differences ( 0 ) ;
+
+  // barrel-like layout: rings of cells in eta, cells at phi = pi included
+  {
+    TestGeometry geometry ;
+    uint32_t raw ( DetId::Calo << 28 ) ;
+    for( int ieta ( -40 ) ; ieta != 40 ; ++ieta ) {
+      for( int iphi ( 0 ) ; iphi != 72 ; ++iphi ) {
+	geometry.addCell( DetId( ++raw ), point( 130., ( ieta + 0.5 )*0.0375, iphi*2*M_PI/72 - M_PI ) ) ;
+      }
+    }
+    // acceptance |eta| < 1.5, points up to |eta| = 3
+    differences += compare( "regular layout", geometry, 3., rng ) ;
+  }
+
+  // random cells, some at the same position to check the ties
+  {
+    TestGeometry geometry ;
+    std::uniform_real_distribution<double> etaDist( -2.5, 2.5 ) ;
+    std::uniform_real_distribution<double> phiDist( -M_PI, M_PI ) ;
+    uint32_t raw ( DetId::Calo << 28 ) ;
+    GlobalPoint previous ;
+    for( unsigned int k ( 0 ) ; k != 3000 ; ++k ) {
+      const GlobalPoint p ( k % 10 == 9 ? previous : point( 150., etaDist( rng ), phiDist( rng ) ) ) ;
+      geometry.addCell( DetId( ++raw ), p ) ;
+      previous = p ;
+    }
+    differences += compare( "random layout", geometry, 4., rng ) ;
+  }
+
+  if( differences != 0 ) {
+    std::cout << differences << " differences with the linear scans" << std::endl ;
+    return EXIT_FAILURE ;
+  }
+  return EXIT_SUCCESS ;
+}
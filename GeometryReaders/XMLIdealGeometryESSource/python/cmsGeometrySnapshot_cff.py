@@ -0,0 +1,9 @@
+import FWCore.ParameterSet.Config as cms
+
+# DDCompactView from a binary snapshot written by OutputDDToSnapshot
+# (see DetectorDescription/OfflineDBLoader/test/writeGeometrySnapshot_cfg.py);
+# replaces XMLIdealGeometryESSource
+XMLIdealGeometryESSource = cms.ESSource("DDSnapshotGeometryESSource",
+                                        rootNodeName = cms.string('cms:OCMS'),
+                                        fileName = cms.string('cmsIdealGeometry.ddsnap')
+                                        )
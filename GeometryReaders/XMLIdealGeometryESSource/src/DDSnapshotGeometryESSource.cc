@@ -0,0 +1,105 @@
+#include "FWCore/Framework/interface/ESProducer.h"
+#include "FWCore/Framework/interface/EventSetupRecordIntervalFinder.h"
+#include "FWCore/Framework/interface/SourceFactory.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "DetectorDescription/Core/interface/DDCompactView.h"
+#include "DetectorDescription/Core/interface/DDRoot.h"
+#include "DetectorDescription/OfflineDBLoader/interface/DDCompactViewSnapshot.h"
+#include "Geometry/Records/interface/IdealGeometryRecord.h"
+#include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/** Provides the DDCompactView from a binary snapshot written by
+    OutputDDToSnapshot, instead of parsing the XML as XMLIdealGeometryESSource.
+    If geomXMLFiles is given (as for XMLIdealGeometryESSource), the digest
+    of these files is compared with the one of the files the snapshot was
+    made from, and a stale snapshot is an error.
+*/
+class DDSnapshotGeometryESSource : public edm::ESProducer,
+                                   public edm::EventSetupRecordIntervalFinder
+{
+public:
+  DDSnapshotGeometryESSource( const edm::ParameterSet& );
+
+  std::unique_ptr<DDCompactView> produceGeom( const IdealGeometryRecord& );
+  std::unique_ptr<DDCompactView> produceMagField( const IdealMagneticFieldRecord& );
+
+protected:
+  void setIntervalFor( const edm::eventsetup::EventSetupRecordKey&,
+		       const edm::IOVSyncValue&, edm::ValidityInterval& ) override;
+
+private:
+  std::unique_ptr<DDCompactView> produce();
+
+  std::string rootNodeName_;
+  std::string fileName_;
+};
+
+DDSnapshotGeometryESSource::DDSnapshotGeometryESSource( const edm::ParameterSet& p )
+  : rootNodeName_( p.getParameter<std::string>( "rootNodeName" )),
+    fileName_( p.getParameter<std::string>( "fileName" ))
+{
+  DDCompactViewSnapshot::Header header = DDCompactViewSnapshot::header( fileName_ );
+  if( p.exists( "geomXMLFiles" )) {
+    std::vector<std::string> files;
+    for( const auto& f : p.getParameter<std::vector<std::string> >( "geomXMLFiles" ))
+      files.emplace_back( edm::FileInPath( f ).fullPath());
+    if( DDCompactViewSnapshot::digest( files ) != header.sourceDigest ) {
+      throw cms::Exception( "DDException" ) << "DDSnapshotGeometryESSource: the snapshot " << fileName_
+					    << " was not made from the given geomXMLFiles, it has to be regenerated.";
+    }
+  }
+
+  if( rootNodeName_ == "MagneticFieldVolumes:MAGF" || rootNodeName_ == "cmsMagneticField:MAGF" ) {
+    setWhatProduced( this, &DDSnapshotGeometryESSource::produceMagField,
+		     edm::es::Label( p.getParameter<std::string>( "@module_label" )));
+    findingRecord<IdealMagneticFieldRecord>();
+  } else {
+    setWhatProduced( this, &DDSnapshotGeometryESSource::produceGeom,
+		     edm::es::Label( p.getParameter<std::string>( "@module_label" )));
+    findingRecord<IdealGeometryRecord>();
+  }
+}
+
+std::unique_ptr<DDCompactView>
+DDSnapshotGeometryESSource::produceGeom( const IdealGeometryRecord& )
+{
+  return produce();
+}
+
+std::unique_ptr<DDCompactView>
+DDSnapshotGeometryESSource::produceMagField( const IdealMagneticFieldRecord& )
+{
+  return produce();
+}
+
+std::unique_ptr<DDCompactView>
+DDSnapshotGeometryESSource::produce()
+{
+  std::unique_ptr<DDCompactView> cpv = DDCompactViewSnapshot::read( fileName_ );
+  if( !( cpv->root().ddname() == DDName( rootNodeName_ ))) {
+    throw cms::Exception( "Geometry" ) << "The root node of the snapshot " << fileName_ << " is \""
+				       << cpv->root().ddname() << "\", not \"" << rootNodeName_ << "\"";
+  }
+  DDRootDef::instance().set( cpv->root());
+  edm::LogInfo( "DDSnapshotGeometryESSource" ) << "DDCompactView with " << cpv->graph().size()
+					       << " logical parts read from " << fileName_;
+  return cpv;
+}
+
+void
+DDSnapshotGeometryESSource::setIntervalFor( const edm::eventsetup::EventSetupRecordKey&,
+					    const edm::IOVSyncValue& iosv,
+					    edm::ValidityInterval& oValidity )
+{
+  edm::ValidityInterval infinity( iosv.beginOfTime(), iosv.endOfTime());
+  oValidity = infinity;
+}
+
+DEFINE_FWK_EVENTSETUP_SOURCE( DDSnapshotGeometryESSource );
@@ -33,6 +33,7 @@
 
 // local headers
 #include "memory_usage.h"
+#include "perf_counters.h"
 #include "processor_model.h"
 
 using namespace std::literals;
@@ -60,6 +61,25 @@ namespace {
   {
     return bytes / 1024;
   }
+
+  // difference between two readings of a hardware counter; the readings could
+  // come from different threads, in which case the difference is meaningless
+  uint64_t counts(uint64_t after, uint64_t before)
+  {
+    return (after > before) ? after - before : 0;
+  }
+
+  // events per thousand instructions
+  double mpki(uint64_t events, uint64_t instructions)
+  {
+    return (instructions > 0) ? 1000. * events / instructions : 0.;
+  }
+
+  // instructions per cycle
+  double ipc(uint64_t instructions, uint64_t cycles)
+  {
+    return (cycles > 0) ? (double) instructions / cycles : 0.;
+  }
 } // namespace
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -72,7 +92,8 @@ FastTimerService::Resources::Resources() :
   time_thread(boost::chrono::nanoseconds::zero()),
   time_real(boost::chrono::nanoseconds::zero()),
   allocated(0ul),
-  deallocated(0ul)
+  deallocated(0ul),
+  counters{}
 { }
 
 void
@@ -81,6 +102,7 @@ FastTimerService::Resources::reset() {
   time_real   = boost::chrono::nanoseconds::zero();
   allocated   = 0ul;
   deallocated = 0ul;
+  counters.fill(0ul);
 }
 
 FastTimerService::Resources &
@@ -89,6 +111,8 @@ FastTimerService::Resources::operator+=(Resources const& other) {
   time_real   += other.time_real;
   allocated   += other.allocated;
   deallocated += other.deallocated;
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    counters[i] += other.counters[i];
   return *this;
 }
 
@@ -109,14 +133,20 @@ FastTimerService::AtomicResources::AtomicResources() :
   time_real(0ul),
   allocated(0ul),
   deallocated(0ul)
-{ }
+{
+  for (auto & counter: counters)
+    counter = 0ul;
+}
 
 FastTimerService::AtomicResources::AtomicResources(AtomicResources const& other) :
   time_thread(other.time_thread.load()),
   time_real(other.time_real.load()),
   allocated(other.allocated.load()),
   deallocated(other.deallocated.load())
-{ }
+{
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    counters[i] = other.counters[i].load();
+}
 
 void
 FastTimerService::AtomicResources::reset() {
@@ -124,6 +154,8 @@ FastTimerService::AtomicResources::reset() {
   time_real   = 0ul;
   allocated   = 0ul;
   deallocated = 0ul;
+  for (auto & counter: counters)
+    counter = 0ul;
 }
 
 FastTimerService::AtomicResources &
@@ -132,6 +164,8 @@ FastTimerService::AtomicResources::operator=(AtomicResources const& other) {
   time_real   = other.time_real.load();
   allocated   = other.allocated.load();
   deallocated = other.deallocated.load();
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    counters[i] = other.counters[i].load();
   return *this;
 }
 
@@ -141,6 +175,8 @@ FastTimerService::AtomicResources::operator+=(AtomicResources const& other) {
   time_real   += other.time_real.load();
   allocated   += other.allocated.load();
   deallocated += other.deallocated.load();
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    counters[i] += other.counters[i].load();
   return *this;
 }
 
@@ -320,6 +356,7 @@ FastTimerService::Measurement::measure() noexcept {
   time_real   = boost::chrono::high_resolution_clock::now();
   allocated   = memory_usage::allocated();
   deallocated = memory_usage::deallocated();
+  perf_counters::read(counters);
 }
 
 void
@@ -331,14 +368,19 @@ FastTimerService::Measurement::measure_and_store(Resources & store) noexcept {
   auto new_time_real   = boost::chrono::high_resolution_clock::now();
   auto new_allocated   = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
+  perf_counters::values new_counters;
+  perf_counters::read(new_counters);
   store.time_thread = new_time_thread - time_thread;
   store.time_real   = new_time_real   - time_real;
   store.allocated   = new_allocated   - allocated;
   store.deallocated = new_deallocated - deallocated;
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    store.counters[i] = ::counts(new_counters[i], counters[i]);
   time_thread = new_time_thread;
   time_real   = new_time_real;
   allocated   = new_allocated;
   deallocated = new_deallocated;
+  counters    = new_counters;
 }
 
 void
@@ -350,14 +392,19 @@ FastTimerService::Measurement::measure_and_accumulate(Resources & store) noexcep
   auto new_time_real   = boost::chrono::high_resolution_clock::now();
   auto new_allocated   = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
+  perf_counters::values new_counters;
+  perf_counters::read(new_counters);
   store.time_thread += new_time_thread - time_thread;
   store.time_real   += new_time_real   - time_real;
   store.allocated   += new_allocated   - allocated;
   store.deallocated += new_deallocated - deallocated;
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    store.counters[i] += ::counts(new_counters[i], counters[i]);
   time_thread = new_time_thread;
   time_real   = new_time_real;
   allocated   = new_allocated;
   deallocated = new_deallocated;
+  counters    = new_counters;
 }
 
 void
@@ -369,14 +416,19 @@ FastTimerService::Measurement::measure_and_accumulate(AtomicResources & store) n
   auto new_time_real   = boost::chrono::high_resolution_clock::now();
   auto new_allocated   = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
+  perf_counters::values new_counters;
+  perf_counters::read(new_counters);
   store.time_thread += boost::chrono::duration_cast<boost::chrono::nanoseconds>(new_time_thread - time_thread).count();
   store.time_real   += boost::chrono::duration_cast<boost::chrono::nanoseconds>(new_time_real   - time_real).count();
   store.allocated   += new_allocated   - allocated;
   store.deallocated += new_deallocated - deallocated;
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    store.counters[i] += ::counts(new_counters[i], counters[i]);
   time_thread = new_time_thread;
   time_real   = new_time_real;
   allocated   = new_allocated;
   deallocated = new_deallocated;
+  counters    = new_counters;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -426,6 +478,30 @@ FastTimerService::PlotsPerElement::book(
     deallocated_.setYTitle(y_title_kB.c_str());
   }
 
+  if (perf_counters::is_available())
+  {
+    ipc_ = booker.book1D(
+        name + " ipc",
+        title + " instructions per cycle",
+        100, 0., 5.);
+    ipc_.setXTitle("instructions per cycle");
+    ipc_.setYTitle("events / 0.05");
+
+    llc_mpki_ = booker.book1D(
+        name + " llc_mpki",
+        title + " last level cache misses per 1000 instructions",
+        100, 0., 50.);
+    llc_mpki_.setXTitle("LLC misses per 1000 instructions");
+    llc_mpki_.setYTitle("events / 0.5");
+
+    branch_mpki_ = booker.book1D(
+        name + " branch_mpki",
+        title + " branch mispredictions per 1000 instructions",
+        100, 0., 50.);
+    branch_mpki_.setXTitle("branch misses per 1000 instructions");
+    branch_mpki_.setYTitle("events / 0.5");
+  }
+
   if (not byls)
     return;
 
@@ -498,6 +574,19 @@ FastTimerService::PlotsPerElement::fill(Resources const& data, unsigned int lumi
 
   if (deallocated_byls_)
     deallocated_byls_.fill(lumisection, kB(data.deallocated));
+
+  // skip the elements that did not run
+  if (data.counters[perf_counters::cycles] == 0)
+    return;
+
+  if (ipc_)
+    ipc_.fill(ipc(data.counters[perf_counters::instructions], data.counters[perf_counters::cycles]));
+
+  if (llc_mpki_)
+    llc_mpki_.fill(mpki(data.counters[perf_counters::llc_misses], data.counters[perf_counters::instructions]));
+
+  if (branch_mpki_)
+    branch_mpki_.fill(mpki(data.counters[perf_counters::branch_misses], data.counters[perf_counters::instructions]));
 }
 
 void
@@ -529,6 +618,19 @@ FastTimerService::PlotsPerElement::fill(AtomicResources const& data, unsigned in
 
   if (deallocated_byls_)
     deallocated_byls_.fill(lumisection, kB(data.deallocated));
+
+  // skip the elements that did not run
+  if (data.counters[perf_counters::cycles] == 0)
+    return;
+
+  if (ipc_)
+    ipc_.fill(ipc(data.counters[perf_counters::instructions], data.counters[perf_counters::cycles]));
+
+  if (llc_mpki_)
+    llc_mpki_.fill(mpki(data.counters[perf_counters::llc_misses], data.counters[perf_counters::instructions]));
+
+  if (branch_mpki_)
+    branch_mpki_.fill(mpki(data.counters[perf_counters::branch_misses], data.counters[perf_counters::instructions]));
 }
 
 void
@@ -619,6 +721,29 @@ FastTimerService::PlotsPerPath::book(
         bins, -0.5, bins - 0.5);
     module_deallocated_total_.setYTitle("memory [kB]");
   }
+  if (perf_counters::is_available())
+  {
+    module_cycles_total_ = booker.book1DD(
+        "module_cycles_total",
+        "total cycles",
+        bins, -0.5, bins - 0.5);
+    module_cycles_total_.setYTitle("cycles");
+    module_instructions_total_ = booker.book1DD(
+        "module_instructions_total",
+        "total instructions",
+        bins, -0.5, bins - 0.5);
+    module_instructions_total_.setYTitle("instructions");
+    module_llc_misses_total_ = booker.book1DD(
+        "module_llc_misses_total",
+        "total last level cache misses",
+        bins, -0.5, bins - 0.5);
+    module_llc_misses_total_.setYTitle("LLC misses");
+    module_branch_misses_total_ = booker.book1DD(
+        "module_branch_misses_total",
+        "total branch mispredictions",
+        bins, -0.5, bins - 0.5);
+    module_branch_misses_total_.setYTitle("branch misses");
+  }
   for (unsigned int bin: boost::irange(0u, bins)) {
     auto const& module = job[path.modules_and_dependencies_[bin]];
     std::string const& label = module.scheduled_ ? module.module_.moduleLabel() : module.module_.moduleLabel() + " (unscheduled)";
@@ -630,6 +755,13 @@ FastTimerService::PlotsPerPath::book(
       module_allocated_total_  .setBinLabel(bin + 1, label.c_str());
       module_deallocated_total_.setBinLabel(bin + 1, label.c_str());
     }
+    if (perf_counters::is_available())
+    {
+      module_cycles_total_        .setBinLabel(bin + 1, label.c_str());
+      module_instructions_total_  .setBinLabel(bin + 1, label.c_str());
+      module_llc_misses_total_    .setBinLabel(bin + 1, label.c_str());
+      module_branch_misses_total_ .setBinLabel(bin + 1, label.c_str());
+    }
   }
   module_counter_.setBinLabel(bins + 1, "");
 
@@ -659,6 +791,18 @@ FastTimerService::PlotsPerPath::fill(ProcessCallGraph::PathType const& descripti
 
     if (module_deallocated_total_)
       module_deallocated_total_.fill(i, kB(module.total.deallocated));
+
+    if (module_cycles_total_)
+      module_cycles_total_.fill(i, module.total.counters[perf_counters::cycles]);
+
+    if (module_instructions_total_)
+      module_instructions_total_.fill(i, module.total.counters[perf_counters::instructions]);
+
+    if (module_llc_misses_total_)
+      module_llc_misses_total_.fill(i, module.total.counters[perf_counters::llc_misses]);
+
+    if (module_branch_misses_total_)
+      module_branch_misses_total_.fill(i, module.total.counters[perf_counters::branch_misses]);
   }
   if (module_counter_ and path.status)
     module_counter_.fill(path.last);
@@ -903,6 +1047,10 @@ FastTimerService::FastTimerService(const edm::ParameterSet & config, edm::Activi
   highlight_module_psets_(      config.getUntrackedParameter<std::vector<edm::ParameterSet>>("highlightModules") ),
   highlight_modules_(           highlight_module_psets_.size())         // filled in postBeginJob()
 {
+  // enable the hardware performance counters before any measurement is taken
+  if (config.getUntrackedParameter<bool>("enableHardwareCounters"))
+    perf_counters::enable();
+
   // start observing when a thread enters or leaves the TBB global thread arena
   tbb::task_scheduler_observer::observe();
 
@@ -1423,6 +1571,29 @@ void FastTimerService::printPathSummaryLine(T& out, Resources const& data, Resou
     % label;
 }
 
+template <typename T>
+void FastTimerService::printCountersHeader(T& out, std::string const& label) const
+{
+  out << "FastReport     Cycles avg.  Instructions avg.    IPC  LLC misses avg.   MPKI  Branch misses avg.   MPKI  ";
+  //      FastReport  ############.  ################.  ##.##  ##############.  ###.#  #################.  ###.#  ...
+  out << label << '\n';
+}
+
+template <typename T>
+void FastTimerService::printCountersLine(T& out, Resources const& data, uint64_t events, std::string const& label) const
+{
+  auto const& c = data.counters;
+  out << boost::format("FastReport  %13.0f  %17.0f  %5.2f  %15.0f  %5.1f  %18.0f  %5.1f  %s\n")
+    % (events ? (double) c[perf_counters::cycles]        / events : 0)
+    % (events ? (double) c[perf_counters::instructions]  / events : 0)
+    % ipc(c[perf_counters::instructions], c[perf_counters::cycles])
+    % (events ? (double) c[perf_counters::llc_misses]    / events : 0)
+    % mpki(c[perf_counters::llc_misses], c[perf_counters::instructions])
+    % (events ? (double) c[perf_counters::branch_misses] / events : 0)
+    % mpki(c[perf_counters::branch_misses], c[perf_counters::instructions])
+    % label;
+}
+
 template <typename T>
 void FastTimerService::printSummary(T& out, ResourcesPerJob const& data, std::string const& label) const
 {
@@ -1472,6 +1643,35 @@ void FastTimerService::printSummary(T& out, ResourcesPerJob const& data, std::st
     printSummaryLine(out, data.highlight[group], data.events, highlight_modules_[group].label);
     out << '\n';
   }
+
+  if (not perf_counters::is_available())
+    return;
+
+  printCountersHeader(out, "Modules");
+  printCountersLine(out, source.total, data.events, source_d.moduleLabel());
+  for (unsigned int i = 0; i < callgraph_.processes().size(); ++i) {
+    auto const& proc_d = callgraph_.processDescription(i);
+    auto const& proc   = data.processes[i];
+    printCountersLine(out, proc.total, data.events, "process " + proc_d.name_);
+    for (unsigned int m: proc_d.modules_) {
+      auto const& module_d = callgraph_.module(m);
+      auto const& module   = data.modules[m];
+      printCountersLine(out, module.total, data.events, "  " + module_d.moduleLabel());
+    }
+  }
+  printCountersLine(out, data.total, data.events, "total");
+  out << '\n';
+  printCountersHeader(out, "Processes and Paths (including dependencies)");
+  for (unsigned int i = 0; i < callgraph_.processes().size(); ++i) {
+    auto const& proc_d = callgraph_.processDescription(i);
+    auto const& proc   = data.processes[i];
+    printCountersLine(out, proc.total, data.events, "process " + proc_d.name_);
+    for (unsigned int p = 0; p < proc.paths.size(); ++p)
+      printCountersLine(out, proc.paths[p].total, data.events, "  " + proc_d.paths_[p].name_);
+    for (unsigned int p = 0; p < proc.endpaths.size(); ++p)
+      printCountersLine(out, proc.endpaths[p].total, data.events, "  " + proc_d.endPaths_[p].name_);
+  }
+  out << '\n';
 }
 
 template <typename T>
@@ -1853,6 +2053,7 @@ FastTimerService::fillDescriptions(edm::ConfigurationDescriptions & descriptions
   desc.addUntracked<double>(      "dqmModuleMemoryResolution", 500. );   // kB
   desc.addUntracked<unsigned>(    "dqmLumiSectionsRange",     2500  );   // ~ 16 hours
   desc.addUntracked<std::string>( "dqmPath",                  "HLT/TimerService");
+  desc.addUntracked<bool>(        "enableHardwareCounters",   false)->setComment("Read the cycles, instructions, last level cache misses and branch mispredictions of each module with perf_event_open.");
 
   edm::ParameterSetDescription highlightModulesDescription;
   highlightModulesDescription.addUntracked<std::vector<std::string>>("modules", {});
@@ -5,6 +5,7 @@
 #include <unistd.h>
 
 // C++ headers
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <map>
@@ -41,6 +42,9 @@
 #include "DQMServices/Core/interface/MonitorElement.h"
 #include "HLTrigger/Timer/interface/ProcessCallGraph.h"
 
+// local headers
+#include "perf_counters.h"
+
 
 /*
 procesing time is divided into
@@ -203,6 +207,7 @@ private:
     boost::chrono::high_resolution_clock::time_point time_real;
     uint64_t                                         allocated;
     uint64_t                                         deallocated;
+    perf_counters::values                            counters;
   };
 
   // highlight a group of modules
@@ -225,6 +230,7 @@ private:
     boost::chrono::nanoseconds time_real;
     uint64_t                   allocated;
     uint64_t                   deallocated;
+    perf_counters::values      counters;
   };
 
   // atomic version of Resources
@@ -243,6 +249,7 @@ private:
     std::atomic<boost::chrono::nanoseconds::rep> time_real;
     std::atomic<uint64_t> allocated;
     std::atomic<uint64_t> deallocated;
+    std::array<std::atomic<uint64_t>, perf_counters::size> counters;
   };
 
   struct ResourcesPerModule {
@@ -330,6 +337,10 @@ private:
     ConcurrentMonitorElement allocated_byls_;       // TProfile
     ConcurrentMonitorElement deallocated_;          // TH1F
     ConcurrentMonitorElement deallocated_byls_;     // TProfile
+    // hardware counters, if enabled
+    ConcurrentMonitorElement ipc_;                  // TH1F
+    ConcurrentMonitorElement llc_mpki_;             // TH1F
+    ConcurrentMonitorElement branch_mpki_;          // TH1F
   };
 
   // plots associated to each path or endpath
@@ -355,6 +366,11 @@ private:
     ConcurrentMonitorElement module_time_real_total_;       // TH1D
     ConcurrentMonitorElement module_allocated_total_;       // TH1D
     ConcurrentMonitorElement module_deallocated_total_;     // TH1D
+    // hardware counters in each module and their dependencies, if enabled
+    ConcurrentMonitorElement module_cycles_total_;          // TH1D
+    ConcurrentMonitorElement module_instructions_total_;    // TH1D
+    ConcurrentMonitorElement module_llc_misses_total_;      // TH1D
+    ConcurrentMonitorElement module_branch_misses_total_;   // TH1D
   };
 
   class PlotsPerProcess {
@@ -495,6 +511,12 @@ private:
   template <typename T>
   void printPathSummaryLine(T& out, Resources const& data, Resources const& total, uint64_t events, std::string const& label) const;
 
+  template <typename T>
+  void printCountersHeader(T& out, std::string const& label) const;
+
+  template <typename T>
+  void printCountersLine(T& out, Resources const& data, uint64_t events, std::string const& label) const;
+
   template <typename T>
   void printSummary(T& out, ResourcesPerJob const& data, std::string const& label) const;
 
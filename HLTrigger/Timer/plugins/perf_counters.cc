@@ -0,0 +1,129 @@
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "perf_counters.h"
+
+namespace {
+  bool enabled = false;
+
+  constexpr uint64_t events[perf_counters::size] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,     // last level cache misses
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  // layout of the data read from the group leader, with PERF_FORMAT_GROUP
+  struct read_format {
+    uint64_t nr;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    uint64_t values[perf_counters::size];
+  };
+
+  int perf_event_open(perf_event_attr * attr, int group_fd)
+  {
+    // measure the calling thread, on any cpu
+    return ::syscall(__NR_perf_event_open, attr, 0, -1, group_fd, 0);
+  }
+
+  // the counters of one thread, all in the same group so that they are scheduled together
+  struct thread_counters {
+    thread_counters() :
+      fds{ -1, -1, -1, -1 }
+    {
+      if (enabled)
+        open();
+    }
+
+    ~thread_counters()
+    {
+      for (int fd: fds)
+        if (fd != -1)
+          ::close(fd);
+    }
+
+    bool open()
+    {
+      for (unsigned int i = 0; i < perf_counters::size; ++i) {
+        perf_event_attr attr;
+        std::memset(& attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.config         = events[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fds[i] = perf_event_open(& attr, i == 0 ? -1 : fds[0]);
+        if (fds[i] == -1) {
+          // close the counters opened so far, preserving errno for the caller
+          int error = errno;
+          for (unsigned int j = 0; j < i; ++j) {
+            ::close(fds[j]);
+            fds[j] = -1;
+          }
+          errno = error;
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool valid() const
+    {
+      return fds[perf_counters::size - 1] != -1;
+    }
+
+    void read(perf_counters::values & counts) const
+    {
+      read_format data;
+      if (not valid() or ::read(fds[0], & data, sizeof(data)) != sizeof(data) or data.time_running == 0) {
+        counts.fill(0);
+        return;
+      }
+      // scale the counts if the group has been multiplexed with other events
+      double scale = (double) data.time_enabled / data.time_running;
+      for (unsigned int i = 0; i < perf_counters::size; ++i)
+        counts[i] = data.time_enabled == data.time_running ? data.values[i] : (uint64_t) (data.values[i] * scale);
+    }
+
+    int fds[perf_counters::size];
+  };
+
+  thread_counters & local_counters()
+  {
+    thread_local thread_counters counters;
+    return counters;
+  }
+
+} // namespace
+
+bool perf_counters::enable()
+{
+  enabled = true;
+  // check that the counters can be opened in the current thread
+  if (not local_counters().valid() and not local_counters().open()) {
+    edm::LogWarning("FastTimerService") << "The hardware performance counters are not available: " << std::strerror(errno) << ".\n"
+      << "Check the value of /proc/sys/kernel/perf_event_paranoid .";
+    enabled = false;
+  }
+  return enabled;
+}
+
+bool perf_counters::is_available()
+{
+  return enabled;
+}
+
+void perf_counters::read(values & counts)
+{
+  if (enabled)
+    local_counters().read(counts);
+  else
+    counts.fill(0);
+}
@@ -0,0 +1,29 @@
+#ifndef perf_counters_h
+#define perf_counters_h
+
+#include <array>
+#include <cstdint>
+
+// per-thread hardware performance counters, read through perf_event_open(2)
+class perf_counters {
+public:
+  enum counter {
+    cycles,
+    instructions,
+    llc_misses,
+    branch_misses,
+    size
+  };
+
+  using values = std::array<uint64_t, size>;
+
+  // try to enable the counters; this fails if the kernel does not allow
+  // unprivileged users to read them (see /proc/sys/kernel/perf_event_paranoid)
+  static bool enable();
+  static bool is_available();
+
+  // read the counters of the current thread, or zeros if they are not available
+  static void read(values & counts);
+};
+
+#endif // perf_counters_h
@@ -4,8 +4,11 @@ Holder for an input TFile.
 #include "TList.h"
 #include "TStreamerInfo.h"
 #include "TClass.h"
+#include "TTree.h"
 #include "InputFile.h"
 
+#include "DataFormats/Provenance/interface/BranchType.h"
+
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/ExceptionPropagate.h"
@@ -97,6 +100,31 @@ namespace edm {
     reportSvc->reportFallbackAttempt(pfn, logicalFileName, errorMessage);
   }
 
+  void
+  InputFile::warmMetaData(Long64_t maxBytes, std::atomic<bool> const* cancelled) {
+    if(!file_) {
+      return;
+    }
+    // Trees read entirely when the RootFile is constructed, smallest first.
+    std::string const* const metaTrees[] = {&poolNames::parentageTreeName(),
+                                            &poolNames::parameterSetsTreeName(),
+                                            &poolNames::metaDataTreeName(),
+                                            &BranchTypeToProductTreeName(InRun),
+                                            &BranchTypeToProductTreeName(InLumi)};
+    for(auto const* name : metaTrees) {
+      if(cancelled != nullptr && *cancelled) {
+        return;
+      }
+      TTree* tree = dynamic_cast<TTree*>(file_->Get(name->c_str()));
+      if(tree != nullptr && tree->GetZipBytes() <= maxBytes) {
+        tree->LoadBaskets(maxBytes);
+        maxBytes -= tree->GetZipBytes();
+      }
+    }
+    // Only the header of the event tree; its baskets are read through the TTreeCache.
+    file_->Get(BranchTypeToProductTreeName(InEvent).c_str());
+  }
+
   void
   InputFile::Close() {
     if(file_->IsOpen()) {
@@ -11,6 +11,7 @@ Holder for an input TFile.
 
 #include "TFile.h"
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
@@ -43,6 +44,11 @@ namespace edm {
     static void reportReadBranches();
     static void reportReadBranch(InputType inputType, std::string const& branchname);
 
+    // Read the tree headers and the small metadata trees needed to initialize the file,
+    // reading at most maxBytes of metadata baskets.  Used when a file is opened ahead of time;
+    // stops before the next tree once *cancelled is set.
+    void warmMetaData(Long64_t maxBytes, std::atomic<bool> const* cancelled = nullptr);
+
     TObject* Get(char const* name) {return file_->Get(name);}
     TFileCacheRead* GetCacheRead() const {return file_->GetCacheRead();}
     void SetCacheRead(TFileCacheRead* tfcr) {file_->SetCacheRead(tfcr, nullptr, TFile::kDoNotDisconnect);}
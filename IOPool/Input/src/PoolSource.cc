@@ -8,6 +8,7 @@
 #include "DataFormats/Common/interface/ThinnedAssociation.h"
 #include "DataFormats/Provenance/interface/BranchDescription.h"
 #include "DataFormats/Provenance/interface/IndexIntoFile.h"
+#include "DataFormats/Provenance/interface/ModuleDescription.h"
 #include "DataFormats/Provenance/interface/ProductRegistry.h"
 #include "DataFormats/Provenance/interface/ThinnedAssociationsHelper.h"
 #include "FWCore/Framework/interface/EventPrincipal.h"
@@ -20,6 +21,9 @@
 #include "FWCore/Framework/interface/RunPrincipal.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "FWCore/ServiceRegistry/interface/ConsumesInfo.h"
+#include "FWCore/ServiceRegistry/interface/PathsAndConsumesOfModulesBase.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include "FWCore/Utilities/interface/InputType.h"
@@ -93,6 +97,10 @@ namespace edm {
     resourceSharedWithDelayedReaderPtr_ = std::make_unique<SharedResourcesAcquirer>(std::move(resources.first));
     mutexSharedWithDelayedReader_ = resources.second;
 
+    if (pset.getUntrackedParameter<bool>("primeCacheFromConsumes")) {
+      actReg()->watchPreBeginJob(this, &PoolSource::primeCacheFromConsumes);
+    }
+
     if (secondaryCatalog_.empty() && pset.getUntrackedParameter<bool>("needSecondaryFileNames", false)) {
       throw Exception(errors::Configuration, "PoolSource") << "'secondaryFileNames' must be specified\n";
     }
@@ -148,6 +156,35 @@ namespace edm {
 
   PoolSource::~PoolSource() {}
 
+  void
+  PoolSource::primeCacheFromConsumes(PathsAndConsumesOfModulesBase const& pathsAndConsumes, ProcessContext const&) {
+    ProductRegistry::ProductList const& productList = productRegistry()->productList();
+    std::set<BranchID> branchIDs;
+    for(auto const* module : pathsAndConsumes.allModules()) {
+      for(auto const& info : pathsAndConsumes.consumesInfo(module->id())) {
+        if(info.branchType() != InEvent) {
+          continue;
+        }
+        if(info.label().empty()) {
+          // consumesMany cannot be mapped to branches, so let the
+          // TTreeCache learn which branches are read, as usual.
+          return;
+        }
+        for(auto const& product : productList) {
+          BranchDescription const& desc = product.second;
+          if(desc.branchType() == InEvent && desc.present() && !desc.produced() &&
+             desc.moduleLabel() == info.label() &&
+             desc.productInstanceName() == info.instance() &&
+             (info.process().empty() || desc.processName() == info.process()) &&
+             (info.kindOfType() != PRODUCT_TYPE || desc.unwrappedTypeID() == info.type())) {
+            branchIDs.insert(desc.branchID());
+          }
+        }
+      }
+    }
+    primaryFileSequence_->setConsumedEventBranches(std::vector<BranchID>(branchIDs.begin(), branchIDs.end()));
+  }
+
   void
   PoolSource::endJob() {
     if(secondaryFileSequence_) secondaryFileSequence_->endJob();
@@ -327,6 +364,9 @@ namespace edm {
     desc.addUntracked<bool>("labelRawDataLikeMC", true)
         ->setComment("If True: replace module label for raw data to match MC. Also use 'LHC' as process.");
     desc.addUntracked<bool>("delayReadingEventProducts",true)->setComment("If True: do not read a data product from the file until it is requested. If False: all event data products are read upfront.");
+    desc.addUntracked<bool>("primeCacheFromConsumes", false)
+        ->setComment("If True: fill the event TTreeCache with the branches of the products declared in the consumes of the modules, instead of learning them from the first events read.\n"
+                     "Products read without a declaration are still cached by the trigger cache. Ignored if a module uses consumesMany.");
     ProductSelectorRules::fillDescription(desc, "inputCommands");
     InputSource::fillDescription(desc);
     RootPrimaryFileSequence::fillDescription(desc);
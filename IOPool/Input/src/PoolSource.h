@@ -24,6 +24,8 @@ PoolSource: This is an InputSource
 namespace edm {
 
   class ConfigurationDescriptions;
+  class PathsAndConsumesOfModulesBase;
+  class ProcessContext;
   class FileCatalogItem;
   class RootPrimaryFileSequence;
   class RootSecondaryFileSequence;
@@ -68,6 +70,8 @@ namespace edm {
     ProcessingController::ReverseState reverseState_() const override;
 
     std::pair<SharedResourcesAcquirer*,std::recursive_mutex*> resourceSharedWithDelayedReader_() override;
+
+    void primeCacheFromConsumes(PathsAndConsumesOfModulesBase const& pathsAndConsumes, ProcessContext const&);
     
     RootServiceChecker rootServiceChecker_;
     InputFileCatalog catalog_;
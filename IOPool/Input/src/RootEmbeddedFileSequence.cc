@@ -336,5 +336,17 @@ namespace edm {
         ->setComment("Skip the first 'skipEvents' events. Used only if 'sequential' is True and 'sameLumiBlock' is False");
     desc.addUntracked<unsigned int>("cacheSize", roottree::defaultCacheSize)
         ->setComment("Size of ROOT TTree prefetch cache.  Affects performance.");
+    desc.addUntracked<unsigned int>("poolSize", 0U)
+        ->setComment("Read by the MixingModule.  If > 0, the pileup events are read ahead into a pool of this many fully\n"
+                     "decoded events shared by all the streams, from which they are drawn at random (see PileUpEventPool).\n"
+                     "WARNING: with a pool and several streams, the events mixed with a signal event depend on the order in\n"
+                     "which the streams process their events, so the job is NOT reproducible from its random number seeds:\n"
+                     "playing back the mixing (playback mode of the MixingModule) is then the only way to reproduce it.\n"
+                     "With a single stream, the job is reproducible from its seeds.\n"
+                     "Cannot be used with 'sequential' or 'sameLumiBlock'.\n"
+                     "0: the pileup events are read by each stream for each signal event.");
+    desc.addUntracked<unsigned int>("poolMaxReuse", 1U)
+        ->setComment("Read by the MixingModule.  Maximum number of signal events each event of the pool is mixed with.\n"
+                     "Used only if 'poolSize' > 0.");
   }
 }
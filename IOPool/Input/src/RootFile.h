@@ -90,7 +90,8 @@ namespace edm {
              bool bypassVersionCheck,
              bool labelRawDataLikeMC,
              bool usingGoToEvent,
-             bool enablePrefetching);
+             bool enablePrefetching,
+             bool enableParallelUnzip = false);
 
     RootFile(std::string const& fileName,
              ProcessConfiguration const& processConfiguration,
@@ -214,6 +215,7 @@ namespace edm {
     IndexIntoFile::IndexIntoFileItr indexIntoFileIter() const;
     void setPosition(IndexIntoFile::IndexIntoFileItr const& position);
     void initAssociationsFromSecondary(std::vector<BranchID> const&);
+    unsigned int primeEventCache(std::vector<BranchID> const& branchIDs) {return eventTree_.primeCache(branchIDs);}
 
     void setSignals(signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* preEventReadSource,
                     signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* postEventReadSource);
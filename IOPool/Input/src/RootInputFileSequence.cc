@@ -9,10 +9,17 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Concurrency/interface/FunctorTask.h"
+#include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
 #include "Utilities/StorageFactory/interface/StorageFactory.h"
 
 #include "TSystem.h"
 
+#include "tbb/task.h"
+
+#include <algorithm>
+#include <chrono>
+
 namespace edm {
   class BranchIDListHelper;
   class EventPrincipal;
@@ -32,7 +39,11 @@ namespace edm {
     fileIter_(fileIterEnd_),
     fileIterLastOpened_(fileIterEnd_),
     rootFile_(),
-    indexesIntoFiles_(fileCatalogItems().size()) {
+    indexesIntoFiles_(fileCatalogItems().size()),
+    fileLookahead_(0U),
+    lookaheadMemoryBudget_(0U),
+    prefetchedFiles_(),
+    cancelledFiles_() {
   }
 
   std::vector<FileCatalogItem> const&
@@ -53,6 +64,17 @@ namespace edm {
   }
 
   RootInputFileSequence::~RootInputFileSequence() {
+    // The background tasks use this job's services, so they must not outlive it.  The
+    // tasks that have not started are claimed here and will do nothing.  The others stop
+    // as soon as their TFile::Open returns: the wait is bounded by one file open, i.e. by
+    // the timeout of the storage system.
+    for(auto& prefetched : prefetchedFiles_) {
+      cancelPrefetchedFile(std::move(prefetched.second));
+    }
+    prefetchedFiles_.clear();
+    for(auto const& cancelled : cancelledFiles_) {
+      cancelled.file.wait();
+    }
   }
 
   std::shared_ptr<RunAuxiliary>
@@ -235,8 +257,11 @@ namespace edm {
     std::list<std::string> originalInfo;
     try {
       std::unique_ptr<InputSource::FileOpenSentry> sentry(input ? std::make_unique<InputSource::FileOpenSentry>(*input, lfn_, usedFallback_) : nullptr);
-      std::unique_ptr<char[]> name(gSystem->ExpandPathName(fileName().c_str()));;
-      filePtr = std::make_shared<InputFile>(name.get(), "  Initiating request to open file ", inputType);
+      filePtr = takePrefetchedFile(fileIter_ - fileIterBegin_);
+      if(!filePtr) {
+        std::unique_ptr<char[]> name(gSystem->ExpandPathName(fileName().c_str()));;
+        filePtr = std::make_shared<InputFile>(name.get(), "  Initiating request to open file ", inputType);
+      }
     }
     catch (cms::Exception const& e) {
       if(!skipBadFiles) {
@@ -297,6 +322,7 @@ namespace edm {
       fileIterLastOpened_ = fileIter_;
       setIndexIntoFile(currentIndexIntoFile);
       rootFile_->reportOpened(inputTypeName);
+      prefetchNextFiles(inputType);
     } else {
       InputFile::reportSkippedFile(fileName(), logicalFileName());
       if(!skipBadFiles) {
@@ -312,4 +338,109 @@ namespace edm {
    indexesIntoFiles_[index] = rootFile()->indexIntoFileSharedPtr();
   }
 
+  std::shared_ptr<InputFile>
+  RootInputFileSequence::takePrefetchedFile(size_t index) {
+    auto it = prefetchedFiles_.find(index);
+    if(it == prefetchedFiles_.end()) {
+      return std::shared_ptr<InputFile>();
+    }
+    auto prefetched = std::move(it->second);
+    prefetchedFiles_.erase(it);
+    if(prefetched.state->claim()) {
+      // The task has not started, e.g. because all the threads are busy: rather than
+      // waiting for a thread, the file is opened here.
+      return std::shared_ptr<InputFile>();
+    }
+    try {
+      return prefetched.file.get();
+    } catch(...) {
+      // Open the file again synchronously so that the failure is
+      // reported, and the fallback is tried, in the usual way.
+      return std::shared_ptr<InputFile>();
+    }
+  }
+
+  void
+  RootInputFileSequence::prefetchNextFiles(InputType inputType) {
+    if(fileLookahead_ == 0U) {
+      return;
+    }
+    size_t const current = fileIter_ - fileIterBegin_;
+    size_t const last = std::min(current + fileLookahead_, numberOfFiles() - 1);
+    // Cancel files no longer ahead of the current one, e.g. after a rewind or a skip.
+    for(auto it = prefetchedFiles_.begin(); it != prefetchedFiles_.end();) {
+      if(it->first <= current || it->first > last) {
+        cancelPrefetchedFile(std::move(it->second));
+        it = prefetchedFiles_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    cancelledFiles_.erase(std::remove_if(cancelledFiles_.begin(), cancelledFiles_.end(), [](PrefetchedFile const& cancelled) {
+                                           return cancelled.file.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                                         }),
+                          cancelledFiles_.end());
+    Long64_t const budget = lookaheadMemoryBudget_ / fileLookahead_;
+    ServiceToken token = ServiceRegistry::instance().presentToken();
+    for(size_t index = current + 1; index <= last; ++index) {
+      FileCatalogItem const& item = fileCatalogItems()[index];
+      if(item.fileName().empty() || prefetchedFiles_.find(index) != prefetchedFiles_.end()) {
+        continue;
+      }
+      std::unique_ptr<char[]> name(gSystem->ExpandPathName(item.fileName().c_str()));
+      std::string fullName(name.get());
+      auto state = std::make_shared<PrefetchState>();
+      state->token = token;
+      PrefetchedFile prefetched{state, state->file.get_future()};
+      // Enqueued rather than spawned, so that the open waits behind the work already
+      // queued for the streams instead of preempting it.
+      tbb::task::enqueue(*make_functor_task(tbb::task::allocate_root(), [state, fullName, inputType, budget]() {
+        if(state->claimed.exchange(true)) {
+          return;
+        }
+        ServiceToken token(state->token);
+        state->token = ServiceToken();
+        //need to make sure Service system is activated on the prefetching thread
+        ServiceRegistry::Operate guard(token);
+        // Released before the guard: if the sequence has already dropped the file, it
+        // is closed here with the services available.
+        auto file = std::move(state->file);
+        try {
+          std::shared_ptr<InputFile> filePtr;
+          if(!state->cancelled) {
+            filePtr = std::make_shared<InputFile>(fullName.c_str(), "  Initiating read-ahead request to open file ", inputType);
+            filePtr->warmMetaData(budget, &state->cancelled);
+          }
+          if(state->cancelled) {
+            // The file is closed here, in the background.
+            filePtr.reset();
+          }
+          file.set_value(std::move(filePtr));
+        } catch(...) {
+          file.set_exception(std::current_exception());
+        }
+      }));
+      prefetchedFiles_.emplace(index, std::move(prefetched));
+    }
+  }
+
+  void
+  RootInputFileSequence::cancelPrefetchedFile(PrefetchedFile&& prefetched) {
+    if(prefetched.state->claim()) {
+      return;
+    }
+    prefetched.state->cancelled = true;
+    cancelledFiles_.push_back(std::move(prefetched));
+  }
+
+  bool
+  RootInputFileSequence::PrefetchState::claim() {
+    if(claimed.exchange(true)) {
+      return false;
+    }
+    token = ServiceToken();
+    file.set_value(std::shared_ptr<InputFile>());
+    return true;
+  }
+
 }
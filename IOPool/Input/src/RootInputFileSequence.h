@@ -10,9 +10,13 @@ RootInputFileSequence: This is an InputSource
 #include "InputFile.h"
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "FWCore/Catalog/interface/InputFileCatalog.h"
+#include "FWCore/ServiceRegistry/interface/ServiceToken.h"
 #include "FWCore/Utilities/interface/InputType.h"
 #include "FWCore/Utilities/interface/get_underlying_safe.h"
 
+#include <atomic>
+#include <future>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -72,6 +76,14 @@ namespace edm {
 
     std::vector<std::shared_ptr<IndexIntoFile> > const& indexesIntoFiles() const {return indexesIntoFiles_;}
     void setIndexIntoFile(size_t index);
+    // Open up to nFiles input files ahead of the current one in the background.
+    // memoryBudget bounds the metadata read ahead of time, summed over those files.
+    // Files skipped over are not waited for; at the end of the job the sequence waits
+    // only for the opens still in progress (see ~RootInputFileSequence).
+    void setFileLookahead(unsigned int nFiles, unsigned long long memoryBudget) {
+      fileLookahead_ = nFiles;
+      lookaheadMemoryBudget_ = memoryBudget;
+    }
     size_t lfnHash() const {return lfnHash_;}
     bool usedFallback() const {return usedFallback_;}
 
@@ -89,8 +101,32 @@ namespace edm {
     std::vector<FileCatalogItem>::const_iterator fileIterLastOpened_;
     edm::propagate_const<RootFileSharedPtr> rootFile_;
     std::vector<std::shared_ptr<IndexIntoFile> > indexesIntoFiles_;
+    unsigned int fileLookahead_;
+    unsigned long long lookaheadMemoryBudget_;
+    // A file opened in the background by a TBB task.  The task runs only if it sets
+    // 'claimed' before the sequence does, so a task that has not started is never waited
+    // for.  Once 'cancelled' is set, a running task stops at its next step and closes the
+    // file, but an open in progress cannot be interrupted.
+    struct PrefetchState {
+      std::atomic<bool> claimed{false};
+      std::atomic<bool> cancelled{false};
+      ServiceToken token;
+      std::promise<std::shared_ptr<InputFile>> file;
+      // true if the task had not started; it will then do nothing
+      bool claim();
+    };
+    struct PrefetchedFile {
+      std::shared_ptr<PrefetchState> state;
+      std::future<std::shared_ptr<InputFile>> file;
+    };
+    std::map<size_t, PrefetchedFile> prefetchedFiles_;
+    // cancelled, kept until their task ends so that dropping them does not block
+    std::vector<PrefetchedFile> cancelledFiles_;
 
   private:
+    std::shared_ptr<InputFile> takePrefetchedFile(size_t index);
+    void prefetchNextFiles(InputType inputType);
+    void cancelPrefetchedFile(PrefetchedFile&& prefetched);
     virtual RootFileSharedPtr makeRootFile(std::shared_ptr<InputFile> filePtr) = 0; 
     virtual void initFile_(bool skipBadFiles) = 0;
     virtual void closeFile_() = 0;
@@ -12,11 +12,16 @@
 #include "FWCore/Catalog/interface/InputFileCatalog.h"
 #include "FWCore/Catalog/interface/SiteLocalConfig.h"
 #include "FWCore/Framework/interface/FileBlock.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "Utilities/StorageFactory/interface/StorageFactory.h"
 
+#include "TTreeCacheUnzip.h"
+
+#include <mutex>
+
 namespace edm {
   RootPrimaryFileSequence::RootPrimaryFileSequence(
                 ParameterSet const& pset,
@@ -27,13 +32,15 @@ namespace edm {
     firstFile_(true),
     branchesMustMatch_(BranchDescription::Permissive),
     orderedProcessHistoryIDs_(),
+    consumedEventBranches_(),
     eventSkipperByID_(EventSkipperByID::create(pset).release()),
     initialNumberOfEventsToSkip_(pset.getUntrackedParameter<unsigned int>("skipEvents")),
     noEventSort_(pset.getUntrackedParameter<bool>("noEventSort")),
     treeCacheSize_(noEventSort_ ? pset.getUntrackedParameter<unsigned int>("cacheSize") : 0U),
     duplicateChecker_(new DuplicateChecker(pset)),
     usingGoToEvent_(false),
-    enablePrefetching_(false) {
+    enablePrefetching_(false),
+    enableParallelUnzip_(pset.getUntrackedParameter<bool>("enableParallelUnzip")) {
 
     // The SiteLocalConfig controls the TTreeCache size and the prefetching settings.
     Service<SiteLocalConfig> pSLC;
@@ -44,6 +51,20 @@ namespace edm {
       enablePrefetching_ = pSLC->enablePrefetching();
     }
 
+    setFileLookahead(pset.getUntrackedParameter<unsigned int>("fileLookahead"),
+                     pset.getUntrackedParameter<unsigned int>("fileLookaheadMemoryBudget") * 1024ULL * 1024ULL);
+
+    // A TTreeCacheUnzip only unzips in parallel if the process-wide mode of ROOT is
+    // enabled when it is created.  The mode is set once, before the first file is opened,
+    // and never reset, so that sources opening files concurrently do not race on it.
+    // RootTree chooses the kind of each of its caches itself.
+    if(enableParallelUnzip_) {
+      static std::once_flag parallelUnzipOnce;
+      std::call_once(parallelUnzipOnce, [] {
+        TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::kEnable);
+      });
+    }
+
     std::string branchesMustMatch = pset.getUntrackedParameter<std::string>("branchesMustMatch", std::string("permissive"));
     if(branchesMustMatch == std::string("strict")) branchesMustMatch_ = BranchDescription::Strict;
 
@@ -109,6 +130,24 @@ namespace edm {
     // If we can't delete all of it, then we can delete the parts we do not need.
     bool deleteIndexIntoFile = !usingGoToEvent_ && !(duplicateChecker_ && duplicateChecker_->checkingAllFiles() && !duplicateChecker_->checkDisabled());
     initTheFile(skipBadFiles, deleteIndexIntoFile, &input_, "primaryFiles", InputType::Primary);
+    if(rootFile() && !consumedEventBranches_.empty()) {
+      primeEventCache();
+    }
+  }
+
+  void
+  RootPrimaryFileSequence::setConsumedEventBranches(std::vector<BranchID> const& branchIDs) {
+    consumedEventBranches_ = branchIDs;
+    if(rootFile()) {
+      primeEventCache();
+    }
+  }
+
+  void
+  RootPrimaryFileSequence::primeEventCache() {
+    unsigned int primed = rootFile()->primeEventCache(consumedEventBranches_);
+    LogInfo("PoolSource") << "Event TTreeCache of " << fileName() << " primed from the declared consumes with "
+                          << primed << " product branch(es)\n";
   }
 
   RootPrimaryFileSequence::RootFileSharedPtr
@@ -143,7 +182,8 @@ namespace edm {
           input_.bypassVersionCheck(),
           input_.labelRawDataLikeMC(),
           usingGoToEvent_,
-          enablePrefetching_);
+          enablePrefetching_,
+          enableParallelUnzip_);
   }
 
   bool RootPrimaryFileSequence::nextFile() {
@@ -330,6 +370,20 @@ namespace edm {
                      "Note 3: Any sorting occurs independently in each input file (no sorting across input files).");
     desc.addUntracked<unsigned int>("cacheSize", roottree::defaultCacheSize)
         ->setComment("Size of ROOT TTree prefetch cache.  Affects performance.");
+    desc.addUntracked<bool>("enableParallelUnzip", false)
+        ->setComment("True:  When the event TTreeCache is filled, ROOT starts TBB tasks that decompress its baskets ahead of use.\n"
+                     "       These tasks run outside the lock shared with the source, concurrently with the other streams.\n"
+                     "       Reading the entries, including the streaming of the products and the decompression of any basket\n"
+                     "       the tasks have not reached yet, still happens while holding that lock.\n"
+                     "       Requires ROOT IMT (see InitRootHandlers) and a non-zero 'cacheSize'.\n"
+                     "False: Baskets are decompressed when they are read, while holding the lock shared with the source.\n"
+                     "Note: This enables the parallel unzip mode of ROOT for the whole process, which also applies to\n"
+                     "      caches made through TTree::SetCacheSize outside of PoolSource.");
+    desc.addUntracked<unsigned int>("fileLookahead", 0U)
+        ->setComment("Number of input files opened in the background ahead of the file being read.\n"
+                     "Hides the latency of opening remote files at file boundaries. 0 disables the read-ahead.");
+    desc.addUntracked<unsigned int>("fileLookaheadMemoryBudget", 100U)
+        ->setComment("Maximum size, in MB, of the metadata read in advance, summed over all files opened ahead of time.");
     std::string defaultString("permissive");
     desc.addUntracked<std::string>("branchesMustMatch", defaultString)
         ->setComment("'strict':     Branches in each input file must match those in the first file.\n"
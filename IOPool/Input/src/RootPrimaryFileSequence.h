@@ -48,12 +48,14 @@ namespace edm {
     bool skipEvents(int offset);
     bool goToEvent(EventID const& eventID);
     void rewind_();
+    void setConsumedEventBranches(std::vector<BranchID> const& branchIDs);
     static void fillDescription(ParameterSetDescription & desc);
     ProcessingController::ForwardState forwardState() const;
     ProcessingController::ReverseState reverseState() const;
   private:
     void initFile_(bool skipBadFiles) override;
     RootFileSharedPtr makeRootFile(std::shared_ptr<InputFile> filePtr) override; 
+    void primeEventCache();
     bool nextFile();
     bool previousFile();
     void rewindFile();
@@ -65,6 +67,7 @@ namespace edm {
     bool firstFile_;
     BranchDescription::MatchMode branchesMustMatch_;
     std::vector<ProcessHistoryID> orderedProcessHistoryIDs_;
+    std::vector<BranchID> consumedEventBranches_;
 
     std::shared_ptr<EventSkipperByID const> eventSkipperByID() const {return get_underlying_safe(eventSkipperByID_);}
     std::shared_ptr<EventSkipperByID>& eventSkipperByID() {return get_underlying_safe(eventSkipperByID_);}
@@ -78,6 +81,7 @@ namespace edm {
     edm::propagate_const<std::shared_ptr<DuplicateChecker>> duplicateChecker_;
     bool usingGoToEvent_;
     bool enablePrefetching_;
+    bool enableParallelUnzip_;
   }; // class RootPrimaryFileSequence
 }
 #endif
@@ -7,6 +7,7 @@
 #include "TTree.h"
 #include "TTreeIndex.h"
 #include "TTreeCache.h"
+#include "TTreeCacheUnzip.h"
 
 #include <cassert>
 #include <iostream>
@@ -24,6 +25,16 @@ namespace edm {
       TBranch* branch = tree->GetBranch(BranchTypeToBranchEntryInfoBranchName(branchType).c_str());
       return branch;
     }
+    // Creates a cache for the tree, of the kind asked for.  TTree::SetCacheSize would
+    // make a TTreeCacheUnzip whenever the process-wide unzip mode of ROOT is enabled
+    // (see RootPrimaryFileSequence), whichever source or cache it is.  As with
+    // SetCacheSize, the constructor attaches the new cache to the file.
+    TTreeCache* makeTreeCache(TTree* tree, Long64_t cacheSize, bool parallelUnzip = false) {
+      if(parallelUnzip) {
+        return new TTreeCacheUnzip(tree, static_cast<Int_t>(cacheSize));
+      }
+      return new TTreeCache(tree, static_cast<Int_t>(cacheSize));
+    }
   }
   RootTree::RootTree(std::shared_ptr<InputFile> filePtr,
                      BranchType const& branchType,
@@ -32,7 +43,8 @@ namespace edm {
                      unsigned int cacheSize,
                      unsigned int learningEntries,
                      bool enablePrefetching,
-                     InputType inputType) :
+                     InputType inputType,
+                     bool enableParallelUnzip) :
     filePtr_(filePtr),
     tree_(dynamic_cast<TTree*>(filePtr_.get() != nullptr ? filePtr_->Get(BranchTypeToProductTreeName(branchType).c_str()) : nullptr)),
     metaTree_(dynamic_cast<TTree*>(filePtr_.get() != nullptr ? filePtr_->Get(BranchTypeToMetaDataTreeName(branchType).c_str()) : nullptr)),
@@ -57,6 +69,7 @@ namespace edm {
     cacheSize_(cacheSize),
     treeAutoFlush_(0),
     enablePrefetching_(enablePrefetching),
+    enableParallelUnzip_(enableParallelUnzip),
     enableTriggerCache_(branchType_ == InEvent),
     rootDelayedReader_(new RootDelayedReader(*this, filePtr, inputType)),
     branchEntryInfoBranch_(metaTree_ ? getProductProvenanceBranch(metaTree_, branchType_) : (tree_ ? getProductProvenanceBranch(tree_, branchType_) : nullptr)),
@@ -180,8 +193,8 @@ namespace edm {
   void
   RootTree::setCacheSize(unsigned int cacheSize) {
     cacheSize_ = cacheSize;
-    tree_->SetCacheSize(static_cast<Long64_t>(cacheSize));
-    treeCache_.reset(dynamic_cast<TTreeCache*>(filePtr_->GetCacheRead()));
+    // Only the primary cache may unzip in parallel; the raw and trigger caches stay plain TTreeCaches.
+    treeCache_.reset(makeTreeCache(tree_, static_cast<Long64_t>(cacheSize), enableParallelUnzip_));
     if(treeCache_) treeCache_->SetEnablePrefetching(enablePrefetching_);
     filePtr_->SetCacheRead(nullptr);
     rawTreeCache_.reset();
@@ -293,8 +306,7 @@ namespace edm {
 
       // ROOT will automatically expand the cache to fit one cluster; hence, we use
       // 5 MB as the cache size below
-      tree_->SetCacheSize(static_cast<Long64_t>(5*1024*1024));
-      rawTriggerTreeCache_.reset(dynamic_cast<TTreeCache*>(filePtr_->GetCacheRead()));
+      rawTriggerTreeCache_.reset(makeTreeCache(tree_, static_cast<Long64_t>(5*1024*1024)));
       if(rawTriggerTreeCache_) rawTriggerTreeCache_->SetEnablePrefetching(false);
       TObjArray *branches = tree_->GetListOfBranches();
       int branchCount = branches->GetEntriesFast();
@@ -325,8 +337,7 @@ namespace edm {
         performedSwitchOver_ = true; 
         
         // Train the triggerCache
-        tree_->SetCacheSize(static_cast<Long64_t>(5*1024*1024));
-        triggerTreeCache_.reset(dynamic_cast<TTreeCache*>(filePtr_->GetCacheRead()));
+        triggerTreeCache_.reset(makeTreeCache(tree_, static_cast<Long64_t>(5*1024*1024)));
         triggerTreeCache_->SetEnablePrefetching(false);
         triggerTreeCache_->SetLearnEntries(0);
         triggerTreeCache_->SetEntryRange(entryNumber, tree_->GetEntries());
@@ -408,8 +419,7 @@ namespace edm {
     assert(branchType_ == InEvent);
     assert(!rawTreeCache_);
     treeCache_->SetLearnEntries(learningEntries_);
-    tree_->SetCacheSize(static_cast<Long64_t>(cacheSize_));
-    rawTreeCache_.reset(dynamic_cast<TTreeCache *>(filePtr_->GetCacheRead()));
+    rawTreeCache_.reset(makeTreeCache(tree_, static_cast<Long64_t>(cacheSize_)));
     rawTreeCache_->SetEnablePrefetching(false);
     filePtr_->SetCacheRead(nullptr);
     rawTreeCache_->SetLearnEntries(0);
@@ -497,6 +507,50 @@ namespace edm {
  
   }
   
+  unsigned int
+  RootTree::primeCache(std::vector<BranchID> const& branchIDs) {
+    // Fill the cache with the branches we know will be read, instead of
+    // learning them over the first learningEntries_ entries.  Branches read
+    // but not listed here are handled by the trigger cache as usual.
+    if (cacheSize_ == 0 || !treeCache_) {
+      return 0;
+    }
+    std::vector<TBranch*> branches;
+    branches.reserve(branchIDs.size());
+    for(auto const& branchID : branchIDs) {
+      auto info = branches_.find(branchID);
+      if(info != nullptr && info->productBranch_ != nullptr) {
+        branches.push_back(info->productBranch_);
+      }
+    }
+    if(branches.empty()) {
+      return 0;
+    }
+    trainNow_ = false;
+    rawTreeCache_.reset();
+    EntryNumber const start = (entryNumber_ < 0 ? 0 : entryNumber_);
+    filePtr_->SetCacheRead(treeCache_.get());
+    treeCache_->StartLearningPhase();
+    treeCache_->SetEntryRange(start, tree_->GetEntries());
+    if (filePtr_->Get(poolNames::branchListIndexesBranchName().c_str()) != nullptr) {
+      treeCache_->AddBranch(poolNames::branchListIndexesBranchName().c_str(), kTRUE);
+    }
+    treeCache_->AddBranch(BranchTypeToAuxiliaryBranchName(branchType_).c_str(), kTRUE);
+    trainedSet_.clear();
+    triggerSet_.clear();
+    rawTriggerSwitchOverEntry_ = -1;
+    for(auto branch : branches) {
+      treeCache_->AddBranch(branch, kTRUE);
+      trainedSet_.insert(branch);
+    }
+    treeCache_->StopLearningPhase();
+    filePtr_->SetCacheRead(nullptr);
+    // Marks the cache as trained, as stopTraining() would have.
+    switchOverEntry_ = start;
+    assert(treeCache_->GetTree() == tree_);
+    return branches.size();
+  }
+
   void
   RootTree::setSignals(signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* preEventReadSource,
                        signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* postEventReadSource) {
@@ -533,8 +587,7 @@ namespace edm {
     std::unique_ptr<TTreeCache>
     trainCache(TTree* tree, InputFile& file, unsigned int cacheSize, char const* branchNames) {
       tree->LoadTree(0);
-      tree->SetCacheSize(cacheSize);
-      std::unique_ptr<TTreeCache> treeCache(dynamic_cast<TTreeCache*>(file.GetCacheRead()));
+      std::unique_ptr<TTreeCache> treeCache(makeTreeCache(tree, cacheSize));
       if (nullptr != treeCache.get()) {
         treeCache->StartLearningPhase();
         treeCache->SetEntryRange(0, tree->GetEntries());
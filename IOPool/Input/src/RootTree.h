@@ -105,7 +105,8 @@ namespace edm {
              unsigned int cacheSize,
              unsigned int learningEntries,
              bool enablePrefetching,
-             InputType inputType);
+             InputType inputType,
+             bool enableParallelUnzip = false);
     ~RootTree();
 
     RootTree(RootTree const&) = delete; // Disallow copying and moving
@@ -187,6 +188,8 @@ namespace edm {
     TTreeCache* checkTriggerCacheImpl(TBranch* branch, EntryNumber entryNumber) const;
     inline TTreeCache* selectCache(TBranch* branch, EntryNumber entryNumber) const;
     void trainCache(char const* branchNames);
+    // returns the number of product branches put in the cache
+    unsigned int primeCache(std::vector<BranchID> const& branchIDs);
     void resetTraining() {trainNow_ = true;}
 
     BranchType branchType() const {return branchType_;}
@@ -232,6 +235,10 @@ namespace edm {
 // Enable asynchronous I/O in ROOT (done in a separate thread).  Only takes
 // effect on the primary treeCache_; all other caches have this explicitly disabled.
     bool enablePrefetching_;
+// Use a TTreeCacheUnzip as the primary treeCache_.  Raw basket bytes are still
+// fetched under the lock shared with the source, but the baskets are decompressed
+// by ROOT in TBB tasks (when IMT is enabled) instead of inline in TBranch::GetEntry.
+    bool enableParallelUnzip_;
     bool enableTriggerCache_;
     std::unique_ptr<RootDelayedReader> rootDelayedReader_;
 
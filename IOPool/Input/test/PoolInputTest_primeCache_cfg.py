@@ -0,0 +1,36 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTRECO")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+# TestPoolInput.sh checks the number of branches the cache is primed with
+process.MessageLogger = cms.Service("MessageLogger",
+    destinations = cms.untracked.vstring('cout'),
+    categories = cms.untracked.vstring('PoolSource'),
+    cout = cms.untracked.PSet(
+        threshold = cms.untracked.string('INFO'),
+        default = cms.untracked.PSet(
+            limit = cms.untracked.int32(0)
+        ),
+        PoolSource = cms.untracked.PSet(
+            limit = cms.untracked.int32(100000000)
+        )
+    )
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+process.OtherThing = cms.EDProducer("OtherThingProducer")
+
+# reads the Thing products through the primed cache, and throws if they
+# are not the ones written by PrePoolInputTest_cfg.py
+process.Analysis = cms.EDAnalyzer("OtherThingAnalyzer")
+
+process.source = cms.Source("PoolSource",
+    primeCacheFromConsumes = cms.untracked.bool(True),
+    setRunNumber = cms.untracked.uint32(621),
+    fileNames = cms.untracked.vstring('file:PoolInputTest.root')
+)
+
+process.p = cms.Path(process.OtherThing*process.Analysis)
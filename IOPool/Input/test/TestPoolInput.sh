@@ -11,6 +11,9 @@ cp PoolInputTest.root PoolInputOther.root
 cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputTest_cfg.py || die 'Failure using PoolInputTest_cfg.py' $?
 cmsRun  ${LOCAL_TEST_DIR}/PoolInputTest_noDelay_cfg.py >& ${LOCAL_TMP_DIR}/PoolInputTest_noDelay_cfg.txt || die 'Failure using PoolInputTest_noDelay_cfg.py' $?
 grep 'event delayed read from source' ${LOCAL_TMP_DIR}/PoolInputTest_noDelay_cfg.txt && die 'Failure in PoolInputTest_noDelay_cfg.py, found delay reads from source' 1
+cmsRun ${LOCAL_TEST_DIR}/PoolInputTest_primeCache_cfg.py >& ${LOCAL_TMP_DIR}/PoolInputTest_primeCache_cfg.txt || die 'Failure using PoolInputTest_primeCache_cfg.py' $?
+# OtherThingProducer consumes the Thing products, the only branch to prime
+grep -q 'primed from the declared consumes with 1 product branch' ${LOCAL_TMP_DIR}/PoolInputTest_primeCache_cfg.txt || die 'Failure in PoolInputTest_primeCache_cfg.py, the event TTreeCache was not primed with the Thing branch' 1
 
 cmsRun ${LOCAL_TEST_DIR}/PrePool2FileInputTest_cfg.py || die 'Failure using PrePool2FileInputTest_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/Pool2FileInputTest_cfg.py || die 'Failure using Pool2FileInputTest_cfg.py' $?
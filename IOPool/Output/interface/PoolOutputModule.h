@@ -59,6 +59,8 @@ namespace edm {
     unsigned int const& maxFileSize() const {return maxFileSize_;}
     int const& inputFileCount() const {return inputFileCount_;}
     int const& whyNotFastClonable() const {return whyNotFastClonable_;}
+    unsigned int eventsPerStreamBuffer() const {return eventsPerStreamBuffer_;}
+    unsigned int numberOfStreams() const {return numberOfStreams_;}
 
     std::string const& currentFileName() const;
 
@@ -133,6 +135,8 @@ namespace edm {
     virtual void doExtrasAfterCloseFile();
   private:
     void preActionBeforeRunEventAsync(WaitingTask* iTask, ModuleCallingContext const& iModuleCallingContext, Principal const& iPrincipal) const override;
+    void serializeEventAsync(WaitingTask* iTask, ModuleCallingContext const& iModuleCallingContext, EventPrincipal const& iPrincipal) const;
+    void preallocStreams(unsigned int nStreams) override;
 
     void openFile(FileBlock const& fb) override;
     void respondToOpenInputFile(FileBlock const& fb) override;
@@ -185,6 +189,8 @@ namespace edm {
     std::string basketOrder_;
     int const treeMaxVirtualSize_;
     int whyNotFastClonable_;
+    unsigned int const eventsPerStreamBuffer_;
+    unsigned int numberOfStreams_;
     DropMetaData dropMetaData_;
     std::string const moduleLabel_;
     bool initializedFromInput_;
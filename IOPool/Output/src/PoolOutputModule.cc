@@ -2,8 +2,11 @@
 
 #include "IOPool/Output/src/RootOutputFile.h"
 
+#include "FWCore/Concurrency/interface/WaitingTask.h"
+#include "FWCore/Concurrency/interface/WaitingTaskHolder.h"
 #include "FWCore/Framework/interface/ConstProductRegistry.h"
 #include "FWCore/Framework/interface/EventForOutput.h"
+#include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/Framework/interface/LuminosityBlockForOutput.h"
 #include "FWCore/Framework/interface/RunForOutput.h"
 #include "FWCore/Framework/interface/FileBlock.h"
@@ -11,6 +14,7 @@
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
 #include "DataFormats/Provenance/interface/BranchDescription.h"
 #include "DataFormats/Provenance/interface/Parentage.h"
 #include "DataFormats/Provenance/interface/ParentageRegistry.h"
@@ -31,6 +35,7 @@
 #include <iomanip>
 #include <sstream>
 #include "boost/algorithm/string.hpp"
+#include "tbb/task.h"
 
 
 namespace edm {
@@ -52,6 +57,8 @@ namespace edm {
     basketOrder_(pset.getUntrackedParameter<std::string>("sortBaskets")),
     treeMaxVirtualSize_(pset.getUntrackedParameter<int>("treeMaxVirtualSize")),
     whyNotFastClonable_(pset.getUntrackedParameter<bool>("fastCloning") ? FileBlock::CanFastClone : FileBlock::DisabledInConfigFile),
+    eventsPerStreamBuffer_(pset.getUntrackedParameter<unsigned int>("eventsPerStreamBuffer")),
+    numberOfStreams_(1U),
     dropMetaData_(DropNone),
     moduleLabel_(pset.getParameter<std::string>("@module_label")),
     initializedFromInput_(false),
@@ -87,6 +94,12 @@ namespace edm {
       whyNotFastClonable_+= FileBlock::EventSelectionUsed;
     }
 
+    // Fast copying appends the baskets of the input file at its opening, while the
+    // events serialized by the streams are appended as the buffers fill.
+    if (eventsPerStreamBuffer_ != 0) {
+      whyNotFastClonable_ |= FileBlock::DisabledInConfigFile;
+    }
+
     auto const& specialSplit {pset.getUntrackedParameterSetVector("overrideBranchesSplitLevel")};
       
     specialSplitLevelForBranches_.reserve(specialSplit.size());
@@ -111,6 +124,10 @@ namespace edm {
     }
   }
 
+  void PoolOutputModule::preallocStreams(unsigned int nStreams) {
+    numberOfStreams_ = nStreams;
+  }
+
   std::string const& PoolOutputModule::currentFileName() const {
     return rootOutputFile_->fileName();
   }
@@ -310,7 +327,7 @@ namespace edm {
 
   
   // At some later date, we may move functionality from finishEndFile() to here.
-  void PoolOutputModule::startEndFile() { }
+  void PoolOutputModule::startEndFile() { rootOutputFile_->appendStreamBuffers(); }
 
   void PoolOutputModule::writeFileFormatVersion() { rootOutputFile_->writeFileFormatVersion(); }
   void PoolOutputModule::writeFileIdentifier() { rootOutputFile_->writeFileIdentifier(); }
@@ -411,6 +428,56 @@ namespace edm {
         }
       }
     }
+    if(eventsPerStreamBuffer_ != 0) {
+      auto const* ep = dynamic_cast<EventPrincipal const*>(&iPrincipal);
+      if(ep) {
+        serializeEventAsync(iTask, iModuleCallingContext, *ep);
+      }
+    }
+  }
+
+  // Serializes the event into the buffer of its stream once the products and their
+  // provenance are available.  iTask, which runs the module, waits for it, so that
+  // write only has to append the full buffers to the file.
+  void
+  PoolOutputModule::serializeEventAsync(WaitingTask* iTask, ModuleCallingContext const& iModuleCallingContext, EventPrincipal const& iPrincipal) const {
+    ServiceToken token = ServiceRegistry::instance().presentToken();
+    auto serializeTask = make_waiting_task(tbb::task::allocate_root(),
+      [this, holder = WaitingTaskHolder(iTask), token, &iModuleCallingContext, &iPrincipal](std::exception_ptr const* iPtr) mutable {
+        if(iPtr) {
+          holder.doneWaiting(*iPtr);
+          return;
+        }
+        std::exception_ptr exceptionPtr;
+        try {
+          ServiceRegistry::Operate guard(token);
+          EventForOutput e(iPrincipal, moduleDescription(), &iModuleCallingContext);
+          e.setConsumer(this);
+          // The output file is only replaced between events.
+          get_underlying(rootOutputFile_)->serializeEvent(e);
+        } catch(...) {
+          exceptionPtr = std::current_exception();
+        }
+        holder.doneWaiting(exceptionPtr);
+      });
+
+    //Need to be sure the ref count isn't set to 0 immediately
+    serializeTask->increment_ref_count();
+    for(auto const& item : itemsToGetFrom(InEvent)) {
+      ProductResolverIndex productResolverIndex = item.productResolverIndex();
+      if(productResolverIndex != ProductResolverIndexAmbiguous) {
+        iPrincipal.prefetchAsync(serializeTask, productResolverIndex, item.skipCurrentProcess(), token, &iModuleCallingContext);
+      }
+    }
+    if(DropAll != dropMetaData_) {
+      auto pr = iPrincipal.productProvenanceRetrieverPtr();
+      if(pr) {
+        pr->readProvenanceAsync(serializeTask, &iModuleCallingContext);
+      }
+    }
+    if(0 == serializeTask->decrement_ref_count()) {
+      tbb::task::spawn(*serializeTask);
+    }
   }
 
   void
@@ -461,6 +528,12 @@ namespace edm {
     desc.addUntracked<bool>("fastCloning", true)
         ->setComment("True:  Allow fast copying, if possible.\n"
                      "False: Disable fast copying.");
+    desc.addUntracked<unsigned int>("eventsPerStreamBuffer", 0U)
+        ->setComment("0: The module serializes and compresses the events, one at a time.\n"
+                     "N: Each stream serializes and compresses its events into a buffer in memory, before the module runs. "
+                     "The module appends the buffer of a stream to the file once it holds N events, and all the buffers "
+                     "at the end of each lumi and of the file. Fast copying is then disabled, and the order of the events "
+                     "in the file depends on the scheduling.");
     desc.addUntracked<bool>("overrideInputFileSplitLevels", false)
         ->setComment("False: Use branch split levels and basket sizes from input file, if possible.\n"
                      "True:  Always use specified or default split levels and basket sizes.");
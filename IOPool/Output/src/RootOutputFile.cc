@@ -38,7 +38,9 @@
 #include "IOPool/Provenance/interface/CommonProvenanceFiller.h"
 
 #include "TTree.h"
+#include "TDirectory.h"
 #include "TFile.h"
+#include "TMemFile.h"
 #include "TClass.h"
 #include "Rtypes.h"
 #include "RVersion.h"
@@ -161,6 +163,12 @@ namespace edm {
         branchesWithStoredHistory_.insert(item.branchID());
       }
     }
+    if(om_->eventsPerStreamBuffer() != 0) {
+      streamBuffers_.reserve(om_->numberOfStreams());
+      for(unsigned int i = 0; i < om_->numberOfStreams(); ++i) {
+        streamBuffers_.push_back(std::make_unique<StreamBuffer>());
+      }
+    }
     // Don't split metadata tree or event description tree
     metaDataTree_         = RootOutputTree::makeTTree(filePtr_.get(), poolNames::metaDataTreeName(), 0);
     parentageTree_ = RootOutputTree::makeTTree(filePtr_.get(), poolNames::parentageTreeName(), 0);
@@ -395,53 +403,159 @@ namespace edm {
   }
 
   void RootOutputFile::writeOne(EventForOutput const& e) {
-    // Auxiliary branch
-    pEventAux_ = &e.eventAuxiliary();
-
-    // Because getting the data may cause an exception to be thrown we want to do that
-    // first before writing anything to the file about this event
-    // NOTE: pEventAux_, pBranchListIndexes_, pEventSelectionIDs_, and pEventEntryInfoVector_
-    // must be set before calling fillBranches since they get written out in that routine.
-    assert(pEventAux_->processHistoryID() == e.processHistoryID());
-    pBranchListIndexes_ = &e.branchListIndexes();
-
-    // Note: The EventSelectionIDVector should have a one to one correspondence with the processes in the process history.
-    // Therefore, a new entry should be added if and only if the current process has been added to the process history,
-    // which is done if and only if there is a produced product.
-    Service<ConstProductRegistry> reg;
-    EventSelectionIDVector esids = e.eventSelectionIDs();
-    if (reg->anyProductProduced() || !om_->wantAllEvents()) {
-      esids.push_back(om_->selectorConfig());
+    if(!streamBuffers_.empty()) {
+      // The event was already serialized by its stream, in serializeEvent.
+      // Only this stream fills its buffer, so no lock is needed to look at it.
+      StreamBuffer& buffer = *streamBuffers_[e.streamID().value()];
+      if(buffer.events_.size() >= om_->eventsPerStreamBuffer()) {
+        appendStreamBuffer(buffer);
+      }
+    } else {
+      // Auxiliary branch
+      pEventAux_ = &e.eventAuxiliary();
+
+      // Because getting the data may cause an exception to be thrown we want to do that
+      // first before writing anything to the file about this event
+      // NOTE: pEventAux_, pBranchListIndexes_, pEventSelectionIDs_, and pEventEntryInfoVector_
+      // must be set before calling fillBranches since they get written out in that routine.
+      assert(pEventAux_->processHistoryID() == e.processHistoryID());
+      pBranchListIndexes_ = &e.branchListIndexes();
+
+      // Note: The EventSelectionIDVector should have a one to one correspondence with the processes in the process history.
+      // Therefore, a new entry should be added if and only if the current process has been added to the process history,
+      // which is done if and only if there is a produced product.
+      Service<ConstProductRegistry> reg;
+      EventSelectionIDVector esids = e.eventSelectionIDs();
+      if (reg->anyProductProduced() || !om_->wantAllEvents()) {
+        esids.push_back(om_->selectorConfig());
+      }
+      pEventSelectionIDs_ = &esids;
+      ProductProvenanceRetriever const* provRetriever = e.productProvenanceRetrieverPtr();
+      assert(provRetriever);
+      fillBranches(InEvent, e, pEventEntryInfoVector_, provRetriever);
+
+      // Store the process history.
+      processHistoryRegistry_.registerProcessHistory(e.processHistory());
+      // Store the reduced ID in the IndexIntoFile
+      ProcessHistoryID reducedPHID = processHistoryRegistry_.reducedProcessHistoryID(e.processHistoryID());
+      // Add event to index
+      indexIntoFile_.addEntry(reducedPHID, pEventAux_->run(), pEventAux_->luminosityBlock(), pEventAux_->event(), eventEntryNumber_);
+      ++eventEntryNumber_;
     }
-    pEventSelectionIDs_ = &esids;
-    ProductProvenanceRetriever const* provRetriever = e.productProvenanceRetrieverPtr();
-    assert(provRetriever);
-    fillBranches(InEvent, e, pEventEntryInfoVector_, provRetriever);
 
     // Add the dataType to the job report if it hasn't already been done
     if(!dataTypeReported_) {
       Service<JobReport> reportSvc;
       std::string dataType("MC");
-      if(pEventAux_->isRealData())  dataType = "Data";
+      if(e.eventAuxiliary().isRealData())  dataType = "Data";
       reportSvc->reportDataType(reportToken_, dataType);
       dataTypeReported_ = true;
     }
 
-    // Store the process history.
-    processHistoryRegistry_.registerProcessHistory(e.processHistory());
-    // Store the reduced ID in the IndexIntoFile
-    ProcessHistoryID reducedPHID = processHistoryRegistry_.reducedProcessHistoryID(e.processHistoryID());
-    // Add event to index
-    indexIntoFile_.addEntry(reducedPHID, pEventAux_->run(), pEventAux_->luminosityBlock(), pEventAux_->event(), eventEntryNumber_);
-    ++eventEntryNumber_;
-
     // Report event written
     Service<JobReport> reportSvc;
     reportSvc->eventWrittenToFile(reportToken_, e.id().run(), e.id().event());
     ++nEventsInLumi_;
   }
 
+  // Called by the stream of the event, before the module runs, once the products are
+  // available.  The event is written in the tree of the stream, which serializes and
+  // compresses it.  The events are added to the IndexIntoFile only when the tree is
+  // appended to the event tree, so an event serialized here is in the file even if
+  // the module fails before writeOne is called for it.
+  void RootOutputFile::serializeEvent(EventForOutput const& e) {
+    unsigned int const streamIndex = e.streamID().value();
+    StreamBuffer& buffer = *streamBuffers_[streamIndex];
+    std::lock_guard<std::mutex> guard(buffer.mutex_);
+    if(!buffer.tree_) {
+      makeStreamBuffer(buffer, streamIndex);
+    }
+    // As in writeOne, the auxiliary branches must be set before calling fillBranches.
+    buffer.pEventAux_ = &e.eventAuxiliary();
+    assert(buffer.pEventAux_->processHistoryID() == e.processHistoryID());
+    buffer.pBranchListIndexes_ = &e.branchListIndexes();
+    Service<ConstProductRegistry> reg;
+    EventSelectionIDVector esids = e.eventSelectionIDs();
+    if (reg->anyProductProduced() || !om_->wantAllEvents()) {
+      esids.push_back(om_->selectorConfig());
+    }
+    buffer.pEventSelectionIDs_ = &esids;
+    ProductProvenanceRetriever const* provRetriever = e.productProvenanceRetrieverPtr();
+    assert(provRetriever);
+    fillBranches(InEvent, buffer.items_, *buffer.tree_, e, buffer.pEventEntryInfoVector_, provRetriever);
+
+    EventAuxiliary const& aux = *buffer.pEventAux_;
+    buffer.events_.push_back(StreamBuffer::Event{e.processHistory(), aux.run(), aux.luminosityBlock(), aux.event()});
+    if(buffer.events_.size() == om_->eventsPerStreamBuffer()) {
+      // Compress the last baskets here rather than in the writer.
+      buffer.tree_->tree()->FlushBaskets();
+    }
+  }
+
+  void RootOutputFile::makeStreamBuffer(StreamBuffer& buffer, unsigned int streamIndex) {
+    // Opening the file changes the current directory of this thread, which other modules use.
+    TDirectory::TContext directoryContext;
+    std::ostringstream name;
+    name << file_ << ".stream" << streamIndex;
+    buffer.file_ = std::make_shared<TMemFile>(name.str().c_str(), "recreate", "", om_->compressionLevel());
+    buffer.file_->SetCompressionAlgorithm(filePtr_->GetCompressionAlgorithm());
+    // The branches must be the same, in the same order, as in the event tree.
+    buffer.tree_ = std::make_unique<RootOutputTree>(buffer.file_, InEvent, om_->splitLevel(), om_->treeMaxVirtualSize());
+    // The baskets are flushed when the buffer is full, so that its events make one cluster.
+    buffer.tree_->setAutoFlush(0);
+    buffer.tree_->addAuxiliary<EventAuxiliary>(BranchTypeToAuxiliaryBranchName(InEvent),
+                                               buffer.pEventAux_, om_->auxItems()[InEvent].basketSize_);
+    buffer.tree_->addAuxiliary<StoredProductProvenanceVector>(BranchTypeToProductProvenanceBranchName(InEvent),
+                                                             buffer.pEventEntryInfoVector_, om_->auxItems()[InEvent].basketSize_);
+    buffer.tree_->addAuxiliary<EventSelectionIDVector>(poolNames::eventSelectionsBranchName(),
+                                                       buffer.pEventSelectionIDs_, om_->auxItems()[InEvent].basketSize_,false);
+    buffer.tree_->addAuxiliary<BranchListIndexes>(poolNames::branchListIndexesBranchName(),
+                                                  buffer.pBranchListIndexes_, om_->auxItems()[InEvent].basketSize_);
+    buffer.items_ = om_->selectedOutputItemList()[InEvent];
+    for(auto const& item : buffer.items_) {
+      item.product_ = nullptr;
+      BranchDescription const& desc = *item.branchDescription_;
+      buffer.tree_->addBranch(desc.branchName(),
+                              desc.wrappedName(),
+                              item.product_,
+                              item.splitLevel_,
+                              item.basketSize_,
+                              desc.produced());
+    }
+  }
+
+  void RootOutputFile::appendStreamBuffer(StreamBuffer& buffer) {
+    std::lock_guard<std::mutex> guard(buffer.mutex_);
+    if(buffer.events_.empty()) {
+      return;
+    }
+    eventTree_.appendTTree(buffer.tree_->tree());
+    for(auto const& event : buffer.events_) {
+      // Store the process history.
+      processHistoryRegistry_.registerProcessHistory(event.processHistory_);
+      // Store the reduced ID in the IndexIntoFile
+      ProcessHistoryID reducedPHID = processHistoryRegistry_.reducedProcessHistoryID(event.processHistory_.id());
+      // Add event to index
+      indexIntoFile_.addEntry(reducedPHID, event.run_, event.lumi_, event.event_, eventEntryNumber_);
+      ++eventEntryNumber_;
+    }
+    buffer.events_.clear();
+    // The next event of the stream starts a new buffer.
+    buffer.tree_->close();
+    buffer.tree_.reset();
+    buffer.file_->Close();
+    buffer.file_.reset();
+  }
+
+  // The events of a luminosity block must be in the IndexIntoFile before the block.
+  void RootOutputFile::appendStreamBuffers() {
+    for(auto& buffer : streamBuffers_) {
+      appendStreamBuffer(*buffer);
+    }
+  }
+
   void RootOutputFile::writeLuminosityBlock(LuminosityBlockForOutput const& lb) {
+    appendStreamBuffers();
     // Auxiliary branch
     // NOTE: lumiAux_ must be filled before calling fillBranches since it gets written out in that routine.
     lumiAux_ = lb.luminosityBlockAuxiliary();
@@ -688,10 +802,19 @@ namespace edm {
                 OccurrenceForOutput const& occurrence,
                 StoredProductProvenanceVector* productProvenanceVecPtr,
                 ProductProvenanceRetriever const* provRetriever) {
+    fillBranches(branchType, om_->selectedOutputItemList()[branchType], *treePointers_[branchType],
+                 occurrence, productProvenanceVecPtr, provRetriever);
+  }
 
-    std::vector<std::unique_ptr<WrapperBase> > dummies;
+  void RootOutputFile::fillBranches(
+                BranchType const& branchType,
+                OutputItemList const& items,
+                RootOutputTree& tree,
+                OccurrenceForOutput const& occurrence,
+                StoredProductProvenanceVector* productProvenanceVecPtr,
+                ProductProvenanceRetriever const* provRetriever) {
 
-    OutputItemList const& items = om_->selectedOutputItemList()[branchType];
+    std::vector<std::unique_ptr<WrapperBase> > dummies;
 
     bool const doProvenance = (productProvenanceVecPtr != nullptr) && (om_->dropMetaData() != PoolOutputModule::DropAll);
     bool const keepProvenanceForPrior = doProvenance && om_->dropMetaData() != PoolOutputModule::DropPrior;
@@ -714,13 +837,14 @@ namespace edm {
     }
 
     // Loop over EDProduct branches, possibly fill the provenance, and write the branch.
+    std::unique_lock<std::mutex> provenanceLock(provenanceMutex_);
     for(auto const& item : items) {
 
       BranchID const& id = item.branchDescription_->branchID();
       branchesWithStoredHistory_.insert(id);
 
       bool produced = item.branchDescription_->produced();
-      bool getProd = (produced || !fastCloning || treePointers_[branchType]->uncloned(item.branchDescription_->branchName()));
+      bool getProd = (produced || !fastCloning || tree.uncloned(item.branchDescription_->branchName()));
       bool keepProvenance = doProvenance && (produced || keepProvenanceForPrior);
 
       WrapperBase const* product = nullptr;
@@ -754,8 +878,10 @@ namespace edm {
       }
     }
 
+    provenanceLock.unlock();
+
     if(doProvenance) productProvenanceVecPtr->assign(provenanceToKeep.begin(), provenanceToKeep.end());
-    treePointers_[branchType]->fillTree();
+    tree.fillTree();
     if(doProvenance) productProvenanceVecPtr->clear();
   }
 
@@ -11,6 +11,7 @@
 
 #include <array>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -25,11 +26,13 @@
 #include "DataFormats/Provenance/interface/IndexIntoFile.h"
 #include "DataFormats/Provenance/interface/LuminosityBlockAuxiliary.h"
 #include "DataFormats/Provenance/interface/ParentageID.h"
+#include "DataFormats/Provenance/interface/ProcessHistory.h"
 #include "DataFormats/Provenance/interface/ProcessHistoryRegistry.h"
 #include "DataFormats/Provenance/interface/ProductProvenance.h"
 #include "DataFormats/Provenance/interface/StoredProductProvenance.h"
 #include "DataFormats/Provenance/interface/StoredMergeableRunProductMetadata.h"
 #include "DataFormats/Provenance/interface/RunAuxiliary.h"
+#include "DataFormats/Provenance/interface/RunLumiEventNumber.h"
 #include "DataFormats/Provenance/interface/SelectedProducts.h"
 #include "IOPool/Output/interface/PoolOutputModule.h"
 #include "IOPool/Output/src/RootOutputTree.h"
@@ -52,6 +55,8 @@ namespace edm {
                             std::vector<std::string> const& processesWithSelectedMergeableRunProducts);
     ~RootOutputFile() {}
     void writeOne(EventForOutput const& e);
+    void serializeEvent(EventForOutput const& e);
+    void appendStreamBuffers();
     //void endFile();
     void writeLuminosityBlock(LuminosityBlockForOutput const& lb);
     void writeRun(RunForOutput const& r);
@@ -80,6 +85,27 @@ namespace edm {
     // Local types
     //
 
+    // The events serialized by one stream into a tree of its own, in memory,
+    // until the tree is appended to the event tree.
+    struct StreamBuffer {
+      struct Event {
+        ProcessHistory processHistory_;
+        RunNumber_t run_;
+        LuminosityBlockNumber_t lumi_;
+        EventNumber_t event_;
+      };
+      std::mutex mutex_;
+      std::shared_ptr<TFile> file_;
+      std::unique_ptr<RootOutputTree> tree_;
+      OutputItemList items_;
+      EventAuxiliary const* pEventAux_ = nullptr;
+      StoredProductProvenanceVector eventEntryInfoVector_;
+      StoredProductProvenanceVector* pEventEntryInfoVector_ = &eventEntryInfoVector_;
+      BranchListIndexes const* pBranchListIndexes_ = nullptr;
+      EventSelectionIDVector const* pEventSelectionIDs_ = nullptr;
+      std::vector<Event> events_;
+    };
+
     //-------------------------------
     // Private functions
 
@@ -90,6 +116,17 @@ namespace edm {
                       StoredProductProvenanceVector* productProvenanceVecPtr = nullptr,
                       ProductProvenanceRetriever const* provRetriever = nullptr);
 
+    void fillBranches(BranchType const& branchType,
+                      OutputItemList const& items,
+                      RootOutputTree& tree,
+                      OccurrenceForOutput const& occurrence,
+                      StoredProductProvenanceVector* productProvenanceVecPtr,
+                      ProductProvenanceRetriever const* provRetriever);
+
+    void makeStreamBuffer(StreamBuffer& buffer, unsigned int streamIndex);
+
+    void appendStreamBuffer(StreamBuffer& buffer);
+
      void insertAncestors(ProductProvenance const& iGetParents,
                           ProductProvenanceRetriever const* iMapper,
                           bool produced,
@@ -141,6 +178,9 @@ namespace edm {
     ProcessHistoryRegistry processHistoryRegistry_;
     std::map<ParentageID,unsigned int> parentageIDs_;
     std::set<BranchID> branchesWithStoredHistory_;
+    // protects parentageIDs_ and branchesWithStoredHistory_ when the streams serialize events
+    std::mutex provenanceMutex_;
+    std::vector<std::unique_ptr<StreamBuffer>> streamBuffers_;
     edm::propagate_const<TClass*> wrapperBaseTClass_;
   };
 
@@ -272,6 +272,21 @@ namespace edm {
     }
   }
 
+  // Appends the baskets of a tree with the same branches, all of them, as filled
+  // by another RootOutputTree.  Nothing is streamed or compressed again.
+  void
+  RootOutputTree::appendTTree(TTree* in) {
+    if(in->GetEntries() != 0) {
+      TTreeCloner cloner(in, tree_, "", TTreeCloner::kNoWarnings);
+      if(!cloner.IsValid()) {
+        throw edm::Exception(errors::FatalRootError)
+          << "invalid TTreeCloner (" << cloner.GetWarning() << ")\n";
+      }
+      tree_->SetEntries(tree_->GetEntries() + in->GetEntries());
+      cloner.Exec();
+    }
+  }
+
   void
   RootOutputTree::writeTTree(TTree* tree) {
     if(tree->GetNbranches() != 0) {
@@ -55,6 +55,8 @@ namespace edm {
 
     void fastCloneTTree(TTree* in, std::string const& option);
 
+    void appendTTree(TTree* in);
+
     static TTree* makeTTree(TFile* filePtr, std::string const& name, int splitLevel);
 
     static TTree* assignTTree(TFile* file, TTree* tree);
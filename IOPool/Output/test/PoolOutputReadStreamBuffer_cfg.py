@@ -0,0 +1,26 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTOUTPUTREAD")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring('file:PoolOutputTestStreamBuffer.root')
+)
+
+# all the events written by PoolOutputTestStreamBuffer_cfg.py, 3 per lumi
+eventSequence = [cms.EventID(1,0,0)]
+for lumi in range(1, 8):
+    eventSequence.append(cms.EventID(1,lumi,0))
+    for event in range(3*lumi-2, min(3*lumi, 20)+1):
+        eventSequence.append(cms.EventID(1,lumi,event))
+    eventSequence.append(cms.EventID(1,lumi,0))
+eventSequence.append(cms.EventID(1,0,0))
+
+process.check = cms.EDAnalyzer("RunLumiEventChecker",
+    eventSequence = cms.untracked.VEventID(*eventSequence),
+    unorderedEvents = cms.untracked.bool(True)
+)
+
+process.Analysis = cms.EDAnalyzer("OtherThingAnalyzer")
+
+process.p = cms.Path(process.check*process.Analysis)
@@ -33,4 +33,8 @@ cmsRun ${LOCAL_TEST_DIR}/TestProvC_cfg.py || die 'Failure using TestProvC_cfg.py
 cmsRun ${LOCAL_TEST_DIR}/PoolOutputTestUnscheduled_cfg.py || die 'Failure using PoolOutputTestUnscheduled_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/PoolOutputTestUnscheduledRead_cfg.py || die 'Failure using PoolOutputTestUnscheduledRead_cfg.py' $?
 
+cmsRun ${LOCAL_TEST_DIR}/PoolOutputTestStreamBuffer_cfg.py || die 'Failure using PoolOutputTestStreamBuffer_cfg.py' $?
+#reads file from above
+cmsRun ${LOCAL_TEST_DIR}/PoolOutputReadStreamBuffer_cfg.py || die 'Failure using PoolOutputReadStreamBuffer_cfg.py' $?
+
 popd
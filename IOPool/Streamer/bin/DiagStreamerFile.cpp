@@ -28,6 +28,7 @@
 #include "IOPool/Streamer/interface/InitMessage.h"
 #include "IOPool/Streamer/interface/MsgTools.h"
 #include "IOPool/Streamer/interface/StreamerInputFile.h"
+#include "IOPool/Streamer/interface/StreamerInputSource.h"
 #include "IOPool/Streamer/interface/StreamerOutputFile.h"
 
 #include "zlib.h"
@@ -268,15 +269,34 @@ bool test_chksum(EventMsgView const* eview) {
 //==========================================================================
 bool test_uncompress(EventMsgView const* eview, std::vector<unsigned char> &dest) {
   unsigned long origsize = eview->origDataSize();
+  unsigned char* data = const_cast<unsigned char*>((unsigned char const*)eview->eventData());
   bool success = false;
-  if(origsize != 0 && origsize != 78)
-  {
-    // compressed
-    success = uncompressBuffer(const_cast<unsigned char*>((unsigned char const*)eview->eventData()),
-                                   eview->eventLength(), dest, origsize);
-  } else {
-    // uncompressed anyway
-    success = true;
+  try {
+    switch(eview->compressionAlgo()) {
+      case ZLIB:
+        success = uncompressBuffer(data, eview->eventLength(), dest, origsize);
+        break;
+      case LZMA:
+        edm::StreamerInputSource::uncompressBufferLZMA(data, eview->eventLength(), dest, origsize);
+        success = true;
+        break;
+      case ZSTD:
+        edm::StreamerInputSource::uncompressBufferZSTD(data, eview->eventLength(), dest, origsize);
+        success = true;
+        break;
+      case LZ4:
+        edm::StreamerInputSource::uncompressBufferLZ4(data, eview->eventLength(), dest, origsize);
+        success = true;
+        break;
+      case UNCOMPRESSED:
+        // uncompressed anyway
+        success = true;
+        break;
+      default:
+        std::cout << "Unknown compression algorithm " << eview->compressionAlgo() << std::endl;
+    }
+  } catch(cms::Exception const& e) {
+    std::cout << "Problem with uncompress: " << e.explainSelf() << std::endl;
   }
   return success;
 }
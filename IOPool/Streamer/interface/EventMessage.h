@@ -48,6 +48,15 @@ Protocol Version 10: identical to version 9, but incremented to keep in sync wit
 
 Protocol Version 11: identical to version 10, except event changed from 4 bytes to 8 bytes
 
+Protocol Version 12: add the algorithm used to compress the data blob
+code 1 | size 4 | protocol version 1 |
+run 4 | event 8 | lumi 4 | origDataSize 4 | outModId 4 |
+droppedEventsCount 4 |
+l1_count 4 | l1bits l1_count/8 | 
+hlt_count 4 | hltbits hlt_count/4 |
+adler32_chksum 4 | host name length 1 | host name {Fixed size}
+compressionAlgo 1 | eventdatalength 4 | eventdata blob {variable} 
+
 */
 
 #ifndef IOPool_Streamer_EventMessage_h
@@ -90,6 +99,7 @@ public:
   uint32 origDataSize() const;
   uint32 outModId() const;
   uint32 droppedEventsCount() const;
+  uint32 compressionAlgo() const { return compression_algo_; }
 
   void l1TriggerBits(std::vector<bool>& put_here) const;
   void hltTriggerBits(uint8* put_here) const;
@@ -113,6 +123,7 @@ private:
   uint32 adler32_chksum_;
   uint8* host_name_start_;
   uint32 host_name_len_;
+  uint32 compression_algo_;
   bool v2Detected_;
 };
 
@@ -22,6 +22,7 @@ public:
 
   uint8* startAddress() const { return buf_; }
   void setDataLength(uint32 registry_length);
+  void setCompressionAlgo(uint32 algo);
   uint8* dataAddress() const  { return data_addr_; }
   uint32 headerSize() const {return data_addr_-buf_;}
   uint32 size() const ;
@@ -20,6 +20,10 @@ struct Header
                FILE_CLOSE_REQUEST = 15, SPARE1 = 16, SPARE2 = 17 };
 };
 
+// algorithm used to compress the data blob of the event messages,
+// recorded in the INIT and EVENT messages since protocol version 12
+enum StreamerCompressionAlgo { UNCOMPRESSED = 0, ZLIB = 1, LZMA = 2, ZSTD = 3, LZ4 = 4 };
+
 // as we need to see it
 class HeaderView
 {
@@ -17,6 +17,7 @@
 #include "DataFormats/Provenance/interface/ParameterSetID.h"
 #include "DataFormats/Provenance/interface/SelectedProducts.h"
 #include "FWCore/Utilities/interface/get_underlying_safe.h"
+#include "IOPool/Streamer/interface/MsgHeader.h"
 
 const int init_size = 1024*1024;
 
@@ -33,7 +34,8 @@ struct SerializeDataBuffer
     ptr_((unsigned char*)rootbuf_.Buffer()),
     header_buf_(),
     bufs_(),
-    adler32_chksum_(0)
+    adler32_chksum_(0),
+    compression_algo_(UNCOMPRESSED)
   { }
 
   // This object caches the results of the last INIT or event 
@@ -45,6 +47,7 @@ struct SerializeDataBuffer
   unsigned int currentSpaceUsed() const { return curr_space_used_; }
   unsigned int currentEventSize() const { return curr_event_size_; }
   uint32_t adler32_chksum() const { return adler32_chksum_; }
+  StreamerCompressionAlgo compressionAlgo() const { return compression_algo_; }
 
   std::vector<unsigned char> comp_buf_; // space for compressed data
   unsigned int curr_event_size_;
@@ -54,6 +57,7 @@ struct SerializeDataBuffer
   SBuffer header_buf_; // place for INIT message creation
   SBuffer bufs_;       // place for EVENT message creation
   uint32_t  adler32_chksum_; // adler32 check sum for the (compressed) data
+  StreamerCompressionAlgo compression_algo_; // UNCOMPRESSED if the compression failed
 };
 
 class EventMsgBuilder;
@@ -76,9 +80,13 @@ namespace edm
                           const BranchIDLists &branchIDLists,
                           ThinnedAssociationsHelper const& thinnedAssociationsHelper);
 
+    /**
+     * Serializes and compresses the event into the data buffer. Different
+     * data buffers can be filled concurrently, e.g. one per stream.
+     */
     int serializeEvent(EventForOutput const& event, ParameterSetID const& selectorConfig,
-                       bool use_compression, int compression_level,
-                       SerializeDataBuffer &data_buffer);
+                       StreamerCompressionAlgo compression_algo, int compression_level,
+                       SerializeDataBuffer &data_buffer) const;
 
     /**
      * Compresses the data in the specified input buffer into the
@@ -89,6 +97,18 @@ namespace edm
                                        unsigned int inputSize,
                                        std::vector<unsigned char> &outputBuffer,
                                        int compressionLevel);
+    static unsigned int compressBufferLZMA(unsigned char *inputBuffer,
+                                           unsigned int inputSize,
+                                           std::vector<unsigned char> &outputBuffer,
+                                           int compressionLevel);
+    static unsigned int compressBufferZSTD(unsigned char *inputBuffer,
+                                           unsigned int inputSize,
+                                           std::vector<unsigned char> &outputBuffer,
+                                           int compressionLevel);
+    static unsigned int compressBufferLZ4(unsigned char *inputBuffer,
+                                          unsigned int inputSize,
+                                          std::vector<unsigned char> &outputBuffer,
+                                          int compressionLevel);
 
   private:
 
@@ -1,11 +1,12 @@
 #ifndef IOPool_Streamer_StreamerOutputModuleBase_h
 #define IOPool_Streamer_StreamerOutputModuleBase_h
 
-#include "FWCore/Framework/interface/one/OutputModule.h"
+#include "FWCore/Framework/interface/global/OutputModule.h"
 #include "FWCore/Utilities/interface/EDGetToken.h"
 #include "IOPool/Streamer/interface/MsgTools.h"
 #include "IOPool/Streamer/interface/StreamSerializer.h"
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class InitMsgBuilder;
@@ -15,15 +16,21 @@ namespace edm {
 
   typedef detail::TriggerResultsBasedEventSelector::handle_t Trig;
 
-  class StreamerOutputModuleBase : public one::OutputModule<one::WatchRuns, one::WatchLuminosityBlocks> {
+  // The events of the different streams are serialized and compressed
+  // concurrently, each stream in its own buffer; they are then passed one at
+  // a time to doOutputEvent.
+  class StreamerOutputModuleBase : public global::OutputModule<> {
   public:
     explicit StreamerOutputModuleBase(ParameterSet const& ps);
     ~StreamerOutputModuleBase() override;
     static void fillDescription(ParameterSetDescription & desc);
 
   private:
-    void beginRun(RunForOutput const&) override;
-    void endRun(RunForOutput const&) override;
+    void preallocStreams(unsigned int nStreams) override;
+    void doBeginRun_(RunForOutput const&) override;
+    void doEndRun_(RunForOutput const&) override;
+    void doBeginLuminosityBlock_(LuminosityBlockForOutput const&) override;
+    void doEndLuminosityBlock_(LuminosityBlockForOutput const&) override;
     void beginJob() override;
     void endJob() override;
     void writeRun(RunForOutput const&) override;
@@ -34,18 +41,20 @@ namespace edm {
     virtual void stop() = 0;
     virtual void doOutputHeader(InitMsgBuilder const& init_message) = 0;
     virtual void doOutputEvent(EventMsgBuilder const& msg) = 0;
+    virtual void beginLuminosityBlock(LuminosityBlockForOutput const&) {}
+    virtual void endLuminosityBlock(LuminosityBlockForOutput const&) {}
 
     std::unique_ptr<InitMsgBuilder> serializeRegistry();
-    std::unique_ptr<EventMsgBuilder> serializeEvent(EventForOutput const& e); 
+    std::unique_ptr<EventMsgBuilder> serializeEvent(EventForOutput const& e, SerializeDataBuffer& data_buffer) const;
     Trig getTriggerResults(EDGetTokenT<TriggerResults> const& token, EventForOutput const& e) const;
-    void setHltMask(EventForOutput const& e);
-    void setLumiSection();
+    void setHltMask(EventForOutput const& e, std::vector<unsigned char>& hltbits) const;
+    uint32 lumiSection() const;
 
   private:
     SelectedProducts const* selections_;
 
     int maxEventSize_;
-    bool useCompression_;
+    StreamerCompressionAlgo compressionAlgo_; // UNCOMPRESSED if compression is not used
     int compressionLevel_;
 
     // test luminosity sections
@@ -54,14 +63,11 @@ namespace edm {
 
     StreamSerializer serializer_;
 
-    SerializeDataBuffer serializeDataBuffer_;
+    SerializeDataBuffer serializeDataBuffer_; // for the INIT message
+    std::unique_ptr<SerializeDataBuffer[]> streamDataBuffers_; // for the events, one per stream
+    std::mutex outputMutex_; // serializes the calls to doOutputEvent
 
-    //Event variables, made class memebers to avoid re instatiation for each event.
     unsigned int hltsize_;
-    uint32 lumi_;
-    std::vector<bool> l1bit_;
-    std::vector<unsigned char> hltbits_;
-    uint32 origSize_;
     char host_name_[255];
 
     edm::EDGetTokenT<edm::TriggerResults> trToken_;
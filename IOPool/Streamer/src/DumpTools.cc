@@ -36,6 +36,9 @@ void dumpInitHeader(const InitMsgView* view)
     std::cout << "Checksum for Registry data = " << view->adler32_chksum()
               << " Hostname = " << view->hostName() << std::endl;
   }
+  if (view->protocolVersion() >= 12) {
+    std::cout << "compressionAlgo = " << view->compressionAlgo() << std::endl;
+  }
 
   //PSet 16 byte non-printable representation, stored in message.
   uint8 vpset[16];
@@ -150,6 +153,7 @@ void dumpEventHeader(const EventMsgView* eview)
        << "event=" << eview->event() << "\n"
        << "lumi=" << eview->lumi() << "\n"
        << "origDataSize=" << eview->origDataSize() << "\n"
+       << "compressionAlgo=" << eview->compressionAlgo() << "\n"
        << "outModId=0x" << std::hex << eview->outModId() << std::dec << "\n"
        << "adler32 chksum= " << eview->adler32_chksum() << "\n"
        << "host name= " << eview->hostName() << "\n"
@@ -15,9 +15,9 @@ EventMsgView::EventMsgView(void* buf):
 
   // 18-Jul-2008, wmtan - payload changed for version 7.
   // So we no longer support previous formats.
-  if (protocolVersion() != 11) {
+  if (protocolVersion() != 11 && protocolVersion() != 12) {
     throw cms::Exception("EventMsgView", "Invalid Message Version:")
-      << "Only message version 10 is currently supported \n"
+      << "Only message versions 11 and 12 are currently supported \n"
       << "(invalid value = " << protocolVersion() << ").\n"
       << "We support only reading and converting streamer files\n"
       << "using the same version of CMSSW used to created the\n"
@@ -60,6 +60,14 @@ EventMsgView::EventMsgView(void* buf):
   host_name_len_ = *host_name_start_;
   host_name_start_ += sizeof(uint8);
   event_start_ = host_name_start_ + host_name_len_;
+  if (protocolVersion() > 11) {
+    compression_algo_ = *event_start_;
+    event_start_ += sizeof(uint8);
+  } else {
+    // version 11 messages could only be compressed with zlib
+    uint32 origsize = origDataSize();
+    compression_algo_ = (origsize != 78 && origsize != 0) ? ZLIB : UNCOMPRESSED;
+  }
   event_len_ = convert32(event_start_); 
   event_start_ += sizeof(char_uint32); 
 }
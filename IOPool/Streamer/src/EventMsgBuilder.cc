@@ -15,7 +15,7 @@ EventMsgBuilder::EventMsgBuilder(void* buf, uint32 size,
   buf_((uint8*)buf),size_(size)
 {
   EventHeader* h = (EventHeader*)buf_;
-  h->protocolVersion_ = 11;
+  h->protocolVersion_ = 12;
   convert(run,h->run_);
   convert(event,h->event_);
   convert(lumi,h->lumi_);
@@ -76,10 +76,18 @@ EventMsgBuilder::EventMsgBuilder(void* buf, uint32 size,
   }
   pos += host_name_len;
 
+  // compression algorithm of the data blob, set once the data is known
+  *pos++ = UNCOMPRESSED;
+
   event_addr_ = pos + sizeof(char_uint32);
   setEventLength(0);
 }
 
+void EventMsgBuilder::setCompressionAlgo(uint32 algo)
+{
+  *(event_addr_ - sizeof(char_uint32) - sizeof(uint8)) = algo;
+}
+
 void EventMsgBuilder::setOrigDataSize(uint32 value)
 {
   EventHeader* h = (EventHeader*)buf_;
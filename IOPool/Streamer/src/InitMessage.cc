@@ -26,6 +26,7 @@ InitMsgView::InitMsgView(void* buf) :
   adler32_chksum_(0),
   host_name_start_(nullptr),
   host_name_len_(0),
+  compression_algo_(UNCOMPRESSED),
   desc_start_(nullptr),
   desc_len_(0) {
   if (protocolVersion() == 2) {
@@ -96,6 +97,11 @@ InitMsgView::InitMsgView(void* buf) :
     }
   }
 
+  if (protocolVersion() > 11) {
+    compression_algo_ = *pos;
+    pos += sizeof(uint8);
+  }
+
   desc_start_ = pos;
   desc_len_ = convert32(desc_start_);
   desc_start_ += sizeof(char_uint32);
@@ -59,6 +59,9 @@ InitMsgBuilder::InitMsgBuilder(void* buf, uint32 size,
   convert(adler_chksum, pos);
   pos = pos + sizeof(uint32);
 
+  // compression algorithm of the event data blobs
+  *pos++ = UNCOMPRESSED;
+
   data_addr_ = pos + sizeof(char_uint32);
   setDataLength(0);
 
@@ -86,6 +89,11 @@ InitMsgBuilder::InitMsgBuilder(void* buf, uint32 size,
   convert(eventHeaderSize, h->event_header_size_);
 }
 
+void InitMsgBuilder::setCompressionAlgo(uint32 algo)
+{
+  *(data_addr_ - sizeof(char_uint32) - sizeof(uint8)) = algo;
+}
+
 void InitMsgBuilder::setDataLength(uint32 len)
 {
   convert(len,data_addr_-sizeof(char_uint32));
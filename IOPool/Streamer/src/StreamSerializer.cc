@@ -22,6 +22,10 @@
 #include "FWCore/ServiceRegistry/interface/Service.h"
 
 #include "zlib.h"
+#include "lzma.h"
+#include "zstd.h"
+#include "lz4.h"
+#include "lz4hc.h"
 #include <algorithm>
 #include <cstdlib>
 #include <iostream>
@@ -127,8 +131,8 @@ namespace edm {
    */
   int StreamSerializer::serializeEvent(EventForOutput const& event,
                                        ParameterSetID const& selectorConfig,
-                                       bool use_compression, int compression_level,
-                                       SerializeDataBuffer& data_buffer) {
+                                       StreamerCompressionAlgo compression_algo, int compression_level,
+                                       SerializeDataBuffer& data_buffer) const {
 
     EventSelectionIDVector selectionIDs = event.eventSelectionIDs();
     selectionIDs.push_back(selectorConfig);
@@ -222,12 +226,31 @@ namespace edm {
     // compress before return if we need to
     // should test if compressed already - should never be?
     //   as double compression can have problems
-    if(use_compression) {
-      unsigned int dest_size =
-        compressBuffer(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+    data_buffer.compression_algo_ = UNCOMPRESSED;
+    if(compression_algo != UNCOMPRESSED) {
+      unsigned int dest_size = 0;
+      switch(compression_algo) {
+        case ZLIB:
+          dest_size = compressBuffer(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+          break;
+        case LZMA:
+          dest_size = compressBufferLZMA(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+          break;
+        case ZSTD:
+          dest_size = compressBufferZSTD(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+          break;
+        case LZ4:
+          dest_size = compressBufferLZ4(data_buffer.ptr_, data_buffer.curr_event_size_, data_buffer.comp_buf_, compression_level);
+          break;
+        default:
+          throw cms::Exception("StreamTranslation","Unknown compression algorithm")
+            << "StreamSerializer got the unknown compression algorithm " << compression_algo
+            << " while attempting to serialize event: " << event.id();
+      }
       if(dest_size != 0) {
         data_buffer.ptr_ = &data_buffer.comp_buf_[0]; // reset to point at compressed area
         data_buffer.curr_space_used_ = dest_size;
+        data_buffer.compression_algo_ = compression_algo;
       }
     }
     // calculate the adler32 checksum and fill it into the struct
@@ -278,4 +301,76 @@ namespace edm {
 
     return resultSize;
   }
+
+  unsigned int
+  StreamSerializer::compressBufferLZMA(unsigned char *inputBuffer,
+                                       unsigned int inputSize,
+                                       std::vector<unsigned char> &outputBuffer,
+                                       int compressionLevel) {
+    size_t dest_size = lzma_stream_buffer_bound(inputSize);
+    if(outputBuffer.size() < dest_size) outputBuffer.resize(dest_size);
+
+    // compression 0-9, 6 is the xz default; the data blob has its own
+    // adler32 checksum, so do not add one to the stream
+    size_t out_pos = 0;
+    lzma_ret ret = lzma_easy_buffer_encode(compressionLevel, LZMA_CHECK_NONE, nullptr,
+                                           inputBuffer, inputSize,
+                                           &outputBuffer[0], &out_pos, dest_size);
+    if(ret != LZMA_OK) {
+      std::cerr << "LZMA compression Return value: " << ret << " Okay = " << LZMA_OK << std::endl;
+      return 0;
+    }
+    FDEBUG(1) << " original size = " << inputSize
+              << " final size = " << out_pos
+              << " ratio = " << double(out_pos)/double(inputSize)
+              << std::endl;
+    return out_pos;
+  }
+
+  unsigned int
+  StreamSerializer::compressBufferZSTD(unsigned char *inputBuffer,
+                                       unsigned int inputSize,
+                                       std::vector<unsigned char> &outputBuffer,
+                                       int compressionLevel) {
+    size_t dest_size = ZSTD_compressBound(inputSize);
+    if(outputBuffer.size() < dest_size) outputBuffer.resize(dest_size);
+
+    // compression 1-22, 3 is the zstd default
+    size_t ret = ZSTD_compress(&outputBuffer[0], dest_size, inputBuffer, inputSize, compressionLevel);
+    if(ZSTD_isError(ret)) {
+      std::cerr << "ZSTD compression error: " << ZSTD_getErrorName(ret) << std::endl;
+      return 0;
+    }
+    FDEBUG(1) << " original size = " << inputSize
+              << " final size = " << ret
+              << " ratio = " << double(ret)/double(inputSize)
+              << std::endl;
+    return ret;
+  }
+
+  unsigned int
+  StreamSerializer::compressBufferLZ4(unsigned char *inputBuffer,
+                                      unsigned int inputSize,
+                                      std::vector<unsigned char> &outputBuffer,
+                                      int compressionLevel) {
+    int dest_size = LZ4_compressBound(inputSize);
+    if(outputBuffer.size() < (unsigned int)dest_size) outputBuffer.resize(dest_size);
+
+    // level 1 is the fast LZ4 compressor, 2-12 the high compression one
+    int ret;
+    if(compressionLevel <= 1) {
+      ret = LZ4_compress_default((char const*)inputBuffer, (char*)&outputBuffer[0], inputSize, dest_size);
+    } else {
+      ret = LZ4_compress_HC((char const*)inputBuffer, (char*)&outputBuffer[0], inputSize, dest_size, compressionLevel);
+    }
+    if(ret <= 0) {
+      std::cerr << "LZ4 compression failed for an input of size " << inputSize << std::endl;
+      return 0;
+    }
+    FDEBUG(1) << " original size = " << inputSize
+              << " final size = " << ret
+              << " ratio = " << double(ret)/double(inputSize)
+              << std::endl;
+    return ret;
+  }
 }
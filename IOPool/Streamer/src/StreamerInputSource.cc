@@ -17,6 +17,9 @@
 #include "DataFormats/Provenance/interface/ThinnedAssociationsHelper.h"
 
 #include "zlib.h"
+#include "lzma.h"
+#include "zstd.h"
+#include "lz4.h"
 
 #include "DataFormats/Common/interface/RefCoreStreamer.h"
 #include "FWCore/Utilities/interface/WrappedClassName.h"
@@ -31,6 +34,7 @@
 #include "DataFormats/Provenance/interface/ProcessHistoryRegistry.h"
 #include "FWCore/Utilities/interface/DebugMacros.h"
 
+#include <cstdint>
 #include <string>
 #include <iostream>
 #include <set>
@@ -227,17 +231,33 @@ namespace edm {
         << " chksum from event = " << adler32_chksum << " from header = "
         << eventView.adler32_chksum() << " host name = " << eventView.hostName() << std::endl;
     }
-    if(origsize != 78 && origsize != 0) {
-      // compressed
-      dest_size = uncompressBuffer(const_cast<unsigned char*>((unsigned char const*)eventView.eventData()),
-                                   eventView.eventLength(), dest_, origsize);
-    } else { // not compressed
-      // we need to copy anyway the buffer as we are using dest in xbuf
-      dest_size = eventView.eventLength();
-      dest_.resize(dest_size);
-      unsigned char* pos = (unsigned char*) &dest_[0];
-      unsigned char const* from = (unsigned char const*) eventView.eventData();
-      std::copy(from,from+dest_size,pos);
+    unsigned char* compressed = const_cast<unsigned char*>((unsigned char const*)eventView.eventData());
+    switch(eventView.compressionAlgo()) {
+      case ZLIB:
+        dest_size = uncompressBuffer(compressed, eventView.eventLength(), dest_, origsize);
+        break;
+      case LZMA:
+        dest_size = uncompressBufferLZMA(compressed, eventView.eventLength(), dest_, origsize);
+        break;
+      case ZSTD:
+        dest_size = uncompressBufferZSTD(compressed, eventView.eventLength(), dest_, origsize);
+        break;
+      case LZ4:
+        dest_size = uncompressBufferLZ4(compressed, eventView.eventLength(), dest_, origsize);
+        break;
+      case UNCOMPRESSED:
+      {
+        // we need to copy anyway the buffer as we are using dest in xbuf
+        dest_size = eventView.eventLength();
+        dest_.resize(dest_size);
+        unsigned char* pos = (unsigned char*) &dest_[0];
+        unsigned char const* from = (unsigned char const*) eventView.eventData();
+        std::copy(from,from+dest_size,pos);
+        break;
+      }
+      default:
+        throw cms::Exception("StreamDeserialization","Uncompression error")
+          << "Unknown compression algorithm " << eventView.compressionAlgo() << "\n";
     }
     //TBuffer xbuf(TBuffer::kRead, dest_size,
     //             (char const*) &dest[0],kFALSE);
@@ -387,6 +407,77 @@ namespace edm {
     return (unsigned int) uncompressedSize;
   }
 
+  unsigned int
+  StreamerInputSource::uncompressBufferLZMA(unsigned char* inputBuffer,
+                                            unsigned int inputSize,
+                                            std::vector<unsigned char>& outputBuffer,
+                                            unsigned int expectedFullSize) {
+    FDEBUG(1) << "UncompressLZMA: original size = " << expectedFullSize
+              << ", compressed size = " << inputSize
+              << std::endl;
+    outputBuffer.resize(expectedFullSize);
+    uint64_t memlimit = UINT64_MAX;
+    size_t in_pos = 0;
+    size_t out_pos = 0;
+    lzma_ret ret = lzma_stream_buffer_decode(&memlimit, 0, nullptr,
+                                             inputBuffer, &in_pos, inputSize,
+                                             &outputBuffer[0], &out_pos, expectedFullSize);
+    if(ret != LZMA_OK) {
+        throw cms::Exception("StreamDeserialization","LZMA uncompression error")
+            << "Error code = " << ret << "\n ";
+    }
+    if(out_pos != expectedFullSize) {
+        throw cms::Exception("StreamDeserialization","LZMA uncompression error")
+          << "mismatch event lengths should be" << expectedFullSize << " got "
+          << out_pos << "\n";
+    }
+    return (unsigned int) out_pos;
+  }
+
+  unsigned int
+  StreamerInputSource::uncompressBufferZSTD(unsigned char* inputBuffer,
+                                            unsigned int inputSize,
+                                            std::vector<unsigned char>& outputBuffer,
+                                            unsigned int expectedFullSize) {
+    FDEBUG(1) << "UncompressZSTD: original size = " << expectedFullSize
+              << ", compressed size = " << inputSize
+              << std::endl;
+    outputBuffer.resize(expectedFullSize);
+    size_t ret = ZSTD_decompress(&outputBuffer[0], expectedFullSize, inputBuffer, inputSize);
+    if(ZSTD_isError(ret)) {
+        throw cms::Exception("StreamDeserialization","ZSTD uncompression error")
+            << "Error = " << ZSTD_getErrorName(ret) << "\n ";
+    }
+    if(ret != expectedFullSize) {
+        throw cms::Exception("StreamDeserialization","ZSTD uncompression error")
+          << "mismatch event lengths should be" << expectedFullSize << " got "
+          << ret << "\n";
+    }
+    return (unsigned int) ret;
+  }
+
+  unsigned int
+  StreamerInputSource::uncompressBufferLZ4(unsigned char* inputBuffer,
+                                           unsigned int inputSize,
+                                           std::vector<unsigned char>& outputBuffer,
+                                           unsigned int expectedFullSize) {
+    FDEBUG(1) << "UncompressLZ4: original size = " << expectedFullSize
+              << ", compressed size = " << inputSize
+              << std::endl;
+    outputBuffer.resize(expectedFullSize);
+    int ret = LZ4_decompress_safe((char const*)inputBuffer, (char*)&outputBuffer[0], inputSize, expectedFullSize);
+    if(ret < 0) {
+        throw cms::Exception("StreamDeserialization","LZ4 uncompression error")
+            << "Error code = " << ret << "\n ";
+    }
+    if((unsigned int)ret != expectedFullSize) {
+        throw cms::Exception("StreamDeserialization","LZ4 uncompression error")
+          << "mismatch event lengths should be" << expectedFullSize << " got "
+          << ret << "\n";
+    }
+    return (unsigned int) ret;
+  }
+
   void StreamerInputSource::resetAfterEndRun() {
      // called from an online streamer source to reset after a stop command
      // so an enable command will work
@@ -8,6 +8,7 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 #include "FWCore/Utilities/interface/DebugMacros.h"
+#include "FWCore/Utilities/interface/Exception.h"
 //#include "FWCore/Utilities/interface/Digest.h"
 #include "FWCore/Version/interface/GetReleaseVersion.h"
 #include "DataFormats/Common/interface/TriggerResults.h"
@@ -51,24 +52,39 @@ namespace {
     // std::cout << std::endl;
 
   }
+
+  StreamerCompressionAlgo compressionAlgoFromName(std::string const& name) {
+    if(name == "ZLIB") return ZLIB;
+    if(name == "LZMA") return LZMA;
+    if(name == "ZSTD") return ZSTD;
+    if(name == "LZ4") return LZ4;
+    throw cms::Exception("StreamerOutputModuleBase")
+      << "Unknown compression algorithm \"" << name << "\", the supported ones are ZLIB, LZMA, ZSTD and LZ4";
+  }
+
+  // highest compression level supported by each algorithm
+  int maxCompressionLevel(StreamerCompressionAlgo algo) {
+    switch(algo) {
+      case ZSTD: return 22;
+      case LZ4: return 12;
+      default: return 9;
+    }
+  }
 }
 
 namespace edm {
   StreamerOutputModuleBase::StreamerOutputModuleBase(ParameterSet const& ps) :
-    one::OutputModuleBase::OutputModuleBase(ps),
-    one::OutputModule<one::WatchRuns, one::WatchLuminosityBlocks>(ps),
+    global::OutputModuleBase::OutputModuleBase(ps),
+    global::OutputModule<>(ps),
     selections_(&keptProducts()[InEvent]),
     maxEventSize_(ps.getUntrackedParameter<int>("max_event_size")),
-    useCompression_(ps.getUntrackedParameter<bool>("use_compression")),
+    compressionAlgo_(compressionAlgoFromName(ps.getUntrackedParameter<std::string>("compression_algorithm"))),
     compressionLevel_(ps.getUntrackedParameter<int>("compression_level")),
     lumiSectionInterval_(ps.getUntrackedParameter<int>("lumiSection_interval")),
     serializer_(selections_),
     serializeDataBuffer_(),
+    streamDataBuffers_(),
     hltsize_(0),
-    lumi_(0),
-    l1bit_(0),
-    hltbits_(0),
-    origSize_(0),
     host_name_(),
     trToken_(consumes<edm::TriggerResults>(edm::InputTag("TriggerResults"))),
     hltTriggerSelections_(),
@@ -81,19 +97,18 @@ namespace edm {
     gettimeofday(&now, &dummyTZ);
     timeInSecSinceUTC = static_cast<double>(now.tv_sec) + (static_cast<double>(now.tv_usec)/1000000.0);
 
-    if(useCompression_ == true) {
-      if(compressionLevel_ <= 0) {
-        FDEBUG(9) << "Compression Level = " << compressionLevel_
-                  << " no compression" << std::endl;
-        compressionLevel_ = 0;
-        useCompression_ = false;
-      } else if(compressionLevel_ > 9) {
-        FDEBUG(9) << "Compression Level = " << compressionLevel_
-                  << " using max compression level 9" << std::endl;
-        compressionLevel_ = 9;
-      }
+    if(!ps.getUntrackedParameter<bool>("use_compression")) {
+      compressionAlgo_ = UNCOMPRESSED;
+    } else if(compressionLevel_ <= 0) {
+      FDEBUG(9) << "Compression Level = " << compressionLevel_
+                << " no compression" << std::endl;
+      compressionLevel_ = 0;
+      compressionAlgo_ = UNCOMPRESSED;
+    } else if(compressionLevel_ > maxCompressionLevel(compressionAlgo_)) {
+      FDEBUG(9) << "Compression Level = " << compressionLevel_
+                << " using max compression level " << maxCompressionLevel(compressionAlgo_) << std::endl;
+      compressionLevel_ = maxCompressionLevel(compressionAlgo_);
     }
-    serializeDataBuffer_.bufs_.resize(maxEventSize_);
     int got_host = gethostname(host_name_, 255);
     if(got_host != 0) strncpy(host_name_, "noHostNameFoundOrTooLong", sizeof(host_name_));
     //loadExtraClasses();
@@ -106,7 +121,15 @@ namespace edm {
   StreamerOutputModuleBase::~StreamerOutputModuleBase() {}
 
   void
-  StreamerOutputModuleBase::beginRun(RunForOutput const&) {
+  StreamerOutputModuleBase::preallocStreams(unsigned int nStreams) {
+    streamDataBuffers_.reset(new SerializeDataBuffer[nStreams]);
+    for(unsigned int i = 0; i < nStreams; ++i) {
+      streamDataBuffers_[i].bufs_.resize(maxEventSize_);
+    }
+  }
+
+  void
+  StreamerOutputModuleBase::doBeginRun_(RunForOutput const&) {
     start();
     std::unique_ptr<InitMsgBuilder>  init_message = serializeRegistry();
     doOutputHeader(*init_message);
@@ -115,10 +138,20 @@ namespace edm {
   }
 
   void
-  StreamerOutputModuleBase::endRun(RunForOutput const&) {
+  StreamerOutputModuleBase::doEndRun_(RunForOutput const&) {
     stop();
   }
 
+  void
+  StreamerOutputModuleBase::doBeginLuminosityBlock_(LuminosityBlockForOutput const& lb) {
+    beginLuminosityBlock(lb);
+  }
+
+  void
+  StreamerOutputModuleBase::doEndLuminosityBlock_(LuminosityBlockForOutput const& lb) {
+    endLuminosityBlock(lb);
+  }
+
   void
   StreamerOutputModuleBase::beginJob() {}
 
@@ -135,7 +168,10 @@ namespace edm {
 
   void
   StreamerOutputModuleBase::write(EventForOutput const& e) {
-    std::unique_ptr<EventMsgBuilder> msg = serializeEvent(e);
+    // the serialization and the compression run concurrently for the
+    // different streams, only the output itself is serial
+    std::unique_ptr<EventMsgBuilder> msg = serializeEvent(e, streamDataBuffers_[e.streamID().value()]);
+    std::lock_guard<std::mutex> guard(outputMutex_);
     doOutputEvent(*msg); // You can't use msg in StreamerOutputModuleBase after this point
   }
 
@@ -189,6 +225,7 @@ namespace edm {
                            moduleLabel.c_str(), outputModuleId_,
                            hltTriggerNames, hltTriggerSelections_, l1_names,
                            (uint32)serializeDataBuffer_.adler32_chksum());
+    init_message->setCompressionAlgo(compressionAlgo_);
 
     // copy data into the destination message
     unsigned char* src = serializeDataBuffer_.bufferPointer();
@@ -205,9 +242,9 @@ namespace edm {
   }
 
   void
-  StreamerOutputModuleBase::setHltMask(EventForOutput const& e) {
+  StreamerOutputModuleBase::setHltMask(EventForOutput const& e, std::vector<unsigned char>& hltbits) const {
 
-    hltbits_.clear();  // If there was something left over from last event
+    hltbits.clear();  // If there was something left over from last event
 
     Handle<TriggerResults> const& prod = getTriggerResults(trToken_, e);
     //Trig const& prod = getTrigMask(e);
@@ -223,61 +260,62 @@ namespace edm {
            vHltState.push_back(hlt::Pass);
       }
     }
-    //Pack into member hltbits_
-    packIntoString(vHltState, hltbits_);
+    //Pack into hltbits
+    packIntoString(vHltState, hltbits);
 
     //This is Just a printing code.
-    //std::cout << "Size of hltbits:" << hltbits_.size() << std::endl;
-    //for(unsigned int i=0; i != hltbits_.size() ; ++i) {
-    //  printBits(hltbits_[i]);
+    //std::cout << "Size of hltbits:" << hltbits.size() << std::endl;
+    //for(unsigned int i=0; i != hltbits.size() ; ++i) {
+    //  printBits(hltbits[i]);
     //}
     //std::cout << "\n";
   }
 
 // test luminosity sections
-  void
-  StreamerOutputModuleBase::setLumiSection() {
+  uint32
+  StreamerOutputModuleBase::lumiSection() const {
     struct timeval now;
     struct timezone dummyTZ;
     gettimeofday(&now, &dummyTZ);
     double timeInSec = static_cast<double>(now.tv_sec) + (static_cast<double>(now.tv_usec)/1000000.0) - timeInSecSinceUTC;
     // what about overflows?
-    if(lumiSectionInterval_ > 0) lumi_ = static_cast<uint32>(timeInSec/lumiSectionInterval_) + 1;
+    if(lumiSectionInterval_ <= 0) return 0;
+    return static_cast<uint32>(timeInSec/lumiSectionInterval_) + 1;
   }
 
   std::unique_ptr<EventMsgBuilder>
-  StreamerOutputModuleBase::serializeEvent(EventForOutput const& e) {
+  StreamerOutputModuleBase::serializeEvent(EventForOutput const& e, SerializeDataBuffer& data_buffer) const {
     //Lets Build the Event Message first
 
     //Following is strictly DUMMY Data for L! Trig and will be replaced with actual
     // once figured out, there is no logic involved here.
-    l1bit_.push_back(true);
-    l1bit_.push_back(true);
-    l1bit_.push_back(false);
+    std::vector<bool> l1bit = {true, true, false};
     //End of dummy data
 
-    setHltMask(e);
+    std::vector<unsigned char> hltbits;
+    setHltMask(e, hltbits);
 
+    uint32 lumi;
     if (lumiSectionInterval_ == 0) {
-      lumi_ = e.luminosityBlock();
+      lumi = e.luminosityBlock();
     } else {
-      setLumiSection();
+      lumi = lumiSection();
     }
 
-    serializer_.serializeEvent(e, selectorConfig(), useCompression_, compressionLevel_, serializeDataBuffer_);
+    serializer_.serializeEvent(e, selectorConfig(), compressionAlgo_, compressionLevel_, data_buffer);
 
     // resize bufs_ to reflect space used in serializer_ + header
     // I just added an overhead for header of 50000 for now
-    unsigned int src_size = serializeDataBuffer_.currentSpaceUsed();
+    unsigned int src_size = data_buffer.currentSpaceUsed();
     unsigned int new_size = src_size + 50000;
-    if(serializeDataBuffer_.bufs_.size() < new_size) serializeDataBuffer_.bufs_.resize(new_size);
+    if(data_buffer.bufs_.size() < new_size) data_buffer.bufs_.resize(new_size);
 
     auto msg = std::make_unique<EventMsgBuilder>(
-                              &serializeDataBuffer_.bufs_[0], serializeDataBuffer_.bufs_.size(), e.id().run(),
-                              e.id().event(), lumi_, outputModuleId_, 0,
-                              l1bit_, (uint8*)&hltbits_[0], hltsize_,
-                              (uint32)serializeDataBuffer_.adler32_chksum(), host_name_);
-    msg->setOrigDataSize(origSize_); // we need this set to zero
+                              &data_buffer.bufs_[0], data_buffer.bufs_.size(), e.id().run(),
+                              e.id().event(), lumi, outputModuleId_, 0,
+                              l1bit, hltbits.data(), hltsize_,
+                              (uint32)data_buffer.adler32_chksum(), host_name_);
+    msg->setOrigDataSize(0); // we need this set to zero
 
     // copy data into the destination message
     // an alternative is to have serializer only to the serialization
@@ -288,12 +326,13 @@ namespace edm {
     // size + overhead for header because we will not know the actual
     // compressed size.
 
-    unsigned char* src = serializeDataBuffer_.bufferPointer();
+    unsigned char* src = data_buffer.bufferPointer();
     std::copy(src,src + src_size, msg->eventAddr());
     msg->setEventLength(src_size);
-    if(useCompression_) msg->setOrigDataSize(serializeDataBuffer_.currentEventSize());
+    // the event is stored uncompressed if the compression failed
+    msg->setCompressionAlgo(data_buffer.compressionAlgo());
+    if(data_buffer.compressionAlgo() != UNCOMPRESSED) msg->setOrigDataSize(data_buffer.currentEventSize());
 
-    l1bit_.clear();  //Clear up for the next event to come.
     return msg;
   }
 
@@ -303,8 +342,11 @@ namespace edm {
         ->setComment("Starting size in bytes of the serialized event buffer.");
     desc.addUntracked<bool>("use_compression", true)
         ->setComment("If True, compression will be used to write streamer file.");
+    desc.addUntracked<std::string>("compression_algorithm", "ZLIB")
+        ->setComment("Compression algorithm to use: ZLIB, LZMA, ZSTD or LZ4.");
     desc.addUntracked<int>("compression_level", 1)
-        ->setComment("ROOT compression level to use.");
+        ->setComment("Compression level to use: 1-9 for ZLIB and LZMA, 1-22 for ZSTD,\n"
+                     "1-12 for LZ4 (1 is the fast LZ4 compressor, 2-12 the high compression one).");
     desc.addUntracked<int>("lumiSection_interval", 0)
         ->setComment("If 0, use lumi section number from event.\n"
                      "If not 0, the interval in seconds between fake lumi sections.");
@@ -119,6 +119,7 @@ int main() try {
 
   emb.setOrigDataSize(78);
   emb.setEventLength(sizeof(test_value));
+  emb.setCompressionAlgo(ZSTD);
   std::copy(&test_value[0],&test_value[0]+sizeof(test_value),
             emb.eventAddr());
 
@@ -147,9 +148,16 @@ int main() try {
 
   emb2.setOrigDataSize(eview.origDataSize());
   emb2.setEventLength(eview.eventLength());
+  emb2.setCompressionAlgo(eview.compressionAlgo());
   std::copy(eview.eventData(),eview.eventData()+eview.eventLength(),
             emb2.eventAddr());
 
+  if(eview.compressionAlgo() != ZSTD)
+    {
+      std::cerr << "compression algorithm not the same\n";
+      abort();
+    }
+
   if(equal(&buf[0],&buf[0]+emb.size(),buf2.begin())==false)
     {
       std::cerr << "event messages not the same\n";
@@ -0,0 +1,23 @@
+import FWCore.ParameterSet.Config as cms
+import sys
+
+# reads the file written by NewStreamOutAlgo_cfg.py with the algorithm
+# given as argument
+algo = sys.argv[2]
+
+process = cms.Process("TRANSFER")
+
+import FWCore.Framework.test.cmsExceptionsFatal_cff
+process.options = FWCore.Framework.test.cmsExceptionsFatal_cff.options
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+
+process.source = cms.Source("NewEventStreamFileReader",
+    fileNames = cms.untracked.vstring('file:teststreamfile_%s.dat' % algo)
+)
+
+process.a1 = cms.EDAnalyzer("StreamThingAnalyzer",
+    product_to_get = cms.string('m1')
+)
+
+process.end = cms.EndPath(process.a1)
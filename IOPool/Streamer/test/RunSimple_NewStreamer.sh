@@ -55,5 +55,16 @@ then
     RC=1
 fi
 
+for ALGO in ZLIB LZMA ZSTD LZ4
+do
+    cmsRun NewStreamOutAlgo_cfg.py ${ALGO} > out_${ALGO} 2>&1 || die "cmsRun NewStreamOutAlgo_cfg.py ${ALGO}" $?
+    cmsRun NewStreamInAlgo_cfg.py ${ALGO} > in_${ALGO} 2>&1 || die "cmsRun NewStreamInAlgo_cfg.py ${ALGO}" $?
+    if [ "${ANS_OUT}" != "`grep CHECKSUM out_${ALGO}`" ] || [ "${ANS_OUT}" != "`grep CHECKSUM in_${ALGO}`" ]
+    then
+        echo "New Stream Test Failed (${ALGO})"
+        RC=1
+    fi
+done
+
 #rm -rf ${OUTDIR}
 exit ${RC}
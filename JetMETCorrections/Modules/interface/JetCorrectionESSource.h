@@ -56,6 +56,8 @@ public:
 
     setWhatProduced(this, label);
     findingRecord<JetCorrectionsRecord>();
+    // the corrector is made from a text file only
+    mayUseOwnMutex();
   }
 
   ~JetCorrectionESSource() override {}
@@ -53,4 +53,8 @@ process.p1 = cms.Path(process.testField)
 
 ### Activate the check of finding volumes at random points 
 #process.testVolumeGeometry = cms.EDAnalyzer("testMagGeometryAnalyzer")
-#process.p2 = cms.Path(process.testVolumeGeometry) 
+#process.p2 = cms.Path(process.testVolumeGeometry)
+
+### Time findVolume on the field queries of AnalyticalPropagator and SteppingHelixPropagator
+### for the given number of random tracks (requires the analyzer above)
+#process.testVolumeGeometry.nBenchmarkTracks = cms.untracked.int32(10000) 
@@ -16,15 +16,50 @@
 #include "MagneticField/GeomBuilder/src/MagGeoBuilderFromDDD.h"
 #include "MagneticField/VolumeBasedEngine/interface/VolumeBasedMagneticField.h"
 
+#include "DataFormats/GeometrySurface/interface/Cylinder.h"
+#include "TrackingTools/GeomPropagators/interface/AnalyticalPropagator.h"
+#include "TrackingTools/TrajectoryState/interface/FreeTrajectoryState.h"
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+#include "TrackPropagation/SteppingHelixPropagator/interface/SteppingHelixPropagator.h"
+
 #include <iostream>
+#include <random>
 #include <vector>
 
 using namespace std;
 
+namespace {
+  // Forwards to the actual field, recording the points where it is queried
+  class RecordingMagneticField : public MagneticField {
+  public:
+    RecordingMagneticField(const MagneticField* field, vector<GlobalPoint>& points) :
+      theField(field), thePoints(points) {}
+
+    GlobalVector inTesla(const GlobalPoint& gp) const override {
+      thePoints.push_back(gp);
+      return theField->inTesla(gp);
+    }
+
+    GlobalVector inTeslaUnchecked(const GlobalPoint& gp) const override {
+      thePoints.push_back(gp);
+      return theField->inTeslaUnchecked(gp);
+    }
+
+    bool isDefined(const GlobalPoint& gp) const override {
+      return theField->isDefined(gp);
+    }
+
+  private:
+    const MagneticField* theField;
+    vector<GlobalPoint>& thePoints;
+  };
+}
+
 class testMagGeometryAnalyzer : public edm::EDAnalyzer {
  public:
   /// Constructor
-  testMagGeometryAnalyzer(const edm::ParameterSet& pset) {};
+  testMagGeometryAnalyzer(const edm::ParameterSet& pset) :
+    nBenchmarkTracks(pset.getUntrackedParameter<int>("nBenchmarkTracks", 0)) {};
 
   /// Destructor
   virtual ~testMagGeometryAnalyzer() {};
@@ -37,6 +72,13 @@ class testMagGeometryAnalyzer : public edm::EDAnalyzer {
   
  private:
   void testGrids( const vector<MagVolume6Faces const*>& bvol);
+
+  // Record the field queries of the propagators for random tracks
+  void recordAnalytical(const MagneticField* field, vector<GlobalPoint>& points);
+  void recordSteppingHelix(const MagneticField* field, vector<GlobalPoint>& points);
+  FreeTrajectoryState randomTrack(const MagneticField* field, std::mt19937& rng) const;
+
+  int nBenchmarkTracks;
 };
 
 using namespace edm;
@@ -55,6 +97,17 @@ void testMagGeometryAnalyzer::analyze(const edm::Event & event, const edm::Event
   //FIXME: the region to be tested is specified inside.
   exe.testFindVolume(10000000);
 
+  // Time findVolume on the query streams of the propagators
+  if (nBenchmarkTracks > 0) {
+    vector<GlobalPoint> points;
+    recordAnalytical(magfield.product(), points);
+    exe.timeFindVolume(points, "AnalyticalPropagator");
+
+    points.clear();
+    recordSteppingHelix(magfield.product(), points);
+    exe.timeFindVolume(points, "SteppingHelixPropagator");
+  }
+
   // Test that random points are inside one and only one volume
   // exe.testInside(100000,0.03); 
 
@@ -94,5 +147,53 @@ void testMagGeometryAnalyzer::testGrids(const vector<MagVolume6Faces const*>& bv
   }
 }
 
+FreeTrajectoryState testMagGeometryAnalyzer::randomTrack(const MagneticField* field, std::mt19937& rng) const {
+  std::uniform_real_distribution<float> pt(1.,50.);
+  std::uniform_real_distribution<float> eta(-2.5,2.5);
+  std::uniform_real_distribution<float> phi(-Geom::pi(),Geom::pi());
+  std::normal_distribution<float> vtx(0.,5.);
+
+  GlobalPoint pos(0., 0., vtx(rng));
+  float trackPt = pt(rng);
+  GlobalVector mom(GlobalVector::Cylindrical(trackPt, phi(rng), trackPt*sinh(eta(rng))));
+  return FreeTrajectoryState(GlobalTrajectoryParameters(pos, mom, (rng()%2 ? 1 : -1), field));
+}
+
+// Track fitting pattern: a track is propagated from one tracker layer to the next
+void testMagGeometryAnalyzer::recordAnalytical(const MagneticField* field, vector<GlobalPoint>& points) {
+  RecordingMagneticField recorder(field, points);
+  AnalyticalPropagator prop(&recorder, alongMomentum);
+  std::mt19937 rng(12345);
+
+  const float radii[] = {3., 7., 11., 16., 25., 34., 43., 52., 61., 70., 79., 88., 97., 108.};
+  vector<Cylinder::CylinderPointer> layers;
+  for (float r : radii) {
+    layers.push_back(Cylinder::build(r, Surface::PositionType(0,0,0), Surface::RotationType()));
+  }
+
+  for (int i = 0; i < nBenchmarkTracks; ++i) {
+    FreeTrajectoryState fts = randomTrack(&recorder, rng);
+    for (auto const& layer : layers) {
+      TrajectoryStateOnSurface tsos = prop.propagate(fts, *layer);
+      if (!tsos.isValid() || fabs(tsos.globalPosition().z()) > 280.) break;
+      fts = *tsos.freeState();
+    }
+  }
+}
+
+// Muon pattern: a track is propagated in steps from the vertex to the muon system
+void testMagGeometryAnalyzer::recordSteppingHelix(const MagneticField* field, vector<GlobalPoint>& points) {
+  RecordingMagneticField recorder(field, points);
+  SteppingHelixPropagator prop(&recorder, alongMomentum);
+  // query the field through MagneticField::inTesla, so that it is recorded
+  prop.setUseMagVolumes(false);
+  std::mt19937 rng(54321);
+
+  Cylinder::CylinderPointer muonStation = Cylinder::build(500., Surface::PositionType(0,0,0), Surface::RotationType());
+  for (int i = 0; i < nBenchmarkTracks; ++i) {
+    prop.propagate(randomTrack(&recorder, rng), *muonStation);
+  }
+}
+
 #include "FWCore/Framework/interface/MakerMacros.h"
 DEFINE_FWK_MODULE(testMagGeometryAnalyzer);
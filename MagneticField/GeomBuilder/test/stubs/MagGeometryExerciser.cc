@@ -12,6 +12,7 @@
 #include "GlobalPointProvider.h"
 
 #include <algorithm>
+#include <chrono>
 
 using namespace std;
 
@@ -90,6 +91,53 @@ bool MagGeometryExerciser::testFindVolume(const GlobalPoint & gp){
 
 
 
+//----------------------------------------------------------------------
+// Replay a stream of query points, as recorded from a propagator.
+// The cached lookup may return a different volume than the search only where
+// volumes overlap, i.e. if the point is inside() both of them.
+void MagGeometryExerciser::timeFindVolume(const vector<GlobalPoint>& points, const string& name, int nRepeat) {
+
+  cout << "-----------------------------------------------------" << endl
+       << " findVolume timing: " << name << ", " << points.size() << " points" << endl;
+
+  if (points.empty()) return;
+
+  int mismatches = 0;
+  for (auto const& gp : points) {
+    MagVolume const* v1 = theGeometry->findVolume(gp);
+    MagVolume const* v2 = theGeometry->findVolumeInLayers(gp, 0.);
+    if (v1 != v2 && (v1 == 0 || v2 == 0 || !v1->inside(gp))) {
+      cout << "ERROR: different volumes at " << gp << endl;
+      ++mismatches;
+    }
+  }
+
+  typedef chrono::high_resolution_clock Clock;
+  int found = 0;
+  auto start = Clock::now();
+  for (int i = 0; i < nRepeat; ++i) {
+    for (auto const& gp : points) {
+      if (theGeometry->findVolume(gp) != 0) ++found;
+    }
+  }
+  auto cached = chrono::duration<double, nano>(Clock::now() - start).count();
+
+  start = Clock::now();
+  for (int i = 0; i < nRepeat; ++i) {
+    for (auto const& gp : points) {
+      if (theGeometry->findVolumeInLayers(gp, 0.) != 0) ++found;
+    }
+  }
+  auto search = chrono::duration<double, nano>(Clock::now() - start).count();
+
+  double n = double(points.size())*nRepeat;
+  cout << " findVolume:         " << cached/n << " ns/query" << endl
+       << " findVolumeInLayers: " << search/n << " ns/query" << endl
+       << " Mismatches: " << mismatches << " (found " << found << ")" << endl
+       << "-----------------------------------------------------" << endl;
+}
+
+
 //----------------------------------------------------------------------
 // Check that a set of points is inside() one and only one volume.
 void MagGeometryExerciser::testInside(int ntry, float tolerance) {
@@ -7,6 +7,7 @@
  *  \author N. Amapane - INFN Torino
  */
 
+#include <string>
 #include <vector>
 #include "DataFormats/GeometryVector/interface/GlobalPoint.h"
 
@@ -26,6 +27,10 @@ public:
   void testFindVolume(int ntry = 100000); // findVolume(random) test
   void testInside(int ntry = 100000, float tolerance=0.);     // inside(random) test
 
+  // Replay a recorded stream of field queries through findVolume, and through
+  // the search in layers and sectors alone, and compare timing and results.
+  void timeFindVolume(const std::vector<GlobalPoint>& points, const std::string& name, int nRepeat = 10);
+
   //  void testFieldRandom(int ntry = 1000);// fieldInTesla vs MagneticField::inTesla (random)
   //  void testFieldVol1();  // fieldInTesla within vol 1 (tiny region)
   //  void testFieldLinear(int ntry = 1000);// fieldInTesla vs MagneticField::inTesla (track-like pattern)
@@ -12,7 +12,6 @@
 #include "DetectorDescription/Core/interface/DDCompactView.h"
 
 #include <vector>
-#include <atomic>
 
 class MagBLayer;
 class MagESector;
@@ -60,9 +59,24 @@ private:
   MagVolume const* findVolume1(const GlobalPoint & gp, double tolerance=0.) const;
 
 
+  // Search through the barrel layers and endcap sectors
+  MagVolume const* findVolumeInLayers(const GlobalPoint & gp, double tolerance) const;
+
+  // Volume expected at gp from the acceleration grid (nullptr if unknown);
+  // it must still be checked with inside().
+  MagVolume const* gridVolume(const GlobalPoint & gp) const;
+
+  // Fill theGrid, see MagGeometry.cc
+  void buildGrid();
+
   bool inBarrel(const GlobalPoint& gp) const;
 
-  mutable std::atomic<MagVolume const*> lastVolume; // Cache last volume found
+  // Uniform (R, phi, Z) grid over the tracker region; each cell holds the
+  // volume found at all of its corners and at its centre, if they agree.
+  std::vector<MagVolume const*> theGrid;
+
+  // Identifies this geometry in the per-thread cache of the last volume found
+  unsigned int theInstance;
 
   std::vector<MagBLayer const*> theBLayers;
   std::vector<MagESector const*> theESectors;
@@ -12,14 +12,41 @@
 
 #include "Utilities/BinningTools/interface/PeriodicBinFinderInPhi.h"
 
+#include "DataFormats/GeometryVector/interface/Pi.h"
 #include "FWCore/Utilities/interface/isFinite.h"
 
 #include "MagneticField/Layers/interface/MagVerbosity.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <atomic>
+#include <cmath>
+
 using namespace std;
 using namespace edm;
 
+namespace {
+  // Last volume found by the calling thread, and the geometry it belongs to.
+  // Keeping it per thread avoids that concurrent propagations in different
+  // regions keep overwriting each other's cache.
+  struct VolumeHint {
+    unsigned int instance = 0;
+    MagVolume const* volume = nullptr;
+  };
+  thread_local VolumeHint lastVolume;
+
+  std::atomic<unsigned int> nextInstance(1);
+
+  // Acceleration grid: R < gridRMax, |Z| < gridZMax, 10 cm x 7.5 deg x 10 cm cells
+  constexpr float gridRMax = 130.;
+  constexpr float gridZMax = 300.;
+  constexpr int gridNR = 13;
+  constexpr int gridNPhi = 48;
+  constexpr int gridNZ = 60;
+  constexpr float gridDR = gridRMax/gridNR;
+  constexpr float gridDPhi = Geom::ftwoPi()/gridNPhi;
+  constexpr float gridDZ = 2*gridZMax/gridNZ;
+}
+
 MagGeometry::MagGeometry(int geomVersion, const std::vector<MagBLayer *>& tbl,
 			 const std::vector<MagESector *>& tes,
 			 const std::vector<MagVolume6Faces*>& tbv,
@@ -31,7 +58,7 @@ MagGeometry::MagGeometry(int geomVersion, const std::vector<MagBLayer const*>& t
 			 const std::vector<MagESector const*>& tes,
 			 const std::vector<MagVolume6Faces const*>& tbv,
 			 const std::vector<MagVolume6Faces const*>& tev) : 
-  lastVolume(nullptr), theBLayers(tbl), theESectors(tes), theBVolumes(tbv), theEVolumes(tev), cacheLastVolume(true), geometryVersion(geomVersion)
+  theInstance(nextInstance++), theBLayers(tbl), theESectors(tes), theBVolumes(tbv), theEVolumes(tev), cacheLastVolume(true), geometryVersion(geomVersion)
 {
   vector<double> rBorders;
 
@@ -56,6 +83,49 @@ MagGeometry::MagGeometry(int geomVersion, const std::vector<MagBLayer const*>& t
   int nEBins = theESectors.size();
   theEndcapBinFinder = new PeriodicBinFinderInPhi<float>(theESectors.front()->minPhi()+Geom::pi()/nEBins, nEBins);
 
+  buildGrid();
+}
+
+// A cell of the grid is assigned a volume when the search finds the same
+// volume at its 8 corners and at its centre. This is only a guess for the
+// volume of the points inside the cell (a thin volume could be missed), so
+// findVolume always checks it with inside() and falls back to the search.
+void MagGeometry::buildGrid() {
+  auto point = [](float r, float phi, float z) {
+    return GlobalPoint(GlobalPoint::Cylindrical(r, phi, z));
+  };
+
+  // volumes at the grid nodes; phi is periodic, so there are gridNPhi nodes in phi
+  vector<MagVolume const*> nodes((gridNR+1)*gridNPhi*(gridNZ+1));
+  auto node = [&](int ir, int iphi, int iz) -> MagVolume const* & {
+    return nodes[(iz*gridNPhi + iphi%gridNPhi)*(gridNR+1) + ir];
+  };
+  for (int iz = 0; iz <= gridNZ; ++iz)
+    for (int iphi = 0; iphi < gridNPhi; ++iphi)
+      for (int ir = 0; ir <= gridNR; ++ir)
+	node(ir, iphi, iz) = findVolumeInLayers(point(ir*gridDR, -Geom::pi() + iphi*gridDPhi, -gridZMax + iz*gridDZ), 0.);
+
+  theGrid.assign(gridNR*gridNPhi*gridNZ, nullptr);
+  int nAssigned = 0;
+  for (int iz = 0; iz < gridNZ; ++iz) {
+    for (int iphi = 0; iphi < gridNPhi; ++iphi) {
+      for (int ir = 0; ir < gridNR; ++ir) {
+	MagVolume const* v = findVolumeInLayers(point((ir+0.5f)*gridDR, -Geom::pi() + (iphi+0.5f)*gridDPhi, -gridZMax + (iz+0.5f)*gridDZ), 0.);
+	if (v==nullptr) continue;
+	bool same = true;
+	for (int corner = 0; corner < 8 && same; ++corner) {
+	  same = (node(ir + (corner&1), iphi + ((corner>>1)&1), iz + ((corner>>2)&1)) == v);
+	}
+	if (same) {
+	  theGrid[(iz*gridNPhi + iphi)*gridNR + ir] = v;
+	  ++nAssigned;
+	}
+      }
+    }
+  }
+
+  if (verbose::debugOut) cout << "MagGeometry: " << nAssigned << " of " << theGrid.size()
+			      << " grid cells assigned to a volume" << endl;
 }
 
 MagGeometry::~MagGeometry(){
@@ -132,15 +202,45 @@ MagGeometry::findVolume1(const GlobalPoint & gp, double tolerance) const {
   return found;
 }
 
-// Use hierarchical structure for fast lookup.
+MagVolume const*
+MagGeometry::gridVolume(const GlobalPoint & gp) const {
+  if (theGrid.empty()) return nullptr;
+  float R = gp.perp();
+  float Z = gp.z();
+  if (!(R < gridRMax && fabs(Z) < gridZMax)) return nullptr;
+  // clamp against rounding at the upper edges
+  int ir = min(int(R/gridDR), gridNR-1);
+  int iphi = min(max(int((gp.barePhi() + Geom::fpi())/gridDPhi), 0), gridNPhi-1);
+  int iz = min(max(int((Z + gridZMax)/gridDZ), 0), gridNZ-1);
+  return theGrid[(iz*gridNPhi + iphi)*gridNR + ir];
+}
+
+// Check the last volume found by this thread, then the volume expected from
+// the acceleration grid, and only then go through the hierarchical search.
 MagVolume const* 
 MagGeometry::findVolume(const GlobalPoint & gp, double tolerance) const{
   // Check volume cache
-  auto lastVolumeCheck = lastVolume.load(std::memory_order_acquire);
-  if (lastVolumeCheck!=nullptr && lastVolumeCheck->inside(gp)){
-    return lastVolumeCheck;
+  VolumeHint & hint = lastVolume;
+  if (hint.instance==theInstance && hint.volume!=nullptr && hint.volume->inside(gp)){
+    return hint.volume;
+  }
+
+  MagVolume const* result = gridVolume(gp);
+  if (result==nullptr || !result->inside(gp)) {
+    result = findVolumeInLayers(gp, tolerance);
   }
 
+  if (cacheLastVolume) {
+    hint.instance = theInstance;
+    hint.volume = result;
+  }
+
+  return result;
+}
+
+// Use hierarchical structure for fast lookup.
+MagVolume const* 
+MagGeometry::findVolumeInLayers(const GlobalPoint & gp, double tolerance) const{
   MagVolume const* result=nullptr;
   if (inBarrel(gp)) { // Barrel
     double R = gp.perp();
@@ -172,11 +272,9 @@ MagGeometry::findVolume(const GlobalPoint & gp, double tolerance) const{
     // This is a hack for thin gaps on air-iron boundaries,
     // which will not be present anymore once surfaces are matched.
     if (verbose::debugOut) cout << "Increasing the tolerance to 0.03" <<endl;
-    result = findVolume(gp, 0.03);
+    result = findVolumeInLayers(gp, 0.03);
   }
 
-  if (cacheLastVolume) lastVolume.store(result,std::memory_order_release);
-
   return result;
 }
 
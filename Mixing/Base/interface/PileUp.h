@@ -2,6 +2,7 @@
 #define Mixing_Base_PileUp_h
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -9,6 +10,7 @@
 #include "DataFormats/Provenance/interface/EventID.h"
 #include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "Mixing/Base/interface/PileUpEventPool.h"
 
 #include "TRandom.h"
 #include "TFile.h"
@@ -35,6 +37,10 @@ namespace edm {
     double averageNumber_;
     std::shared_ptr<TH1F> histo_;
     const bool playback_;
+    // pool of pileup events shared by the streams, created by the first of
+    // them if 'poolSize' is set
+    std::shared_ptr<PileUpEventPool> pool_;
+    std::once_flag poolOnce_;
   };
 
   class PileUp {
@@ -63,7 +69,11 @@ namespace edm {
     }
     void dropUnwantedBranches(std::vector<std::string> const& wantedBranches) {
       input_->dropUnwantedBranches(wantedBranches);
+      if (pool_) pool_->dropUnwantedBranches(wantedBranches);
     }
+    // true if the pileup events are taken from a pool shared with the other
+    // streams, in which case their products must not be modified
+    bool sharedEvents() const {return bool(pool_);}
     void beginStream(edm::StreamID);
     void endStream();
 
@@ -140,6 +150,11 @@ namespace edm {
 
     // sequential reading
     bool sequential_;
+
+    // shared pool of pileup events, and the signal event they are drawn for
+    std::shared_ptr<PileUpEventPool> pool_;
+    EventID poolSignal_;
+    unsigned long long poolToken_;
   };
 
 
@@ -181,8 +196,21 @@ namespace edm {
     ids.reserve(pileEventCnt);
     RecordEventID<T> recorder(ids,eventOperator);
     int read = 0;
-    CLHEP::HepRandomEngine* engine = (sequential_ ? nullptr : randomEngine(streamID));
-    read = input_->loopOverEvents(*eventPrincipal_, fileNameHash_, pileEventCnt, recorder, engine, &signal);
+    if (pool_) {
+      if (signal != poolSignal_) {
+        poolSignal_ = signal;
+        poolToken_ = pool_->newToken();
+      }
+      std::vector<std::shared_ptr<PileUpEventPool::Event const> > events;
+      pool_->draw(pileEventCnt, *randomEngine(streamID), poolToken_, events);
+      for (auto const& event : events) {
+        recorder(event->principal(), event->fileNameHash());
+      }
+      read = events.size();
+    } else {
+      CLHEP::HepRandomEngine* engine = (sequential_ ? nullptr : randomEngine(streamID));
+      read = input_->loopOverEvents(*eventPrincipal_, fileNameHash_, pileEventCnt, recorder, engine, &signal);
+    }
     if (read != pileEventCnt)
       edm::LogWarning("PileUp") << "Could not read enough pileup events: only " << read << " out of " << pileEventCnt << " requested.";
   }
@@ -0,0 +1,117 @@
+#ifndef Mixing_Base_PileUpEventPool_h
+#define Mixing_Base_PileUpEventPool_h
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "CLHEP/Random/JamesRandom.h"
+
+namespace CLHEP {
+  class HepRandomEngine;
+}
+
+namespace edm {
+  class EventPrincipal;
+  class ParameterSet;
+  class ProcessConfiguration;
+  class ProductRegistry;
+  class VectorInputSource;
+
+  /*! Pool of pileup events, read and fully decoded once, shared by the
+   *  PileUp objects of all the streams of a mixing module.
+   *
+   *  The events are drawn at random from the pool.  Each event is used
+   *  at most 'poolMaxReuse' times, and never twice for the same signal
+   *  event; it is then dropped from the pool.  Before drawing, the calling
+   *  stream tops the pool up to 'poolSize' events, unless another stream is
+   *  already reading, in which case it draws from the pool as it is rather
+   *  than wait.  If the pool does not hold enough events, the missing ones
+   *  are read by the calling stream; this waits for any other stream that
+   *  is reading, which only happens when 'poolSize' is too small for the
+   *  pileup of the streams.
+   *
+   *  The events of the pool are read-only: the products must not be
+   *  modified in place (see Adjuster and PileUpEventPrincipal).
+   *
+   *  With a single stream the pool is always full when drawing, so the
+   *  events mixed with each signal event only depend on the random seeds.
+   *  With several streams they depend on the order in which the streams
+   *  draw, and the job can only be reproduced by playing back the mixing.
+   */
+  class PileUpEventPool {
+  public:
+    class Event {
+    public:
+      Event(std::unique_ptr<EventPrincipal> principal, size_t fileNameHash);
+      ~Event();
+
+      EventPrincipal const& principal() const {return *principal_;}
+      size_t fileNameHash() const {return fileNameHash_;}
+
+    private:
+      friend class PileUpEventPool;
+
+      std::unique_ptr<EventPrincipal> const principal_;
+      size_t const fileNameHash_;
+      // guarded by the mutex of the pool
+      unsigned int uses_;
+      unsigned long long token_;
+    };
+
+    // makes the next pileup event, a null pointer if there is none left
+    typedef std::function<std::shared_ptr<Event>()> Reader;
+
+    // pset is the parameter set of the secondary source
+    explicit PileUpEventPool(ParameterSet const& pset);
+    // for unit tests: the events are made by 'reader' instead of a source
+    PileUpEventPool(unsigned int size, unsigned int maxReuse, Reader reader);
+    ~PileUpEventPool();
+
+    PileUpEventPool(PileUpEventPool const&) = delete;
+    PileUpEventPool& operator=(PileUpEventPool const&) = delete;
+
+    // 0 if the pool is not enabled in the parameter set
+    static unsigned int poolSize(ParameterSet const& pset);
+
+    // only the first call of each of these has an effect
+    void dropUnwantedBranches(std::vector<std::string> const& wantedBranches);
+    void beginJob(unsigned int seed);
+
+    // identifies the events drawn for one signal event
+    unsigned long long newToken() {return ++tokens_;}
+
+    // appends 'number' different events to 'events'
+    void draw(size_t number, CLHEP::HepRandomEngine& engine, unsigned long long token,
+              std::vector<std::shared_ptr<Event const> >& events);
+
+  private:
+    // to be called with inputMutex_ held
+    std::shared_ptr<Event> readEvent();
+    void topUp();
+
+    unsigned int const size_;
+    unsigned int const maxReuse_;
+
+    std::shared_ptr<ProductRegistry> productRegistry_;
+    std::unique_ptr<VectorInputSource> const input_;
+    std::shared_ptr<ProcessConfiguration> processConfiguration_;
+    CLHEP::HepJamesRandom engine_;
+    Reader const reader_;
+    std::mutex inputMutex_;   // guards input_, engine_ and reader_
+
+    std::vector<std::shared_ptr<Event> > events_;
+    std::mutex mutex_;        // guards events_
+
+    std::atomic<unsigned long long> tokens_;
+
+    std::once_flag dropOnce_;
+    std::once_flag beginOnce_;
+    bool begun_;
+  };
+}
+
+#endif
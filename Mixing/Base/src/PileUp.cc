@@ -88,7 +88,10 @@ namespace edm {
     PoissonDistr_OOT_(),
     randomEngine_(),
     playback_(config->playback_),
-    sequential_(pset.getUntrackedParameter<bool>("sequential", false)) {
+    sequential_(pset.getUntrackedParameter<bool>("sequential", false)),
+    pool_(),
+    poolSignal_(),
+    poolToken_(0U) {
 
     // Use the empty parameter set for the parameter set ID of our "@MIXING" process.
     processConfiguration_->setParameterSetID(ParameterSet::emptyParameterSetID());
@@ -169,16 +172,28 @@ namespace edm {
       }
     }
 
+    // In playback the events to mix are given, the pool is of no use.
+    if(PileUpEventPool::poolSize(pset) > 0 && !playback_) {
+      std::call_once(config->poolOnce_, [&] {
+        config->pool_ = std::make_shared<PileUpEventPool>(pset);
+      });
+      pool_ = config->pool_;
+    }
+
     if(Source_type_ == "cosmics") {  // allow for some extra flexibility for mixing
       minBunch_cosmics_ = pset.getUntrackedParameter<int>("minBunch_cosmics", -1000);
       maxBunch_cosmics_ = pset.getUntrackedParameter<int>("maxBunch_cosmics", 1000);
     }
   } // end of constructor
 
-  void PileUp::beginStream (edm::StreamID) {
+  void PileUp::beginStream (edm::StreamID streamID) {
     auto iID = eventPrincipal_->streamID(); // each producer has its own workermanager, so use default streamid
     streamContext_.reset(new StreamContext(iID, processContext_.get()));
     input_->doBeginJob();
+    if (pool_) {
+      // the first stream seeds the engine used to read the pool
+      pool_->beginJob(static_cast<unsigned int>(*randomEngine(streamID)));
+    }
     if (provider_.get() != nullptr) {
       provider_->beginJob(*productRegistry_);
       provider_->beginStream(iID, *streamContext_);
@@ -0,0 +1,198 @@
+#include "Mixing/Base/interface/PileUpEventPool.h"
+#include "DataFormats/Provenance/interface/BranchID.h"
+#include "DataFormats/Provenance/interface/BranchIDListHelper.h"
+#include "DataFormats/Provenance/interface/ProcessConfiguration.h"
+#include "DataFormats/Provenance/interface/ProductProvenanceRetriever.h"
+#include "DataFormats/Provenance/interface/ThinnedAssociationsHelper.h"
+#include "FWCore/Framework/interface/EventPrincipal.h"
+#include "FWCore/Framework/src/SignallingProductRegistry.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Sources/interface/VectorInputSource.h"
+#include "FWCore/Sources/interface/VectorInputSourceDescription.h"
+#include "FWCore/Sources/interface/VectorInputSourceFactory.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/GetPassID.h"
+#include "FWCore/Version/interface/GetReleaseVersion.h"
+
+#include "CLHEP/Random/RandFlat.h"
+
+#include <algorithm>
+
+namespace edm {
+
+  PileUpEventPool::Event::Event(std::unique_ptr<EventPrincipal> principal, size_t fileNameHash) :
+    principal_(std::move(principal)),
+    fileNameHash_(fileNameHash),
+    uses_(0U),
+    token_(0U) {
+  }
+
+  PileUpEventPool::Event::~Event() {
+  }
+
+  unsigned int PileUpEventPool::poolSize(ParameterSet const& pset) {
+    return pset.getUntrackedParameter<unsigned int>("poolSize", 0U);
+  }
+
+  PileUpEventPool::PileUpEventPool(ParameterSet const& pset) :
+    size_(poolSize(pset)),
+    maxReuse_(pset.getUntrackedParameter<unsigned int>("poolMaxReuse", 1U)),
+    productRegistry_(new SignallingProductRegistry),
+    input_(VectorInputSourceFactory::get()->makeVectorInputSource(pset, VectorInputSourceDescription(
+                                                                   productRegistry_, edm::PreallocationConfiguration())).release()),
+    processConfiguration_(new ProcessConfiguration(std::string("@MIXING"), getReleaseVersion(), getPassID())),
+    engine_(),
+    reader_(),
+    events_(),
+    tokens_(0U),
+    begun_(false) {
+
+    if (maxReuse_ == 0U) {
+      throw cms::Exception("Illegal parameter value","PileUpEventPool::PileUpEventPool(ParameterSet const& pset)")
+        << "'poolMaxReuse' must be at least 1\n";
+    }
+    // the events of the pool do not depend on the signal event
+    if (pset.getUntrackedParameter<bool>("sequential", false) ||
+        pset.getUntrackedParameter<bool>("sameLumiBlock", false) ||
+        pset.existsAs<std::vector<ParameterSet> >("producers", true)) {
+      throw cms::Exception("Configuration","PileUpEventPool::PileUpEventPool(ParameterSet const& pset)")
+        << "A pool of pileup events ('poolSize' > 0) cannot be used together with\n"
+        << "'sequential', 'sameLumiBlock' or secondary 'producers'.\n";
+    }
+
+    processConfiguration_->setParameterSetID(ParameterSet::emptyParameterSetID());
+    productRegistry_->setFrozen();
+    events_.reserve(size_);
+
+    edm::LogInfo("MixingModule") << "Pileup events will be drawn from a pool of " << size_
+                                 << " events shared by all the streams, each used at most "
+                                 << maxReuse_ << " times; with several streams, the job can only be reproduced by playback";
+  }
+
+  PileUpEventPool::PileUpEventPool(unsigned int size, unsigned int maxReuse, Reader reader) :
+    size_(size),
+    maxReuse_(maxReuse),
+    productRegistry_(),
+    input_(),
+    processConfiguration_(),
+    engine_(),
+    reader_(reader),
+    events_(),
+    tokens_(0U),
+    begun_(false) {
+    events_.reserve(size_);
+  }
+
+  PileUpEventPool::~PileUpEventPool() {
+    if (begun_ && input_) {
+      input_->doEndJob();
+    }
+  }
+
+  void PileUpEventPool::dropUnwantedBranches(std::vector<std::string> const& wantedBranches) {
+    std::call_once(dropOnce_, [&] {
+      if (input_) input_->dropUnwantedBranches(wantedBranches);
+    });
+  }
+
+  void PileUpEventPool::beginJob(unsigned int seed) {
+    std::call_once(beginOnce_, [&] {
+      engine_.setSeed(seed, 0);
+      if (input_) input_->doBeginJob();
+      begun_ = true;
+    });
+  }
+
+  std::shared_ptr<PileUpEventPool::Event> PileUpEventPool::readEvent() {
+    if (reader_) {
+      return reader_();
+    }
+    // A modified HistoryAppender must be used for unscheduled processing.
+    auto principal = std::make_unique<EventPrincipal>(input_->productRegistry(),
+                                                      std::make_shared<BranchIDListHelper>(),
+                                                      std::make_shared<ThinnedAssociationsHelper>(),
+                                                      *processConfiguration_,
+                                                      nullptr);
+    size_t fileNameHash = 0U;
+    size_t read = input_->loopOverEvents(*principal, fileNameHash, 1U,
+                                         [](EventPrincipal const&, size_t) {}, &engine_);
+    if (read == 0U) {
+      return std::shared_ptr<Event>();
+    }
+    // The event is going to be used by several streams, after the input has
+    // possibly moved to another file: read all the products and their
+    // provenance now, so that nothing is read on demand later.
+    principal->readAllFromSourceAndMergeImmediately();
+    principal->productProvenanceRetrieverPtr()->branchIDToProvenance(BranchID());
+    return std::make_shared<Event>(std::move(principal), fileNameHash);
+  }
+
+  void PileUpEventPool::topUp() {
+    // A stream finding another one reading does not wait for it: it draws
+    // from the pool as it is, which has then been topped up at most one
+    // draw earlier.  With a single stream the lock is always taken, so the
+    // pool is full before each draw.
+    std::unique_lock<std::mutex> input(inputMutex_, std::try_to_lock);
+    if (!input.owns_lock()) {
+      return;
+    }
+    while (true) {
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (events_.size() >= size_) break;
+      }
+      std::shared_ptr<Event> event = readEvent();
+      if (!event) break;
+      std::lock_guard<std::mutex> guard(mutex_);
+      events_.push_back(std::move(event));
+    }
+  }
+
+  void PileUpEventPool::draw(size_t number, CLHEP::HepRandomEngine& engine, unsigned long long token,
+                             std::vector<std::shared_ptr<Event const> >& events) {
+    size_t const expected = events.size() + number;
+    events.reserve(expected);
+    if (begun_) {
+      topUp();
+    }
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      // partial Fisher-Yates shuffle: the events moved to the front are a
+      // random subset of the pool, of which those not yet used for this
+      // signal event are taken
+      size_t const size = events_.size();
+      for (size_t i = 0; i < size && events.size() < expected; ++i) {
+        std::swap(events_[i], events_[i + CLHEP::RandFlat::shootInt(&engine, size - i)]);
+        Event& event = *events_[i];
+        if (event.token_ == token) continue;
+        event.token_ = token;
+        ++event.uses_;
+        events.push_back(events_[i]);
+      }
+      events_.erase(std::remove_if(events_.begin(), events_.end(),
+                                   [this](std::shared_ptr<Event> const& event) {return event->uses_ >= maxReuse_;}),
+                    events_.end());
+    }
+
+    // not enough events in the pool: read the missing ones now.  This may
+    // wait for a stream topping the pool up, which is acceptable as it only
+    // happens when the streams drain the pool faster than it is topped up,
+    // i.e. when 'poolSize' is too small for the pileup of the streams.
+    if (events.size() == expected) {
+      return;
+    }
+    std::lock_guard<std::mutex> input(inputMutex_);
+    while (events.size() < expected) {
+      std::shared_ptr<Event> event = readEvent();
+      if (!event) break;
+      event->token_ = token;
+      event->uses_ = 1U;
+      events.push_back(event);
+      if (maxReuse_ > 1U) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (events_.size() < size_) events_.push_back(std::move(event));
+      }
+    }
+  }
+}
@@ -0,0 +1,149 @@
+/*
+ *  testPileUpEventPool.cppunit.cc
+ *
+ *  Checks the drawing of the events of PileUpEventPool: the events given
+ *  for one signal event are all different, no event is used more than
+ *  'poolMaxReuse' times, the missing events are read directly when the
+ *  pool is too small, and with a single stream the events drawn only
+ *  depend on the seeds.
+ */
+
+#include "Mixing/Base/interface/PileUpEventPool.h"
+#include "FWCore/Framework/interface/EventPrincipal.h"
+
+#include "CLHEP/Random/JamesRandom.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace {
+  typedef edm::PileUpEventPool::Event Event;
+
+  // numbered events, the number being kept as the file name hash; at most
+  // 'limit' events are made.  The copies given to the pool share the count.
+  class Reader {
+  public:
+    explicit Reader(size_t limit) : made_(std::make_shared<std::atomic<size_t> >(0U)), limit_(limit) {}
+    std::shared_ptr<Event> operator()() {
+      if (*made_ == limit_) return std::shared_ptr<Event>();
+      return std::make_shared<Event>(std::unique_ptr<edm::EventPrincipal>(), ++*made_);
+    }
+    size_t made() const {return *made_;}
+  private:
+    std::shared_ptr<std::atomic<size_t> > made_;
+    size_t limit_;
+  };
+
+  // draws 'number' events for each of 'signals' signal events, and checks
+  // that the events of each signal event are different; returns how many
+  // times each event was used
+  std::map<size_t, unsigned int> drawAll(edm::PileUpEventPool& pool, unsigned int signals, size_t number, size_t expected) {
+    CLHEP::HepJamesRandom engine(1234);
+    std::map<size_t, unsigned int> uses;
+    for (unsigned int signal = 0; signal < signals; ++signal) {
+      std::vector<std::shared_ptr<Event const> > events;
+      pool.draw(number, engine, pool.newToken(), events);
+      CPPUNIT_ASSERT(events.size() == expected);
+      std::set<size_t> different;
+      for (auto const& event : events) {
+        different.insert(event->fileNameHash());
+        ++uses[event->fileNameHash()];
+      }
+      CPPUNIT_ASSERT(different.size() == events.size());
+    }
+    return uses;
+  }
+}
+
+class testPileUpEventPool : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testPileUpEventPool);
+  CPPUNIT_TEST(noDuplicatesTest);
+  CPPUNIT_TEST(maxReuseTest);
+  CPPUNIT_TEST(shortPoolTest);
+  CPPUNIT_TEST(exhaustedInputTest);
+  CPPUNIT_TEST(reproducibleTest);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void noDuplicatesTest();
+  void maxReuseTest();
+  void shortPoolTest();
+  void exhaustedInputTest();
+  void reproducibleTest();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testPileUpEventPool);
+
+void testPileUpEventPool::noDuplicatesTest() {
+  // many reuses and few events: a draw often meets events already taken
+  edm::PileUpEventPool pool(20U, 1000U, Reader(1000000U));
+  pool.beginJob(1U);
+  drawAll(pool, 500U, 15U, 15U);
+}
+
+void testPileUpEventPool::maxReuseTest() {
+  for (unsigned int maxReuse : {1U, 3U}) {
+    edm::PileUpEventPool pool(50U, maxReuse, Reader(1000000U));
+    pool.beginJob(2U);
+    auto uses = drawAll(pool, 200U, 10U, 10U);
+    for (auto const& used : uses) {
+      CPPUNIT_ASSERT(used.second <= maxReuse);
+    }
+    // the events are reused, when allowed
+    if (maxReuse > 1U) {
+      CPPUNIT_ASSERT(uses.size() < 200U * 10U);
+    }
+  }
+}
+
+void testPileUpEventPool::shortPoolTest() {
+  // more events needed than the pool can hold: the missing ones are read
+  // by the caller
+  Reader reader(1000000U);
+  edm::PileUpEventPool pool(3U, 2U, reader);
+  pool.beginJob(3U);
+  auto uses = drawAll(pool, 20U, 10U, 10U);
+  for (auto const& used : uses) {
+    CPPUNIT_ASSERT(used.second <= 2U);
+  }
+  CPPUNIT_ASSERT(reader.made() >= uses.size());
+}
+
+void testPileUpEventPool::exhaustedInputTest() {
+  // the input has fewer events than needed: as many as possible are given.
+  // The pool is not started, so that all the events are read by draw.
+  edm::PileUpEventPool pool(3U, 1U, Reader(5U));
+  CLHEP::HepJamesRandom engine(1234);
+  std::vector<std::shared_ptr<Event const> > events;
+  pool.draw(10U, engine, pool.newToken(), events);
+  CPPUNIT_ASSERT(events.size() == 5U);
+  std::set<size_t> different;
+  for (auto const& event : events) different.insert(event->fileNameHash());
+  CPPUNIT_ASSERT(different.size() == 5U);
+}
+
+void testPileUpEventPool::reproducibleTest() {
+  // a single stream: the pool is full before each draw, so two jobs with
+  // the same seeds mix the same events in the same order
+  std::vector<size_t> drawn[2];
+  for (auto& hashes : drawn) {
+    edm::PileUpEventPool pool(30U, 3U, Reader(1000000U));
+    pool.beginJob(4U);
+    CLHEP::HepJamesRandom engine(1234);
+    for (unsigned int signal = 0; signal < 100U; ++signal) {
+      std::vector<std::shared_ptr<Event const> > events;
+      pool.draw(12U, engine, pool.newToken(), events);
+      CPPUNIT_ASSERT(events.size() == 12U);
+      for (auto const& event : events) hashes.push_back(event->fileNameHash());
+    }
+  }
+  CPPUNIT_ASSERT(drawn[0] == drawn[1]);
+}
@@ -0,0 +1 @@
+#include "Utilities/Testing/interface/CppUnit_testdriver.icpp"
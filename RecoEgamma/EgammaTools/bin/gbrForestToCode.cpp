@@ -0,0 +1,38 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// gbrForestToCode
+// ---------------
+//
+// Converts the BDT of a TMVA weights file into the C++ code of an evaluator
+// specific to it (see GBRForestTools::writeCode), to be compiled into the
+// module using it instead of evaluating the GBRForest payload.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RecoEgamma/EgammaTools/interface/GBRForestTools.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv)
+{
+  if (argc != 4) {
+    std::cerr << "USAGE: gbrForestToCode <weights file> <function name> <output header>" << std::endl;
+    return 1;
+  }
+
+  std::unique_ptr<const GBRForest> forest = GBRForestTools::createGBRForest(std::string(argv[1]));
+  std::ofstream out(argv[3]);
+  if (!out) {
+    std::cerr << "Cannot write " << argv[3] << std::endl;
+    return 1;
+  }
+  out << "// Generated from " << argv[1] << " by gbrForestToCode, do not edit.\n";
+  GBRForestTools::writeCode(*forest, argv[2], out);
+  if (!out) {
+    std::cerr << "Cannot write " << argv[3] << std::endl;
+    return 1;
+  }
+  std::cout << "gbrForestToCode: wrote " << forest->Trees().size() << " trees to " << argv[3] << std::endl;
+  return 0;
+}
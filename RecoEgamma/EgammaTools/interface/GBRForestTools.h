@@ -13,6 +13,7 @@
 
 #include <vector>
 #include <string>
+#include <ostream>
 
 #include "CondFormats/EgammaObjects/interface/GBRForest.h"
 #include "FWCore/ParameterSet/interface/FileInPath.h"
@@ -34,6 +35,11 @@ class GBRForestTools
     static std::unique_ptr<const GBRForest> createGBRForest(const std::string &weightFile, std::vector<std::string> &varNames);
     static std::unique_ptr<const GBRForest> createGBRForest(const edm::FileInPath &weightFile, std::vector<std::string> &varNames);
 
+    // Writes the C++ code of an evaluator specific to this forest, with the same results as GBRForest::GetResponse:
+    // inline functions name(const float* vector) and name(vectors, nvectors, stride, responses), where each tree
+    // is compiled into nested conditional expressions on constant cuts and responses
+    static void writeCode(const GBRForest &forest, const std::string &name, std::ostream &out);
+
 };
 
 #endif
@@ -1,5 +1,7 @@
 #include "RecoEgamma/EgammaTools/interface/GBRForestTools.h"
 
+#include <cmath>
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 
@@ -25,6 +27,31 @@ namespace {
       return str.substr(pos, count - 1);
   }
 
+  // Exact C++ literal of a float value
+  std::string float_literal(float value)
+  {
+      if (std::isinf(value))
+        return value > 0 ? "std::numeric_limits<float>::infinity()" : "-std::numeric_limits<float>::infinity()";
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "%af", value);
+      return buffer;
+  }
+
+  // Nested conditional expression giving the response of the node of a tree
+  void write_node(const GBRTree &tree, int index, std::ostream &out)
+  {
+      // positive indices are intermediate nodes, the others terminal nodes
+      if (index <= 0) {
+        out << float_literal(tree.Responses()[-index]);
+        return;
+      }
+      out << "(vector[" << int(tree.CutIndices()[index]) << "] > " << float_literal(tree.CutVals()[index]) << " ? ";
+      write_node(tree, tree.RightIndices()[index], out);
+      out << " : ";
+      write_node(tree, tree.LeftIndices()[index], out);
+      out << ")";
+  }
+
 };
 
 std::unique_ptr<const GBRForest> GBRForestTools::createGBRForest(const std::string &weightFile,
@@ -149,3 +176,43 @@ std::unique_ptr<const GBRForest> GBRForestTools::createGBRForest(const edm::File
     std::vector<std::string> varNames;
     return GBRForestTools::createGBRForest(weightFile, varNames);
 }
+
+void GBRForestTools::writeCode(const GBRForest &forest, const std::string &name, std::ostream &out){
+
+  const std::vector<GBRTree> &trees = forest.Trees();
+
+  out << "// Evaluator of a GBRForest with " << trees.size() << " trees, generated by GBRForestTools::writeCode.\n";
+  out << "// The responses are bit-identical to the ones of GBRForest::GetResponse for the same forest.\n";
+  out << "\n";
+  out << "#include <limits>\n";
+  out << "\n";
+  out << "namespace " << name << "_trees {\n";
+  for (unsigned int itree = 0; itree < trees.size(); ++itree) {
+    // the root node is always an intermediate node, its index is 0
+    const GBRTree &tree = trees[itree];
+    out << "  inline float tree" << itree << "(const float* vector) {\n";
+    out << "    return (vector[" << int(tree.CutIndices()[0]) << "] > " << float_literal(tree.CutVals()[0]) << " ? ";
+    write_node(tree, tree.RightIndices()[0], out);
+    out << " : ";
+    write_node(tree, tree.LeftIndices()[0], out);
+    out << ");\n";
+    out << "  }\n";
+  }
+  out << "}\n";
+  out << "\n";
+
+  // the initial response is a double
+  char initial[64];
+  std::snprintf(initial, sizeof(initial), "%a", forest.InitialResponse());
+  out << "inline double " << name << "(const float* vector) {\n";
+  out << "  double response = " << initial << ";\n";
+  for (unsigned int itree = 0; itree < trees.size(); ++itree)
+    out << "  response += " << name << "_trees::tree" << itree << "(vector);\n";
+  out << "  return response;\n";
+  out << "}\n";
+  out << "\n";
+  out << "inline void " << name << "(const float* vectors, unsigned int nvectors, unsigned int stride, double* responses) {\n";
+  out << "  for (unsigned int i = 0; i < nvectors; ++i)\n";
+  out << "    responses[i] = " << name << "(vectors + i*stride);\n";
+  out << "}\n";
+}
@@ -0,0 +1,114 @@
+#include "RecoEgamma/EgammaTools/interface/GBRForestTools.h"
+#include "CondFormats/EgammaObjects/test/RandomGBRTree.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <dlfcn.h>
+#include <unistd.h>
+
+// Checks that the code written by GBRForestTools::writeCode, once compiled,
+// gives bit-identical results to GBRForest::GetResponse on a small random
+// forest.  The code is compiled at run time with the C++ compiler ($CXX, or
+// c++), into a library that is then loaded.  The test is skipped when there
+// is no compiler.
+
+namespace {
+
+  typedef double Response(const float *);
+  typedef void Responses(const float *, unsigned int, unsigned int, double *);
+
+  bool same(double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; }
+
+}
+
+int main()
+{
+  std::mt19937 rng(4321);
+  std::uniform_real_distribution<float> input(-1.2f, 1.2f);
+  const unsigned int nvars = 5;
+  const unsigned int stride = 6;
+
+  GBRForest forest;
+  forest.SetInitialResponse(0.1);
+  for (unsigned int itree = 0; itree < 20; ++itree) {
+    GBRTree tree;
+    gbrtest::addNode(tree, 1 + itree % 5, nvars, rng);
+    forest.Trees().push_back(tree);
+  }
+  // cuts that are never or always passed, as made by adjustboundary
+  forest.Trees()[1].CutVals()[0] = std::numeric_limits<float>::infinity();
+  forest.Trees()[2].CutVals()[0] = -std::numeric_limits<float>::infinity();
+
+  char dir[] = "/tmp/testGBRForestCodeXXXXXX";
+  if (!mkdtemp(dir)) {
+    std::cerr << "cannot create a temporary directory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string source = std::string(dir) + "/forest.cc";
+  const std::string library = std::string(dir) + "/forest.so";
+  {
+    std::ofstream out(source.c_str());
+    GBRForestTools::writeCode(forest, "testForest", out);
+    out << "\n";
+    out << "extern \"C\" double response(const float* vector) { return testForest(vector); }\n";
+    out << "extern \"C\" void responses(const float* vectors, unsigned int nvectors, unsigned int stride, double* responses) {\n";
+    out << "  testForest(vectors, nvectors, stride, responses);\n";
+    out << "}\n";
+  }
+
+  const char *cxx = std::getenv("CXX");
+  const std::string compiler = cxx ? cxx : "c++";
+  if (std::system((compiler + " --version > /dev/null 2>&1").c_str()) != 0) {
+    std::cout << "no C++ compiler found (" << compiler << "), the generated code is not tested" << std::endl;
+    std::remove(source.c_str());
+    rmdir(dir);
+    return EXIT_SUCCESS;
+  }
+  std::string command = compiler + " -O2 -shared -fPIC -o " + library + " " + source;
+  int status = std::system(command.c_str());
+  void *dl = status == 0 ? dlopen(library.c_str(), RTLD_NOW) : nullptr;
+  std::remove(source.c_str());
+  std::remove(library.c_str());
+  rmdir(dir);
+  if (!dl) {
+    std::cerr << "the generated code could not be built or loaded: " << command << std::endl;
+    return EXIT_FAILURE;
+  }
+  Response *response = reinterpret_cast<Response *>(dlsym(dl, "response"));
+  Responses *responses = reinterpret_cast<Responses *>(dlsym(dl, "responses"));
+  if (!response || !responses) {
+    std::cerr << "the generated functions were not found" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const unsigned int nvectors = 1000;
+  std::vector<float> vectors(nvectors * stride);
+  for (auto &v : vectors) v = input(rng);
+  // values on the cuts, to check the boundaries
+  for (unsigned int i = 0; i < nvectors; i += 5) {
+    const GBRTree &tree = forest.Trees()[i % forest.Trees().size()];
+    vectors[i * stride + tree.CutIndices()[0]] = tree.CutVals()[0];
+  }
+
+  std::vector<double> batch(nvectors);
+  responses(vectors.data(), nvectors, stride, batch.data());
+  for (unsigned int i = 0; i < nvectors; ++i) {
+    const float *vector = vectors.data() + i * stride;
+    double expected = forest.GetResponse(vector);
+    double generated = response(vector);
+    if (!same(expected, generated) || !same(expected, batch[i])) {
+      std::cerr << "the generated code differs from GetResponse for vector " << i << ": " << generated
+                << " and " << batch[i] << " instead of " << expected << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -13,6 +13,9 @@
 #include "CondFormats/EcalObjects/interface/EcalPedestals.h"
 #include "CondFormats/EcalObjects/interface/EcalGainRatios.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+
+#include <vector>
 
 
 #include "TMatrixDSym.h"
@@ -35,8 +38,21 @@ class EcalUncalibRecHitMultiFitAlgo
   void setAddPedestalUncertainty(double x) { _addPedestalUncertainty = x; }
   void setSimplifiedNoiseModelForGainSwitch(bool b) { _simplifiedNoiseModelForGainSwitch = b; }
   void setGainSwitchUseMaxSample(bool b) { _gainSwitchUseMaxSample = b; }
+
+  // single precision fit of several channels at once (see PulseChiSqSNNLSBatch), for
+  // the frames which are read in gain 12 only; the prefit and the uncertainties are not
+  // supported. The frames added after beginBatch are fitted kLanes at a time, and their
+  // rechits are available in the same order after endBatch.
+  static bool canBatch(const EcalDataFrame& dataFrame);
+  void beginBatch(const BXVector &activeBX);
+  void addToBatch(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov);
+  void endBatch();
+  const std::vector<EcalUncalibratedRecHit> &batchedRecHits() const { return _batchedRecHits; }
   
  private:
+   void fitBatch();
+
+
    PulseChiSqSNNLS _pulsefunc;
    PulseChiSqSNNLS _pulsefuncSingle;
    bool _computeErrors;
@@ -49,6 +65,9 @@ class EcalUncalibRecHitMultiFitAlgo
    bool _simplifiedNoiseModelForGainSwitch;
    bool _gainSwitchUseMaxSample;
    BXVector _singlebx;
+   PulseChiSqSNNLSBatch _pulsefuncBatch;
+   std::vector<EcalUncalibratedRecHit> _batchedRecHits;
+   unsigned int _nBatchLanes;
 
 };
 
@@ -0,0 +1,85 @@
+#ifndef PulseChiSqSNNLSBatch_h
+#define PulseChiSqSNNLSBatch_h
+
+/* Single precision version of the PulseChiSqSNNLS fit, which fits kLanes
+ * channels at once. All arrays hold one element per channel ("lane") in their
+ * innermost dimension, so that the covariance update, the Cholesky
+ * decompositions, the triangular solves and the normal equations of the NNLS
+ * are vectorized across channels.
+ *
+ * All channels of a batch are fitted with the same pulses (the active BXs,
+ * plus one pedestal if the pedestals are fitted), i.e. only single gain
+ * frames without bad samples can be batched. The NNLS keeps every variable in
+ * place and solves the passive set of each lane by replacing the rows of the
+ * constrained variables with the identity, so that all lanes solve systems of
+ * the same size; the lanes run the iterations in lock step, and a lane which
+ * has converged keeps its result while the others go on. Uncertainties are
+ * not computed.
+ */
+
+#include "RecoLocalCalo/EcalRecAlgos/interface/EigenMatrixTypes.h"
+
+class PulseChiSqSNNLSBatch {
+  public:
+
+    static constexpr unsigned int kLanes = 8;
+
+    PulseChiSqSNNLSBatch();
+
+    // the pulses fitted in all lanes; a pedestal (bx 100) is appended if dynamicPedestal
+    void setPulses(const BXVector &bxs, bool dynamicPedestal);
+    void setChannel(unsigned int ilane, const SampleVector &samples, const SampleMatrix &samplecov, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov);
+    // fits the channels of lanes [0,nlanes)
+    void DoFit(unsigned int nlanes);
+
+    unsigned int nPulses() const { return _npulse; }
+    int BX(unsigned int ipulse) const { return _bxs[ipulse]; }
+    // amplitudes are in the order of the pulses given to setPulses
+    float X(unsigned int ilane, unsigned int ipulse) const { return _ampvecmin[ipulse][ilane]; }
+    float ChiSq(unsigned int ilane) const { return _chisq[ilane]; }
+
+    void setMaxIters(int n) { _maxiters = n;}
+
+  protected:
+
+    void Minimize();
+    void NNLS();
+    void OnePulseMinimize();
+    void updateCov();
+    void computeNormalEquations();
+    void solvePassive();
+    void computeChiSq(float (&chisq)[kLanes]);
+
+    static constexpr unsigned int nsample = SampleVectorSize;
+    static constexpr unsigned int nfullsample = FullSampleVectorSize;
+    static constexpr unsigned int npulsemax = PulseVectorSize;
+
+    // inputs
+    float _sampvec[nsample][kLanes];
+    float _samplecov[nsample][nsample][kLanes];
+    float _fullpulsecov[nfullsample][nfullsample][kLanes];
+    float _pulsemat[nsample][npulsemax][kLanes];
+
+    // covariance and its Cholesky factor L (lower triangle)
+    float _covdecomp[nsample][nsample][kLanes];
+    // L^-1 times the pulse matrix and the samples
+    float _invcovp[nsample][npulsemax][kLanes];
+    float _invcovs[nsample][kLanes];
+    float _aTamat[npulsemax][npulsemax][kLanes];
+    float _aTbvec[npulsemax][kLanes];
+    float _work[npulsemax][npulsemax][kLanes];
+    float _ampvecpermtest[npulsemax][kLanes];
+
+    float _ampvec[npulsemax][kLanes];
+    float _ampvecmin[npulsemax][kLanes];
+    bool _passive[npulsemax][kLanes];
+    unsigned int _nP[kLanes];
+    float _chisq[kLanes];
+    bool _converged[kLanes];
+
+    int _bxs[npulsemax];
+    unsigned int _npulse;
+    int _maxiters;
+};
+
+#endif
@@ -14,7 +14,8 @@ EcalUncalibRecHitMultiFitAlgo::EcalUncalibRecHitMultiFitAlgo() :
   _selectiveBadSampleCriteria(false),
   _addPedestalUncertainty(0.),
   _simplifiedNoiseModelForGainSwitch(true),
-  _gainSwitchUseMaxSample(false){
+  _gainSwitchUseMaxSample(false),
+  _nBatchLanes(0){
     
   _singlebx.resize(1);
   _singlebx << 0;
@@ -225,3 +226,66 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
   return rh;
 }
 
+
+bool EcalUncalibRecHitMultiFitAlgo::canBatch(const EcalDataFrame& dataFrame) {
+  for(unsigned int iSample = 0; iSample < EcalDataFrame::MAXSAMPLES; iSample++) {
+    if (dataFrame.sample(iSample).gainId()!=1) return false;
+  }
+  return true;
+}
+
+void EcalUncalibRecHitMultiFitAlgo::beginBatch(const BXVector &activeBX) {
+  _pulsefuncBatch.setPulses(activeBX,_dynamicPedestals);
+  _batchedRecHits.clear();
+  _nBatchLanes = 0;
+}
+
+/// same inputs as makeRecHit for a frame without gain switch
+void EcalUncalibRecHitMultiFitAlgo::addToBatch(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov) {
+
+  const unsigned int nsample = EcalDataFrame::MAXSAMPLES;
+  const double pedestal = _dynamicPedestals ? 0. : aped->mean_x12;
+
+  SampleVector amplitudes;
+  for(unsigned int iSample = 0; iSample < nsample; iSample++) {
+    amplitudes[iSample] = (double)(dataFrame.sample(iSample).adc()) - pedestal;
+  }
+
+  SampleMatrix noisecov = aped->rms_x12*aped->rms_x12*noisecors[0];
+  if (!_dynamicPedestals && _addPedestalUncertainty>0.) {
+    //add fully correlated component to noise covariance to inflate pedestal uncertainty
+    noisecov += _addPedestalUncertainty*_addPedestalUncertainty*SampleMatrix::Ones();
+  }
+
+  _pulsefuncBatch.setChannel(_nBatchLanes,amplitudes,noisecov,fullpulse,fullpulsecov);
+  _batchedRecHits.emplace_back( dataFrame.id(), 0., aped->mean_x12, 0., 0., 0 );
+  if (++_nBatchLanes==PulseChiSqSNNLSBatch::kLanes) fitBatch();
+}
+
+void EcalUncalibRecHitMultiFitAlgo::endBatch() {
+  if (_nBatchLanes>0) fitBatch();
+}
+
+void EcalUncalibRecHitMultiFitAlgo::fitBatch() {
+
+  _pulsefuncBatch.DoFit(_nBatchLanes);
+
+  auto rh = _batchedRecHits.end() - _nBatchLanes;
+  for (unsigned int ilane=0; ilane<_nBatchLanes; ++ilane, ++rh) {
+    rh->setChi2(_pulsefuncBatch.ChiSq(ilane));
+    rh->setAmplitudeError(0.);
+    for (unsigned int ipulse=0; ipulse<_pulsefuncBatch.nPulses(); ++ipulse) {
+      int bx = _pulsefuncBatch.BX(ipulse);
+      if (bx==0) {
+        rh->setAmplitude(_pulsefuncBatch.X(ilane,ipulse));
+      }
+      else if (std::abs(bx)<100) {
+        rh->setOutOfTimeAmplitude(bx+5, _pulsefuncBatch.X(ilane,ipulse));
+      }
+      else {
+        rh->setPedestal(_pulsefuncBatch.X(ilane,ipulse));
+      }
+    }
+  }
+  _nBatchLanes = 0;
+}
@@ -0,0 +1,417 @@
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+  constexpr unsigned int kLanes = PulseChiSqSNNLSBatch::kLanes;
+
+  // in-place Cholesky decomposition of the leading n x n block of a, the lower
+  // triangle is replaced by L. A pivot which has lost all its significant bits
+  // belongs to a variable which is degenerate with the previous ones: it is
+  // given a huge pivot instead, which fixes the variable to zero in the solution,
+  // much like the pivoting LDLT of the double precision fit drops it
+  template<unsigned int N>
+  void choleskyInPlace(float (&a)[N][N][kLanes], unsigned int n) {
+    constexpr float minPivot = 1e-5f;
+    constexpr float hugePivot = 1e15f;
+    for (unsigned int j=0; j<n; ++j) {
+      float d[kLanes], inv[kLanes];
+      for (unsigned int l=0; l<kLanes; ++l) d[l] = a[j][j][l];
+      for (unsigned int k=0; k<j; ++k) {
+        for (unsigned int l=0; l<kLanes; ++l) d[l] -= a[j][k][l]*a[j][k][l];
+      }
+      for (unsigned int l=0; l<kLanes; ++l) {
+        const float dmin = minPivot*a[j][j][l];
+        a[j][j][l] = d[l]>dmin ? std::sqrt(std::max(d[l], dmin)) : hugePivot;
+        inv[l] = 1.f/a[j][j][l];
+      }
+      for (unsigned int i=j+1; i<n; ++i) {
+        for (unsigned int k=0; k<j; ++k) {
+          for (unsigned int l=0; l<kLanes; ++l) a[i][j][l] -= a[i][k][l]*a[j][k][l];
+        }
+        for (unsigned int l=0; l<kLanes; ++l) a[i][j][l] *= inv[l];
+      }
+    }
+  }
+
+  // solves L y = b in place for the first ncol columns of b
+  template<unsigned int N, unsigned int M>
+  void forwardSubstitute(const float (&L)[N][N][kLanes], float (&b)[N][M][kLanes], unsigned int n, unsigned int ncol) {
+    for (unsigned int i=0; i<n; ++i) {
+      for (unsigned int k=0; k<i; ++k) {
+        for (unsigned int c=0; c<ncol; ++c) {
+          for (unsigned int l=0; l<kLanes; ++l) b[i][c][l] -= L[i][k][l]*b[k][c][l];
+        }
+      }
+      for (unsigned int c=0; c<ncol; ++c) {
+        for (unsigned int l=0; l<kLanes; ++l) b[i][c][l] /= L[i][i][l];
+      }
+    }
+  }
+
+  template<unsigned int N>
+  void forwardSubstitute(const float (&L)[N][N][kLanes], float (&b)[N][kLanes], unsigned int n) {
+    for (unsigned int i=0; i<n; ++i) {
+      for (unsigned int k=0; k<i; ++k) {
+        for (unsigned int l=0; l<kLanes; ++l) b[i][l] -= L[i][k][l]*b[k][l];
+      }
+      for (unsigned int l=0; l<kLanes; ++l) b[i][l] /= L[i][i][l];
+    }
+  }
+
+  // solves L^T x = y in place
+  template<unsigned int N>
+  void backSubstitute(const float (&L)[N][N][kLanes], float (&b)[N][kLanes], unsigned int n) {
+    for (unsigned int i=n; i-->0; ) {
+      for (unsigned int k=i+1; k<n; ++k) {
+        for (unsigned int l=0; l<kLanes; ++l) b[i][l] -= L[k][i][l]*b[k][l];
+      }
+      for (unsigned int l=0; l<kLanes; ++l) b[i][l] /= L[i][i][l];
+    }
+  }
+
+}
+
+PulseChiSqSNNLSBatch::PulseChiSqSNNLSBatch() :
+  _npulse(0),
+  _maxiters(50)
+{
+
+}
+
+void PulseChiSqSNNLSBatch::setPulses(const BXVector &bxs, bool dynamicPedestal) {
+
+  const unsigned int npulse = bxs.rows() + (dynamicPedestal ? 1 : 0);
+  if (npulse==0 || npulse>npulsemax) {
+    throw cms::Exception("MultFitWeirdState")
+      << "Weird number of pulses encountered in multifit, module is configured incorrectly!";
+  }
+  _npulse = npulse;
+  for (int ipulse=0; ipulse<bxs.rows(); ++ipulse) {
+    _bxs[ipulse] = bxs.coeff(ipulse);
+  }
+  if (dynamicPedestal) {
+    _bxs[_npulse-1] = 100; //bx values >=100 indicate dynamic pedestals, as in PulseChiSqSNNLS
+  }
+}
+
+void PulseChiSqSNNLSBatch::setChannel(unsigned int ilane, const SampleVector &samples, const SampleMatrix &samplecov, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov) {
+
+  for (unsigned int i=0; i<nsample; ++i) {
+    _sampvec[i][ilane] = samples.coeff(i);
+    for (unsigned int j=0; j<nsample; ++j) {
+      _samplecov[i][j][ilane] = samplecov.coeff(i,j);
+    }
+  }
+  for (unsigned int i=0; i<nfullsample; ++i) {
+    for (unsigned int j=0; j<nfullsample; ++j) {
+      _fullpulsecov[i][j][ilane] = fullpulsecov.coeff(i,j);
+    }
+  }
+  for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+    const int bx = _bxs[ipulse];
+    const int offset = 7-3-bx;
+    for (unsigned int i=0; i<nsample; ++i) {
+      _pulsemat[i][ipulse][ilane] = bx>=100 ? 1.f : fullpulse.coeff(i+offset);
+    }
+  }
+}
+
+void PulseChiSqSNNLSBatch::DoFit(unsigned int nlanes) {
+
+  //unused lanes repeat the first channel, so that they stay well defined
+  for (unsigned int ilane=nlanes; ilane<kLanes; ++ilane) {
+    for (unsigned int i=0; i<nsample; ++i) {
+      _sampvec[i][ilane] = _sampvec[i][0];
+      for (unsigned int j=0; j<nsample; ++j) _samplecov[i][j][ilane] = _samplecov[i][j][0];
+      for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) _pulsemat[i][ipulse][ilane] = _pulsemat[i][ipulse][0];
+    }
+    for (unsigned int i=0; i<nfullsample; ++i) {
+      for (unsigned int j=0; j<nfullsample; ++j) _fullpulsecov[i][j][ilane] = _fullpulsecov[i][j][0];
+    }
+  }
+
+  //pedestals are unconstrained already for the first iteration since they should always be non-zero
+  for (unsigned int l=0; l<kLanes; ++l) {
+    _nP[l] = 0;
+    _chisq[l] = 0.f;
+    _converged[l] = false;
+  }
+  for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+    const bool pedestal = _bxs[ipulse]>=100;
+    for (unsigned int l=0; l<kLanes; ++l) {
+      _ampvec[ipulse][l] = 0.f;
+      _passive[ipulse][l] = pedestal;
+      _nP[l] += pedestal;
+    }
+  }
+  if (_npulse==1 && _bxs[0]<100) {
+    for (unsigned int l=0; l<kLanes; ++l) _ampvec[0][l] = _sampvec[_bxs[0] + 5][l];
+  }
+  for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+    for (unsigned int l=0; l<kLanes; ++l) _ampvecmin[ipulse][l] = _ampvec[ipulse][l];
+  }
+
+  Minimize();
+}
+
+void PulseChiSqSNNLSBatch::Minimize() {
+
+  for (int iter=0; iter<_maxiters; ++iter) {
+
+    updateCov();
+    if (_npulse>1) {
+      NNLS();
+    }
+    else {
+      OnePulseMinimize();
+    }
+
+    float chisqnow[kLanes];
+    computeChiSq(chisqnow);
+
+    //lanes which have converged keep their result, the others go on
+    bool done = true;
+    for (unsigned int l=0; l<kLanes; ++l) {
+      if (_converged[l]) continue;
+      const float deltachisq = chisqnow[l] - _chisq[l];
+      _chisq[l] = chisqnow[l];
+      for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) _ampvecmin[ipulse][l] = _ampvec[ipulse][l];
+      _converged[l] = std::abs(deltachisq)<1e-3f;
+      done &= _converged[l];
+    }
+    if (done) break;
+  }
+}
+
+void PulseChiSqSNNLSBatch::updateCov() {
+
+  for (unsigned int i=0; i<nsample; ++i) {
+    for (unsigned int j=0; j<nsample; ++j) {
+      for (unsigned int l=0; l<kLanes; ++l) _covdecomp[i][j][l] = _samplecov[i][j][l];
+    }
+  }
+
+  for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+    const int bx = _bxs[ipulse];
+    if (bx>=100) continue; //no contribution to covariance from pedestal
+
+    const unsigned int firstsamplet = std::max(0,bx + 3);
+    const int offset = 7-3-bx;
+
+    float ampsq[kLanes];
+    for (unsigned int l=0; l<kLanes; ++l) ampsq[l] = _ampvec[ipulse][l]*_ampvec[ipulse][l];
+
+    for (unsigned int i=firstsamplet; i<nsample; ++i) {
+      for (unsigned int j=firstsamplet; j<=i; ++j) {
+        for (unsigned int l=0; l<kLanes; ++l) _covdecomp[i][j][l] += ampsq[l]*_fullpulsecov[i+offset][j+offset][l];
+      }
+    }
+  }
+
+  choleskyInPlace(_covdecomp, nsample);
+}
+
+void PulseChiSqSNNLSBatch::computeNormalEquations() {
+
+  for (unsigned int i=0; i<nsample; ++i) {
+    for (unsigned int l=0; l<kLanes; ++l) _invcovs[i][l] = _sampvec[i][l];
+    for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+      for (unsigned int l=0; l<kLanes; ++l) _invcovp[i][ipulse][l] = _pulsemat[i][ipulse][l];
+    }
+  }
+  forwardSubstitute(_covdecomp, _invcovp, nsample, _npulse);
+  forwardSubstitute(_covdecomp, _invcovs, nsample);
+
+  for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+    for (unsigned int jpulse=0; jpulse<=ipulse; ++jpulse) {
+      float sum[kLanes] = {};
+      for (unsigned int i=0; i<nsample; ++i) {
+        for (unsigned int l=0; l<kLanes; ++l) sum[l] += _invcovp[i][ipulse][l]*_invcovp[i][jpulse][l];
+      }
+      for (unsigned int l=0; l<kLanes; ++l) {
+        _aTamat[ipulse][jpulse][l] = sum[l];
+        _aTamat[jpulse][ipulse][l] = sum[l];
+      }
+    }
+    float sum[kLanes] = {};
+    for (unsigned int i=0; i<nsample; ++i) {
+      for (unsigned int l=0; l<kLanes; ++l) sum[l] += _invcovp[i][ipulse][l]*_invcovs[i][l];
+    }
+    for (unsigned int l=0; l<kLanes; ++l) _aTbvec[ipulse][l] = sum[l];
+  }
+}
+
+void PulseChiSqSNNLSBatch::solvePassive() {
+
+  //normal equations restricted to the passive set, identity for the constrained parameters
+  float passive[npulsemax][kLanes];
+  for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+    for (unsigned int l=0; l<kLanes; ++l) passive[ipulse][l] = _passive[ipulse][l] ? 1.f : 0.f;
+  }
+  for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+    for (unsigned int jpulse=0; jpulse<=ipulse; ++jpulse) {
+      const float diag = ipulse==jpulse ? 1.f : 0.f;
+      for (unsigned int l=0; l<kLanes; ++l) {
+        const float both = passive[ipulse][l]*passive[jpulse][l];
+        _work[ipulse][jpulse][l] = both*_aTamat[ipulse][jpulse][l] + (1.f - both)*diag;
+      }
+    }
+    for (unsigned int l=0; l<kLanes; ++l) _ampvecpermtest[ipulse][l] = passive[ipulse][l]*_aTbvec[ipulse][l];
+  }
+
+  choleskyInPlace(_work, _npulse);
+  forwardSubstitute(_work, _ampvecpermtest, _npulse);
+  backSubstitute(_work, _ampvecpermtest, _npulse);
+}
+
+void PulseChiSqSNNLSBatch::NNLS() {
+
+  //Fast NNLS (fnnls) algorithm as in PulseChiSqSNNLS::NNLS, run in lock step by all lanes
+
+  const unsigned int maxPassive = std::min(_npulse, nsample);
+
+  computeNormalEquations();
+
+  bool nnlsdone[kLanes];
+  int idxwmax[kLanes];
+  float wmax[kLanes];
+  for (unsigned int l=0; l<kLanes; ++l) {
+    nnlsdone[l] = false;
+    idxwmax[l] = -1;
+    wmax[l] = 0.f;
+  }
+
+  float threshold = 1e-11f;
+  for (int iter=0; ; ++iter) {
+
+    //can only perform this step if solution is guaranteed viable
+    bool alldone = true;
+    for (unsigned int l=0; l<kLanes; ++l) {
+      if (nnlsdone[l]) continue;
+      if (iter>0 || _nP[l]==0) {
+        if (_nP[l]==maxPassive) {
+          nnlsdone[l] = true;
+          continue;
+        }
+
+        int idx = -1;
+        float w = -std::numeric_limits<float>::max();
+        for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+          if (_passive[ipulse][l]) continue;
+          float wp = _aTbvec[ipulse][l];
+          for (unsigned int jpulse=0; jpulse<_npulse; ++jpulse) wp -= _aTamat[ipulse][jpulse][l]*_ampvec[jpulse][l];
+          if (wp>w) {
+            w = wp;
+            idx = ipulse;
+          }
+        }
+
+        //convergence, or worst case protection
+        if (w<threshold || (idx==idxwmax[l] && w==wmax[l]) || iter>=500) {
+          nnlsdone[l] = true;
+          continue;
+        }
+        idxwmax[l] = idx;
+        wmax[l] = w;
+
+        //unconstrain parameter
+        _passive[idx][l] = true;
+        ++_nP[l];
+      }
+      alldone = false;
+    }
+    if (alldone) break;
+
+    bool inner[kLanes];
+    bool anyinner = false;
+    for (unsigned int l=0; l<kLanes; ++l) {
+      inner[l] = !nnlsdone[l] && _nP[l]>0;
+      anyinner |= inner[l];
+    }
+
+    while (anyinner) {
+
+      solvePassive();
+
+      anyinner = false;
+      for (unsigned int l=0; l<kLanes; ++l) {
+        if (!inner[l]) continue;
+
+        //check solution
+        bool positive = true;
+        for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+          if (_passive[ipulse][l]) positive &= (_ampvecpermtest[ipulse][l] > 0.f);
+        }
+        if (positive) {
+          for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+            if (_passive[ipulse][l]) _ampvec[ipulse][l] = _ampvecpermtest[ipulse][l];
+          }
+          inner[l] = false;
+          continue;
+        }
+
+        //update parameter vector
+        unsigned int minratioidx = 0;
+        float minratio = std::numeric_limits<float>::max();
+        for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+          if (_passive[ipulse][l] && _ampvecpermtest[ipulse][l]<=0.f) {
+            const float c_ampvec = _ampvec[ipulse][l];
+            const float denom = c_ampvec-_ampvecpermtest[ipulse][l];
+            //a degenerate parameter may come back exactly at zero
+            const float ratio = denom>0.f ? c_ampvec/denom : 0.f;
+            if (ratio<minratio) {
+              minratio = ratio;
+              minratioidx = ipulse;
+            }
+          }
+        }
+        for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+          if (_passive[ipulse][l]) _ampvec[ipulse][l] += minratio*(_ampvecpermtest[ipulse][l] - _ampvec[ipulse][l]);
+        }
+
+        //avoid numerical problems with later ==0. check
+        _ampvec[minratioidx][l] = 0.f;
+        _passive[minratioidx][l] = false;
+        --_nP[l];
+
+        inner[l] = _nP[l]>0;
+        anyinner |= inner[l];
+      }
+    }
+
+    //adaptive convergence threshold to avoid infinite loops but still
+    //ensure best value is used
+    if ((iter+1) % 16 == 0) {
+      threshold *= 2;
+    }
+  }
+}
+
+void PulseChiSqSNNLSBatch::OnePulseMinimize() {
+
+  computeNormalEquations();
+  for (unsigned int l=0; l<kLanes; ++l) {
+    _ampvec[0][l] = std::max(0.f, _aTbvec[0][l]/_aTamat[0][0][l]);
+  }
+}
+
+void PulseChiSqSNNLSBatch::computeChiSq(float (&chisq)[kLanes]) {
+
+  float resvec[nsample][kLanes];
+  for (unsigned int i=0; i<nsample; ++i) {
+    for (unsigned int l=0; l<kLanes; ++l) resvec[i][l] = -_sampvec[i][l];
+    for (unsigned int ipulse=0; ipulse<_npulse; ++ipulse) {
+      for (unsigned int l=0; l<kLanes; ++l) resvec[i][l] += _pulsemat[i][ipulse][l]*_ampvec[ipulse][l];
+    }
+  }
+  forwardSubstitute(_covdecomp, resvec, nsample);
+
+  for (unsigned int l=0; l<kLanes; ++l) chisq[l] = 0.f;
+  for (unsigned int i=0; i<nsample; ++i) {
+    for (unsigned int l=0; l<kLanes; ++l) chisq[l] += resvec[i][l]*resvec[i][l];
+  }
+}
@@ -0,0 +1,157 @@
+// Validation of the single precision batched multifit (PulseChiSqSNNLSBatch)
+// against the double precision reference (PulseChiSqSNNLS): fits random
+// single gain pulses with out-of-time pileup and correlated noise with both,
+// and reports the deviations of the in-time amplitude and of the chi2, and the
+// time spent in each fit.
+// Returns a non-zero exit code if the deviations exceed the tolerances.
+
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  struct Deviations {
+    unsigned int nfits = 0;
+    double maxAmplitude = 0.;    // |A_float - A_double|, ADC counts
+    double maxRelAmplitude = 0.; // same, relative, for A_double > 10 ADC
+    double sumAmplitude = 0.;
+    double maxChiSq = 0.;        // |chi2_float - chi2_double| / max(1, chi2_double)
+    unsigned int nFailed = 0;    // above tolerance
+    double timeReference = 0.;   // s
+    double timeBatch = 0.;
+  };
+
+  // alpha-beta parametrization of the ECAL pulse, peaking at sample 5 for bx 0
+  void makePulse(FullSampleVector &fullpulse, FullSampleMatrix &fullpulsecov) {
+    const double alpha = 1.138, beta = 1.655;
+    fullpulse = FullSampleVector::Zero();
+    for (int i=0; i<12; ++i) {
+      const double x = i - 2;
+      fullpulse(i+7) = x > -alpha*beta ? std::pow(1. + x/(alpha*beta), alpha)*std::exp(-x/beta) : 0.;
+    }
+    // small fully correlated shape uncertainty plus an uncorrelated part
+    fullpulsecov = FullSampleMatrix::Zero();
+    for (int i=7; i<19; ++i) {
+      for (int j=7; j<19; ++j) {
+        fullpulsecov(i,j) = 1e-5*fullpulse(i)*fullpulse(j) + (i==j ? 1e-6 : 0.);
+      }
+    }
+  }
+
+  void run(const char *name, const BXVector &bxs, bool dynamicPedestal, unsigned int nchannels, std::mt19937 &rng, Deviations &dev) {
+
+    FullSampleVector fullpulse;
+    FullSampleMatrix fullpulsecov;
+    makePulse(fullpulse, fullpulsecov);
+
+    // gain 12 noise, exponentially correlated between samples
+    const double rms = 1.1, rho = 0.6, pedestal = 200.;
+    SampleMatrix noisecov;
+    for (int i=0; i<SampleVectorSize; ++i) {
+      for (int j=0; j<SampleVectorSize; ++j) {
+        noisecov(i,j) = rms*rms*std::pow(rho, std::abs(i-j));
+      }
+    }
+    const SampleMatrix noiseL = noisecov.llt().matrixL();
+
+    std::normal_distribution<double> gaus;
+    std::uniform_real_distribution<double> flat;
+
+    const SampleGainVector gains = (dynamicPedestal ? 0 : -1)*SampleGainVector::Ones();
+
+    PulseChiSqSNNLS reference;
+    reference.disableErrorCalculation();
+    PulseChiSqSNNLSBatch batch;
+    batch.setPulses(bxs, dynamicPedestal);
+
+    unsigned int ipulseintime = 0;
+    for (unsigned int ipulse=0; ipulse<batch.nPulses(); ++ipulse) {
+      if (batch.BX(ipulse)==0) ipulseintime = ipulse;
+    }
+
+    std::vector<SampleVector> samples(PulseChiSqSNNLSBatch::kLanes);
+    for (unsigned int ichannel=0; ichannel<nchannels; ichannel+=PulseChiSqSNNLSBatch::kLanes) {
+      const unsigned int nlanes = std::min(PulseChiSqSNNLSBatch::kLanes, nchannels-ichannel);
+      for (unsigned int ilane=0; ilane<nlanes; ++ilane) {
+        SampleVector noise;
+        for (int i=0; i<SampleVectorSize; ++i) noise(i) = gaus(rng);
+        SampleVector &s = samples[ilane];
+        s = noiseL*noise;
+        if (dynamicPedestal) s += pedestal*SampleVector::Ones();
+        // in-time amplitude spread logarithmically between 0.1 and 3000 ADC counts
+        const double amplitude = 0.1*std::pow(3e4, flat(rng));
+        s += amplitude*fullpulse.segment<SampleVectorSize>(4);
+        for (int bx=-5; bx<=4; ++bx) {
+          if (bx==0 || flat(rng)>0.3) continue;
+          s += 50.*flat(rng)*fullpulse.segment<SampleVectorSize>(4-bx);
+        }
+        batch.setChannel(ilane, s, noisecov, fullpulse, fullpulsecov);
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      batch.DoFit(nlanes);
+      auto stop = std::chrono::steady_clock::now();
+      dev.timeBatch += std::chrono::duration<double>(stop - start).count();
+
+      for (unsigned int ilane=0; ilane<nlanes; ++ilane) {
+        start = std::chrono::steady_clock::now();
+        reference.DoFit(samples[ilane], noisecov, bxs, fullpulse, fullpulsecov, gains);
+        stop = std::chrono::steady_clock::now();
+        dev.timeReference += std::chrono::duration<double>(stop - start).count();
+        double xref = 0.;
+        for (int ipulse=0; ipulse<reference.BXs().rows(); ++ipulse) {
+          if (reference.BXs().coeff(ipulse)==0) xref = reference.X()[ipulse];
+        }
+        const double dx = std::abs(batch.X(ilane, ipulseintime) - xref);
+        const double dchisq = std::abs(batch.ChiSq(ilane) - reference.ChiSq())/std::max(1., reference.ChiSq());
+
+        ++dev.nfits;
+        dev.maxAmplitude = std::max(dev.maxAmplitude, dx);
+        if (xref>10.) dev.maxRelAmplitude = std::max(dev.maxRelAmplitude, dx/xref);
+        dev.sumAmplitude += dx;
+        dev.maxChiSq = std::max(dev.maxChiSq, dchisq);
+        // both fits stop when the chi2 changes by less than 1e-3, which leaves
+        // the amplitude undetermined at the level of a few % of the noise
+        if (dx > 0.1*rms + 1e-3*xref || dchisq > 2e-2) ++dev.nFailed;
+      }
+    }
+
+    std::cout << name << ": " << nchannels << " channels, max |dA| = " << dev.maxAmplitude
+              << " ADC, mean |dA| = " << dev.sumAmplitude/dev.nfits
+              << " ADC, max |dA|/A (A > 10 ADC) = " << dev.maxRelAmplitude
+              << ", max |dchi2|/max(1,chi2) = " << dev.maxChiSq
+              << ", above tolerance: " << dev.nFailed
+              << ", time per channel: double " << 1e6*dev.timeReference/dev.nfits
+              << " us, batched float " << 1e6*dev.timeBatch/dev.nfits << " us" << std::endl;
+  }
+
+}
+
+int main() {
+
+  std::mt19937 rng(12345);
+  const unsigned int nchannels = 20000;
+
+  BXVector allbx(10);
+  allbx << -5,-4,-3,-2,-1,0,1,2,3,4;
+  BXVector singlebx(1);
+  singlebx << 0;
+
+  Deviations devStatic, devDynamic, devSingle;
+  run("10 BX, static pedestal", allbx, false, nchannels, rng, devStatic);
+  run("10 BX, dynamic pedestal", allbx, true, nchannels, rng, devDynamic);
+  run("in-time pulse only", singlebx, false, nchannels, rng, devSingle);
+
+  // allow for a handful of fits which stop at a different point of the chi2 plateau
+  const unsigned int maxFailed = nchannels/1000;
+  bool ok = devStatic.nFailed<=maxFailed && devDynamic.nFailed<=maxFailed && devSingle.nFailed<=maxFailed;
+  std::cout << (ok ? "PASSED" : "FAILED") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -5,6 +5,7 @@
 #include "FWCore/Framework/interface/Run.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include "CondFormats/DataRecord/interface/EcalGainRatiosRcd.h"
 #include "CondFormats/DataRecord/interface/EcalPedestalsRcd.h"
@@ -35,6 +36,11 @@ EcalUncalibRecHitWorkerMultiFit::EcalUncalibRecHitWorkerMultiFit(const edm::Para
 
   // uncertainty calculation (CPU intensive)
   ampErrorCalculation_ = ps.getParameter<bool>("ampErrorCalculation");
+  // single precision fit of the gain 12 channels, several channels at once
+  batchedFit_ = ps.getParameter<bool>("batchedFit");
+  if (batchedFit_ && ampErrorCalculation_) {
+    throw cms::Exception("Configuration") << "the batched multifit does not compute the amplitude uncertainties, batchedFit requires ampErrorCalculation = False";
+  }
   useLumiInfoRunHeader_ = ps.getParameter<bool>("useLumiInfoRunHeader");
   
   if (useLumiInfoRunHeader_) {
@@ -284,6 +290,43 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
     FullSampleVector fullpulse(FullSampleVector::Zero());
     FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
 
+    // the channels read in gain 12 are fitted beforehand, several at once;
+    // the prefit is not supported by the batched fit
+    const bool batchedFit = batchedFit_ && !(barrel ? doPrefitEB_ : doPrefitEE_);
+    if (batchedFit) {
+        multiFitMethod_.beginBatch(activeBX);
+        for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg) {
+            if (!EcalUncalibRecHitMultiFitAlgo::canBatch(*itdg)) continue;
+            DetId detid(itdg->id());
+
+            const EcalPedestals::Item * aped = nullptr;
+            const EcalPulseShapes::Item * aPulse = nullptr;
+            const EcalPulseCovariances::Item * aPulseCov = nullptr;
+            if (barrel) {
+                unsigned int hashedIndex = EBDetId(detid).hashedIndex();
+                aped       = &peds->barrel(hashedIndex);
+                aPulse     = &pulseshapes->barrel(hashedIndex);
+                aPulseCov  = &pulsecovariances->barrel(hashedIndex);
+            } else {
+                unsigned int hashedIndex = EEDetId(detid).hashedIndex();
+                aped       = &peds->endcap(hashedIndex);
+                aPulse     = &pulseshapes->endcap(hashedIndex);
+                aPulseCov  = &pulsecovariances->endcap(hashedIndex);
+            }
+
+            for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i)
+                fullpulse(i+7) = aPulse->pdfval[i];
+
+            for(int i=0; i<EcalPulseShape::TEMPLATESAMPLES;i++)
+            for(int j=0; j<EcalPulseShape::TEMPLATESAMPLES;j++)
+                fullpulsecov(i+7,j+7) = aPulseCov->covval[i][j];
+
+            multiFitMethod_.addToBatch(*itdg, aped, noisecor(barrel), fullpulse, fullpulsecov);
+        }
+        multiFitMethod_.endBatch();
+    }
+    auto batchedRecHit = multiFitMethod_.batchedRecHits().begin();
+
     result.reserve(result.size() + digis.size());
     for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg)
     {
@@ -371,7 +414,11 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
             // multifit
             const SampleMatrixGainArray &noisecors = noisecor(barrel);
             
-            result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+            if (batchedFit && EcalUncalibRecHitMultiFitAlgo::canBatch(*itdg)) {
+                result.push_back(*batchedRecHit++);
+            } else {
+                result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+            }
             auto & uncalibRecHit = result.back();
             
             // === time computation ===
@@ -551,6 +598,7 @@ EcalUncalibRecHitWorkerMultiFit::getAlgoDescription() {
  edm::ParameterSetDescription psd;
  psd.addNode(edm::ParameterDescription<std::vector<int>>("activeBXs", {-5,-4,-3,-2,-1,0,1,2,3,4}, true) and
 	      edm::ParameterDescription<bool>("ampErrorCalculation", true, true) and
+	      edm::ParameterDescription<bool>("batchedFit", false, true) and
 	      edm::ParameterDescription<bool>("useLumiInfoRunHeader", true, true) and
 	      edm::ParameterDescription<int>("bunchSpacing", 0, true) and
 	      edm::ParameterDescription<bool>("doPrefitEB", false, true) and
@@ -67,6 +67,7 @@ class EcalUncalibRecHitWorkerMultiFit final : public EcalUncalibRecHitWorkerBase
                 std::array<SampleMatrixGainArray, 2> noisecors_;
                 BXVector activeBX;
                 bool ampErrorCalculation_;
+                bool batchedFit_;
                 bool useLumiInfoRunHeader_;
                 EcalUncalibRecHitMultiFitAlgo multiFitMethod_;
                 
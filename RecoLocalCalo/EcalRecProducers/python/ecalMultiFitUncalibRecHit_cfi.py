@@ -13,6 +13,8 @@ ecalMultiFitUncalibRecHit = cms.EDProducer("EcalUncalibRecHitProducer",
       EcalPulseShapeParameters = cms.PSet( ecal_pulse_shape_parameters ),
       activeBXs = cms.vint32(-5,-4,-3,-2,-1,0,1,2,3,4),
       ampErrorCalculation = cms.bool(True),
+      # single precision fit of the gain 12 channels, several at once (requires ampErrorCalculation = False)
+      batchedFit = cms.bool(False),
       useLumiInfoRunHeader = cms.bool(True),
   
       doPrefitEB = cms.bool(False),
@@ -15,6 +15,7 @@
 #include "DataFormats/EgammaReco/interface/BasicCluster.h"
 
 #include "RecoLocalCalo/HGCalRecAlgos/interface/RecHitTools.h"
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
 
 // C/C++ headers
 #include <string>
@@ -41,9 +42,12 @@ std::vector<size_t> sorted_indices(const std::vector<T> &v) {
         return idx;
 }
 
+class testHGCalImagingAlgo;
+
 class HGCalImagingAlgo
 {
 
+friend class testHGCalImagingAlgo;
 
 public:
 
@@ -267,6 +271,7 @@ std::vector<size_t> sort_by_delta(const std::vector<KDNode> &v) const {
 std::vector<std::vector<KDNode> > points;   //a vector of vectors of hexels, one for each layer
 //@@EM todo: the number of layers should be obtained programmatically - the range is 1-n instead of 0-n-1...
 
+// bounding box of the hits of each layer, for the tiles
 std::vector<std::array<float,2> > minpos;
 std::vector<std::array<float,2> > maxpos;
 
@@ -280,9 +285,11 @@ inline double distance2(const Hexel &pt1, const Hexel &pt2) const{   //distance
 inline double distance(const Hexel &pt1, const Hexel &pt2) const{   //2-d distance on the layer (x-y)
         return std::sqrt(distance2(pt1,pt2));
 }
-double calculateLocalDensity(std::vector<KDNode> &, KDTree &, const unsigned int) const;   //return max density
-double calculateDistanceToHigher(std::vector<KDNode> &) const;
-int findAndAssignClusters(std::vector<KDNode> &, KDTree &, double, KDTreeBox &, const unsigned int, std::vector<std::vector<KDNode> >&) const;
+// maximum search distance (critical distance) for the layer
+float criticalDistance(const unsigned int) const;
+double calculateLocalDensity(std::vector<KDNode> &, const HGCalLayerTiles &, const unsigned int) const;   //return max density
+double calculateDistanceToHigher(std::vector<KDNode> &, const HGCalLayerTiles &) const;
+int findAndAssignClusters(std::vector<KDNode> &, const HGCalLayerTiles &, double, const unsigned int, std::vector<std::vector<KDNode> >&) const;
 math::XYZPoint calculatePosition(std::vector<KDNode> &) const;
 
 // attempt to find subclusters within a given set of hexels
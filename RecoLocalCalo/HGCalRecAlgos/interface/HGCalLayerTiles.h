@@ -0,0 +1,101 @@
+#ifndef RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+#define RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+
+#include <algorithm>
+#include <vector>
+
+// Fixed grid of tiles covering the hits of one layer, used by HGCalImagingAlgo
+// to look up the neighbours of a hit.
+// The hits are sorted by tile, and their positions and their indices in the
+// input are stored in flat arrays, so that the hits of each tile are
+// contiguous in memory.
+class HGCalLayerTiles {
+public:
+  // build the tiles for the hits at (x[i], y[i]), all inside the rectangle
+  // [minX, maxX] x [minY, maxY]; the tiles are at least minTileSize wide,
+  // and there are at most as many tiles as hits
+  void fill(const std::vector<float> &x, const std::vector<float> &y,
+            float minX, float maxX, float minY, float maxY, float minTileSize);
+
+  int nBinsX() const { return nBinsX_; }
+  int nBinsY() const { return nBinsY_; }
+
+  // tile containing the position, the positions outside the grid are moved to
+  // the closest tile
+  int binX(float x) const {
+    return std::min(std::max(int((x - minX_) / tileSizeX_), 0), nBinsX_ - 1);
+  }
+  int binY(float y) const {
+    return std::min(std::max(int((y - minY_) / tileSizeY_), 0), nBinsY_ - 1);
+  }
+
+  // smallest side of the tiles: the hits in the tiles at distance r (in
+  // tiles) from the tile of a hit are at least (r-1) times this far from it
+  float tileSize() const { return std::min(tileSizeX_, tileSizeY_); }
+
+  // position and index in the input of the k-th hit, sorted by tile
+  float x(unsigned int k) const { return x_[k]; }
+  float y(unsigned int k) const { return y_[k]; }
+  unsigned int index(unsigned int k) const { return index_[k]; }
+
+  // calls f(k) for the hits of all the tiles overlapping the given box
+  template <typename F>
+  void forEachInBox(float xmin, float xmax, float ymin, float ymax, F &&f) const {
+    const int bxmax = binX(xmax);
+    const int bymax = binY(ymax);
+    for (int by = binY(ymin); by <= bymax; ++by)
+      for (int bx = binX(xmin); bx <= bxmax; ++bx)
+        forEachInTile(bx, by, f);
+  }
+
+  // calls f(k) for the hits of the tiles at distance r (in tiles) from the
+  // tile (bx, by); returns false if all these tiles are outside the grid
+  template <typename F>
+  bool forEachInRing(int bx, int by, int r, F &&f) const {
+    if (r == 0) {
+      forEachInTile(bx, by, f);
+      return true;
+    }
+    if (bx - r < 0 and bx + r >= nBinsX_ and by - r < 0 and by + r >= nBinsY_)
+      return false;
+    const int xlow = std::max(bx - r, 0);
+    const int xhigh = std::min(bx + r, nBinsX_ - 1);
+    for (int y = std::max(by - r, 0); y <= std::min(by + r, nBinsY_ - 1); ++y) {
+      if (y == by - r or y == by + r) {
+        // top and bottom rows of the ring
+        for (int x = xlow; x <= xhigh; ++x)
+          forEachInTile(x, y, f);
+      } else {
+        // left and right columns of the ring
+        if (bx - r >= 0)
+          forEachInTile(bx - r, y, f);
+        if (bx + r < nBinsX_)
+          forEachInTile(bx + r, y, f);
+      }
+    }
+    return true;
+  }
+
+private:
+  template <typename F>
+  void forEachInTile(int bx, int by, F &&f) const {
+    const unsigned int tile = by * nBinsX_ + bx;
+    for (unsigned int k = offsets_[tile]; k < offsets_[tile + 1]; ++k)
+      f(k);
+  }
+
+  float minX_ = 0.f;
+  float minY_ = 0.f;
+  float tileSizeX_ = 1.f;
+  float tileSizeY_ = 1.f;
+  int nBinsX_ = 1;
+  int nBinsY_ = 1;
+
+  // the hits of the tile t are [offsets_[t], offsets_[t+1])
+  std::vector<unsigned int> offsets_;
+  std::vector<float> x_;
+  std::vector<float> y_;
+  std::vector<unsigned int> index_;
+};
+
+#endif
@@ -22,6 +22,10 @@ class KDTreeLinkerAlgo
  void build(std::vector<KDTreeNodeInfoT<DATA,DIM> > 	&eltList,
 	    const KDTreeBoxT<DIM>	                &region);
   
+  // This permutes "eltList" as build() does, without building the tree: 
+  // search() gives the points it finds in the order of the permuted list.
+  void reorder(std::vector<KDTreeNodeInfoT<DATA,DIM> > 	&eltList);
+
   // Here we search in the KDTree for all points that would be 
   // contained in the given searchbox. The founded points are stored in resRecHitList.
   void search(const KDTreeBoxT<DIM>			&searchBox,
@@ -67,6 +71,11 @@ class KDTreeLinkerAlgo
 				 int				depth,
 				 const KDTreeBoxT<DIM>		&region);
 
+  // Recursif partition of the elements, as by recBuild(). Is called by reorder()
+ void recReorder(int					low,
+		 int					high,
+		 int					depth);
+
   // Recursif kdtree search. Is called by search()
  void recSearch(const KDTreeNodeT<DATA,DIM>		*current,
 		const KDTreeBoxT<DIM>			&trackBox);    
@@ -100,6 +109,30 @@ KDTreeLinkerAlgo<DATA,DIM>::build(std::vector<KDTreeNodeInfoT<DATA,DIM> >  &eltL
   }
 }
  
+template < typename DATA, unsigned DIM >
+void
+KDTreeLinkerAlgo<DATA,DIM>::reorder(std::vector<KDTreeNodeInfoT<DATA,DIM> >  &eltList)
+{
+  if (!eltList.empty()) {
+    initialEltList = &eltList;
+    recReorder(0, eltList.size(), 0);
+    initialEltList = nullptr;
+  }
+}
+
+template < typename DATA, unsigned DIM >
+void
+KDTreeLinkerAlgo<DATA,DIM>::recReorder(int	low,
+				       int	high,
+				       int	depth)
+{
+  if (high - low > 1) {
+    int medianId = medianSearch(low, high, depth);
+    recReorder(low, medianId + 1, depth + 1);
+    recReorder(medianId + 1, high, depth + 1);
+  }
+}
+ 
 //Fast median search with Wirth algorithm in eltList between low and high indexes.
 template < typename DATA, unsigned DIM >
 int
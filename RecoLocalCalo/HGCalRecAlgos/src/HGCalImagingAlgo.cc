@@ -88,23 +88,36 @@ void HGCalImagingAlgo::makeClusters() {
   // assign all hits in each layer to a cluster core or halo
   tbb::this_task_arena::isolate([&] {
     tbb::parallel_for(size_t(0), size_t(2 * maxlayer + 2), [&](size_t i) {
-      KDTreeBox bounds(minpos[i][0], maxpos[i][0], minpos[i][1], maxpos[i][1]);
-      KDTree hit_kdtree;
-      hit_kdtree.build(points[i], bounds);
-
       unsigned int actualLayer =
           i > maxlayer
               ? (i - (maxlayer + 1))
-              : i; // maps back from index used for KD trees to actual layer
+              : i; // maps back from index used for the tiles to actual layer
+
+      // put the hits in the order in which the KD tree used to find them, so
+      // that the densities are summed and the ties broken in the same order
+      KDTree().reorder(points[i]);
+
+      // index the hits of the layer on a grid of tiles as large as the
+      // critical distance
+      std::vector<float> x, y;
+      x.reserve(points[i].size());
+      y.reserve(points[i].size());
+      for (auto const &node : points[i]) {
+        x.push_back(node.dims[0]);
+        y.push_back(node.dims[1]);
+      }
+      HGCalLayerTiles tiles;
+      tiles.fill(x, y, minpos[i][0], maxpos[i][0], minpos[i][1], maxpos[i][1],
+                 criticalDistance(actualLayer));
 
       double maxdensity = calculateLocalDensity(
-          points[i], hit_kdtree, actualLayer); // also stores rho (energy
-                                               // density) for each point (node)
+          points[i], tiles, actualLayer); // also stores rho (energy
+                                          // density) for each point (node)
       // calculate distance to nearest point with higher density storing
       // distance (delta) and point's index
-      calculateDistanceToHigher(points[i]);
-      findAndAssignClusters(points[i], hit_kdtree, maxdensity, bounds,
-                            actualLayer, layerClustersPerLayer[i]);
+      calculateDistanceToHigher(points[i], tiles);
+      findAndAssignClusters(points[i], tiles, maxdensity, actualLayer,
+                            layerClustersPerLayer[i]);
     });
   });
 }
@@ -230,46 +243,67 @@ HGCalImagingAlgo::calculatePosition(std::vector<KDNode> &v) const {
   return math::XYZPoint(0, 0, 0);
 }
 
+float HGCalImagingAlgo::criticalDistance(const unsigned int layer) const {
+  if (layer <= lastLayerEE)
+    return vecDeltas[0];
+  else if (layer <= lastLayerFH)
+    return vecDeltas[1];
+  else
+    return vecDeltas[2];
+}
+
 double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd,
-                                               KDTree &lp,
+                                               const HGCalLayerTiles &lp,
                                                const unsigned int layer) const {
 
+  // maximum search distance (critical distance) for local density calculation
+  const float delta_c = criticalDistance(layer);
+
+  // for each node calculate local density rho and store it; the largest
+  // partial sum of each node is kept to compute the maximum density
+  std::vector<double> maxrho(nd.size(), 0.);
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, nd.size()),
+      [&](const tbb::blocked_range<size_t> &range) {
+        std::vector<unsigned int> found;
+        for (size_t i = range.begin(); i < range.end(); ++i) {
+          // speed up search by looking within +/- delta_c window only
+          const float xmin = nd[i].dims[0] - delta_c;
+          const float xmax = nd[i].dims[0] + delta_c;
+          const float ymin = nd[i].dims[1] - delta_c;
+          const float ymax = nd[i].dims[1] + delta_c;
+          found.clear();
+          lp.forEachInBox(xmin, xmax, ymin, ymax, [&](unsigned int k) {
+            if (lp.x(k) >= xmin and lp.x(k) <= xmax and lp.y(k) >= ymin and
+                lp.y(k) <= ymax)
+              found.push_back(lp.index(k));
+          });
+          // sum in the order of the hits, which is the order of the KD tree
+          // search, so that rho is the same to the last bit
+          std::sort(found.begin(), found.end());
+          for (unsigned int j : found) {
+            if (distance(nd[i].data, nd[j].data) < delta_c) {
+              nd[i].data.rho += nd[j].data.weight;
+              maxrho[i] = std::max(maxrho[i], nd[i].data.rho);
+            }
+          }
+        }
+      }); // end loop nodes
+
   double maxdensity = 0.;
-  float delta_c; // maximum search distance (critical distance) for local
-                 // density calculation
-  if (layer <= lastLayerEE)
-    delta_c = vecDeltas[0];
-  else if (layer <= lastLayerFH)
-    delta_c = vecDeltas[1];
-  else
-    delta_c = vecDeltas[2];
-
-  // for each node calculate local density rho and store it
-  for (unsigned int i = 0; i < nd.size(); ++i) {
-    // speec up search by looking within +/- delta_c window only
-    KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
-                         nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
-    std::vector<KDNode> found;
-    lp.search(search_box, found);
-    const unsigned int found_size = found.size();
-    for (unsigned int j = 0; j < found_size; j++) {
-      if (distance(nd[i].data, found[j].data) < delta_c) {
-        nd[i].data.rho += found[j].data.weight;
-        maxdensity = std::max(maxdensity, nd[i].data.rho);
-      }
-    } // end loop found
-  }   // end loop nodes
+  for (double rho : maxrho)
+    maxdensity = std::max(maxdensity, rho);
   return maxdensity;
 }
 
 double
-HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd) const {
+HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd,
+                                            const HGCalLayerTiles &lp) const {
 
   // sort vector of Hexels by decreasing local density
   std::vector<size_t> rs = sorted_indices(nd);
 
   double maxdensity = 0.0;
-  int nearestHigher = -1;
 
   if (!rs.empty())
     maxdensity = nd[rs[0]].data.rho;
@@ -285,37 +319,58 @@ HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd) const {
       dist2 = tmp;
   }
   nd[rs[0]].data.delta = std::sqrt(dist2);
-  nd[rs[0]].data.nearestHigher = nearestHigher;
-
-  // now we save the largest distance as a starting point
-  const double max_dist2 = dist2;
-  const unsigned int nd_size = nd.size();
-
-  for (unsigned int oi = 1; oi < nd_size;
-       ++oi) { // start from second-highest density
-    dist2 = max_dist2;
-    unsigned int i = rs[oi];
-    // we only need to check up to oi since hits
-    // are ordered by decreasing density
-    // and all points coming BEFORE oi are guaranteed to have higher rho
-    // and the ones AFTER to have lower rho
-    for (unsigned int oj = 0; oj < oi; ++oj) {
-      unsigned int j = rs[oj];
-      double tmp = distance2(nd[i].data, nd[j].data);
-      if (tmp <= dist2) { // this "<=" instead of "<" addresses the (rare) case
-                          // when there are only two hits
-        dist2 = tmp;
-        nearestHigher = j;
-      }
+  nd[rs[0]].data.nearestHigher = -1;
+
+  // position of each hit in the list sorted by decreasing density: all points
+  // with a lower rank have a higher rho
+  std::vector<unsigned int> rank(nd.size());
+  for (unsigned int oi = 0; oi < rs.size(); ++oi)
+    rank[rs[oi]] = oi;
+
+  // tolerance on the distance between a hit and the border of its tile
+  const double margin = 1.e-3;
+  const double tileSize = lp.tileSize();
+
+  tbb::parallel_for(size_t(1), rs.size(), [&](size_t oi) {
+    // start from second-highest density
+    const unsigned int i = rs[oi];
+    const double xi = nd[i].data.x;
+    const double yi = nd[i].data.y;
+    const int bx = lp.binX(nd[i].dims[0]);
+    const int by = lp.binY(nd[i].dims[1]);
+    double dist2 = std::numeric_limits<double>::max();
+    int nearestHigher = -1;
+    // look for the nearest point with a higher density in rings of tiles
+    // of increasing size around the tile of the hit, until the next ring is
+    // farther than the nearest point found so far; among the points at the
+    // same distance, the one with the lowest density is chosen
+    for (int r = 0;; ++r) {
+      if (r > 1 and dist2 < std::pow(std::max((r - 1) * tileSize - margin, 0.), 2))
+        break;
+      bool inside = lp.forEachInRing(bx, by, r, [&](unsigned int k) {
+        const unsigned int j = lp.index(k);
+        if (rank[j] >= oi)
+          return;
+        const double dx = xi - lp.x(k);
+        const double dy = yi - lp.y(k);
+        const double tmp = dx * dx + dy * dy;
+        if (tmp < dist2 or
+            (tmp == dist2 and rank[j] > rank[nearestHigher])) {
+          dist2 = tmp;
+          nearestHigher = j;
+        }
+      });
+      if (not inside)
+        break;
     }
     nd[i].data.delta = std::sqrt(dist2);
     nd[i].data.nearestHigher =
         nearestHigher; // this uses the original unsorted hitlist
-  }
+  });
   return maxdensity;
 }
 int HGCalImagingAlgo::findAndAssignClusters(
-    std::vector<KDNode> &nd, KDTree &lp, double maxdensity, KDTreeBox &bounds,
+    std::vector<KDNode> &nd, const HGCalLayerTiles &lp, double maxdensity,
     const unsigned int layer,
     std::vector<std::vector<KDNode>> &clustersOnLayer) const {
 
@@ -325,13 +380,7 @@ int HGCalImagingAlgo::findAndAssignClusters(
   // cluster centers...
 
   unsigned int nClustersOnLayer = 0;
-  float delta_c; // critical distance
-  if (layer <= lastLayerEE)
-    delta_c = vecDeltas[0];
-  else if (layer <= lastLayerFH)
-    delta_c = vecDeltas[1];
-  else
-    delta_c = vecDeltas[2];
+  const float delta_c = criticalDistance(layer); // critical distance
 
   std::vector<size_t> rs =
       sorted_indices(nd); // indices sorted by decreasing rho
@@ -389,51 +438,57 @@ int HGCalImagingAlgo::findAndAssignClusters(
   // assign points closer than dc to other clusters to border region
   // and find critical border density
   std::vector<double> rho_b(nClustersOnLayer, 0.);
-  lp.clear();
-  lp.build(nd, bounds);
   // now loop on all hits again :( and check: if there are hits from another
   // cluster within d_c -> flag as border hit
-  for (unsigned int i = 0; i < nd_size; ++i) {
+  tbb::parallel_for(size_t(0), size_t(nd_size), [&](size_t i) {
     int ci = nd[i].data.clusterIndex;
+    if (ci == -1)
+      return;
+    bool flag_border = false;
     bool flag_isolated = true;
-    if (ci != -1) {
-      KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
-                           nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
-      std::vector<KDNode> found;
-      lp.search(search_box, found);
-
-      const unsigned int found_size = found.size();
-      for (unsigned int j = 0; j < found_size;
-           j++) { // start from 0 here instead of 1
-        // check if the hit is not within d_c of another cluster
-        if (found[j].data.clusterIndex != -1) {
-          float dist = distance(found[j].data, nd[i].data);
-          if (dist < delta_c && found[j].data.clusterIndex != ci) {
-            // in which case we assign it to the border
-            nd[i].data.isBorder = true;
-            break;
-          }
-          // because we are using two different containers, we have to make sure
-          // that we don't unflag the
-          // hit when it finds *itself* closer than delta_c
-          if (dist < delta_c && dist != 0. &&
-              found[j].data.clusterIndex == ci) {
-            // in this case it is not an isolated hit
-            // the dist!=0 is because the hit being looked at is also inside the
-            // search box and at dist==0
+    const double xi = nd[i].data.x;
+    const double yi = nd[i].data.y;
+    const float xmin = nd[i].dims[0] - delta_c;
+    const float xmax = nd[i].dims[0] + delta_c;
+    const float ymin = nd[i].dims[1] - delta_c;
+    const float ymax = nd[i].dims[1] + delta_c;
+    lp.forEachInBox(
+        xmin, xmax, ymin, ymax, [&](unsigned int k) {
+          if (lp.x(k) < xmin or lp.x(k) > xmax or lp.y(k) < ymin or
+              lp.y(k) > ymax)
+            return;
+          const int cj = nd[lp.index(k)].data.clusterIndex;
+          if (cj == -1)
+            return;
+          const double dx = xi - lp.x(k);
+          const double dy = yi - lp.y(k);
+          float dist = std::sqrt(dx * dx + dy * dy);
+          // check if the hit is not within d_c of another cluster, in which
+          // case we assign it to the border
+          if (dist < delta_c && cj != ci)
+            flag_border = true;
+          // the hit is not isolated if there is another hit of the same
+          // cluster within d_c; the dist!=0 is because the hit being looked
+          // at is also inside the search box and at dist==0
+          if (dist < delta_c && dist != 0. && cj == ci)
             flag_isolated = false;
-          }
-        }
-      }
-      if (flag_isolated)
-        nd[i].data.isBorder =
-            true; // the hit is more than delta_c from any of its brethren
-    }
-    // check if this border hit has density larger than the current rho_b and
-    // update
+        });
+    if (flag_border || flag_isolated)
+      nd[i].data.isBorder =
+          true; // the hit is more than delta_c from any of its brethren
+  }); // end loop all hits
+
+  // check if the border hits have density larger than the current rho_b and
+  // update
+  for (unsigned int i = 0; i < nd_size; ++i) {
+    int ci = nd[i].data.clusterIndex;
     if (nd[i].data.isBorder && rho_b[ci] < nd[i].data.rho)
       rho_b[ci] = nd[i].data.rho;
-  } // end loop all hits
+  }
+
+  // the hits used to be reordered here by a second KD tree build, which
+  // gives the order of the hits in the clusters
+  KDTree().reorder(nd);
 
   // flag points in cluster with density < rho_b as halo points, then fill the
   // cluster vector
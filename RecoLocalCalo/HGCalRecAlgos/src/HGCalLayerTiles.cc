@@ -0,0 +1,46 @@
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalLayerTiles.h"
+
+#include <cmath>
+#include <numeric>
+
+namespace {
+  // number of tiles along one axis, and their size
+  void binning(float extent, float minTileSize, int maxBins, int &nBins,
+               float &tileSize) {
+    nBins = std::min(std::max(int(extent / minTileSize), 1), maxBins);
+    tileSize = std::max(extent / nBins, minTileSize);
+  }
+}
+
+void HGCalLayerTiles::fill(const std::vector<float> &x,
+                           const std::vector<float> &y, float minX, float maxX,
+                           float minY, float maxY, float minTileSize) {
+  const unsigned int size = x.size();
+
+  // do not use more tiles than hits, most of them would be empty
+  const int maxBins = std::max(int(std::sqrt(float(size))), 1);
+  minX_ = minX;
+  minY_ = minY;
+  binning(maxX - minX, minTileSize, maxBins, nBinsX_, tileSizeX_);
+  binning(maxY - minY, minTileSize, maxBins, nBinsY_, tileSizeY_);
+
+  // counting sort of the hits by tile
+  std::vector<unsigned int> tiles(size);
+  offsets_.assign(nBinsX_ * nBinsY_ + 1, 0);
+  for (unsigned int i = 0; i < size; ++i) {
+    tiles[i] = binY(y[i]) * nBinsX_ + binX(x[i]);
+    ++offsets_[tiles[i] + 1];
+  }
+  std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+
+  x_.resize(size);
+  y_.resize(size);
+  index_.resize(size);
+  std::vector<unsigned int> next(offsets_.begin(), offsets_.end() - 1);
+  for (unsigned int i = 0; i < size; ++i) {
+    const unsigned int k = next[tiles[i]]++;
+    x_[k] = x[i];
+    y_[k] = y[i];
+    index_[k] = i;
+  }
+}
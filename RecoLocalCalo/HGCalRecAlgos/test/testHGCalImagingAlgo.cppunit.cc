@@ -0,0 +1,248 @@
+/*
+ *  testHGCalImagingAlgo.cppunit.cc
+ *
+ *  Checks that HGCalImagingAlgo::makeClusters, which looks up the neighbours
+ *  of the hits in HGCalLayerTiles, makes exactly the same clusters as the
+ *  previous implementation with a KD tree per layer, copied here: same hits
+ *  in the same order, with the same density, distance to higher, border and
+ *  halo flags.
+ */
+
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalImagingAlgo.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+class testHGCalImagingAlgo : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testHGCalImagingAlgo);
+  CPPUNIT_TEST(sameClustersTest);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void sameClustersTest();
+
+private:
+  typedef HGCalImagingAlgo::Hexel Hexel;
+  typedef HGCalImagingAlgo::KDNode KDNode;
+  typedef HGCalImagingAlgo::KDTree KDTree;
+
+  static double distance(const Hexel &pt1, const Hexel &pt2);
+  static void fillLayer(HGCalImagingAlgo &algo, unsigned int layer,
+                        unsigned int nhits, std::mt19937 &rng);
+
+  // the clustering of one layer with a KD tree, as it was done before the tiles
+  static void referenceClusters(std::vector<KDNode> &nd, float xmin, float xmax,
+                                float ymin, float ymax, float delta_c,
+                                double kappa,
+                                std::vector<std::vector<KDNode>> &clusters);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testHGCalImagingAlgo);
+
+double testHGCalImagingAlgo::distance(const Hexel &pt1, const Hexel &pt2) {
+  const double dx = pt1.x - pt2.x;
+  const double dy = pt1.y - pt2.y;
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+// hits on a grid of hexagons of side 1, with a few energy values so that
+// many densities and distances are equal, and some hot spots
+void testHGCalImagingAlgo::fillLayer(HGCalImagingAlgo &algo, unsigned int layer,
+                                     unsigned int nhits, std::mt19937 &rng) {
+  const double energies[] = {0.5, 1., 1., 2., 2., 5.};
+  std::uniform_int_distribution<int> cell(0, 59);
+  std::uniform_int_distribution<int> energy(0, 5);
+  std::uniform_real_distribution<double> spot(0., 1.);
+  auto &points = algo.points[layer];
+  for (unsigned int n = 0; n < nhits; ++n) {
+    const int row = cell(rng);
+    const int column = cell(rng);
+    Hexel hexel;
+    hexel.x = float((column + 0.5 * (row % 2)) * std::sqrt(3.));
+    hexel.y = float(row * 1.5);
+    hexel.weight = energies[energy(rng)] * (spot(rng) < 0.05 ? 20. : 1.);
+    hexel.detid = DetId(DetId(DetId::Forward, 0).rawId() + layer * 100000 + n);
+    const float x = hexel.x;
+    const float y = hexel.y;
+    points.emplace_back(hexel, x, y);
+    if (n == 0) {
+      algo.minpos[layer] = {{x, y}};
+      algo.maxpos[layer] = {{x, y}};
+    } else {
+      algo.minpos[layer] = {{std::min(x, algo.minpos[layer][0]),
+                             std::min(y, algo.minpos[layer][1])}};
+      algo.maxpos[layer] = {{std::max(x, algo.maxpos[layer][0]),
+                             std::max(y, algo.maxpos[layer][1])}};
+    }
+  }
+}
+
+void testHGCalImagingAlgo::referenceClusters(
+    std::vector<KDNode> &nd, float xmin, float xmax, float ymin, float ymax,
+    float delta_c, double kappa, std::vector<std::vector<KDNode>> &clusters) {
+  KDTreeBox bounds(xmin, xmax, ymin, ymax);
+  KDTree lp;
+  lp.build(nd, bounds);
+
+  // local density
+  double maxdensity = 0.;
+  for (unsigned int i = 0; i < nd.size(); ++i) {
+    KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
+                         nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
+    std::vector<KDNode> found;
+    lp.search(search_box, found);
+    for (auto const &hit : found) {
+      if (distance(nd[i].data, hit.data) < delta_c) {
+        nd[i].data.rho += hit.data.weight;
+        maxdensity = std::max(maxdensity, nd[i].data.rho);
+      }
+    }
+  }
+
+  // distance to the nearest hit with a higher density
+  std::vector<size_t> rs = sorted_indices(nd);
+  if (rs.empty())
+    return;
+  double dist2 = 0.;
+  for (auto &j : nd) {
+    const double dx = nd[rs[0]].data.x - j.data.x;
+    const double dy = nd[rs[0]].data.y - j.data.y;
+    dist2 = std::max(dist2, dx * dx + dy * dy);
+  }
+  nd[rs[0]].data.delta = std::sqrt(dist2);
+  nd[rs[0]].data.nearestHigher = -1;
+  const double max_dist2 = dist2;
+  int nearestHigher = -1;
+  for (unsigned int oi = 1; oi < nd.size(); ++oi) {
+    dist2 = max_dist2;
+    unsigned int i = rs[oi];
+    for (unsigned int oj = 0; oj < oi; ++oj) {
+      unsigned int j = rs[oj];
+      const double dx = nd[i].data.x - nd[j].data.x;
+      const double dy = nd[i].data.y - nd[j].data.y;
+      const double tmp = dx * dx + dy * dy;
+      if (tmp <= dist2) {
+        dist2 = tmp;
+        nearestHigher = j;
+      }
+    }
+    nd[i].data.delta = std::sqrt(dist2);
+    nd[i].data.nearestHigher = nearestHigher;
+  }
+
+  // cluster centers
+  std::vector<size_t> ds(nd.size());
+  std::iota(ds.begin(), ds.end(), 0);
+  std::sort(ds.begin(), ds.end(), [&nd](size_t i1, size_t i2) {
+    return nd[i1].data.delta > nd[i2].data.delta;
+  });
+  unsigned int nClusters = 0;
+  for (unsigned int i = 0; i < nd.size(); ++i) {
+    if (nd[ds[i]].data.delta < delta_c)
+      break;
+    if (nd[ds[i]].data.rho * kappa < maxdensity)
+      continue;
+    nd[ds[i]].data.clusterIndex = nClusters++;
+  }
+  if (nClusters == 0)
+    return;
+  for (unsigned int oi = 1; oi < nd.size(); ++oi) {
+    unsigned int i = rs[oi];
+    if (nd[i].data.clusterIndex == -1)
+      nd[i].data.clusterIndex = nd[nd[i].data.nearestHigher].data.clusterIndex;
+  }
+  clusters.resize(nClusters);
+
+  // border and halo hits
+  std::vector<double> rho_b(nClusters, 0.);
+  lp.clear();
+  lp.build(nd, bounds);
+  for (unsigned int i = 0; i < nd.size(); ++i) {
+    int ci = nd[i].data.clusterIndex;
+    bool flag_isolated = true;
+    if (ci != -1) {
+      KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
+                           nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
+      std::vector<KDNode> found;
+      lp.search(search_box, found);
+      for (auto const &hit : found) {
+        if (hit.data.clusterIndex != -1) {
+          float dist = distance(hit.data, nd[i].data);
+          if (dist < delta_c && hit.data.clusterIndex != ci) {
+            nd[i].data.isBorder = true;
+            break;
+          }
+          if (dist < delta_c && dist != 0. && hit.data.clusterIndex == ci)
+            flag_isolated = false;
+        }
+      }
+      if (flag_isolated)
+        nd[i].data.isBorder = true;
+    }
+    if (nd[i].data.isBorder && rho_b[ci] < nd[i].data.rho)
+      rho_b[ci] = nd[i].data.rho;
+  }
+  for (unsigned int i = 0; i < nd.size(); ++i) {
+    int ci = nd[i].data.clusterIndex;
+    if (ci != -1) {
+      if (nd[i].data.rho <= rho_b[ci])
+        nd[i].data.isHalo = true;
+      clusters[ci].push_back(nd[i]);
+    }
+  }
+}
+
+void testHGCalImagingAlgo::sameClustersTest() {
+  const std::vector<double> vecDeltas = {2., 2., 5.};
+  const double kappa = 9.;
+  HGCalImagingAlgo algo(vecDeltas, kappa, 0., reco::CaloCluster::hgcal_mixed,
+                        false, std::vector<double>(), std::vector<double>(),
+                        std::vector<double>(), 1., std::vector<double>(), 1.);
+
+  // EE, FH and BH layers of both endcaps, with different occupancies
+  std::mt19937 rng(1234);
+  const unsigned int maxlayer = HGCalImagingAlgo::maxlayer;
+  const std::vector<unsigned int> layers = {1, 20, 35, 45, maxlayer + 2,
+                                            maxlayer + 48};
+  const std::vector<unsigned int> nhits = {3000, 800, 1500, 200, 50, 1};
+  for (unsigned int l = 0; l < layers.size(); ++l)
+    fillLayer(algo, layers[l], nhits[l], rng);
+  const std::vector<std::vector<KDNode>> points = algo.points;
+
+  algo.makeClusters();
+
+  for (unsigned int l = 0; l < layers.size(); ++l) {
+    const unsigned int i = layers[l];
+    const unsigned int actualLayer = i > maxlayer ? i - (maxlayer + 1) : i;
+    std::vector<KDNode> nd = points[i];
+    std::vector<std::vector<KDNode>> expected;
+    referenceClusters(nd, algo.minpos[i][0], algo.maxpos[i][0],
+                      algo.minpos[i][1], algo.maxpos[i][1],
+                      algo.criticalDistance(actualLayer), kappa, expected);
+
+    auto const &clusters = algo.layerClustersPerLayer[i];
+    CPPUNIT_ASSERT(clusters.size() == expected.size());
+    for (unsigned int c = 0; c < clusters.size(); ++c) {
+      CPPUNIT_ASSERT(clusters[c].size() == expected[c].size());
+      for (unsigned int h = 0; h < clusters[c].size(); ++h) {
+        const Hexel &hit = clusters[c][h].data;
+        const Hexel &ref = expected[c][h].data;
+        CPPUNIT_ASSERT(hit.detid == ref.detid);
+        CPPUNIT_ASSERT(hit.rho == ref.rho);
+        CPPUNIT_ASSERT(hit.delta == ref.delta);
+        CPPUNIT_ASSERT(hit.nearestHigher == ref.nearestHigher);
+        CPPUNIT_ASSERT(hit.clusterIndex == ref.clusterIndex);
+        CPPUNIT_ASSERT(hit.isBorder == ref.isBorder);
+        CPPUNIT_ASSERT(hit.isHalo == ref.isHalo);
+      }
+    }
+  }
+}
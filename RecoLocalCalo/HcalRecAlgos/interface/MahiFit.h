@@ -14,6 +14,9 @@
 
 #include <Math/Functor.h>
 
+#include <map>
+#include <memory>
+
 struct MahiNnlsWorkspace {
 
   unsigned int nPulseTot;
@@ -153,6 +156,7 @@ class MahiFit
   void updatePulseShape(double itQ, FullSampleVector &pulseShape, 
 			FullSampleVector &pulseDeriv,
 			FullSampleMatrix &pulseCov) const;
+  void getPulseShape(double t0, std::array<double, MaxSVSize>& pulse) const;
 
   double calculateArrivalTime() const;
   double calculateChiSq() const;
@@ -202,8 +206,25 @@ class MahiFit
 
   //for pulse shapes
   int cntsetPulseShape_;
-  std::unique_ptr<FitterFuncs::PulseShapeFunctor> psfPtr_;
-  std::unique_ptr<ROOT::Math::Functor> pfunctor_;
+
+  // The unit-amplitude pulse given by PulseShapeFunctor is linear in the arrival
+  // time within each half-ns cell, so it is tabulated per cell (value at the
+  // start of the cell and slope) once per template. Times outside the table
+  // are evaluated with the functor.
+  static constexpr float pulseTableMin_  = -50.f;
+  static constexpr float pulseTableStep_ = 0.5f;
+  static constexpr int   pulseTableSize_ = 300;
+
+  struct PulseShapeTemplate {
+    std::unique_ptr<FitterFuncs::PulseShapeFunctor> psf;
+    std::unique_ptr<ROOT::Math::Functor> functor;
+    std::vector<std::array<double, MaxSVSize> > shape;
+    std::vector<std::array<double, MaxSVSize> > slope;
+  };
+
+  // templates are kept for the whole job, since the channels alternate between them
+  std::map<const HcalPulseShapes::Shape*, PulseShapeTemplate> pulseShapeTemplates_;
+  const PulseShapeTemplate* pulseTemplate_=nullptr;
 
 }; 
 #endif
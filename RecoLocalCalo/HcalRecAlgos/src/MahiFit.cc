@@ -260,21 +260,12 @@ void MahiFit::updatePulseShape(double itQ, FullSampleVector &pulseShape, FullSam
   nnlsWork_.pulseM.fill(0);
   nnlsWork_.pulseP.fill(0);
 
-  const double xx[4]={t0, 1.0, 0.0, 3};
-  const double xxm[4]={-nnlsWork_.dt+t0, 1.0, 0.0, 3};
-  const double xxp[4]={ nnlsWork_.dt+t0, 1.0, 0.0, 3};
-
-  (*pfunctor_)(&xx[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseN);
-
-  (*pfunctor_)(&xxm[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseM);
-  
-  (*pfunctor_)(&xxp[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseP);
+  getPulseShape(t0, nnlsWork_.pulseN);
+  getPulseShape(-nnlsWork_.dt+t0, nnlsWork_.pulseM);
+  getPulseShape( nnlsWork_.dt+t0, nnlsWork_.pulseP);
 
   //in the 2018+ case where the sample of interest (SOI) is in TS3, add an extra offset to align 
-  //with previous SOI=TS4 case assumed by psfPtr_->getPulseShape()
+  //with previous SOI=TS4 case assumed by PulseShapeFunctor::getPulseShape()
   int delta =nnlsWork_. tsOffset == 3 ? 1 : 0;
 
   for (unsigned int iTS=0; iTS<nnlsWork_.tsSize; ++iTS) {
@@ -455,6 +446,32 @@ void MahiFit::onePulseMinimize() const {
 
 }
 
+void MahiFit::getPulseShape(double t0, std::array<double, MaxSVSize>& pulse) const {
+
+  double x = (t0 - pulseTableMin_)/pulseTableStep_;
+
+  if (x >= 0 && x < pulseTableSize_) {
+    int cell = int(x);
+    double dt = t0 - (pulseTableMin_ + cell*pulseTableStep_);
+    // the functor is continuous from the left at the cell boundaries
+    if (cell > 0 && x == cell) {
+      --cell;
+      dt = pulseTableStep_;
+    }
+    const auto& shape = pulseTemplate_->shape[cell];
+    const auto& slope = pulseTemplate_->slope[cell];
+    for (int iTS=0; iTS<MaxSVSize; ++iTS) {
+      pulse[iTS] = shape[iTS] + slope[iTS]*dt;
+    }
+  }
+  else {
+    const double xx[4]={t0, 1.0, 0.0, 3};
+    (*pulseTemplate_->functor)(&xx[0]);
+    pulseTemplate_->psf->getPulseShape(pulse);
+  }
+
+}
+
 double MahiFit::calculateChiSq() const {
   
   return (nnlsWork_.covDecomp.matrixL().solve(nnlsWork_.pulseMat*nnlsWork_.ampVec - nnlsWork_.amplitudes)).squaredNorm();
@@ -468,7 +485,9 @@ void MahiFit::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps,const HcalT
       hcalTimeSlewDelay_ = hcalTimeSlewDelay;
       tsDelay1GeV_= hcalTimeSlewDelay->delay(1.0, slewFlavor_);
 
-      resetPulseShapeTemplate(ps);
+      auto found = pulseShapeTemplates_.find(&ps);
+      if (found == pulseShapeTemplates_.end()) resetPulseShapeTemplate(ps);
+      else pulseTemplate_ = &found->second;
       currentPulseShape_ = &ps;
     }
 }
@@ -476,12 +495,33 @@ void MahiFit::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps,const HcalT
 void MahiFit::resetPulseShapeTemplate(const HcalPulseShapes::Shape& ps) { 
   ++ cntsetPulseShape_;
 
+  PulseShapeTemplate& pst = pulseShapeTemplates_[&ps];
+
   // only the pulse shape itself from PulseShapeFunctor is used for Mahi
   // the uncertainty terms calculated inside PulseShapeFunctor are used for Method 2 only
-  psfPtr_.reset(new FitterFuncs::PulseShapeFunctor(ps,false,false,false,
+  pst.psf.reset(new FitterFuncs::PulseShapeFunctor(ps,false,false,false,
 						   1,0,0,10));
-  pfunctor_ = std::unique_ptr<ROOT::Math::Functor>( new ROOT::Math::Functor(psfPtr_.get(),&FitterFuncs::PulseShapeFunctor::singlePulseShapeFunc, 3) );
+  pst.functor = std::unique_ptr<ROOT::Math::Functor>( new ROOT::Math::Functor(pst.psf.get(),&FitterFuncs::PulseShapeFunctor::singlePulseShapeFunc, 3) );
+
+  // the value at the start of each cell is extrapolated from two points inside
+  // it, as the pulse jumps at some of the boundaries
+  pst.shape.resize(pulseTableSize_);
+  pst.slope.resize(pulseTableSize_);
+  std::array<double, MaxSVSize> pulse1, pulse3;
+  for (int cell=0; cell<pulseTableSize_; ++cell) {
+    const double xx1[4]={pulseTableMin_ + (cell+0.25)*pulseTableStep_, 1.0, 0.0, 3};
+    const double xx3[4]={pulseTableMin_ + (cell+0.75)*pulseTableStep_, 1.0, 0.0, 3};
+    (*pst.functor)(&xx1[0]);
+    pst.psf->getPulseShape(pulse1);
+    (*pst.functor)(&xx3[0]);
+    pst.psf->getPulseShape(pulse3);
+    for (int iTS=0; iTS<MaxSVSize; ++iTS) {
+      pst.slope[cell][iTS] = (pulse3[iTS] - pulse1[iTS])/(0.5*pulseTableStep_);
+      pst.shape[cell][iTS] = pulse1[iTS] - 0.25*pulseTableStep_*pst.slope[cell][iTS];
+    }
+  }
 
+  pulseTemplate_ = &pst;
 
 }
 
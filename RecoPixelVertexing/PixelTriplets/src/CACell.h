@@ -3,6 +3,8 @@
 
 #include <array>
 #include <cmath>
+#include <utility>
+#include <vector>
 
 #include "DataFormats/Math/interface/deltaPhi.h"
 #include "RecoTracker/TkHitPairs/interface/RecHitsSortedInPhi.h"
@@ -39,6 +41,9 @@ public:
   using CAntuplet = std::vector<unsigned int>;
   using CAColl = std::vector<CACell>;
   using CAStatusColl = std::vector<CACellStatus>;
+  // (inner cell, outer cell) connections, collected in a single arena
+  using CAEdge = std::pair<unsigned int, unsigned int>;
+  using CAEdges = std::vector<CAEdge>;
   
   
   CACell(const HitDoublets* doublets, int doubletId, const int innerHitId, const int outerHitId) :
@@ -98,27 +103,10 @@ public:
     return theDoublets->phi(theDoubletId, HitDoublets::outer);
   }
   
-  void evolve(unsigned int me, CAStatusColl& allStatus) {
-    
-    allStatus[me].hasSameStateNeighbors = 0;
-    auto mystate = allStatus[me].theCAState;
-    
-    for (auto oc : theOuterNeighbors ) {
-      
-      if (allStatus[oc].getCAState() == mystate) {
-	
-	allStatus[me].hasSameStateNeighbors = 1;
-	
-	break;
-      }
-    }
-    
-  }
-  
-
   void checkAlignmentAndAct(CAColl& allCells, CAntuple & innerCells, const float ptmin, const float region_origin_x,
 			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
-			    const float phiCut, const float hardPtCut, std::vector<CACell::CAntuplet> * foundTriplets) {
+			    const float phiCut, const float hardPtCut, std::vector<CACell::CAntuplet> * foundTriplets,
+			    CAEdges * foundEdges) {
     int ncells = innerCells.size();
     int constexpr VSIZE = 16;
     int ok[VSIZE];
@@ -142,9 +130,7 @@ public:
 	if (ok[j]&&haveSimilarCurvature(oc,ptmin, region_origin_x, region_origin_y,
 					region_origin_radius, phiCut, hardPtCut)) {
 	  if (foundTriplets) foundTriplets->emplace_back(CACell::CAntuplet{koc,cellId});
-	  else {
-	    oc.tagAsOuterNeighbor(cellId);
-	  }
+	  else foundEdges->emplace_back(koc,cellId);
 	}
       }
     };
@@ -154,11 +140,11 @@ public:
     
   }
   
-  void checkAlignmentAndTag(CAColl& allCells, CAntuple & innerCells, const float ptmin, const float region_origin_x,
-			    const float region_origin_y, const float region_origin_radius, const float thetaCut,
-			    const float phiCut, const float hardPtCut) {
+  void checkAlignmentAndTag(CAColl& allCells, CAntuple & innerCells, CAEdges& foundEdges, const float ptmin,
+			    const float region_origin_x, const float region_origin_y, const float region_origin_radius,
+			    const float thetaCut, const float phiCut, const float hardPtCut) {
     checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, nullptr);
+			 phiCut, hardPtCut, nullptr, &foundEdges);
     
   }
   void checkAlignmentAndPushTriplet(CAColl& allCells, CAntuple & innerCells, std::vector<CACell::CAntuplet>& foundTriplets,
@@ -166,7 +152,7 @@ public:
 				    const float region_origin_radius, const float thetaCut, const float phiCut,
 				    const float hardPtCut) {
     checkAlignmentAndAct(allCells, innerCells, ptmin, region_origin_x, region_origin_y, region_origin_radius, thetaCut,
-			 phiCut, hardPtCut, &foundTriplets);
+			 phiCut, hardPtCut, &foundTriplets, nullptr);
   }
   
   
@@ -182,12 +168,6 @@ public:
   }
   
   
-  void tagAsOuterNeighbor(unsigned int otherCell)
-  {
-    theOuterNeighbors.push_back(otherCell);
-  }
-  
-  
   bool haveSimilarCurvature(const CACell & otherCell, const float ptmin,
 			    const float region_origin_x, const float region_origin_y, const float region_origin_radius, const float phiCut, const float hardPtCut) const
   {
@@ -257,37 +237,8 @@ public:
   }
   
   
-  // trying to free the track building process from hardcoded layers, leaving the visit of the graph
-  // based on the neighborhood connections between cells.
-  
-  void findNtuplets(CAColl& allCells, std::vector<CAntuplet>& foundNtuplets, CAntuplet& tmpNtuplet, const unsigned int minHitsPerNtuplet) const {
-    
-    // the building process for a track ends if:
-    // it has no outer neighbor
-    // it has no compatible neighbor
-    // the ntuplets is then saved if the number of hits it contains is greater than a threshold
-    
-    if (tmpNtuplet.size() == minHitsPerNtuplet - 1)
-      {
-	foundNtuplets.push_back(tmpNtuplet);
-      }
-    else
-      {
-	unsigned int numberOfOuterNeighbors = theOuterNeighbors.size();
-	for (unsigned int i = 0; i < numberOfOuterNeighbors; ++i) {
-	  tmpNtuplet.push_back((theOuterNeighbors[i]));
-	  allCells[theOuterNeighbors[i]].findNtuplets(allCells,foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
-	  tmpNtuplet.pop_back();
-	}
-      }
-    
-  }
-  
-  
 private:
   
-  CAntuple theOuterNeighbors;
-  
   const HitDoublets* theDoublets;  
   const int theDoubletId;
   
@@ -14,6 +14,7 @@ void CellularAutomaton::createAndConnectCells(
     tsize += hd->size();
   }
   allCells.reserve(tsize);
+  theEdges.reserve(2 * tsize);
   unsigned int cellId = 0;
   float ptmin = region.ptMin();
   float region_origin_x = region.origin().x();
@@ -61,7 +62,7 @@ void CellularAutomaton::createAndConnectCells(
 
           auto & neigCells = currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)];
           allCells.back().checkAlignmentAndTag(
-              allCells, neigCells, ptmin, region_origin_x, region_origin_y,
+              allCells, neigCells, theEdges, ptmin, region_origin_x, region_origin_y,
               region_origin_radius, thetaCut, phiCut, hardPtCut);
         }
         assert(cellId == currentLayerPairRef.theFoundCells[1]);
@@ -78,25 +79,55 @@ void CellularAutomaton::createAndConnectCells(
       }
     }
   }
+
+  buildOuterNeighbors();
+}
+
+void CellularAutomaton::buildOuterNeighbors()
+{
+  // counting sort of the connections by inner cell; it is stable, so the
+  // neighbors of each cell keep the order in which they were found
+  theOuterNeighborsOffsets.assign(allCells.size() + 1, 0);
+  for (auto const & edge : theEdges) {
+    ++theOuterNeighborsOffsets[edge.first + 1];
+  }
+  for (unsigned int i = 0; i < allCells.size(); ++i) {
+    theOuterNeighborsOffsets[i + 1] += theOuterNeighborsOffsets[i];
+  }
+  theOuterNeighbors.resize(theEdges.size());
+  std::vector<unsigned int> fill(theOuterNeighborsOffsets.begin(), theOuterNeighborsOffsets.end() - 1);
+  for (auto const & edge : theEdges) {
+    theOuterNeighbors[fill[edge.first]++] = edge.second;
+  }
+  theEdges.clear();
 }
 
 void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
 {
   allStatus.resize(allCells.size());
 
+  // a cell has a "friend" if at least one of its outer neighbors is in the same state
+  auto evolveCell = [this](unsigned int i) {
+    auto mystate = allStatus[i].theCAState;
+    unsigned char same = 0;
+    for (auto k = theOuterNeighborsOffsets[i]; k < theOuterNeighborsOffsets[i + 1]; ++k) {
+      same |= (allStatus[theOuterNeighbors[k]].theCAState == mystate);
+    }
+    allStatus[i].hasSameStateNeighbors = same;
+  };
+
+  // the cells of all layer pairs are stored contiguously, so the first
+  // iterations run over the whole status array
+  unsigned int numberOfCells = allCells.size();
   unsigned int numberOfIterations = minHitsPerNtuplet - 2;
   // keeping the last iteration for later
   for (unsigned int iteration = 0; iteration < numberOfIterations - 1; ++iteration) {
-    for (auto & layerPair : theLayerGraph.theLayerPairs) {
-      for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
-        allCells[i].evolve(i, allStatus);
-      }
+    for (unsigned int i = 0; i < numberOfCells; ++i) {
+      evolveCell(i);
     }
 
-    for (auto & layerPair : theLayerGraph.theLayerPairs) {
-      for (auto i = layerPair.theFoundCells[0]; i < layerPair.theFoundCells[1]; ++i) {
-        allStatus[i].updateState();
-      }
+    for (unsigned int i = 0; i < numberOfCells; ++i) {
+      allStatus[i].updateState();
     }
   }
 
@@ -107,7 +138,7 @@ void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
       auto foundCells = theLayerGraph.theLayerPairs[rootLayerPair].theFoundCells;
       for (auto i = foundCells[0]; i < foundCells[1]; ++i) {
         auto & cell = allStatus[i];
-        allCells[i].evolve(i, allStatus);
+        evolveCell(i);
         cell.updateState();
         if (cell.isRootCell(minHitsPerNtuplet - 2)) {
           theRootCells.push_back(i);
@@ -126,7 +157,27 @@ void CellularAutomaton::findNtuplets(std::vector<CACell::CAntuplet> & foundNtupl
   {
     tmpNtuplet.clear();
     tmpNtuplet.push_back(root_cell);
-    allCells[root_cell].findNtuplets(allCells, foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+    findNtuplets(root_cell, foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+  }
+}
+
+// trying to free the track building process from hardcoded layers, leaving the visit of the graph
+// based on the neighborhood connections between cells.
+void CellularAutomaton::findNtuplets(unsigned int cell, std::vector<CACell::CAntuplet> & foundNtuplets,
+                                     CACell::CAntuplet & tmpNtuplet, const unsigned int minHitsPerNtuplet) const
+{
+  // the building process for a track ends if:
+  // it has no outer neighbor
+  // it has no compatible neighbor
+  // the ntuplets is then saved if the number of hits it contains is greater than a threshold
+  if (tmpNtuplet.size() == minHitsPerNtuplet - 1) {
+    foundNtuplets.push_back(tmpNtuplet);
+  } else {
+    for (auto k = theOuterNeighborsOffsets[cell]; k < theOuterNeighborsOffsets[cell + 1]; ++k) {
+      tmpNtuplet.push_back(theOuterNeighbors[k]);
+      findNtuplets(theOuterNeighbors[k], foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+      tmpNtuplet.pop_back();
+    }
   }
 }
 
@@ -27,11 +27,21 @@ public:
 		    const float thetaCut, const float phiCut, const float hardPtCut);
   
 private:
+  // sort the connections found while creating the cells by inner cell,
+  // keeping their order, into the flat adjacency arrays below
+  void buildOuterNeighbors();
+  void findNtuplets(unsigned int cell, std::vector<CACell::CAntuplet>&, CACell::CAntuplet&, const unsigned int) const;
+
   CAGraph & theLayerGraph;
 
   std::vector<CACell> allCells;
   std::vector<CACellStatus> allStatus;
 
+  // outer neighbors of cell i are theOuterNeighbors[theOuterNeighborsOffsets[i]..theOuterNeighborsOffsets[i+1])
+  CACell::CAEdges theEdges;
+  std::vector<unsigned int> theOuterNeighborsOffsets;
+  std::vector<unsigned int> theOuterNeighbors;
+
   std::vector<unsigned int> theRootCells;
   std::vector<std::vector<CACell*> > theNtuplets;
   
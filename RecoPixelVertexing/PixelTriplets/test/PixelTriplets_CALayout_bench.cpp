@@ -0,0 +1,253 @@
+// Compares the two layouts of the connections between the cells of the
+// CellularAutomaton, on a synthetic graph of the size of a high pileup event:
+// - the layout used before, where each CACell owned a std::vector of its
+//   outer neighbors, filled with push_back while the cells were connected;
+// - the current one, where the connections are collected in a single arena
+//   and then sorted by inner cell into flat (CSR) adjacency arrays.
+// The cells only hold what CACell holds besides the neighbors.  For both
+// layouts the time to connect the cells, to evolve them and to find the
+// quadruplets is printed, and the quadruplets must be the same.
+//
+// usage: PixelTriplets_CALayout_bench [cells per layer pair] [events]
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  typedef std::vector<unsigned int> Ntuplet;
+  typedef std::pair<unsigned int, unsigned int> Edge;
+
+  struct Status {
+    unsigned char theCAState = 0;
+    unsigned char hasSameStateNeighbors = 0;
+    void updateState() { theCAState += hasSameStateNeighbors; }
+  };
+
+  // the connections of one event: the inner cells compatible with each new
+  // cell, in the order in which createAndConnectCells finds them
+  struct Event {
+    unsigned int cellsPerPair;
+    unsigned int pairs;
+    std::vector<std::vector<unsigned int> > innerCells;
+
+    Event(unsigned int cells, unsigned int layerPairs, std::mt19937& rng) : cellsPerPair(cells), pairs(layerPairs) {
+      std::poisson_distribution<unsigned int> neighbors(2.5);
+      std::uniform_int_distribution<unsigned int> cell(0, cells - 1);
+      innerCells.resize(cells * pairs);
+      for (unsigned int p = 1; p < pairs; ++p) {
+        for (unsigned int i = 0; i < cells; ++i) {
+          auto& inner = innerCells[p * cells + i];
+          for (unsigned int n = neighbors(rng); n > 0; --n)
+            inner.push_back((p - 1) * cells + cell(rng));
+        }
+      }
+    }
+  };
+
+  struct OldCell {
+    std::vector<unsigned int> theOuterNeighbors;
+    const void* theDoublets = nullptr;
+    int theDoubletId = 0;
+    float theInnerR = 0.f;
+    float theInnerZ = 0.f;
+  };
+
+  struct NewCell {
+    const void* theDoublets = nullptr;
+    int theDoubletId = 0;
+    float theInnerR = 0.f;
+    float theInnerZ = 0.f;
+  };
+
+  class OldLayout {
+  public:
+    void connect(const Event& event) {
+      allCells.clear();
+      allCells.reserve(event.innerCells.size());
+      for (unsigned int cellId = 0; cellId < event.innerCells.size(); ++cellId) {
+        allCells.emplace_back();
+        for (auto koc : event.innerCells[cellId])
+          allCells[koc].theOuterNeighbors.push_back(cellId);
+      }
+    }
+
+    void evolve(const Event& event, std::vector<unsigned int>& rootCells) {
+      allStatus.assign(allCells.size(), Status());
+      for (unsigned int i = 0; i < allCells.size(); ++i)
+        evolveCell(i);
+      for (auto& status : allStatus)
+        status.updateState();
+      for (unsigned int i = 0; i < event.cellsPerPair; ++i) {
+        evolveCell(i);
+        allStatus[i].updateState();
+        if (allStatus[i].theCAState >= 2)
+          rootCells.push_back(i);
+      }
+    }
+
+    void findNtuplets(unsigned int cell, std::vector<Ntuplet>& found, Ntuplet& tmp) const {
+      if (tmp.size() == 3) {
+        found.push_back(tmp);
+      } else {
+        for (auto oc : allCells[cell].theOuterNeighbors) {
+          tmp.push_back(oc);
+          findNtuplets(oc, found, tmp);
+          tmp.pop_back();
+        }
+      }
+    }
+
+  private:
+    void evolveCell(unsigned int me) {
+      allStatus[me].hasSameStateNeighbors = 0;
+      auto mystate = allStatus[me].theCAState;
+      for (auto oc : allCells[me].theOuterNeighbors) {
+        if (allStatus[oc].theCAState == mystate) {
+          allStatus[me].hasSameStateNeighbors = 1;
+          break;
+        }
+      }
+    }
+
+    std::vector<OldCell> allCells;
+    std::vector<Status> allStatus;
+  };
+
+  class NewLayout {
+  public:
+    void connect(const Event& event) {
+      allCells.clear();
+      allCells.reserve(event.innerCells.size());
+      theEdges.clear();
+      theEdges.reserve(2 * event.innerCells.size());
+      for (unsigned int cellId = 0; cellId < event.innerCells.size(); ++cellId) {
+        allCells.emplace_back();
+        for (auto koc : event.innerCells[cellId])
+          theEdges.emplace_back(koc, cellId);
+      }
+      // as CellularAutomaton::buildOuterNeighbors
+      theOffsets.assign(allCells.size() + 1, 0);
+      for (auto const& edge : theEdges)
+        ++theOffsets[edge.first + 1];
+      for (unsigned int i = 0; i < allCells.size(); ++i)
+        theOffsets[i + 1] += theOffsets[i];
+      theNeighbors.resize(theEdges.size());
+      std::vector<unsigned int> fill(theOffsets.begin(), theOffsets.end() - 1);
+      for (auto const& edge : theEdges)
+        theNeighbors[fill[edge.first]++] = edge.second;
+    }
+
+    void evolve(const Event& event, std::vector<unsigned int>& rootCells) {
+      allStatus.assign(allCells.size(), Status());
+      for (unsigned int i = 0; i < allCells.size(); ++i)
+        evolveCell(i);
+      for (auto& status : allStatus)
+        status.updateState();
+      for (unsigned int i = 0; i < event.cellsPerPair; ++i) {
+        evolveCell(i);
+        allStatus[i].updateState();
+        if (allStatus[i].theCAState >= 2)
+          rootCells.push_back(i);
+      }
+    }
+
+    void findNtuplets(unsigned int cell, std::vector<Ntuplet>& found, Ntuplet& tmp) const {
+      if (tmp.size() == 3) {
+        found.push_back(tmp);
+      } else {
+        for (auto k = theOffsets[cell]; k < theOffsets[cell + 1]; ++k) {
+          tmp.push_back(theNeighbors[k]);
+          findNtuplets(theNeighbors[k], found, tmp);
+          tmp.pop_back();
+        }
+      }
+    }
+
+  private:
+    void evolveCell(unsigned int i) {
+      auto mystate = allStatus[i].theCAState;
+      unsigned char same = 0;
+      for (auto k = theOffsets[i]; k < theOffsets[i + 1]; ++k)
+        same |= (allStatus[theNeighbors[k]].theCAState == mystate);
+      allStatus[i].hasSameStateNeighbors = same;
+    }
+
+    std::vector<NewCell> allCells;
+    std::vector<Status> allStatus;
+    std::vector<Edge> theEdges;
+    std::vector<unsigned int> theOffsets;
+    std::vector<unsigned int> theNeighbors;
+  };
+
+  typedef std::chrono::steady_clock Clock;
+
+  double since(Clock::time_point& start) {
+    auto now = Clock::now();
+    double ms = std::chrono::duration<double, std::milli>(now - start).count();
+    start = now;
+    return ms;
+  }
+
+  // times connect, evolve and findNtuplets, in ms, summed over the events
+  template <typename Layout>
+  void run(Layout& layout, const std::vector<Event>& events, double (&times)[3], std::vector<Ntuplet>& found) {
+    for (auto const& event : events) {
+      auto start = Clock::now();
+      layout.connect(event);
+      times[0] += since(start);
+      std::vector<unsigned int> rootCells;
+      layout.evolve(event, rootCells);
+      times[1] += since(start);
+      Ntuplet tmp;
+      for (auto root : rootCells) {
+        tmp.assign(1, root);
+        layout.findNtuplets(root, found, tmp);
+      }
+      times[2] += since(start);
+    }
+  }
+
+}
+
+int main(int argc, char** argv) {
+  const unsigned int cells = argc > 1 ? std::atoi(argv[1]) : 20000;
+  const unsigned int nevents = argc > 2 ? std::atoi(argv[2]) : 10;
+
+  std::mt19937 rng(1234);
+  std::vector<Event> events;
+  for (unsigned int i = 0; i < nevents; ++i)
+    events.emplace_back(cells, 3, rng);
+
+  OldLayout oldLayout;
+  NewLayout newLayout;
+  double oldTimes[3] = {0., 0., 0.};
+  double newTimes[3] = {0., 0., 0.};
+  std::vector<Ntuplet> oldFound, newFound;
+  // once to warm up, then timed
+  run(oldLayout, events, oldTimes, oldFound);
+  run(newLayout, events, newTimes, newFound);
+  if (oldFound != newFound) {
+    std::cerr << "the two layouts give different quadruplets" << std::endl;
+    return EXIT_FAILURE;
+  }
+  oldFound.clear();
+  newFound.clear();
+  for (auto& t : oldTimes) t = 0.;
+  for (auto& t : newTimes) t = 0.;
+  run(oldLayout, events, oldTimes, oldFound);
+  run(newLayout, events, newTimes, newFound);
+
+  const char* steps[3] = {"connect", "evolve", "findNtuplets"};
+  std::cout << cells << " cells per layer pair, " << nevents << " events, " << newFound.size() / nevents
+            << " quadruplets per event" << std::endl;
+  std::cout << "ms per event      per-cell vectors   flat arrays" << std::endl;
+  for (unsigned int s = 0; s < 3; ++s) {
+    std::cout << steps[s] << "\t\t" << oldTimes[s] / nevents << "\t\t" << newTimes[s] / nevents << std::endl;
+  }
+  return EXIT_SUCCESS;
+}
@@ -7,6 +7,7 @@
 #include "FWCore/Framework/interface/ConsumesCollector.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 
 #include "TrackingTools/PatternTools/interface/TrajectoryBuilder.h"
 #include "RecoTracker/CkfPattern/interface/BaseCkfTrajectoryBuilder.h"
@@ -39,6 +40,9 @@ namespace cms
 
     virtual ~CkfTrackCandidateMakerBase() noexcept(false);
 
+    // the parameters read by the base class without an existence check
+    static void fillPSetDescription(edm::ParameterSetDescription& desc);
+
     virtual void beginRunBase (edm::Run const & , edm::EventSetup const & es);
 
     virtual void produceBase(edm::Event& e, const edm::EventSetup& es);
@@ -50,6 +54,8 @@ namespace cms
     bool doSeedingRegionRebuilding;
     bool cleanTrajectoryAfterInOut;
     bool reverseTrajectories;
+    // build the trajectories of different seeds concurrently within the event
+    bool parallelSeedBuilding_;
     bool produceSeedStopReasons_;
 
     unsigned int theMaxNSeeds;
@@ -7,6 +7,8 @@
 #include "FWCore/Framework/interface/EventSetup.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 
 #include "TrackingTools/TrajectoryCleaning/interface/TrajectoryCleaner.h"
 
@@ -35,6 +37,14 @@ namespace cms
 
     ~CkfTrackCandidateMaker() override{;}
 
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+      edm::ParameterSetDescription desc;
+      CkfTrackCandidateMakerBase::fillPSetDescription(desc);
+      // the other parameters are not described yet
+      desc.setAllowAnything();
+      descriptions.addDefault(desc);
+    }
+
     void beginRun (edm::Run const& r, edm::EventSetup const & es) override {beginRunBase(r,es);}
 
     void produce(edm::Event& e, const edm::EventSetup& es) override {produceBase(e,es);}
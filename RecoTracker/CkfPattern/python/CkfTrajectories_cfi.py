@@ -15,6 +15,8 @@ ckfTrajectories = cms.EDProducer("CkfTrajectoryMaker",
     doSeedingRegionRebuilding = cms.bool(False),
     ## reverse trajectories after pattern-reco creating new seed on last hit
     reverseTrajectories       = cms.bool(False),
+    ## build the trajectories of different seeds concurrently, same result
+    parallelSeedBuilding = cms.bool(False),
     trackCandidateAlso = cms.bool(False),
     #bool   seedCleaning         = false
     src = cms.InputTag('globalMixedSeeds'),
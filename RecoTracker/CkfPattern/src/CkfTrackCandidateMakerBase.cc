@@ -41,9 +41,7 @@
 // #define VI_TBB
 
 #include <thread>
-#ifdef VI_TBB
 #include "tbb/parallel_for.h"
-#endif
 
 #include "RecoTracker/CkfPattern/interface/PrintoutHelper.h"
 
@@ -51,6 +49,10 @@ using namespace edm;
 using namespace std;
 
 namespace {
+  // number of seeds built concurrently before their trajectories are merged
+  // and the seed cleaner is updated, in the parallel mode
+  constexpr size_t parallelSeedBlockSize = 256;
+
   BaseCkfTrajectoryBuilder *createBaseCkfTrajectoryBuilder(const edm::ParameterSet& pset, edm::ConsumesCollector& iC) {
     return BaseCkfTrajectoryBuilderFactory::get()->create(pset.getParameter<std::string>("ComponentType"), pset, iC);
   }
@@ -64,6 +66,7 @@ namespace cms{
     doSeedingRegionRebuilding(conf.getParameter<bool>("doSeedingRegionRebuilding")),
     cleanTrajectoryAfterInOut(conf.getParameter<bool>("cleanTrajectoryAfterInOut")),
     reverseTrajectories(conf.existsAs<bool>("reverseTrajectories") && conf.getParameter<bool>("reverseTrajectories")),
+    parallelSeedBuilding_(conf.getParameter<bool>("parallelSeedBuilding")),
     theMaxNSeeds(conf.getParameter<unsigned int>("maxNSeeds")),
     theTrajectoryBuilder(createBaseCkfTrajectoryBuilder(conf.getParameter<edm::ParameterSet>("TrajectoryBuilderPSet"), iC)),
     theTrajectoryCleanerName(conf.getParameter<std::string>("TrajectoryCleaner")),
@@ -118,6 +121,10 @@ namespace cms{
   }
 
 
+  void CkfTrackCandidateMakerBase::fillPSetDescription(edm::ParameterSetDescription& desc) {
+    desc.add<bool>("parallelSeedBuilding", false);
+  }
+
   // Virtual destructor needed.
   CkfTrackCandidateMakerBase::~CkfTrackCandidateMakerBase() noexcept(false) {
     if (theSeedCleaner) delete theSeedCleaner;
@@ -267,37 +274,21 @@ namespace cms{
 #endif
 
       std::atomic<unsigned int> ntseed(0);
-      auto theLoop = [&](size_t ii) {
-        auto j = indeces[ii];
-
-        ntseed++;
-
-        // to be moved inside a par section (how with tbb??)
-        std::vector<Trajectory> theTmpTrajectories;
-
-
-	LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
-
-        { Lock lock(theMutex);
-	// Check if seed hits already used by another track
-	if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
-          LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
-          (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
-          return;  // from the lambda!
-        }}
-
 
+      // Build the trajectories of seed j into theTmpTrajectories;
+      // returns false (and sets the stop reason) if none of them survives.
+      // Only const methods of the builder and of the cleaner are used, and all
+      // the working containers are local, so that it can run concurrently for
+      // different seeds.
+      auto theBuild = [&](size_t j, std::vector<Trajectory> & theTmpTrajectories) -> bool {
 	// Build trajectory from seed outwards
         theTmpTrajectories.clear();
         unsigned int nCandPerSeed = 0;
         auto const & startTraj = theTrajectoryBuilder->buildTrajectories( (*collseed)[j], theTmpTrajectories, nCandPerSeed, nullptr );
-        {
-          Lock lock(theMutex);
-          (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed);
-          if(theTmpTrajectories.empty()) {
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::NO_TRAJECTORY);
-            return; // from the lambda!
-          }
+        (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed);
+        if(theTmpTrajectories.empty()) {
+          (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::NO_TRAJECTORY);
+          return false;
         }
 
 	LogDebug("CkfPattern") << "======== In-out trajectory building found " << theTmpTrajectories.size()
@@ -325,9 +316,8 @@ namespace cms{
   			              << " valid/invalid trajectories from seed " << j << " ========\n"
 				 <<PrintoutHelper::dumpCandidates(theTmpTrajectories);
           if(theTmpTrajectories.empty()) {
-            Lock lock(theMutex);
             (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_REGION_REBUILD);
-            return;
+            return false;
           }
         }
 
@@ -338,8 +328,12 @@ namespace cms{
         LogDebug("CkfPattern") << "======== Trajectory cleaning gave the following " << theTmpTrajectories.size() << " valid trajectories from seed "
                                << j << " ========\n"
 			       <<PrintoutHelper::dumpCandidates(theTmpTrajectories);
+        return true;
+      };
 
-        { Lock lock(theMutex);
+      // Move the valid trajectories of seed j into rawResult;
+      // must be called under the mutex and, to be reproducible, in seed order.
+      auto theStore = [&](size_t j, std::vector<Trajectory> & theTmpTrajectories) {
 	for(vector<Trajectory>::iterator it=theTmpTrajectories.begin();
 	    it!=theTmpTrajectories.end(); it++){
 	  if( it->isValid() ) {
@@ -352,13 +346,12 @@ namespace cms{
             if (theSeedCleaner && rawResult.back().foundHits()>3) theSeedCleaner->add( &rawResult.back() );
             //if (theSeedCleaner ) theSeedCleaner->add( & (*it) );
 	  }
-	}}
+	}
 
         theTmpTrajectories.clear();
 
 	LogDebug("CkfPattern") << "rawResult trajectories found so far = " << rawResult.size();
 
-        { Lock lock(theMutex);
 	if ( maxSeedsBeforeCleaning_ >0 && rawResult.size() > maxSeedsBeforeCleaning_+lastCleanResult) {
           theTrajectoryCleaner->clean(rawResult);
           rawResult.erase(std::remove_if(rawResult.begin()+lastCleanResult,rawResult.end(),
@@ -366,12 +359,75 @@ namespace cms{
 			  rawResult.end());
           lastCleanResult=rawResult.size();
         }
+      };
+
+      auto theLoop = [&](size_t ii) {
+        auto j = indeces[ii];
+
+        ntseed++;
+
+        // to be moved inside a par section (how with tbb??)
+        std::vector<Trajectory> theTmpTrajectories;
+
+
+	LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
+
+        { Lock lock(theMutex);
+	// Check if seed hits already used by another track
+	if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
+          LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
+          (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
+          return;  // from the lambda!
+        }}
+
+        if (!theBuild(j, theTmpTrajectories)) return; // from the lambda!
+
+        { Lock lock(theMutex);
+          theStore(j, theTmpTrajectories);
         }
 
       };
       // end of loop over seeds
 
-
+      if (parallelSeedBuilding_) {
+        // The seeds are processed in blocks: the trajectories of all the seeds
+        // of a block are built concurrently, then they are stored one seed at
+        // a time, in the same order as in the serial loop. The seed cleaner is
+        // only asked about a seed at its turn in the merge, with the same
+        // content it would have in the serial loop, so that the result does
+        // not depend on the number of threads. Since the cleaner only grows,
+        // the seeds it already rejects before a block is built are not built.
+        std::vector<std::vector<Trajectory>> blockTrajectories(std::min(collseed_size, parallelSeedBlockSize));
+        std::vector<char> blockBuilt(blockTrajectories.size());
+        for (size_t first = 0; first < collseed_size; first += parallelSeedBlockSize) {
+          size_t last = std::min(collseed_size, first + parallelSeedBlockSize);
+          for (auto ii = first; ii < last; ++ii)
+            blockBuilt[ii-first] = (!theSeedCleaner || theSeedCleaner->good( &((*collseed)[indeces[ii]]) ));
+
+          tbb::parallel_for(first, last, [&](size_t ii) {
+            auto j = indeces[ii];
+            ntseed++;
+            if (!blockBuilt[ii-first]) return;
+            LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
+            blockBuilt[ii-first] = theBuild(j, blockTrajectories[ii-first]);
+          });
+
+          for (auto ii = first; ii < last; ++ii) {
+            auto j = indeces[ii];
+            auto & theTmpTrajectories = blockTrajectories[ii-first];
+            // Check if seed hits already used by another track
+            if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
+              LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
+              // as if the seed had never been built
+              (*outputSeedStopInfos)[j] = SeedStopInfo();
+              (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
+              theTmpTrajectories.clear();
+              continue;
+            }
+            if (blockBuilt[ii-first]) theStore(j, theTmpTrajectories);
+          }
+        }
+      } else {
 #ifdef VI_TBB
      tbb::parallel_for(0UL,collseed_size,1UL,theLoop);
 #else
@@ -382,6 +438,7 @@ namespace cms{
        theLoop(j);
       }
 #endif
+      }
       assert(ntseed==collseed_size);
       if (theSeedCleaner) theSeedCleaner->done();
 
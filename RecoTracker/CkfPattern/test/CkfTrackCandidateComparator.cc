@@ -0,0 +1,114 @@
+// Compares the products of two CkfTrackCandidateMaker instances, e.g. the
+// serial and the parallel building of the seeds, which must be identical:
+// same candidates in the same order, with the same seed, hits, stop reason
+// and state, and the same SeedStopInfo for each seed.  Throws at the first
+// difference.
+
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/TrackCandidate/interface/TrackCandidateCollection.h"
+#include "DataFormats/TrackReco/interface/SeedStopInfo.h"
+
+#include <vector>
+
+class CkfTrackCandidateComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit CkfTrackCandidateComparator(const edm::ParameterSet& conf);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  void analyze(edm::StreamID, const edm::Event& e, const edm::EventSetup& es) const override;
+
+private:
+  static bool sameCandidate(const TrackCandidate& a, const TrackCandidate& b);
+
+  edm::EDGetTokenT<TrackCandidateCollection> referenceCandidates_;
+  edm::EDGetTokenT<TrackCandidateCollection> candidates_;
+  edm::EDGetTokenT<std::vector<SeedStopInfo> > referenceStopInfo_;
+  edm::EDGetTokenT<std::vector<SeedStopInfo> > stopInfo_;
+};
+
+CkfTrackCandidateComparator::CkfTrackCandidateComparator(const edm::ParameterSet& conf) :
+  referenceCandidates_(consumes<TrackCandidateCollection>(conf.getParameter<edm::InputTag>("reference"))),
+  candidates_(consumes<TrackCandidateCollection>(conf.getParameter<edm::InputTag>("candidates"))),
+  referenceStopInfo_(consumes<std::vector<SeedStopInfo> >(conf.getParameter<edm::InputTag>("reference"))),
+  stopInfo_(consumes<std::vector<SeedStopInfo> >(conf.getParameter<edm::InputTag>("candidates")))
+{}
+
+void CkfTrackCandidateComparator::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("reference", edm::InputTag("initialStepTrackCandidates"));
+  desc.add<edm::InputTag>("candidates", edm::InputTag("initialStepTrackCandidatesParallel"));
+  descriptions.add("ckfTrackCandidateComparator", desc);
+}
+
+bool CkfTrackCandidateComparator::sameCandidate(const TrackCandidate& a, const TrackCandidate& b) {
+  if (a.seedRef() != b.seedRef() ||
+      a.recHits().second - a.recHits().first != b.recHits().second - b.recHits().first ||
+      a.stopReason() != b.stopReason() || a.nLoops() != b.nLoops())
+    return false;
+  auto ha = a.recHits().first;
+  for (auto hb = b.recHits().first; hb != b.recHits().second; ++ha, ++hb) {
+    if (ha->geographicalId() != hb->geographicalId() || ha->getType() != hb->getType() ||
+        !ha->sharesInput(&*hb, TrackingRecHit::all))
+      return false;
+  }
+  auto const& sa = a.trajectoryStateOnDet();
+  auto const& sb = b.trajectoryStateOnDet();
+  if (sa.detId() != sb.detId() || sa.surfaceSide() != sb.surfaceSide())
+    return false;
+  auto va = sa.parameters().vector();
+  auto vb = sb.parameters().vector();
+  for (unsigned int i = 0; i < 5; ++i) {
+    if (va[i] != vb[i])
+      return false;
+  }
+  return true;
+}
+
+void CkfTrackCandidateComparator::analyze(edm::StreamID, const edm::Event& e, const edm::EventSetup&) const {
+  edm::Handle<TrackCandidateCollection> referenceHandle;
+  e.getByToken(referenceCandidates_, referenceHandle);
+  edm::Handle<TrackCandidateCollection> candidatesHandle;
+  e.getByToken(candidates_, candidatesHandle);
+  auto const& reference = *referenceHandle;
+  auto const& candidates = *candidatesHandle;
+  if (reference.size() != candidates.size()) {
+    throw cms::Exception("CkfTrackCandidateComparator") << "event " << e.id() << ": "
+      << candidates.size() << " track candidates instead of " << reference.size();
+  }
+  for (unsigned int i = 0; i < reference.size(); ++i) {
+    if (!sameCandidate(reference[i], candidates[i])) {
+      throw cms::Exception("CkfTrackCandidateComparator") << "event " << e.id()
+        << ": the track candidate " << i << " differs";
+    }
+  }
+
+  edm::Handle<std::vector<SeedStopInfo> > referenceStopsHandle;
+  e.getByToken(referenceStopInfo_, referenceStopsHandle);
+  edm::Handle<std::vector<SeedStopInfo> > stopsHandle;
+  e.getByToken(stopInfo_, stopsHandle);
+  auto const& referenceStops = *referenceStopsHandle;
+  auto const& stops = *stopsHandle;
+  if (referenceStops.size() != stops.size()) {
+    throw cms::Exception("CkfTrackCandidateComparator") << "event " << e.id() << ": "
+      << stops.size() << " SeedStopInfo instead of " << referenceStops.size();
+  }
+  for (unsigned int i = 0; i < referenceStops.size(); ++i) {
+    if (referenceStops[i].candidatesPerSeed() != stops[i].candidatesPerSeed() ||
+        referenceStops[i].stopReason() != stops[i].stopReason()) {
+      throw cms::Exception("CkfTrackCandidateComparator") << "event " << e.id()
+        << ": the SeedStopInfo of the seed " << i << " differs";
+    }
+  }
+}
+
+DEFINE_FWK_MODULE(CkfTrackCandidateComparator);
@@ -0,0 +1,55 @@
+import FWCore.ParameterSet.Config as cms
+import FWCore.ParameterSet.VarParsing as VarParsing
+from Configuration.StandardSequences.Eras import eras
+
+# Runs the tracking on 2017 MC RAW events with several threads, builds the
+# initial step track candidates a second time with parallelSeedBuilding, and
+# checks that both give the same products.  cmsRun fails at the first difference.
+#
+# cmsRun parallelSeedBuilding_cfg.py inputFiles=file:step1.root [threads=8]
+
+options = VarParsing.VarParsing('analysis')
+options.register('threads', 8, VarParsing.VarParsing.multiplicity.singleton,
+                 VarParsing.VarParsing.varType.int, "number of threads")
+options.parseArguments()
+
+process = cms.Process('CKFTEST', eras.Run2_2017)
+
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.EventContent.EventContent_cff')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.RawToDigi_cff')
+process.load('Configuration.StandardSequences.Reconstruction_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2017_realistic', '')
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(0)
+)
+process.MessageLogger.cerr.FwkReport.reportEvery = 10
+
+process.initialStepTrackCandidatesParallel = process.initialStepTrackCandidates.clone(
+    parallelSeedBuilding = True
+)
+process.load('RecoTracker.CkfPattern.ckfTrackCandidateComparator_cfi')
+
+process.tracking = cms.Path(
+    process.RawToDigi *
+    process.reconstruction_trackingOnly
+)
+process.compare = cms.Path(
+    process.initialStepTrackCandidatesParallel *
+    process.ckfTrackCandidateComparator
+)
+process.schedule = cms.Schedule(process.tracking, process.compare)
@@ -3,15 +3,20 @@
 
 #include "DataFormats/TrackerRecHit2D/interface/BaseTrackerRecHit.h"
 #include "TrackingTools/DetLayers/interface/DetLayer.h"
+#include "DataFormats/GeometryVector/interface/Pi.h"
 
 #include <vector>
 #include<array>
+#include<algorithm>
+#include<functional>
 
 #include<cassert>
 
 /** A RecHit container sorted in phi.
  *  Provides fast access for hits in a given phi window
- *  using binary search.
+ *  using a coarse phi binning: the bin of the phi boundary is found
+ *  by a multiplication, and the position inside the bin by counting
+ *  (branch-free) the hits of the bin with smaller phi.
  */
 
 class RecHitsSortedInPhi {
@@ -85,8 +90,12 @@ public:
     return Range(theHits.begin(), theHits.end());
   }
 
+  // indices of the first hit with phi >= phiMin, and of the first hit with phi > phiMax
+  int lowerIndex(float phiMin) const { return countInBin(phiMin, std::less<float>()); }
+  int upperIndex(float phiMax) const { return countInBin(phiMax, std::less_equal<float>()); }
+
 public:
-  float       phi(int i) const { return theHits[i].phi();}
+  float       phi(int i) const { return gphi[i];}
   float       gv(int i) const { return isBarrel ? z[i] : gp(i).perp();}  // global v
   float       rv(int i) const { return isBarrel ? u[i] : v[i];}  // dispaced r
   GlobalPoint gp(int i) const { return GlobalPoint(x[i],y[i],z[i]);}
@@ -112,6 +121,28 @@ public:
   std::vector<float> dv;
   std::vector<float> lphi;
 
+  // global phi of the hits, sorted (same order as theHits)
+  std::vector<float> gphi;
+
+  // phi binning: hits with phiBin(phi)==k are in [phiBinStart[k],phiBinStart[k+1])
+  float phiBinScale;
+  std::vector<int> phiBinStart;
+
+  int phiBin(float phi) const {
+    int bin = (phi+Geom::fpi())*phiBinScale;
+    return std::min(std::max(bin,0),int(phiBinStart.size())-2);
+  }
+
+  template<typename Less>
+  int countInBin(float phi, Less less) const {
+    int bin = phiBin(phi);
+    int b = phiBinStart[bin]; int e = phiBinStart[bin+1];
+    // phi is sorted: the number of hits of the bin before phi is the offset in the bin
+    int n = 0;
+    for (int i=b; i<e; ++i) n += less(gphi[i],phi);
+    return b+n;
+  }
+
   static void copyResult( const Range& range, std::vector<Hit>& result) {
     result.reserve(result.size()+(range.second-range.first));
     for (HitIter i = range.first; i != range.second; i++) result.push_back( i->hit());
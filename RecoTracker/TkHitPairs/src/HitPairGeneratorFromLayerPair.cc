@@ -162,15 +162,17 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 	  std::get<2>(kernels)(b,e,innerHitsMap, ok);
 	  break;
       }
+      // count the compatible hits first, so that the check loop has no branches
+      int nok=0;
+      for (int i=0; i!=e-b; ++i) nok += ok[i];
+      if (theMaxElement!=0 && result.size()+nok > theMaxElement){
+        result.clear();
+        edm::LogError("TooManyPairs")<<"number of pairs exceed maximum, no pairs produced";
+        delete checkRZ;
+        return;
+      }
       for (int i=0; i!=e-b; ++i) {
-	if (!ok[i]) continue;
-	if (theMaxElement!=0 && result.size() >= theMaxElement){
-	  result.clear();
-	  edm::LogError("TooManyPairs")<<"number of pairs exceed maximum, no pairs produced";
-	  delete checkRZ;
-	  return;
-	}
-        result.add(b+i,io);
+	if (ok[i]) result.add(b+i,io);
       }
     }
     delete checkRZ;
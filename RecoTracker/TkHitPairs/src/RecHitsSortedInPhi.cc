@@ -11,7 +11,8 @@ RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint
   isBarrel(il->isBarrel()),
   x(hits.size()),y(hits.size()),z(hits.size()),drphi(hits.size()),
   u(hits.size()),v(hits.size()),du(hits.size()),dv(hits.size()),
-  lphi(hits.size())
+  lphi(hits.size()),
+  gphi(hits.size())
 {
 
   // standard region have origin as 0,0,z (not true!!!!0
@@ -43,34 +44,46 @@ RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint
     du[i] = isBarrel ? dr : dz;
     dv[i] = isBarrel ? dz : dr;
     lphi[i] = loc.barePhi();
+    gphi[i] = theHits[i].phi();
   }
-  
+
+  // about four hits per phi bin
+  constexpr int maxBins = 256;
+  int nBins = std::max(1,std::min(int(theHits.size()/4),maxBins));
+  phiBinScale = float(nBins)/Geom::ftwoPi();
+  phiBinStart.assign(nBins+1,0);
+  for (auto p : gphi) ++phiBinStart[phiBin(p)+1];
+  for (int k=0; k!=nBins; ++k) phiBinStart[k+1] += phiBinStart[k];
+
 }
 
 
 RecHitsSortedInPhi::DoubleRange RecHitsSortedInPhi::doubleRange(float phiMin, float phiMax) const {
-  Range r1,r2;
+  auto range = [&](float pmin, float pmax) {
+    int low = lowerIndex(pmin);
+    return std::make_pair(low, std::max(low,upperIndex(pmax)));
+  };
+  std::pair<int,int> r1,r2;
   if ( phiMin < phiMax) {
     if ( phiMin < -Geom::fpi()) {
-      r1 = unsafeRange( phiMin + Geom::ftwoPi(), Geom::fpi());
-      r2 = unsafeRange( -Geom::fpi(), phiMax);
+      r1 = range( phiMin + Geom::ftwoPi(), Geom::fpi());
+      r2 = range( -Geom::fpi(), phiMax);
     }
     else if (phiMax > Geom::pi()) {
-     r1 = unsafeRange( phiMin, Geom::fpi());
-     r2 = unsafeRange( -Geom::fpi(), phiMax-Geom::ftwoPi());
+     r1 = range( phiMin, Geom::fpi());
+     r2 = range( -Geom::fpi(), phiMax-Geom::ftwoPi());
     }
     else {
-      r1 = unsafeRange( phiMin, phiMax);
-      r2 = Range(theHits.begin(),theHits.begin());
+      r1 = range( phiMin, phiMax);
+      r2 = std::make_pair(0,0);
     }
   }
   else {
-    r1 =unsafeRange( phiMin, Geom::fpi());
-    r2 =unsafeRange( -Geom::fpi(), phiMax);
+    r1 = range( phiMin, Geom::fpi());
+    r2 = range( -Geom::fpi(), phiMax);
   }
 
-  return (DoubleRange){{int(r1.first-theHits.begin()),int(r1.second-theHits.begin())
-	,int(r2.first-theHits.begin()),int(r2.second-theHits.begin())}};
+  return (DoubleRange){{r1.first,r1.second,r2.first,r2.second}};
 }
 
 
@@ -105,7 +118,8 @@ std::vector<RecHitsSortedInPhi::Hit> RecHitsSortedInPhi::hits( float phiMin, flo
 RecHitsSortedInPhi::Range 
 RecHitsSortedInPhi::unsafeRange( float phiMin, float phiMax) const
 {
-  auto low = std::lower_bound( theHits.begin(), theHits.end(), HitWithPhi(phiMin), HitLessPhi());
-  return Range( low,
-	       std::upper_bound(low, theHits.end(), HitWithPhi(phiMax), HitLessPhi()));
+  if (theHits.empty()) return Range(theHits.begin(),theHits.end());
+  auto low = lowerIndex(phiMin);
+  auto high = std::max(low,upperIndex(phiMax));
+  return Range(theHits.begin()+low, theHits.begin()+high);
 }
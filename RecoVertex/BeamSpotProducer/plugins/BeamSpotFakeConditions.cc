@@ -43,6 +43,8 @@ BeamSpotFakeConditions::BeamSpotFakeConditions(const edm::ParameterSet &params)
 {	
 		setWhatProduced(this);
 		findingRecord<BeamSpotObjectsRcd>();
+		// the beam spot comes from the configuration or a text file only
+		mayUseOwnMutex();
 		getDataFromFile_ = params.getParameter<bool>("getDataFromFile");
 		if (getDataFromFile_) {
 		  inputFilename_   = params.getParameter<edm::FileInPath>("InputFilename");
@@ -9,16 +9,12 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "Geometry/HcalCommonData/interface/HcalDDDSimConstants.h"
 #include "SimG4CMS/Calo/interface/HFFibre.h"
+#include "SimG4CMS/Calo/interface/HFShowerLibraryData.h"
 #include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
 #include "DetectorDescription/Core/interface/DDsvalues.h"
 
 #include "G4ThreeVector.hh"
  
-//ROOT
-#include "TROOT.h"
-#include "TFile.h"
-#include "TTree.h"
-
 #include <string>
 #include <memory>
 
@@ -53,23 +49,21 @@ public:
 protected:
 
   bool                rInside(double r);
-  void                getRecord(int, int);
-  void                loadEventInfo(TBranch *);
+  HFShowerLibraryData::Record getRecord(int, int) const;
   void                interpolate(int, double);
   void                extrapolate(int, double);
-  void                storePhoton(int j);
+  void                storePhoton(const HFShowerLibraryData::Photon &);
   std::vector<double> getDDDArray(const std::string&, const DDsvalues_type&,
                                   int&);
 
 private:
 
   HFFibre *           fibre;
-  TFile *             hf;
-  TBranch             *emBranch, *hadBranch;
+  // photon records, read once and shared by all the threads
+  std::shared_ptr<const HFShowerLibraryData> library;
 
-  bool                verbose, applyFidCut, newForm, v3version;
+  bool                verbose, applyFidCut;
   int                 nMomBin, totEvents, evtPerBin;
-  float               libVers, listVersion; 
   std::vector<double> pmom;
 
   double              probMax, backProb;
@@ -78,8 +72,6 @@ private:
 
   int                 npe;
   HFShowerPhotonCollection pe;
-  HFShowerPhotonCollection* photo;
-  HFShowerPhotonCollection photon;
 
 };
 #endif
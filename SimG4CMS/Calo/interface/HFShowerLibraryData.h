@@ -0,0 +1,81 @@
+#ifndef SimG4CMS_HFShowerLibraryData_h
+#define SimG4CMS_HFShowerLibraryData_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: HFShowerLibraryData.h
+// Description: Content of a HF shower library, read once from the ROOT file
+//              and shared (read-only) by all the HFShowerLibrary instances
+//              of the process, i.e. by all the Geant4 worker threads
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class TBranch;
+
+class HFShowerLibraryData {
+
+public:
+
+  // photon as stored in the library (the same content as HFShowerPhoton,
+  // without its virtual table)
+  struct Photon {
+    float x, y, z, lambda, t;
+  };
+
+  // photons of one record, contiguous in memory
+  class Record {
+  public:
+    Record(const Photon* begin, const Photon* end) : begin_(begin), end_(end) {}
+    const Photon*  begin()                  const { return begin_; }
+    const Photon*  end()                    const { return end_; }
+    unsigned int   size()                   const { return end_ - begin_; }
+    const Photon & operator[](unsigned int j) const { return begin_[j]; }
+  private:
+    const Photon * begin_;
+    const Photon * end_;
+  };
+
+  // Returns the library described by the "HFShowerLibrary" parameters; the
+  // file is read only by the first call, the following calls (from any
+  // thread) share the same object as long as it is in use
+  static std::shared_ptr<const HFShowerLibraryData> get(edm::ParameterSet const & p);
+
+  explicit HFShowerLibraryData(edm::ParameterSet const & p);
+
+  HFShowerLibraryData(const HFShowerLibraryData&) = delete;
+  HFShowerLibraryData& operator=(const HFShowerLibraryData&) = delete;
+
+  // record (1 ... totEvents()) of type 0 (EM) or 1 (hadron), in O(1)
+  Record record(int type, int irc) const {
+    const std::vector<unsigned int> & off = offsets[type > 0 ? 1 : 0];
+    const Photon* base = photons[type > 0 ? 1 : 0].data();
+    return Record(base + off[irc-1], base + off[irc]);
+  }
+
+  int                         momBins()        const { return nMomBin; }
+  int                         totalEvents()    const { return totEvents; }
+  int                         eventsPerBin()   const { return evtPerBin; }
+  float                       libraryVersion() const { return libVers; }
+  float                       physListVersion() const { return listVersion; }
+  // energy bins, in Geant4 units
+  const std::vector<double> & energyBins()     const { return pmom; }
+
+private:
+
+  void                loadEventInfo(TBranch *);
+  void                loadRecords(int type, TBranch *, int first, bool newForm,
+                                  bool v3version);
+
+  int                 nMomBin, totEvents, evtPerBin;
+  float               libVers, listVersion;
+  std::vector<double> pmom;
+
+  // photons of all the records of a type (0: EM, 1: hadron) one after the
+  // other; the photons of record r are [offsets[r-1], offsets[r])
+  std::vector<Photon>       photons[2];
+  std::vector<unsigned int> offsets[2];
+};
+#endif
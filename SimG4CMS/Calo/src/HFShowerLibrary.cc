@@ -4,7 +4,6 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SimG4CMS/Calo/interface/HFShowerLibrary.h"
-#include "SimDataFormats/CaloHit/interface/HFShowerLibraryEventInfo.h"
 #include "DetectorDescription/Core/interface/DDFilter.h"
 #include "DetectorDescription/Core/interface/DDFilteredView.h"
 #include "DetectorDescription/Core/interface/DDValue.h"
@@ -24,9 +23,7 @@
 //#define DebugLog
 
 HFShowerLibrary::HFShowerLibrary(const std::string & name, const DDCompactView & cpv,
-                                 edm::ParameterSet const & p) : fibre(nullptr),hf(nullptr),
-                                                                emBranch(nullptr),
-                                                                hadBranch(nullptr),
+                                 edm::ParameterSet const & p) : fibre(nullptr),
                                                                 npe(0) {
   
 
@@ -34,97 +31,26 @@ HFShowerLibrary::HFShowerLibrary(const std::string & name, const DDCompactView &
   probMax                 = m_HF.getParameter<double>("ProbMax");
 
   edm::ParameterSet m_HS= p.getParameter<edm::ParameterSet>("HFShowerLibrary");
-  edm::FileInPath fp       = m_HS.getParameter<edm::FileInPath>("FileName");
-  std::string pTreeName    = fp.fullPath();
   backProb                 = m_HS.getParameter<double>("BackProbability");  
-  std::string emName       = m_HS.getParameter<std::string>("TreeEMID");
-  std::string hadName      = m_HS.getParameter<std::string>("TreeHadID");
-  std::string branchEvInfo = m_HS.getUntrackedParameter<std::string>("BranchEvt","HFShowerLibraryEventInfos_hfshowerlib_HFShowerLibraryEventInfo");
-  std::string branchPre    = m_HS.getUntrackedParameter<std::string>("BranchPre","HFShowerPhotons_hfshowerlib_");
-  std::string branchPost   = m_HS.getUntrackedParameter<std::string>("BranchPost","_R.obj");
   verbose                  = m_HS.getUntrackedParameter<bool>("Verbosity",false);
   applyFidCut              = m_HS.getParameter<bool>("ApplyFiducialCut");
 
-  if (pTreeName.find(".") == 0) pTreeName.erase(0,2);
-  const char* nTree = pTreeName.c_str();
-  hf                = TFile::Open(nTree);
+  // the records are read from the file only once, by the first thread
+  library   = HFShowerLibraryData::get(p);
+  nMomBin   = library->momBins();
+  totEvents = library->totalEvents();
+  evtPerBin = library->eventsPerBin();
+  pmom      = library->energyBins();
 
-  if (!hf->IsOpen()) { 
-    edm::LogError("HFShower") << "HFShowerLibrary: opening " << nTree 
-                              << " failed";
-    throw cms::Exception("Unknown", "HFShowerLibrary") 
-      << "Opening of " << pTreeName << " fails\n";
-  } else {
-    edm::LogInfo("HFShower") << "HFShowerLibrary: opening " << nTree 
-                             << " successfully"; 
-  }
-
-  newForm = (branchEvInfo.empty());
-  TTree* event(nullptr);
-  if (newForm) event = (TTree *) hf ->Get("HFSimHits");
-  else         event = (TTree *) hf ->Get("Events");
-  if (event) {
-    TBranch *evtInfo(nullptr);
-    if (!newForm) {
-      std::string info = branchEvInfo + branchPost;
-      evtInfo          = event->GetBranch(info.c_str());
-    }
-    if (evtInfo || newForm) {
-      loadEventInfo(evtInfo);
-    } else {
-      edm::LogError("HFShower") << "HFShowerLibrary: HFShowerLibrayEventInfo"
-                                << " Branch does not exist in Event";
-      throw cms::Exception("Unknown", "HFShowerLibrary")
-        << "Event information absent\n";
-    }
-  } else {
-    edm::LogError("HFShower") << "HFShowerLibrary: Events Tree does not "
-                              << "exist";
-    throw cms::Exception("Unknown", "HFShowerLibrary")
-      << "Events tree absent\n";
-  }
-  
-  std::stringstream ss;
-  ss << "HFShowerLibrary: Library " << libVers << " ListVersion " << listVersion 
-     << " Events Total " << totEvents << " and " << evtPerBin << " per bin\n";
-  ss << "HFShowerLibrary: Energies (GeV) with " << nMomBin << " bins\n";
-  for (int i=0; i<nMomBin; ++i) {
-    if(i/10*10 == i && i > 0) { ss << "\n"; }
-    ss << "  " << pmom[i]/CLHEP::GeV;
-  }
-  edm::LogInfo("HFShower") << ss.str();
-
-  std::string nameBr = branchPre + emName + branchPost;
-  emBranch         = event->GetBranch(nameBr.c_str());
-  if (verbose) emBranch->Print();
-  nameBr           = branchPre + hadName + branchPost;
-  hadBranch        = event->GetBranch(nameBr.c_str());
-  if (verbose) hadBranch->Print();
-
-  v3version=false;
-  if ( emBranch->GetClassName() == std::string("vector<float>") ) {
-    v3version=true;
-  }
-  
-  edm::LogInfo("HFShower") << " HFShowerLibrary:Branch " << emName 
-                           << " has " << emBranch->GetEntries() 
-                           << " entries and Branch " << hadName 
-                           << " has " << hadBranch->GetEntries() 
-                           << " entries"
-                           << "\n HFShowerLibrary::No packing information -"
-                           << " Assume x, y, z are not in packed form"
-                           << "\n Maximum probability cut off " 
+  edm::LogInfo("HFShower") << "HFShowerLibrary: Maximum probability cut off " 
                            << probMax << "  Back propagation of light prob. "
                            << backProb;
   
   fibre = new HFFibre(name, cpv, p);
-  photo = new HFShowerPhotonCollection;
 }
 
 HFShowerLibrary::~HFShowerLibrary() {
-  if (hf)     hf->Close();
   delete fibre;
-  delete photo;
 }
 
 void HFShowerLibrary::initRun(G4ParticleTable*, const HcalDDDSimConstants* hcons) {
@@ -365,92 +291,20 @@ bool HFShowerLibrary::rInside(double r) {
   return (r >= rMin && r <= rMax);
 }
 
-void HFShowerLibrary::getRecord(int type, int record) {
+HFShowerLibraryData::Record HFShowerLibrary::getRecord(int type, int record) const {
 
-  int nrc     = record-1;
-  photon.clear();
-  photo->clear();
-  if (type > 0) {
-    if (newForm) {
-      if ( !v3version ) {
-        hadBranch->SetAddress(&photo);
-        hadBranch->GetEntry(nrc+totEvents);
-      }
-      else{
-        std::vector<float> t;
-        std::vector<float> *tp=&t;
-        hadBranch->SetAddress(&tp);
-        hadBranch->GetEntry(nrc+totEvents);
-        unsigned int tSize=t.size()/5;
-        photo->reserve(tSize);
-        for ( unsigned int i=0; i<tSize; i++ ) {
-          photo->push_back( HFShowerPhoton( t[i], t[1*tSize+i], t[2*tSize+i], t[3*tSize+i], t[4*tSize+i] ) );
-        }
-      }
-    } else {
-      hadBranch->SetAddress(&photon);
-      hadBranch->GetEntry(nrc);
-    }
-  } else {
-    if (newForm) {
-      if (!v3version) {
-        emBranch->SetAddress(&photo);
-        emBranch->GetEntry(nrc);
-      }
-      else{
-        std::vector<float> t;
-        std::vector<float> *tp=&t;
-        emBranch->SetAddress(&tp);
-        emBranch->GetEntry(nrc);
-        unsigned int tSize=t.size()/5;
-        photo->reserve(tSize);
-        for ( unsigned int i=0; i<tSize; i++ ) {
-          photo->push_back( HFShowerPhoton( t[i], t[1*tSize+i], t[2*tSize+i], t[3*tSize+i], t[4*tSize+i] ) );
-        }
-      }
-    } else {
-      emBranch->SetAddress(&photon);
-      emBranch->GetEntry(nrc);
-    }
-  }
+  HFShowerLibraryData::Record photons = library->record(type, record);
 #ifdef DebugLog
-  int nPhoton = (newForm) ? photo->size() : photon.size();
+  int nPhoton = photons.size();
   LogDebug("HFShower") << "HFShowerLibrary::getRecord: Record " << record
                        << " of type " << type << " with " << nPhoton 
                        << " photons";
   for (int j = 0; j < nPhoton; j++) 
-    if (newForm) LogDebug("HFShower") << "Photon " << j << " " << photo->at(j);
-    else         LogDebug("HFShower") << "Photon " << j << " " << photon[j];
+    LogDebug("HFShower") << "Photon " << j << " " << photons[j].x << ", "
+                         << photons[j].y << ", " << photons[j].z << ", "
+                         << photons[j].lambda << ", " << photons[j].t;
 #endif
-}
-
-void HFShowerLibrary::loadEventInfo(TBranch* branch) {
-
-  if (branch) {
-    std::vector<HFShowerLibraryEventInfo> eventInfoCollection;
-    branch->SetAddress(&eventInfoCollection);
-    branch->GetEntry(0);
-    edm::LogInfo("HFShower") << "HFShowerLibrary::loadEventInfo loads "
-                             << " EventInfo Collection of size "
-                             << eventInfoCollection.size() << " records";
-    totEvents   = eventInfoCollection[0].totalEvents();
-    nMomBin     = eventInfoCollection[0].numberOfBins();
-    evtPerBin   = eventInfoCollection[0].eventsPerBin();
-    libVers     = eventInfoCollection[0].showerLibraryVersion();
-    listVersion = eventInfoCollection[0].physListVersion();
-    pmom        = eventInfoCollection[0].energyBins();
-  } else {
-    edm::LogInfo("HFShower") << "HFShowerLibrary::loadEventInfo loads "
-                             << " EventInfo from hardwired numbers";
-    nMomBin     = 16;
-    evtPerBin   = 5000;
-    totEvents   = nMomBin*evtPerBin;
-    libVers     = 1.1;
-    listVersion = 3.6;
-    pmom        = {2,3,5,7,10,15,20,30,50,75,100,150,250,350,500,1000};
-  }
-  for (int i=0; i<nMomBin; i++) 
-    pmom[i] *= GeV;
+  return photons;
 }
 
 void HFShowerLibrary::interpolate(int type, double pin) {
@@ -512,13 +366,13 @@ void HFShowerLibrary::interpolate(int type, double pin) {
   int npold = 0;
   for (int ir=0; ir < 2; ir++) {
     if (irc[ir]>0) {
-      getRecord (type, irc[ir]);
-      int nPhoton = (newForm) ? photo->size() : photon.size();
+      HFShowerLibraryData::Record photons = getRecord (type, irc[ir]);
+      int nPhoton = photons.size();
       npold      += nPhoton;
       for (int j=0; j<nPhoton; j++) {
         r = G4UniformRand();
         if ((ir==0 && r > w) || (ir > 0 && r < w)) {
-          storePhoton (j);
+          storePhoton (photons[j]);
         }
       }
     }
@@ -578,13 +432,13 @@ void HFShowerLibrary::extrapolate(int type, double pin) {
   int npold = 0;
   for (int ir=0; ir<nrec; ir++) {
     if (irc[ir]>0) {
-      getRecord (type, irc[ir]);
-      int nPhoton = (newForm) ? photo->size() : photon.size();
+      HFShowerLibraryData::Record photons = getRecord (type, irc[ir]);
+      int nPhoton = photons.size();
       npold      += nPhoton;
       for (int j=0; j<nPhoton; j++) {
         double r = G4UniformRand();
         if (ir != nrec-1 || r < w) {
-          storePhoton (j);
+          storePhoton (photons[j]);
         }
       }
 #ifdef DebugLog
@@ -614,12 +468,11 @@ void HFShowerLibrary::extrapolate(int type, double pin) {
 #endif
 }
 
-void HFShowerLibrary::storePhoton(int j) {
+void HFShowerLibrary::storePhoton(const HFShowerLibraryData::Photon & ph) {
 
-  if (newForm) pe.push_back(photo->at(j));
-  else         pe.push_back(photon[j]);
+  pe.emplace_back(ph.x, ph.y, ph.z, ph.lambda, ph.t);
 #ifdef DebugLog
-  LogDebug("HFShower") << "HFShowerLibrary: storePhoton " << j << " npe " 
+  LogDebug("HFShower") << "HFShowerLibrary: storePhoton npe " 
                        << npe << " " << pe[npe];
 #endif
   npe++;
@@ -0,0 +1,217 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: HFShowerLibraryData.cc
+// Description: Content of a HF shower library shared by all threads
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Calo/interface/HFShowerLibraryData.h"
+#include "SimDataFormats/CaloHit/interface/HFShowerLibraryEventInfo.h"
+#include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/thread_safety_macros.h"
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace {
+  std::string libraryFile(edm::ParameterSet const & m_HS) {
+    std::string pTreeName = m_HS.getParameter<edm::FileInPath>("FileName").fullPath();
+    if (pTreeName.find(".") == 0) pTreeName.erase(0,2);
+    return pTreeName;
+  }
+}
+
+std::shared_ptr<const HFShowerLibraryData> HFShowerLibraryData::get(edm::ParameterSet const & p) {
+
+  // the libraries in use, by file and branch names; the lock is kept while a
+  // library is read, so that the other threads wait for it instead of reading
+  // the file again
+  CMS_THREAD_SAFE static std::mutex mutex;
+  CMS_THREAD_SAFE static std::map<std::string, std::weak_ptr<const HFShowerLibraryData> > libraries;
+
+  edm::ParameterSet m_HS = p.getParameter<edm::ParameterSet>("HFShowerLibrary");
+  std::string key = libraryFile(m_HS) + ":"
+    + m_HS.getParameter<std::string>("TreeEMID") + ":"
+    + m_HS.getParameter<std::string>("TreeHadID") + ":"
+    + m_HS.getUntrackedParameter<std::string>("BranchEvt","HFShowerLibraryEventInfos_hfshowerlib_HFShowerLibraryEventInfo") + ":"
+    + m_HS.getUntrackedParameter<std::string>("BranchPre","HFShowerPhotons_hfshowerlib_") + ":"
+    + m_HS.getUntrackedParameter<std::string>("BranchPost","_R.obj");
+
+  std::lock_guard<std::mutex> guard(mutex);
+  std::shared_ptr<const HFShowerLibraryData> library = libraries[key].lock();
+  if (!library) {
+    library = std::make_shared<const HFShowerLibraryData>(p);
+    libraries[key] = library;
+  }
+  return library;
+}
+
+HFShowerLibraryData::HFShowerLibraryData(edm::ParameterSet const & p) {
+
+  edm::ParameterSet m_HS= p.getParameter<edm::ParameterSet>("HFShowerLibrary");
+  std::string pTreeName    = libraryFile(m_HS);
+  std::string emName       = m_HS.getParameter<std::string>("TreeEMID");
+  std::string hadName      = m_HS.getParameter<std::string>("TreeHadID");
+  std::string branchEvInfo = m_HS.getUntrackedParameter<std::string>("BranchEvt","HFShowerLibraryEventInfos_hfshowerlib_HFShowerLibraryEventInfo");
+  std::string branchPre    = m_HS.getUntrackedParameter<std::string>("BranchPre","HFShowerPhotons_hfshowerlib_");
+  std::string branchPost   = m_HS.getUntrackedParameter<std::string>("BranchPost","_R.obj");
+  bool        verbose      = m_HS.getUntrackedParameter<bool>("Verbosity",false);
+
+  const char* nTree = pTreeName.c_str();
+  std::unique_ptr<TFile> hf(TFile::Open(nTree));
+
+  if (!hf || !hf->IsOpen()) {
+    edm::LogError("HFShower") << "HFShowerLibrary: opening " << nTree
+                              << " failed";
+    throw cms::Exception("Unknown", "HFShowerLibrary")
+      << "Opening of " << pTreeName << " fails\n";
+  } else {
+    edm::LogInfo("HFShower") << "HFShowerLibrary: opening " << nTree
+                             << " successfully";
+  }
+
+  bool newForm = (branchEvInfo.empty());
+  TTree* event(nullptr);
+  if (newForm) event = (TTree *) hf ->Get("HFSimHits");
+  else         event = (TTree *) hf ->Get("Events");
+  if (event) {
+    TBranch *evtInfo(nullptr);
+    if (!newForm) {
+      std::string info = branchEvInfo + branchPost;
+      evtInfo          = event->GetBranch(info.c_str());
+    }
+    if (evtInfo || newForm) {
+      loadEventInfo(evtInfo);
+    } else {
+      edm::LogError("HFShower") << "HFShowerLibrary: HFShowerLibrayEventInfo"
+                                << " Branch does not exist in Event";
+      throw cms::Exception("Unknown", "HFShowerLibrary")
+        << "Event information absent\n";
+    }
+  } else {
+    edm::LogError("HFShower") << "HFShowerLibrary: Events Tree does not "
+                              << "exist";
+    throw cms::Exception("Unknown", "HFShowerLibrary")
+      << "Events tree absent\n";
+  }
+
+  std::stringstream ss;
+  ss << "HFShowerLibrary: Library " << libVers << " ListVersion " << listVersion
+     << " Events Total " << totEvents << " and " << evtPerBin << " per bin\n";
+  ss << "HFShowerLibrary: Energies (GeV) with " << nMomBin << " bins\n";
+  for (int i=0; i<nMomBin; ++i) {
+    if(i/10*10 == i && i > 0) { ss << "\n"; }
+    ss << "  " << pmom[i]/CLHEP::GeV;
+  }
+  edm::LogInfo("HFShower") << ss.str();
+
+  std::string nameBr = branchPre + emName + branchPost;
+  TBranch* emBranch  = event->GetBranch(nameBr.c_str());
+  nameBr             = branchPre + hadName + branchPost;
+  TBranch* hadBranch = event->GetBranch(nameBr.c_str());
+  if (!emBranch || !hadBranch) {
+    edm::LogError("HFShower") << "HFShowerLibrary: Branch " << emName
+                              << " or " << hadName << " does not exist";
+    throw cms::Exception("Unknown", "HFShowerLibrary")
+      << "Shower branches absent\n";
+  }
+  if (verbose) {
+    emBranch->Print();
+    hadBranch->Print();
+  }
+
+  bool v3version = (emBranch->GetClassName() == std::string("vector<float>"));
+
+  edm::LogInfo("HFShower") << " HFShowerLibrary:Branch " << emName
+                           << " has " << emBranch->GetEntries()
+                           << " entries and Branch " << hadName
+                           << " has " << hadBranch->GetEntries()
+                           << " entries"
+                           << "\n HFShowerLibrary::No packing information -"
+                           << " Assume x, y, z are not in packed form";
+
+  // in the new format the hadronic records follow the EM ones in the tree
+  loadRecords(0, emBranch, 0, newForm, v3version);
+  loadRecords(1, hadBranch, (newForm ? totEvents : 0), newForm, v3version);
+  hf->Close();
+
+  edm::LogInfo("HFShower") << "HFShowerLibrary: " << totEvents << " EM and "
+                           << totEvents << " hadronic records with "
+                           << photons[0].size() << " and "
+                           << photons[1].size() << " photons loaded in "
+                           << "memory";
+}
+
+void HFShowerLibraryData::loadEventInfo(TBranch* branch) {
+
+  if (branch) {
+    std::vector<HFShowerLibraryEventInfo> eventInfoCollection;
+    branch->SetAddress(&eventInfoCollection);
+    branch->GetEntry(0);
+    edm::LogInfo("HFShower") << "HFShowerLibrary::loadEventInfo loads "
+                             << " EventInfo Collection of size "
+                             << eventInfoCollection.size() << " records";
+    totEvents   = eventInfoCollection[0].totalEvents();
+    nMomBin     = eventInfoCollection[0].numberOfBins();
+    evtPerBin   = eventInfoCollection[0].eventsPerBin();
+    libVers     = eventInfoCollection[0].showerLibraryVersion();
+    listVersion = eventInfoCollection[0].physListVersion();
+    pmom        = eventInfoCollection[0].energyBins();
+    branch->ResetAddress();
+  } else {
+    edm::LogInfo("HFShower") << "HFShowerLibrary::loadEventInfo loads "
+                             << " EventInfo from hardwired numbers";
+    nMomBin     = 16;
+    evtPerBin   = 5000;
+    totEvents   = nMomBin*evtPerBin;
+    libVers     = 1.1;
+    listVersion = 3.6;
+    pmom        = {2,3,5,7,10,15,20,30,50,75,100,150,250,350,500,1000};
+  }
+  for (int i=0; i<nMomBin; i++)
+    pmom[i] *= CLHEP::GeV;
+}
+
+void HFShowerLibraryData::loadRecords(int type, TBranch* branch, int first,
+                                      bool newForm, bool v3version) {
+
+  std::vector<Photon> & out = photons[type];
+  std::vector<unsigned int> & off = offsets[type];
+  off.reserve(totEvents+1);
+  off.push_back(0);
+
+  HFShowerPhotonCollection  photon;
+  HFShowerPhotonCollection* photo = &photon;
+  std::vector<float>        t;
+  std::vector<float>*       tp = &t;
+  if (newForm && v3version) branch->SetAddress(&tp);
+  else if (newForm)         branch->SetAddress(&photo);
+  else                      branch->SetAddress(&photon);
+
+  for (int nrc = 0; nrc < totEvents; ++nrc) {
+    branch->GetEntry(nrc+first);
+    if (newForm && v3version) {
+      // x, y, z, lambda and time of all the photons, one after the other
+      unsigned int tSize=t.size()/5;
+      for (unsigned int i=0; i<tSize; i++) {
+        out.push_back({t[i], t[1*tSize+i], t[2*tSize+i], t[3*tSize+i], t[4*tSize+i]});
+      }
+    } else {
+      for (const auto & ph : *photo) {
+        out.push_back({ph.x(), ph.y(), ph.z(), ph.lambda(), ph.t()});
+      }
+    }
+    off.push_back(out.size());
+  }
+  branch->ResetAddress();
+  out.shrink_to_fit();
+}
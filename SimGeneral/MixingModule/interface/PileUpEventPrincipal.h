@@ -1,10 +1,13 @@
 #ifndef SimGeneral_MixingModule_PileUpEventPrincipal_h
 #define SimGeneral_MixingModule_PileUpEventPrincipal_h
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 
 #include "FWCore/Framework/interface/EventPrincipal.h"
+#include "DataFormats/Common/interface/Wrapper.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "FWCore/Utilities/interface/ProductKindOfType.h"
 #include "FWCore/Utilities/interface/TypeID.h"
@@ -19,8 +22,10 @@ namespace edm {
 class PileUpEventPrincipal {
 public:
 
-  PileUpEventPrincipal(edm::EventPrincipal const& ep, edm::ModuleCallingContext const* mcc, int bcr) :
-    principal_(ep), mcc_(mcc), bunchCrossing_(bcr) {}
+  // shared is true if the event is also used by other streams (see
+  // edm::PileUpEventPool), in which case its products must not be modified
+  PileUpEventPrincipal(edm::EventPrincipal const& ep, edm::ModuleCallingContext const* mcc, int bcr, bool shared = false) :
+    principal_(ep), mcc_(mcc), bunchCrossing_(bcr), shared_(shared) {}
 
   edm::EventPrincipal const& principal() {
     return principal_;
@@ -38,11 +43,39 @@ public:
     return bunchCrossing_;
   }
 
+  bool shared() const {
+    return shared_;
+  }
+
+  // replaces, for this crossing, a product of a shared event by a modified copy
+  void setAdjusted(edm::WrapperBase const* original, std::shared_ptr<edm::WrapperBase const> adjusted) {
+    adjusted_[original] = std::move(adjusted);
+  }
+
+  template<typename T>
+  std::shared_ptr<edm::Wrapper<T> const>
+  getProductByTag(edm::InputTag const& tag) const {
+    std::shared_ptr<edm::Wrapper<T> const> product = edm::getProductByTag<T>(principal_, tag, mcc_);
+    if(product && !adjusted_.empty()) {
+      auto it = adjusted_.find(product.get());
+      if(it != adjusted_.end()) {
+        return std::static_pointer_cast<edm::Wrapper<T> const>(it->second);
+      }
+    }
+    return product;
+  }
+
 
   template<typename T>
   bool
   getByLabel(edm::InputTag const& tag, edm::Handle<T>& result) const {
     edm::BasicHandle bh = principal_.getByLabel(edm::PRODUCT_TYPE, edm::TypeID(typeid(T)), tag, nullptr, nullptr, mcc_);
+    if(bh.isValid() && !adjusted_.empty()) {
+      auto it = adjusted_.find(bh.wrapper());
+      if(it != adjusted_.end()) {
+        bh = edm::BasicHandle(it->second.get(), bh.provenance());
+      }
+    }
     convert_handle(std::move(bh), result);
     return result.isValid();
   }
@@ -51,6 +84,8 @@ private:
   edm::EventPrincipal const& principal_;
   edm::ModuleCallingContext const* mcc_;
   int bunchCrossing_;
+  bool shared_;
+  std::map<edm::WrapperBase const*, std::shared_ptr<edm::WrapperBase const> > adjusted_;
 };
 
 #endif
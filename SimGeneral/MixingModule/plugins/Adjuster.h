@@ -12,6 +12,7 @@
 #include "SimDataFormats/TrackingHit/interface/PSimHitContainer.h"
 #include "SimDataFormats/Vertex/interface/SimVertexContainer.h"
 #include "DataFormats/TrackingRecHit/interface/TrackingRecHitFwd.h"
+#include "SimGeneral/MixingModule/interface/PileUpEventPrincipal.h"
 
 #include <memory>
 #include <vector>
@@ -26,7 +27,7 @@ namespace edm {
   class AdjusterBase {
   public:
     virtual ~AdjusterBase() {}
-    virtual void doOffset(int bunchspace, int bcr, const edm::EventPrincipal&, ModuleCallingContext const*, unsigned int EventNr, int vertexOffset) = 0;
+    virtual void doOffset(int bunchspace, PileUpEventPrincipal&, unsigned int EventNr, int vertexOffset) = 0;
     virtual bool checkSignal(edm::Event const& event) = 0;
   };
 
@@ -38,7 +39,7 @@ namespace edm {
 
     ~Adjuster() override {}
 
-    void doOffset(int bunchspace, int bcr, const edm::EventPrincipal&, ModuleCallingContext const*, unsigned int EventNr, int vertexOffset) override;
+    void doOffset(int bunchspace, PileUpEventPrincipal&, unsigned int EventNr, int vertexOffset) override;
 
     bool checkSignal(edm::Event const& event) override {
       bool got = false;
@@ -66,11 +67,18 @@ namespace edm {
   }
 
   template<typename T>
-  void  Adjuster<T>::doOffset(int bunchspace, int bcr, const EventPrincipal &ep, ModuleCallingContext const* mcc, unsigned int eventNr, int vertexOffset) {
-    std::shared_ptr<Wrapper<T> const> shPtr = getProductByTag<T>(ep, tag_, mcc);
+  void  Adjuster<T>::doOffset(int bunchspace, PileUpEventPrincipal &ep, unsigned int eventNr, int vertexOffset) {
+    std::shared_ptr<Wrapper<T> const> shPtr = getProductByTag<T>(ep.principal(), tag_, ep.moduleCallingContext());
     if (shPtr) {
-      T& product = const_cast<T&>(*shPtr->product());
-      detail::doTheOffset(bunchspace, bcr, product, eventNr, vertexOffset, WrapT_);
+      if (ep.shared()) {
+        // the event is used by other streams as well, offset a copy
+        auto product = std::make_unique<T>(*shPtr->product());
+        detail::doTheOffset(bunchspace, ep.bunchCrossing(), *product, eventNr, vertexOffset, WrapT_);
+        ep.setAdjusted(shPtr.get(), std::make_shared<Wrapper<T> const>(std::move(product)));
+      } else {
+        T& product = const_cast<T&>(*shPtr->product());
+        detail::doTheOffset(bunchspace, ep.bunchCrossing(), product, eventNr, vertexOffset, WrapT_);
+      }
     }
   }
 
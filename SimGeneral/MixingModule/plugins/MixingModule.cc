@@ -325,7 +325,8 @@ namespace edm {
                                     int bunchCrossing, int eventId,
                                     int& vertexOffset,
                                     const edm::EventSetup& setup,
-                                    StreamID const& streamID) {
+                                    StreamID const& streamID,
+                                    bool shared) {
 
 
     InternalContext internalContext(eventPrincipal.id(), mcc);
@@ -333,10 +334,12 @@ namespace edm {
     ModuleCallingContext moduleCallingContext(&moduleDescription());
     ModuleContextSentry moduleContextSentry(&moduleCallingContext, parentContext);
 
+    // if the event is shared with other streams, the adjusters store the
+    // modified products in pep instead of modifying the event
+    PileUpEventPrincipal pep(eventPrincipal, &moduleCallingContext, bunchCrossing, shared);
     for (auto const& adjuster : adjusters_) {
-      adjuster->doOffset(bunchSpace_, bunchCrossing, eventPrincipal, &moduleCallingContext, eventId, vertexOffset);
+      adjuster->doOffset(bunchSpace_, pep, eventId, vertexOffset);
     }
-    PileUpEventPrincipal pep(eventPrincipal, &moduleCallingContext, bunchCrossing);
 
     accumulateEvent(pep, setup, streamID);
 
@@ -344,7 +347,7 @@ namespace edm {
       LogDebug("MixingModule") <<" merging Event:  id " << eventPrincipal.id();
       //      std::cout <<"PILEALLWORKERS merging Event:  id " << eventPrincipal.id() << std::endl;
 
-      worker->addPileups(eventPrincipal, &moduleCallingContext, eventId);
+      worker->addPileups(pep, eventId);
     }
   }
 
@@ -488,7 +491,8 @@ namespace edm {
           sizes.push_back(numberOfEvents);
           inputSources_[readSrcIdx]->readPileUp(e.id(), recordEventID,
                                                 std::bind(&MixingModule::pileAllWorkers, std::ref(*this), _1, mcc, bunchIdx,
-                                                            _2, vertexOffset, std::ref(setup), e.streamID()), numberOfEvents, e.streamID());
+                                                            _2, vertexOffset, std::ref(setup), e.streamID(), source->sharedEvents()),
+                                                numberOfEvents, e.streamID());
         } else if(oldFormatPlayback) {
           std::vector<edm::EventID> const& playEventID = oldFormatPlaybackInfo_H->getStartEventId(readSrcIdx, bunchIdx);
           size_t numberOfEvents = playEventID.size();
@@ -502,7 +506,7 @@ namespace edm {
           inputSources_[readSrcIdx]->playOldFormatPileUp(
             begin, end, recordEventID,
             std::bind(&MixingModule::pileAllWorkers, std::ref(*this), _1, mcc, bunchIdx,
-                        _2, vertexOffset, std::ref(setup), e.streamID()));
+                        _2, vertexOffset, std::ref(setup), e.streamID(), false));
         } else {
           size_t numberOfEvents = playbackInfo_H->getNumberOfEvents(bunchIdx, readSrcIdx);
           if(readSrcIdx == 0) {
@@ -516,7 +520,7 @@ namespace edm {
           inputSources_[readSrcIdx]->playPileUp(
             begin, end, recordEventID,
             std::bind(&MixingModule::pileAllWorkers, std::ref(*this), _1, mcc, bunchIdx,
-                        _2, vertexOffset, std::ref(setup), e.streamID()));
+                        _2, vertexOffset, std::ref(setup), e.streamID(), false));
 	}
       }
       for(Accumulators::const_iterator accItr = digiAccumulators_.begin(), accEnd = digiAccumulators_.end(); accItr != accEnd; ++accItr) {
@@ -84,7 +84,7 @@ namespace edm {
       void addSignals(const edm::Event &e, const edm::EventSetup& es) override; 
       void doPileUp(edm::Event &e, const edm::EventSetup& es) override;
       void pileAllWorkers(EventPrincipal const& ep, ModuleCallingContext const*, int bcr, int id, int& offset,
-			  const edm::EventSetup& setup, edm::StreamID const&);
+			  const edm::EventSetup& setup, edm::StreamID const&, bool shared);
       void createDigiAccumulators(const edm::ParameterSet& mixingPSet, edm::ConsumesCollector& iC);
 
       InputTag inputTagPlayback_;
@@ -9,10 +9,10 @@
 
 namespace edm {
   template <>
-  void MixingWorker<HepMCProduct>::addPileups(const EventPrincipal& ep, ModuleCallingContext const* mcc, unsigned int eventNr) {
+  void MixingWorker<HepMCProduct>::addPileups(const PileUpEventPrincipal& ep, unsigned int eventNr) {
     // HepMCProduct does not come as a vector....
     for(InputTag const& tag : allTags_) {
-      std::shared_ptr<Wrapper<HepMCProduct> const> shPtr = getProductByTag<HepMCProduct>(ep, tag, mcc);
+      std::shared_ptr<Wrapper<HepMCProduct> const> shPtr = ep.getProductByTag<HepMCProduct>(tag);
       if(shPtr) {
         LogDebug("MixingModule") << "HepMC pileup objects  added, eventNr " << eventNr << " Tag " << tag << std::endl;
         crFrame_->setPileupPtr(shPtr);
@@ -26,6 +26,7 @@
 #include "SimDataFormats/CrossingFrame/interface/PCrossingFrame.h"
 #include "SimDataFormats/TrackingHit/interface/PSimHitContainer.h"
 #include "FWCore/Utilities/interface/InputTag.h" 
+#include "SimGeneral/MixingModule/interface/PileUpEventPrincipal.h"
 
 #include <memory>
 #include <vector>
@@ -147,7 +148,7 @@ namespace edm
         }
       }
 
-      void addPileups(const EventPrincipal &ep, ModuleCallingContext const*, unsigned int eventNr) override;
+      void addPileups(const PileUpEventPrincipal &ep, unsigned int eventNr) override;
 
       void setBcrOffset() override {crFrame_->setBcrOffset();}
       void setSourceOffset(const unsigned int s) override {crFrame_->setSourceOffset(s);}
@@ -183,8 +184,8 @@ namespace edm
     };
 
   template <typename T>
-  void  MixingWorker<T>::addPileups(const EventPrincipal &ep, ModuleCallingContext const* mcc, unsigned int eventNr) {
-    std::shared_ptr<Wrapper<std::vector<T> > const> shPtr = getProductByTag<std::vector<T> >(ep, tag_, mcc);
+  void  MixingWorker<T>::addPileups(const PileUpEventPrincipal &ep, unsigned int eventNr) {
+    std::shared_ptr<Wrapper<std::vector<T> > const> shPtr = ep.getProductByTag<std::vector<T> >(tag_);
     if (shPtr) {
       LogDebug("MixingModule") << shPtr->product()->size() << "  pileup objects  added, eventNr " << eventNr;
       crFrame_->setPileupPtr(shPtr);
@@ -194,7 +195,7 @@ namespace edm
 //=============== template specializations ====================================================================================
 
 template <>
-    void MixingWorker<HepMCProduct>::addPileups(const EventPrincipal &ep, ModuleCallingContext const*, unsigned int eventNr);
+    void MixingWorker<HepMCProduct>::addPileups(const PileUpEventPrincipal &ep, unsigned int eventNr);
 
 template <class T>
     void MixingWorker<T>::setTof() {;}
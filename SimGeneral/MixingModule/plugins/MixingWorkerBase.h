@@ -17,6 +17,8 @@
 #include "Mixing/Base/interface/PileUp.h"
 #include "DataFormats/Provenance/interface/EventID.h"
 
+class PileUpEventPrincipal;
+
 namespace edm
 {
   class MixingModule;
@@ -40,8 +42,7 @@ namespace edm
       virtual bool checkSignal(const edm::Event &e)=0;
       virtual void createnewEDProduct()=0; 
       virtual void addSignals(const edm::Event &e) =0;
-      virtual void addPileups(const edm::EventPrincipal&,
-                              ModuleCallingContext const*,
+      virtual void addPileups(const PileUpEventPrincipal&,
                               unsigned int EventNr)=0;
       virtual void setBcrOffset()=0;
       virtual void setSourceOffset(const unsigned int s)=0;
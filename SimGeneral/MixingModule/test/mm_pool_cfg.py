@@ -0,0 +1,37 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("PRODMIXNEW")
+process.load("SimGeneral.MixingModule.mixLowLumPU_cfi")
+
+# draw the pileup events from a pool shared by the 4 streams, each pool
+# event being used for at most 4 signal events.  With several streams, the
+# output depends on the stream scheduling: only playback reproduces it.
+process.mix.input.poolSize = cms.untracked.uint32(2000)
+process.mix.input.poolMaxReuse = cms.untracked.uint32(4)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(4)
+)
+
+process.RandomNumberGeneratorService = cms.Service("RandomNumberGeneratorService",
+    moduleSeeds = cms.PSet(
+        mix = cms.untracked.uint32(12345)
+    )
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring('rfio:/castor/cern.ch/cms/store/relval/2008/6/22/RelVal-RelValSingleElectronPt35-1213987236-IDEAL_V2-2nd/0006/4CF7711A-E241-DD11-A987-000423D99658.root')
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(20)
+)
+process.out = cms.OutputModule("PoolOutputModule",
+    outputCommands = cms.untracked.vstring('drop *_*_*_*',
+        'keep *_*_*_PRODMIXNEW'),
+    fileName = cms.untracked.string('file:/tmp/Cum_pool.root')
+)
+
+process.p = cms.Path(process.mix)
+process.outpath = cms.EndPath(process.out)
@@ -10,6 +10,7 @@
 #include "MagneticField/VolumeGeometry/interface/MagVolume.h"
 #include "FWCore/Utilities/interface/Visibility.h"
 
+#include <vector>
 
 class GlobalTrajectoryParameters;
 class GlobalParametersWithPath;
@@ -43,6 +44,15 @@ private:
   
 
 public:
+  /// Propagation of several states to the same surface. The results are the ones
+  /// of propagateWithPath for each state, but the Runge-Kutta steps of all the
+  /// states are made together (see RKBatchSolver).
+  std::vector<std::pair< TrajectoryStateOnSurface, double> >
+  propagateWithPath (const std::vector<FreeTrajectoryState>&, const Plane&) const;
+
+  std::vector<std::pair< TrajectoryStateOnSurface, double> >
+  propagateWithPath (const std::vector<FreeTrajectoryState>&, const Cylinder&) const;
+
   Propagator * clone() const override;
 
   const MagneticField* magneticField() const override {return theVolume;}
@@ -76,6 +86,11 @@ private:
   GlobalParametersWithPath propagateParametersOnCylinder( const FreeTrajectoryState& ts, 
 							  const Cylinder& cyl) const dso_internal;
 
+  std::vector<GlobalParametersWithPath> propagateParametersOnPlane( const std::vector<FreeTrajectoryState>& ts,
+								    const Plane& plane) const dso_internal;
+  std::vector<GlobalParametersWithPath> propagateParametersOnCylinder( const std::vector<FreeTrajectoryState>& ts,
+								       const Cylinder& cyl) const dso_internal;
+
 };
 
 #endif
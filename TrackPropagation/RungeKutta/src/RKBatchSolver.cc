@@ -0,0 +1,156 @@
+#include "RKBatchSolver.h"
+#include "RKLocalFieldProvider.h"
+#include "RKAdaptiveSolver.h"
+#include "DataFormats/GeometryVector/interface/Basic3DVector.h"
+
+#include <cmath>
+
+namespace {
+  // Cash-Karp coefficients, as in RKOneCashKarpStep
+  constexpr double a[6][5] = {
+    { 0., 0., 0., 0., 0.},
+    { 0.2, 0., 0., 0., 0.},
+    { 3./40., 9./40., 0., 0., 0.},
+    { 0.3, -0.9, 1.2, 0., 0.},
+    { -11./54., 5./2., -70./27., 35./27., 0.},
+    { 1631./55296., 175./512., 575./13824., 44275./110592., 253./4096.}
+  };
+  constexpr double c[6] = { 37./378., 0., 250./621., 125./594., 0., 512./1771.};
+  constexpr double d[6] = { 2825./27648., 0., 18575./48384., 13525./55296., 277./14336., 0.25};
+}
+
+void RKBatchSolver::derivatives( const RKLocalFieldProvider& field, int stage)
+{
+  const unsigned int n = theRunning.size();
+  for (unsigned int i=0; i<n; ++i) {
+    auto b = field.inTesla( float(theArg[0][i]), float(theArg[1][i]), float(theArg[2][i]));
+    theB[0][i] = b.x(); theB[1][i] = b.y(); theB[2][i] = b.z();
+  }
+
+  // same arithmetic as CartesianLorentzForce, which works with the float CartesianStateAdaptor
+  constexpr float k = 2.99792458e-3; // conversion to [cm]
+  const float* bx = theB[0].data(); const float* by = theB[1].data(); const float* bz = theB[2].data();
+  const double* px = theArg[3].data(); const double* py = theArg[4].data(); const double* pz = theArg[5].data();
+  const float* q = theCharge.data();
+  const double* h = theH.data();
+  double* k0 = theK[stage][0].data(); double* k1 = theK[stage][1].data(); double* k2 = theK[stage][2].data();
+  double* k3 = theK[stage][3].data(); double* k4 = theK[stage][4].data(); double* k5 = theK[stage][5].data();
+  for (unsigned int i=0; i<n; ++i) {
+    float mx = px[i], my = py[i], mz = pz[i];
+    float inv = 1.f/std::sqrt( mx*mx + my*my + mz*mz);
+    float tx = mx*inv, ty = my*inv, tz = mz*inv;
+    float kq = k*q[i];
+    k0[i] = h[i]*tx;
+    k1[i] = h[i]*ty;
+    k2[i] = h[i]*tz;
+    k3[i] = h[i]*(kq*(ty*bz[i] - tz*by[i]));
+    k4[i] = h[i]*(kq*(tz*bx[i] - tx*bz[i]));
+    k5[i] = h[i]*(kq*(tx*by[i] - ty*bx[i]));
+  }
+}
+
+void RKBatchSolver::operator()( States& states, const std::vector<unsigned int>& tracks,
+				const std::vector<double>& steps, const RKLocalFieldProvider& field,
+				float eps)
+{
+  using namespace RKDetails;
+  constexpr float Safety = 0.9;
+
+  theRemaining.resize( states.size());
+  theStepSize.resize( states.size());
+  theRunning = tracks;
+  for (auto t : tracks) {
+    theRemaining[t] = steps[t];
+    theStepSize[t] = steps[t];   // attempt to solve in one step
+  }
+
+  while (!theRunning.empty()) {
+    const unsigned int n = theRunning.size();
+    for (int cc=0; cc<6; ++cc) {
+      theStart[cc].resize(n);
+      theArg[cc].resize(n);
+      for (auto& ks : theK) ks[cc].resize(n);
+    }
+    for (auto& b : theB) b.resize(n);
+    theH.resize(n);
+    theCharge.resize(n);
+    for (unsigned int i=0; i<n; ++i) {
+      unsigned int t = theRunning[i];
+      for (int cc=0; cc<6; ++cc) theStart[cc][i] = states.v[cc][t];
+      theH[i] = theStepSize[t];
+      theCharge[i] = states.charge[t];
+    }
+
+    // the six stages of the Cash-Karp step, for all the running tracks
+    for (int s=0; s<6; ++s) {
+      for (int cc=0; cc<6; ++cc) {
+	const double* v = theStart[cc].data();
+	double* arg = theArg[cc].data();
+	for (unsigned int i=0; i<n; ++i) arg[i] = v[i];
+	for (int j=0; j<s; ++j) {
+	  const double aj = a[s][j];
+	  const double* kj = theK[j][cc].data();
+	  for (unsigned int i=0; i<n; ++i) arg[i] += aj*kj[i];
+	}
+      }
+      derivatives( field, s);
+    }
+
+    // fifth order result in theArg, fourth order estimate in theStart
+    for (int cc=0; cc<6; ++cc) {
+      double* r5 = theArg[cc].data();
+      double* r4 = theStart[cc].data();
+      for (unsigned int i=0; i<n; ++i) r5[i] = r4[i];
+      for (int j=0; j<6; ++j) {
+	const double cj = c[j], dj = d[j];
+	const double* kj = theK[j][cc].data();
+	if (cj != 0) for (unsigned int i=0; i<n; ++i) r5[i] += cj*kj[i];
+	if (dj != 0) for (unsigned int i=0; i<n; ++i) r4[i] += dj*kj[i];
+      }
+    }
+
+    // step size control, track by track as in RKAdaptiveSolver
+    unsigned int nrun = 0;
+    for (unsigned int i=0; i<n; ++i) {
+      unsigned int t = theRunning[i];
+      RKSmallVector<double,6> r5;
+      for (int cc=0; cc<6; ++cc) r5[cc] = theArg[cc][i];
+      Basic3DVector<float> dpos( theStart[0][i]-r5[0], theStart[1][i]-r5[1], theStart[2][i]-r5[2]);
+      Basic3DVector<float> dmom( theStart[3][i]-r5[3], theStart[4][i]-r5[4], theStart[5][i]-r5[5]);
+      Basic3DVector<float> mom5( r5[3], r5[4], r5[5]);
+      float acc = dpos.mag() + dmom.mag()/mom5.mag();
+
+      double& remainigStep = theRemaining[t];
+      double& stepSize = theStepSize[t];
+      bool done = false;
+      if (acc <eps || std::abs(stepSize) < std::abs(remainigStep)*0.1f) {
+	states.set( t, r5);
+	if (std::abs(remainigStep - stepSize) < 0.5f*eps) {
+	  done = true; // we are there
+	} else {
+	  remainigStep -= stepSize;
+	  // increase step size
+	  const float cut = std::pow(4.f/Safety,5.f);
+	  float factor =  (eps < cut*acc) ? Safety * fastPow(eps/acc,0.2) : 4.f;
+	  double absRemainingStep = std::abs(remainigStep);
+	  double absSize =  std::min( std::abs(stepSize*factor), absRemainingStep);
+	  if (absSize < 0.05f* absRemainingStep ) absSize =  0.05f* absRemainingStep;
+	  stepSize = std::copysign(absSize,stepSize);
+	}
+      } else {
+	// decrease step size
+	constexpr float cut =  Safety*Safety*Safety*Safety*100*100;
+	float factor = ( cut*eps > acc) ? Safety * fastPow(eps/acc,0.25) : 0.1f;
+	stepSize *= factor;
+	if (std::abs(stepSize) < 0.05f*std::abs(remainigStep)) stepSize = 0.05f*remainigStep;
+      }
+      if (!done && !(std::abs(remainigStep) > eps*0.5f)) {
+	// as RKAdaptiveSolver, which returns the last attempted step
+	states.set( t, r5);
+	done = true;
+      }
+      if (!done) theRunning[nrun++] = t;
+    }
+    theRunning.resize(nrun);
+  }
+}
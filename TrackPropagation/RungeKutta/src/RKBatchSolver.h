@@ -0,0 +1,70 @@
+#ifndef RKBatchSolver_H
+#define RKBatchSolver_H
+
+#include "FWCore/Utilities/interface/Visibility.h"
+#include "RKSmallVector.h"
+
+#include <vector>
+
+class RKLocalFieldProvider;
+
+/** Adaptive Cash-Karp solver for the 6D cartesian state of a batch of tracks,
+ *  with the path length as free parameter: the batched equivalent of
+ *  RKAdaptiveSolver<double,RKOneCashKarpStep,6> with CartesianLorentzForce
+ *  and RKCartesianDistance, with the same step size control.
+ *  The states are kept in SoA form. Each track has its own step and step
+ *  size, but the stages of the steps of all the tracks still running are
+ *  computed together: the field of all of them is read in one loop, and
+ *  the Lorentz force and the state updates are vectorized over the tracks.
+ */
+
+class dso_internal RKBatchSolver {
+public:
+
+  /// SoA cartesian states (position, momentum) and charges of the tracks
+  struct States {
+    std::vector<double> v[6];
+    std::vector<float>  charge;
+
+    unsigned int size() const {return charge.size();}
+    void resize( unsigned int n) {
+      for (auto& c : v) c.resize(n);
+      charge.resize(n);
+    }
+
+    RKSmallVector<double,6> rkstate( unsigned int i) const {
+      RKSmallVector<double,6> res;
+      for (int c=0; c<6; ++c) res[c] = v[c][i];
+      return res;
+    }
+    void set( unsigned int i, const RKSmallVector<double,6>& rk) {
+      for (int c=0; c<6; ++c) v[c][i] = rk[c];
+    }
+  };
+
+  /// Advance the states of "tracks" by their "steps" (indexed by track),
+  /// in the frame of the field provider
+  void operator()( States& states, const std::vector<unsigned int>& tracks,
+		   const std::vector<double>& steps, const RKLocalFieldProvider& field,
+		   float eps);
+
+private:
+
+  void derivatives( const RKLocalFieldProvider& field, int stage);
+
+  // per track adaptive step control
+  std::vector<double> theRemaining;
+  std::vector<double> theStepSize;
+
+  // the running tracks, and their states, steps, charges and stages, in SoA
+  std::vector<unsigned int> theRunning;
+  std::vector<double> theStart[6];
+  std::vector<double> theArg[6];
+  std::vector<double> theK[6][6];
+  std::vector<double> theH;
+  std::vector<float>  theCharge;
+  std::vector<float>  theB[3];
+
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include "DataFormats/GeometrySurface/interface/Plane.h"
 #include "DataFormats/GeometrySurface/interface/Cylinder.h"
 #include "RKAdaptiveSolver.h"
+#include "RKBatchSolver.h"
 #include "RKOne4OrderStep.h"
 #include "RKOneCashKarpStep.h"
 #include "PathToPlane2Order.h"
@@ -329,6 +330,193 @@ RKPropagatorInS::propagateParametersOnCylinder( const FreeTrajectoryState& ts,
 }
 
 
+std::vector<std::pair<TrajectoryStateOnSurface,double> >
+RKPropagatorInS::propagateWithPath(const std::vector<FreeTrajectoryState>& fts,
+				   const Plane& plane) const
+{
+  std::vector<GlobalParametersWithPath> gps = propagateParametersOnPlane( fts, plane);
+  std::vector<TsosWP> result;
+  result.reserve( fts.size());
+  for (unsigned int i=0; i<fts.size(); ++i) {
+    const GlobalParametersWithPath& gp = gps[i];
+    if UNLIKELY(!gp) { result.emplace_back( TrajectoryStateOnSurface(), 0.); continue; }
+    SurfaceSideDefinition::SurfaceSide side = PropagationDirectionFromPath()(gp.s(),propagationDirection())==alongMomentum
+      ? SurfaceSideDefinition::beforeSurface : SurfaceSideDefinition::afterSurface;
+    result.push_back( analyticalErrorPropagation( fts[i], plane, side, gp.parameters(), gp.s()));
+  }
+  return result;
+}
+
+std::vector<std::pair<TrajectoryStateOnSurface,double> >
+RKPropagatorInS::propagateWithPath(const std::vector<FreeTrajectoryState>& fts,
+				   const Cylinder& cyl) const
+{
+  std::vector<GlobalParametersWithPath> gps = propagateParametersOnCylinder( fts, cyl);
+  std::vector<TsosWP> result;
+  result.reserve( fts.size());
+  for (unsigned int i=0; i<fts.size(); ++i) {
+    const GlobalParametersWithPath& gp = gps[i];
+    if UNLIKELY(!gp) { result.emplace_back( TrajectoryStateOnSurface(), 0.); continue; }
+    SurfaceSideDefinition::SurfaceSide side = PropagationDirectionFromPath()(gp.s(),propagationDirection())==alongMomentum
+      ? SurfaceSideDefinition::beforeSurface : SurfaceSideDefinition::afterSurface;
+    result.push_back( analyticalErrorPropagation( fts[i], cyl, side, gp.parameters(), gp.s()));
+  }
+  return result;
+}
+
+std::vector<GlobalParametersWithPath>
+RKPropagatorInS::propagateParametersOnPlane( const std::vector<FreeTrajectoryState>& ts,
+					     const Plane& plane) const
+{
+  // same iterations as for a single state, each state keeping its own path, direction and distance
+  std::vector<GlobalParametersWithPath> result( ts.size());
+  RKBatchSolver::States states;
+  states.resize( ts.size());
+  std::vector<double> startZ( ts.size()), stot( ts.size(), 0.), steps( ts.size(), 0.);
+  std::vector<PropagationDirection> currentDirection( ts.size(), propagationDirection());
+  std::vector<unsigned int> running, stepping;
+  for (unsigned int i=0; i<ts.size(); ++i) {
+    // straight lines are not worth a batch
+    if UNLIKELY( fabs(ts[i].transverseCurvature())<1.e-10 ) {
+      result[i] = propagateParametersOnPlane( ts[i], plane);
+      continue;
+    }
+    GlobalPoint gpos( ts[i].position());
+    startZ[i] = plane.localZ(gpos);
+    states.set( i, CartesianStateAdaptor::rkstate( rkPosition(gpos), rkMomentum(ts[i].momentum())));
+    states.charge[i] = ts[i].charge();
+    running.push_back(i);
+  }
+  if (running.empty()) return result;
+
+  RKLocalFieldProvider field( fieldProvider());
+  PathToPlane2Order pathLength( field, &field.frame());
+  RKBatchSolver solver;
+  double eps = theTolerance;
+
+  int safeGuard = 0;
+  while (!running.empty() && safeGuard++<100) {
+    stepping.clear();
+    for (auto i : running) {
+      CartesianStateAdaptor startState( states.rkstate(i));
+      std::pair<bool,double> path = pathLength( plane, startState.position(),
+						startState.momentum(),
+						(double) ts[i].charge(), currentDirection[i]);
+      if UNLIKELY(!path.first) {
+	LogDebug("RKPropagatorInS")  << "RKPropagatorInS: Path length calculation to plane failed!";
+	continue;
+      }
+      if UNLIKELY( std::abs(path.second) < eps) {
+	result[i] = GlobalParametersWithPath( gtpFromVolumeLocal( startState, ts[i].charge()), stot[i]);
+	continue;
+      }
+      steps[i] = path.second;
+      stepping.push_back(i);
+    }
+
+    solver( states, stepping, steps, field, eps);
+
+    running.clear();
+    for (auto i : stepping) {
+      stot[i] += steps[i];
+      CartesianStateAdaptor cur( states.rkstate(i));
+      double remainingZ = plane.localZ( globalPosition(cur.position()));
+      if ( fabs(remainingZ) < eps) {
+	result[i] = GlobalParametersWithPath( gtpFromVolumeLocal( cur, ts[i].charge()), stot[i]);
+	continue;
+      }
+      if (remainingZ * startZ[i] <= 0) currentDirection[i] = invertDirection( currentDirection[i]);
+      startZ[i] = remainingZ;
+      running.push_back(i);
+    }
+  }
+
+  if UNLIKELY(!running.empty())
+    edm::LogError("FailedPropagation") << " too many iterations trying to reach plane for " << running.size() << " states";
+  return result;
+}
+
+std::vector<GlobalParametersWithPath>
+RKPropagatorInS::propagateParametersOnCylinder( const std::vector<FreeTrajectoryState>& ts,
+						const Cylinder& cyl) const
+{
+  const GlobalPoint& sp = cyl.position();
+  if UNLIKELY(sp.x()!=0. || sp.y()!=0.) {
+      throw PropagationException("Cannot propagate to an arbitrary cylinder");
+    }
+
+  // same iterations as for a single state, each state keeping its own path, direction and distance
+  std::vector<GlobalParametersWithPath> result( ts.size());
+  RKBatchSolver::States states;
+  states.resize( ts.size());
+  std::vector<double> startR( ts.size()), stot( ts.size(), 0.), steps( ts.size(), 0.);
+  std::vector<PropagationDirection> currentDirection( ts.size(), propagationDirection());
+  std::vector<unsigned int> running, stepping;
+  for (unsigned int i=0; i<ts.size(); ++i) {
+    // straight lines are not worth a batch
+    if UNLIKELY( fabs(ts[i].transverseCurvature())<1.e-10 ) {
+      result[i] = propagateParametersOnCylinder( ts[i], cyl);
+      continue;
+    }
+    LocalPoint pos(cyl.toLocal(ts[i].position()));
+    LocalVector mom(cyl.toLocal(ts[i].momentum()));
+    startR[i] = cyl.radius() - pos.perp();
+    states.set( i, CartesianStateAdaptor::rkstate( pos.basicVector(), mom.basicVector()));
+    states.charge[i] = ts[i].charge();
+    running.push_back(i);
+  }
+  if (running.empty()) return result;
+
+  RKLocalFieldProvider field( fieldProvider(cyl));
+  RKBatchSolver solver;
+  double eps = theTolerance;
+
+  int safeGuard = 0;
+  while (!running.empty() && safeGuard++<100) {
+    stepping.clear();
+    for (auto i : running) {
+      CartesianStateAdaptor startState( states.rkstate(i));
+      StraightLineCylinderCrossing pathLength( LocalPoint(startState.position()),
+					       LocalVector(startState.momentum()),
+					       currentDirection[i], eps);
+      std::pair<bool,double> path = pathLength.pathLength( cyl);
+      if UNLIKELY(!path.first) {
+	LogDebug("RKPropagatorInS")  << "RKPropagatorInS: Path length calculation to cylinder failed!"
+				     << "Radius " << cyl.radius() << " pos.perp() " << LocalPoint(startState.position()).perp() ;
+	continue;
+      }
+      if UNLIKELY( std::abs(path.second) < eps) {
+	result[i] = GlobalParametersWithPath( gtpFromLocal( startState.position(), startState.momentum(),
+							    ts[i].charge(), cyl), stot[i]);
+	continue;
+      }
+      steps[i] = path.second;
+      stepping.push_back(i);
+    }
+
+    solver( states, stepping, steps, field, eps);
+
+    running.clear();
+    for (auto i : stepping) {
+      stot[i] += steps[i];
+      CartesianStateAdaptor cur( states.rkstate(i));
+      double remainingR = cyl.radius() - cur.position().perp();
+      if ( fabs(remainingR) < eps) {
+	result[i] = GlobalParametersWithPath( gtpFromLocal( cur.position(), cur.momentum(),
+							    ts[i].charge(), cyl), stot[i]);
+	continue;
+      }
+      if (remainingR * startR[i] <= 0) currentDirection[i] = invertDirection( currentDirection[i]);
+      startR[i] = remainingR;
+      running.push_back(i);
+    }
+  }
+
+  if UNLIKELY(!running.empty())
+    edm::LogError("FailedPropagation") << " too many iterations trying to reach cylinder for " << running.size() << " states";
+  return result;
+}
+
 Propagator * RKPropagatorInS::clone() const
 {
     return new RKPropagatorInS(*this);
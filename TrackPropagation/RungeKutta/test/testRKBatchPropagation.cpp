@@ -0,0 +1,106 @@
+// Benchmark of the batched propagation of RKPropagatorInS, and check of its
+// agreement with the propagation of one state at a time.
+
+#include "TrackPropagation/RungeKutta/interface/defaultRKPropagator.h"
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "DataFormats/GeometrySurface/interface/Cylinder.h"
+#include "DataFormats/GeometrySurface/interface/Plane.h"
+#include "TrackingTools/TrajectoryState/interface/FreeTrajectoryState.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+  // a solenoid-like, non uniform field
+  class SolenoidLikeField final : public MagneticField {
+  public:
+    GlobalVector inTesla( const GlobalPoint& gp) const override {
+      float a = 1.f/400.f;
+      float f = 1.f/(1.f + a*a*(gp.perp2() + gp.z()*gp.z()));
+      return GlobalVector( 0.5f*a*a*gp.x()*gp.z()*3.8f*f*f, 0.5f*a*a*gp.y()*gp.z()*3.8f*f*f, 3.8f*f);
+    }
+  };
+
+  template <typename F>
+  double timeIt( int repeat, F f) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r=0; r<repeat; ++r) f();
+    std::chrono::duration<double, std::micro> dt = std::chrono::high_resolution_clock::now() - start;
+    return dt.count()/repeat;
+  }
+
+  int compare( const std::vector<std::pair<TrajectoryStateOnSurface,double> >& scalar,
+	       const std::vector<std::pair<TrajectoryStateOnSurface,double> >& batch,
+	       const char* what) {
+    int nbad = 0;
+    double maxDpos = 0, maxDmom = 0, maxDerr = 0;
+    for (unsigned int i=0; i<scalar.size(); ++i) {
+      const auto& s = scalar[i].first;
+      const auto& b = batch[i].first;
+      if (s.isValid() != b.isValid()) { ++nbad; continue; }
+      if (!s.isValid()) continue;
+      double dpos = (s.globalPosition() - b.globalPosition()).mag();
+      double dmom = (s.globalMomentum() - b.globalMomentum()).mag()/s.globalMomentum().mag();
+      double derr = std::abs( s.curvilinearError().matrix()(0,0) - b.curvilinearError().matrix()(0,0))
+	/s.curvilinearError().matrix()(0,0);
+      maxDpos = std::max( maxDpos, dpos);
+      maxDmom = std::max( maxDmom, dmom);
+      maxDerr = std::max( maxDerr, derr);
+      if (dpos > 1.e-3 || dmom > 1.e-5 || std::abs( scalar[i].second - batch[i].second) > 1.e-3) ++nbad;
+    }
+    std::cout << what << ": max position difference " << maxDpos << " cm, max relative momentum difference "
+	      << maxDmom << ", max relative error difference " << maxDerr << ", " << nbad << " disagreements"
+	      << std::endl;
+    return nbad;
+  }
+}
+
+int main( int argc, char** argv) {
+  unsigned int ntracks = argc > 1 ? std::atoi(argv[1]) : 500;
+  int repeat = argc > 2 ? std::atoi(argv[2]) : 20;
+
+  SolenoidLikeField field;
+  defaultRKPropagator::Product prod( &field, alongMomentum, 5.e-5);
+  const RKPropagatorInS& prop = prod.propagator;
+
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<float> uphi( -M_PI, M_PI), ueta( -1.2, 1.2), upt( 0.8, 50.), uz( -10., 10.);
+  AlgebraicSymMatrix55 err;
+  for (int i=0; i<5; ++i) err(i,i) = 1.e-4;
+  std::vector<FreeTrajectoryState> states;
+  for (unsigned int i=0; i<ntracks; ++i) {
+    float phi = uphi(rng), eta = ueta(rng), pt = upt(rng);
+    GlobalVector mom( pt*std::cos(phi), pt*std::sin(phi), pt*std::sinh(eta));
+    GlobalPoint pos( 0.1f*std::cos(phi), 0.1f*std::sin(phi), uz(rng));
+    states.emplace_back( GlobalTrajectoryParameters( pos, mom, (i%2) ? 1 : -1, &field),
+			 CurvilinearTrajectoryError( err));
+  }
+
+  auto cyl = Cylinder::build( 120.f, Surface::PositionType(0,0,0), Surface::RotationType());
+  auto plane = Plane::build( Surface::PositionType(0,0,200), Surface::RotationType());
+
+  int nbad = 0;
+  std::vector<std::pair<TrajectoryStateOnSurface,double> > scalar, batch;
+  auto propagateScalar = [&]( const Surface& surface) {
+    scalar.clear();
+    for (const auto& s : states) scalar.push_back( prop.propagateWithPath( s, surface));
+  };
+
+  double tScalar = timeIt( repeat, [&]() { propagateScalar( *cyl); });
+  double tBatch = timeIt( repeat, [&]() { batch = prop.propagateWithPath( states, *cyl); });
+  nbad += compare( scalar, batch, "cylinder");
+  std::cout << "cylinder: " << ntracks << " states, " << tScalar << " us one at a time, "
+	    << tBatch << " us in a batch" << std::endl;
+
+  tScalar = timeIt( repeat, [&]() { propagateScalar( *plane); });
+  tBatch = timeIt( repeat, [&]() { batch = prop.propagateWithPath( states, *plane); });
+  nbad += compare( scalar, batch, "plane");
+  std::cout << "plane: " << ntracks << " states, " << tScalar << " us one at a time, "
+	    << tBatch << " us in a batch" << std::endl;
+
+  return nbad == 0 ? 0 : 1;
+}
@@ -46,6 +46,7 @@ class CachedTrajectory {
 
 private:
   friend class TrackDetectorAssociator;
+  friend class SharedTrajectoryCache;
   friend std::vector<SteppingHelixStateInfo> 
   propagateThoughFromIP(const SteppingHelixStateInfo& state,const Propagator* ptr,
 			const FiducialVolume& volume,int nsteps,
@@ -56,6 +57,10 @@ private:
   enum WideTrajectoryType { Ecal, Hcal, HO };
   
   void reset_trajectory() dso_internal;
+
+  /// take the propagated trajectory and calorimeter crossings of another
+  /// instance, keeping this one's propagator, settings and state at IP
+  void copyPropagatedStates(const CachedTrajectory&) dso_internal;
   
   /// propagate through the whole detector, returns true if successful
   bool propagateAll(const SteppingHelixStateInfo& initialState) dso_internal;
@@ -95,6 +95,10 @@ class TrackAssociatorParameters {
    // and trajectory is assumed to be known perfectly
    double trajectoryUncertaintyTolerance;
 
+   // Reuse the trajectories propagated by other modules in the same
+   // event when the default propagator is used (untracked, default true)
+   bool shareTrajectories = true;
+
    edm::EDGetTokenT<EBRecHitCollection> EBRecHitsToken;
    edm::EDGetTokenT<EERecHitCollection> EERecHitsToken;
    edm::EDGetTokenT<CaloTowerCollection> caloTowersToken;
@@ -453,6 +453,16 @@ void CachedTrajectory::reset_trajectory() {
    fullTrajectoryFilled_ = false;
 }
 
+void CachedTrajectory::copyPropagatedStates( const CachedTrajectory& other ) {
+   reset_trajectory();
+   fullTrajectory_ = other.fullTrajectory_;
+   ecalTrajectory_ = other.ecalTrajectory_;
+   hcalTrajectory_ = other.hcalTrajectory_;
+   hoTrajectory_ = other.hoTrajectory_;
+   preshowerTrajectory_ = other.preshowerTrajectory_;
+   fullTrajectoryFilled_ = other.fullTrajectoryFilled_;
+}
+
 void CachedTrajectory::findEcalTrajectory( const FiducialVolume& volume ) {
    LogTrace("TrackAssociator") << "getting trajectory in ECAL";
    getTrajectory(ecalTrajectory_, volume, 4 );
@@ -0,0 +1,92 @@
+// -*- C++ -*-
+//
+// Package:    TrackAssociator
+// Class:      SharedTrajectoryCache
+// 
+//
+//
+
+#include "SharedTrajectoryCache.h"
+#include "TrackingTools/TrajectoryState/interface/FreeTrajectoryState.h"
+
+#include "tbb/concurrent_unordered_map.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace {
+   struct EventTrajectories {
+      std::mutex mutex;
+      // guarded by the mutex, used only by the modules of the event
+      edm::Event::CacheIdentifier_t event = 0;
+      std::map<SharedTrajectoryCache::Key, CachedTrajectory> trajectories;
+   };
+
+   // trajectories of the current event of each stream; the slot of a stream
+   // is made once and never removed, so looking it up takes no lock
+   tbb::concurrent_unordered_map<unsigned int, std::shared_ptr<EventTrajectories> > streamTrajectories;
+
+   EventTrajectories& trajectoriesOf( const edm::Event& iEvent ) {
+      unsigned int stream = iEvent.streamID().value();
+      auto itr = streamTrajectories.find( stream );
+      if ( itr == streamTrajectories.end() )
+	 itr = streamTrajectories.insert( std::make_pair( stream, std::make_shared<EventTrajectories>() ) ).first;
+      return *itr->second;
+   }
+
+   // to be called with the mutex of the trajectories held
+   void dropIfOtherEvent( EventTrajectories& trajectories, const edm::Event& iEvent ) {
+      if ( trajectories.event != iEvent.cacheIdentifier() ) {
+	 trajectories.trajectories.clear();
+	 trajectories.event = iEvent.cacheIdentifier();
+      }
+   }
+}
+
+SharedTrajectoryCache::Key::Key( const SteppingHelixStateInfo& state, const MagneticField* iField,
+				 const std::array<const DetIdAssociator*,4>& iAssociators,
+				 float iMaxRho, float iMaxZ, float iMinRho, float iMinZ, float iStep ):
+  parameters{ {state.position().x(), state.position().y(), state.position().z(),
+	       state.momentum().x(), state.momentum().y(), state.momentum().z()} },
+  charge( state.charge() ), hasError( false ), covariance{ {} }, field( iField ), associators( iAssociators ),
+  maxRho( iMaxRho ), maxZ( iMaxZ ), minRho( iMinRho ), minZ( iMinZ ), step( iStep )
+{
+   FreeTrajectoryState fts;
+   state.getFreeState( fts );
+   hasError = fts.hasError();
+   if ( hasError ) {
+      const AlgebraicSymMatrix55& matrix = fts.curvilinearError().matrix();
+      unsigned int k = 0;
+      for ( unsigned int i = 0; i < 5; ++i )
+	 for ( unsigned int j = 0; j <= i; ++j )
+	    covariance[k++] = matrix(i,j);
+   }
+}
+
+bool SharedTrajectoryCache::Key::operator<( const Key& other ) const
+{
+   return std::tie( parameters, charge, hasError, covariance, field, associators, maxRho, maxZ, minRho, minZ, step ) <
+     std::tie( other.parameters, other.charge, other.hasError, other.covariance, other.field, other.associators,
+	       other.maxRho, other.maxZ, other.minRho, other.minZ, other.step );
+}
+
+bool SharedTrajectoryCache::get( const edm::Event& iEvent, const Key& key, CachedTrajectory& trajectory )
+{
+   EventTrajectories& cache = trajectoriesOf( iEvent );
+   std::lock_guard<std::mutex> guard( cache.mutex );
+   dropIfOtherEvent( cache, iEvent );
+   auto itr = cache.trajectories.find( key );
+   if ( itr == cache.trajectories.end() ) return false;
+   trajectory.copyPropagatedStates( itr->second );
+   return true;
+}
+
+void SharedTrajectoryCache::put( const edm::Event& iEvent, const Key& key, const CachedTrajectory& trajectory )
+{
+   EventTrajectories& cache = trajectoriesOf( iEvent );
+   std::lock_guard<std::mutex> guard( cache.mutex );
+   dropIfOtherEvent( cache, iEvent );
+   cache.trajectories.emplace( key, trajectory );
+}
@@ -0,0 +1,61 @@
+#ifndef TrackAssociator_SharedTrajectoryCache_h
+#define TrackAssociator_SharedTrajectoryCache_h 1
+// -*- C++ -*-
+//
+// Package:    TrackAssociator
+// Class:      SharedTrajectoryCache
+// 
+/*
+
+ Description: trajectories propagated through the detector by the
+ * TrackDetectorAssociator of one module, made available to the other
+ * modules associating the same tracks in the same event (muon ID,
+ * calorimeter isolation, PF, ...), so that each track is propagated once.
+
+ Implementation:
+     The trajectories are kept per stream and dropped when the stream
+ * moves to another event; only the modules of the same event share a lock.
+ * A trajectory is identified by everything the propagation with the default
+ * propagator and the search of the calorimeter crossings depend on: the state
+ * it is propagated from (including its errors, used by getWideTrajectory),
+ * the magnetic field, the propagation boundaries and step, and the
+ * DetIdAssociators giving the calorimeter volumes.
+*/
+//
+
+#include "TrackingTools/TrackAssociator/interface/CachedTrajectory.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Utilities/interface/Visibility.h"
+
+#include <array>
+
+class DetIdAssociator;
+class MagneticField;
+
+class dso_internal SharedTrajectoryCache {
+ public:
+   struct Key {
+      Key( const SteppingHelixStateInfo& state, const MagneticField* field,
+	   const std::array<const DetIdAssociator*,4>& associators,
+	   float maxRho, float maxZ, float minRho, float minZ, float step );
+      bool operator<( const Key& other ) const;
+
+      std::array<float,6> parameters;
+      int charge;
+      bool hasError;
+      std::array<double,15> covariance;
+      const MagneticField* field;
+      std::array<const DetIdAssociator*,4> associators;
+      float maxRho;
+      float maxZ;
+      float minRho;
+      float minZ;
+      float step;
+   };
+
+   /// returns false if the trajectory has not been propagated yet in this event,
+   /// otherwise copies its propagated states to the trajectory
+   static bool get( const edm::Event&, const Key&, CachedTrajectory& );
+   static void put( const edm::Event&, const Key&, const CachedTrajectory& );
+};
+#endif
@@ -56,6 +56,7 @@ void TrackAssociatorParameters::loadParameters( const edm::ParameterSet& iConfig
    
    truthMatch = iConfig.getParameter<bool>("truthMatch");
    muonMaxDistanceSigmaY = iConfig.getParameter<double>("trajectoryUncertaintyTolerance");
+   shareTrajectories = iConfig.getUntrackedParameter<bool>("shareTrajectories", true);
 
    if (useEcal) {
      EBRecHitsToken=iC.consumes<EBRecHitCollection>(theEBRecHitCollectionLabel);
@@ -78,6 +78,7 @@
 
 #include "TrackingTools/TrackAssociator/interface/DetIdAssociator.h"
 #include "TrackingTools/TrackAssociator/interface/DetIdInfo.h"
+#include "SharedTrajectoryCache.h"
 // #include "TrackingTools/TrackAssociator/interface/CaloDetIdAssociator.h"
 // #include "TrackingTools/TrackAssociator/interface/EcalDetIdAssociator.h"
 // #include "TrackingTools/TrackAssociator/interface/PreshowerDetIdAssociator.h"
@@ -236,13 +237,28 @@ TrackDetMatchInfo TrackDetectorAssociator::associate( const edm::Event& iEvent,
 
    if ( trackOrigin.momentum().mag() == 0 ) return info;
    if ( edm::isNotFinite(trackOrigin.momentum().x()) or edm::isNotFinite(trackOrigin.momentum().y()) or edm::isNotFinite(trackOrigin.momentum().z()) ) return info;
-   if ( ! cachedTrajectory_.propagateAll(trackOrigin) ) return info;
+
+   // trajectories propagated with the default propagator are shared
+   // with the other associators working on the same event
+   bool shareTrajectory = parameters.shareTrajectories && useDefaultPropagator_ && ivProp_ == defProp_;
+   SharedTrajectoryCache::Key key( trackOrigin, defProp_ ? defProp_->magneticField() : nullptr,
+				   {{ ecalDetIdAssociator_.product(), hcalDetIdAssociator_.product(),
+				      hoDetIdAssociator_.product(), preshowerDetIdAssociator_.product() }},
+				   cachedTrajectory_.maxRho_, cachedTrajectory_.maxZ_,
+				   cachedTrajectory_.minRho_, cachedTrajectory_.minZ_,
+				   cachedTrajectory_.step_ );
+   if ( shareTrajectory && SharedTrajectoryCache::get( iEvent, key, cachedTrajectory_ ) ) {
+      LogTrace("TrackAssociator") << "Using the trajectory already propagated in this event";
+   } else {
+      if ( ! cachedTrajectory_.propagateAll(trackOrigin) ) return info;
    
-   // get trajectory in calorimeters
-   cachedTrajectory_.findEcalTrajectory( ecalDetIdAssociator_->volume() );
-   cachedTrajectory_.findHcalTrajectory( hcalDetIdAssociator_->volume() );
-   cachedTrajectory_.findHOTrajectory( hoDetIdAssociator_->volume() );
-   cachedTrajectory_.findPreshowerTrajectory( preshowerDetIdAssociator_->volume() );
+      // get trajectory in calorimeters
+      cachedTrajectory_.findEcalTrajectory( ecalDetIdAssociator_->volume() );
+      cachedTrajectory_.findHcalTrajectory( hcalDetIdAssociator_->volume() );
+      cachedTrajectory_.findHOTrajectory( hoDetIdAssociator_->volume() );
+      cachedTrajectory_.findPreshowerTrajectory( preshowerDetIdAssociator_->volume() );
+      if ( shareTrajectory ) SharedTrajectoryCache::put( iEvent, key, cachedTrajectory_ );
+   }
 
    info.trkGlobPosAtEcal = getPoint( cachedTrajectory_.getStateAtEcal().position() );
    info.trkGlobPosAtHcal = getPoint( cachedTrajectory_.getStateAtHcal().position() );